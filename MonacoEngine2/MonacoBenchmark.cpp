@@ -0,0 +1,15 @@
+#include "Benchmark.h"
+
+/**
+ * Punto de entrada del ejecutable de benchmarks del nucleo portable (objetivo MonacoBenchmark
+ * de CMakeLists.txt). Equivale a "MonacoEngine2 -bench <nombre>" sin ventana ni Direct3D.
+ *
+ * Uso: MonacoBenchmark [nombre] [reporte]. Sin nombre ejecuta todos; el reporte por defecto
+ * es benchmark_<nombre>.txt en el directorio actual.
+ */
+int
+main(int argc, char** argv) {
+	const std::string name = argc > 1 ? argv[1] : "all";
+	const std::string reportFile = argc > 2 ? argv[2] : "benchmark_" + name + ".txt";
+	return Benchmark::run(name, reportFile);
+}
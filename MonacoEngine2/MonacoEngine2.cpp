@@ -1,9 +1,70 @@
 #include "Prerequisites.h"
 #include "BaseApp.h"
+#include "Benchmark.h"
 
 
 int WINAPI
 wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, int nCmdShow) {
 	BaseApp app(hInstance, nCmdShow);
+
+	// -headless [-frames N]: render en CPU sin ventana (validacion / CI).
+	if (lpCmdLine && wcsstr(lpCmdLine, L"-headless")) {
+		unsigned int frames = 60;
+		const wchar_t* framesArg = wcsstr(lpCmdLine, L"-frames");
+		if (framesArg) {
+			frames = static_cast<unsigned int>(_wtoi(framesArg + wcslen(L"-frames")));
+		}
+		return app.runHeadless(frames, "headless_espada.tga");
+	}
+
+	// -shaderlib <archivo.fx> <salida> [FEATURE ...]: compila en paralelo todas las permutaciones
+	// de las features indicadas en una biblioteca de shaders (ver ShaderLibrary.h).
+	const wchar_t* libraryArg = lpCmdLine ? wcsstr(lpCmdLine, L"-shaderlib") : nullptr;
+	if (libraryArg) {
+		std::wistringstream args(libraryArg + wcslen(L"-shaderlib"));
+		std::vector<std::string> words;
+		std::wstring word;
+		while (args >> word) {
+			words.push_back(std::string(word.begin(), word.end()));
+		}
+		if (words.size() < 2) {
+			ERROR("Main", "shaderlib", "Usage: -shaderlib <file.fx> <output> [FEATURE ...]");
+			return 1;
+		}
+		JobSystem::instance().init();
+		ShaderCache cache;
+		ShaderLibraryDesc desc;
+		desc.fileName = words[0];
+		desc.features.assign(words.begin() + 2, words.end());
+		desc.flags = ShaderProgram::getCompileFlags();
+		desc.compilerVersion = D3D_COMPILER_VERSION;
+		desc.jobs = &JobSystem::instance();
+		desc.cache = SUCCEEDED(cache.init("ShaderCache", D3D_COMPILER_VERSION)) ? &cache : nullptr;
+		ShaderLibraryBuildStats stats;
+		HRESULT hr = ShaderLibrary::build(desc, &ShaderProgram::compileVariant, words[1], &stats);
+		JobSystem::instance().destroy();
+		if (FAILED(hr)) {
+			return 1;
+		}
+		MESSAGE("ShaderLibrary", "build",
+			(words[1] + ": " + std::to_string(stats.variants) + " variantes (" + std::to_string(stats.compiled) +
+			 " compiladas, " + std::to_string(stats.cached) + " de cache), " + std::to_string(stats.uniqueBlobs) +
+			 " blobs, " + std::to_string(stats.fileBytes) + " bytes, " + std::to_string(stats.totalMs) + " ms").c_str());
+		return 0;
+	}
+
+	// -bench <nombre>: benchmarks de los sistemas de CPU (ver Benchmark.h).
+	const wchar_t* benchArg = lpCmdLine ? wcsstr(lpCmdLine, L"-bench") : nullptr;
+	if (benchArg) {
+		std::wistringstream args(benchArg + wcslen(L"-bench"));
+		std::wstring wideName;
+		args >> wideName;
+		std::string name(wideName.begin(), wideName.end());
+		if (name.empty()) {
+			name = "all";
+		}
+		return Benchmark::run(name, "benchmark_" + name + ".txt");
+	}
+
 	return app.run(hInstance, nCmdShow);
-}
\ No newline at end of file
+}
@@ -13,6 +13,20 @@
 #include "Buffer.h"
 #include "SamplerState.h"
 #include "ModelLoader.h"
+#include "Image.h"
+#include "SoftwareRasterizer.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "SpatialGrid.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "ECS/World.h"
+#include "TransformComponent.h"
+#include "TransformHierarchy.h"
+#include "TextureUploadQueue.h"
+#include "TextureCache.h"
+#include "ShaderCache.h"
+#include "ShaderProgramQueue.h"
 
 /**
  * @class BaseApp
@@ -47,6 +61,19 @@ public:
      */
     int run(HINSTANCE hInst, int nCmdShow);
 
+    /**
+     * @brief Renderiza la escena sin ventana ni GPU usando el rasterizador por software.
+     *
+     * Carga el mismo modelo y textura que init(), anima la escena con un paso de tiempo fijo
+     * (resultado determinista) y guarda el ultimo frame como TGA junto con un reporte de
+     * tiempos por etapa (@p outputFile + ".txt").
+     *
+     * @param frames     Numero de frames a renderizar.
+     * @param outputFile Ruta del TGA de salida.
+     * @return 0 si fue exitoso; 1 en caso de error.
+     */
+    int runHeadless(unsigned int frames, const std::string& outputFile);
+
     /**
      * @brief Inicializa todos los componentes necesarios para la ejecucin de la aplicacin.
      * @return HRESULT indicando si la inicializacin fue exitosa.
@@ -59,6 +86,13 @@ public:
      */
     void update(float deltaTime);
 
+    /**
+     * @brief Calcula matrices y constantes de la escena para el tiempo @p t.
+     * @param t         Tiempo de animacin en segundos.
+     * @param deltaTime Tiempo desde el frame anterior (sistemas del ECS).
+     */
+    void updateScene(float t, float deltaTime);
+
     /**
      * @brief Renderiza la escena en pantalla.
      */
@@ -80,6 +114,30 @@ private:
      */
     static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
+    /**
+     * @brief Configura la cmara fija y la proyeccin segn el tamao de la ventana.
+     */
+    void initCamera();
+
+    /**
+     * @brief Crea m_world con la entidad del modelo (malla cargada de disco + transform) y su nodo en m_sceneGraph.
+     */
+    HRESULT initScene();
+
+    /// Malla de m_model (vlida mientras no cambie la estructura de m_world).
+    MeshComponent& getModelMesh() { return *m_world.getComponent<MeshComponent>(m_model); }
+
+    /**
+     * @brief Inserta en m_spatialGrid una entrada por submalla del modelo e inicializa los cullers
+     *        (frustum y oclusion).
+     */
+    HRESULT initCulling();
+
+    /**
+     * @brief Actualiza los volmenes de las submallas y calcula cules son visibles.
+     */
+    void cullScene();
+
 private:
     /// Componente que gestiona la ventana principal de la aplicacin.
     Window              m_window;
@@ -111,8 +169,29 @@ private:
     /// Programa de shaders utilizado en la escena.
     ShaderProgram       m_shaderProgram;
 
-    /// Componente que gestiona la malla 3D.
-    MeshComponent       m_mesh;
+    /// Bytecode compilado de los shaders en disco; evita recompilar HLSL en cada arranque.
+    ShaderCache         m_shaderCache;
+
+    /// Variantes precompiladas con "-shaderlib"; si existe, m_shaderProgram sale de aqui.
+    ShaderLibrary       m_shaderLibrary;
+
+    /// Compila m_shaderProgram en segundo plano y lo cambia entre frames cuando esta listo.
+    ShaderProgramQueue  m_shaderPrograms;
+
+    /// Color plano sin textura; lo usa m_shaderProgram mientras compila.
+    ShaderProgram       m_fallbackProgram;
+
+    /// Entidades de la escena con sus componentes y sistemas.
+    World               m_world;
+
+    /// Entidad del modelo: MeshComponent + TransformComponent.
+    Entity              m_model;
+
+    /// Jerarqua de transformaciones de la escena; calcula las matrices de mundo.
+    TransformHierarchy  m_sceneGraph;
+
+    /// Nodo de m_model en m_sceneGraph.
+    unsigned int        m_modelNode = TransformHierarchy::INVALID_HANDLE;
 
     /// Cargador de modelos 3D desde archivos externos.
     ModelLoader         m_modelLoader;
@@ -135,9 +214,57 @@ private:
     /// Textura cbica usada para efectos visuales o ambientales.
     Texture             m_textureCube;
 
+    /// Texturas compartidas por ruta y contenido; conserva las que no se usan dentro del presupuesto.
+    TextureCache        m_textureCache;
+
+    /// VRAM para texturas cargadas que ya no usa nadie.
+    static constexpr size_t TEXTURE_CACHE_BUDGET_BYTES = 256ull * 1024 * 1024;
+
+    /// Decodifica las texturas en segundo plano y las crea con un presupuesto por frame.
+    TextureUploadQueue  m_textureUploads;
+
+    /// Milisegundos por frame para crear texturas ya decodificadas.
+    static constexpr double TEXTURE_UPLOAD_BUDGET_MS = 2.0;
+
     /// Estado del muestreador de texturas utilizado por los shaders.
     SamplerState        m_samplerState;
 
+    /// Copia en CPU de la textura, usada por el rasterizador por software.
+    Image               m_textureImage;
+
+    /// Backend de render en CPU para validacin sin GPU.
+    SoftwareRasterizer  m_softwareRasterizer;
+
+    /// ndice espacial con la caja en espacio de mundo de cada submalla del modelo.
+    SpatialGrid         m_spatialGrid;
+
+    /// Handle en m_spatialGrid de cada submalla.
+    std::vector<unsigned int> m_subMeshHandles;
+
+    /// Culling por frustum de las submallas.
+    FrustumCuller       m_frustumCuller;
+
+    /// ndices (en MeshComponent::m_subMeshes del modelo) de las submallas visibles en el frame actual.
+    std::vector<unsigned int> m_visibleSubMeshes;
+
+    /// Culling por oclusin de las submallas que pasan el frustum.
+    OcclusionCuller     m_occlusionCuller;
+
+    /// Caja en espacio de mundo de cada submalla de m_visibleSubMeshes (entrada de m_occlusionCuller).
+    std::vector<AABB>   m_occlusionBoxes;
+
+    /// Resultado de la prueba de oclusin por caja (1 = visible).
+    std::vector<unsigned char> m_occlusionVisible;
+
+    /// Tamao aproximado en pantalla (radio / profundidad) y posicin en m_visibleSubMeshes de cada candidata a oclusor.
+    std::vector<std::pair<float, unsigned int>> m_occluderCandidates;
+
+    /// Mximo de submallas rasterizadas como oclusores por frame.
+    static const unsigned int MAX_OCCLUDERS = 8;
+
+    /// Tamao mnimo en pantalla (radio / profundidad) para usar una submalla como oclusor.
+    static constexpr float OCCLUDER_MIN_SIZE = 0.05f;
+
     /// Matriz de transformacin del mundo.
     XMMATRIX            m_World;
 
@@ -0,0 +1,112 @@
+/**
+ * @file Benchmark.h
+ * @brief Declara la clase Benchmark, pruebas de rendimiento sin ventana de los sistemas de CPU.
+ *
+ * Cada benchmark genera su propia escena sintetica, ejecuta varios frames y escribe un
+ * reporte con tiempos (Profiler) y contadores. Se invocan con "-bench <nombre>".
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+
+class MeshComponent;
+
+/**
+ * @class Benchmark
+ * @brief Registro de benchmarks por nombre.
+ */
+class Benchmark {
+public:
+    /**
+     * @brief Ejecuta un benchmark.
+     * @param name       Nombre del benchmark ("all" ejecuta todos).
+     * @param reportFile Archivo donde se escribe el reporte.
+     * @return 0 si fue exitoso; 1 si el nombre no existe o fallo.
+     */
+    static int run(const std::string& name, const std::string& reportFile);
+
+    /**
+     * @brief Agrega una caja cerrada a la malla (caras en sentido horario vistas desde fuera).
+     * @param mesh Malla destino.
+     * @param min  Esquina minima.
+     * @param max  Esquina maxima.
+     */
+    static void appendBox(MeshComponent& mesh, const Vector3& min, const Vector3& max);
+
+private:
+    /// Ciudad sintetica: edificios como oclusores y props en las calles.
+    static HRESULT occlusionCity(std::ostream& report);
+
+    /// Un millon de objetos dispersos probados contra el frustum de una camara que gira.
+    static HRESULT frustumMillion(std::ostream& report);
+
+    /// Construccion, refit y consultas del BVH de escena; rayos contra BVH de triangulos.
+    static HRESULT bvhScene(std::ostream& report);
+
+    /// 100K objetos moviendose cada frame en la rejilla espacial: actualizacion y consultas.
+    static HRESULT spatialGridDynamic(std::ostream& report);
+
+    /// Un millon de entidades del ECS actualizadas por sistemas, contra objetos con herencia.
+    static HRESULT ecsMillion(std::ostream& report);
+
+    /// 500K transformaciones en jerarquia con 10 % modificadas por frame, contra un arbol recursivo.
+    static HRESULT transformHierarchy(std::ostream& report);
+
+    /// Cada operacion de la libreria de matematica: tiempo y, en Windows, tiempo y error contra XNA math.
+    static HRESULT mathOps(std::ostream& report);
+
+    /// Decodificacion de las imagenes del repositorio en ImageDecodeQueue con 1, 2, 4... hilos (MP/s).
+    static HRESULT textureDecode(std::ostream& report);
+
+    /// Cadena de mipmaps de imagenes de 4K y 8K con filtro Box y Kaiser (MP/s), contra una referencia con powf.
+    static HRESULT mipGeneration(std::ostream& report);
+
+    /// Compresion BC1/BC3/BC4/BC5/BC7 rapida y de alta calidad: MP/s y PSNR contra la imagen original.
+    static HRESULT blockCompression(std::ostream& report);
+
+    /// Cocina BC7 y RGBA8 a DDS y los vuelve a abrir proyectados, contra leer el archivo completo; verifica cubemaps y arreglos.
+    static HRESULT ddsFiles(std::ostream& report);
+
+    /// Cache de texturas simulada bajo un presupuesto de VRAM: aciertos por ruta y contenido, expulsiones, hash en GB/s.
+    static HRESULT textureCache(std::ostream& report);
+
+    /// Streaming de mipmaps en un mundo de 2304 objetos con una camara simulada: residencia, lecturas y presion de presupuesto.
+    static HRESULT textureStreaming(std::ostream& report);
+
+    /// Empaqueta 600 texturas pequenas en atlas y arreglos: eficiencia, cambios de textura por frame y sangrado entre regiones.
+    static HRESULT textureAtlas(std::ostream& report);
+
+    /// Decodifica PNG/JPEG grandes con stb_image y con los decodificadores rapidos (1 y N hilos): MP/s y diferencia.
+    static HRESULT imageCodecs(std::ostream& report);
+
+    /// Carga 200 texturas con mipmaps por Image + MipChain y por UploadArena: tiempo, reservas y pico de memoria.
+    static HRESULT textureUpload(std::ostream& report);
+
+    /// Conversiones sRGB <-> lineal con tabla, FloatV y powf: error contra la formula exacta y M valores/s.
+    static HRESULT colorSpace(std::ostream& report);
+
+    /// Carga .hdr, float -> medio float escalar y FloatV, y empaquetado, memoria y error por formato HDR (BC6H incluido).
+    static HRESULT hdrFormats(std::ostream& report);
+
+    /// Panorama a cubemap, SH9 contra la irradiancia exacta y prefiltrado GGX con tiempos por nivel y cara.
+    static HRESULT environmentMaps(std::ostream& report);
+
+    /// Cache de shaders en disco: propiedades de la clave, arranque en frio y en caliente, y entradas danadas.
+    static HRESULT shaderCache(std::ostream& report);
+
+    /// Permutaciones de shaders: compilacion paralela, tamano de la biblioteca y latencia de busqueda por mascara.
+    static HRESULT shaderLibrary(std::ostream& report);
+
+    /// Compilacion de shaders bloqueando el frame contra ShaderCompileQueue: peor frame, profundidad y latencia.
+    static HRESULT shaderCompileQueue(std::ostream& report);
+
+    /// Recarga en caliente con inotify y con sondeo: includes compartidos, renombrados, latencia y costo por frame.
+    static HRESULT shaderHotReload(std::ostream& report);
+
+    /// Escenas del rasterizador por software (sin GPU) comparadas con una imagen de referencia en double.
+    static HRESULT softwareRaster(std::ostream& report);
+
+    /// Construye el BVH de @p mesh y mide rayos primarios individuales y en paquetes.
+    static HRESULT bvhMesh(std::ostream& report, const std::string& label, const MeshComponent& mesh);
+};
@@ -0,0 +1,150 @@
+/**
+ * @file BlockCompression.h
+ * @brief Declara la clase BlockImage, compresion por bloques BC1/BC3/BC4/BC5/BC6H/BC7 en CPU.
+ *
+ * Cada bloque de 4x4 se codifica de forma independiente, asi que la imagen se reparte por
+ * filas de bloques en el JobSystem. Dentro del bloque los 16 pixeles se guardan por canal
+ * (SoA) y la eleccion de indices, la proyeccion sobre el eje principal y las distancias a la
+ * paleta se calculan con FloatV.
+ *
+ *  - Fast: extremos en el eje principal (PCA) e indices al mas cercano. BC7 solo usa el modo 6.
+ *  - High: ademas refina los extremos por minimos cuadrados; BC4/BC5 prueban ambos modos de
+ *    interpolacion y BC7 compara el modo 6 contra el modo 1 (dos subconjuntos) en las mejores
+ *    particiones para bloques opacos.
+ *
+ * decode() reconstruye RGBA8 para verificar el resultado sin GPU (PSNR en el benchmark). Para
+ * BC7 decodifica los modos 1 y 3 a 7; los modos 0 y 2 (tres subconjuntos) no los emite este
+ * codificador y se devuelven en negro.
+ *
+ * BC6H (HDR sin signo) parte de una HdrImage y solo emite el modo 11: extremos de 10 bits por
+ * canal e indices de 4 bits, ajustados sobre los bits de medio float de cada pixel. decode()
+ * a HdrImage lee ese modo; los demas modos de BC6H se devuelven en negro.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Image.h"
+
+class JobSystem;
+class MipChain;
+class HdrImage;
+
+/**
+ * @enum BlockFormat
+ * @brief Formatos de compresion por bloques de Direct3D 11.
+ */
+enum class BlockFormat {
+    BC1,    ///< RGB 5:6:5 con 4 colores por bloque (o 3 + transparente). 8 bytes por bloque.
+    BC3,    ///< Color BC1 + alfa de 8 bits interpolado. 16 bytes por bloque.
+    BC4,    ///< Un canal (R) interpolado. 8 bytes por bloque.
+    BC5,    ///< Dos canales (R, G) interpolados; mapas de normales. 16 bytes por bloque.
+    BC7,    ///< RGBA de alta calidad con modos y particiones. 16 bytes por bloque.
+    BC6H    ///< RGB HDR sin signo (medios floats), sin alfa. 16 bytes por bloque.
+};
+
+/**
+ * @enum BlockQuality
+ * @brief Compromiso entre tiempo de codificacion y calidad.
+ */
+enum class BlockQuality {
+    Fast,   ///< Un ajuste por bloque; para iteracion rapida.
+    High    ///< Refinamiento y busqueda de modos; para el cocinado final.
+};
+
+/**
+ * @struct BlockSettings
+ * @brief Opciones de BlockImage::encode().
+ */
+struct BlockSettings {
+    BlockFormat format = BlockFormat::BC7;
+    BlockQuality quality = BlockQuality::Fast;
+    JobSystem* jobs = nullptr;  ///< Pool para repartir las filas de bloques; nullptr = hilo actual.
+};
+
+/**
+ * @class BlockImage
+ * @brief Un nivel de textura comprimido por bloques.
+ */
+class BlockImage {
+public:
+    BlockImage() = default;
+    ~BlockImage() = default;
+
+    BlockImage(const BlockImage&) = default;
+    BlockImage& operator=(const BlockImage&) = default;
+    BlockImage(BlockImage&&) = default;
+    BlockImage& operator=(BlockImage&&) = default;
+
+    /**
+     * @brief Comprime una imagen RGBA8.
+     *
+     * Los bloques del borde derecho e inferior repiten el ultimo pixel si el tamano no es
+     * multiplo de 4.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si la imagen esta vacia, no es RGBA8 o
+     *         el formato es BC6H.
+     */
+    HRESULT encode(const Image& image, const BlockSettings& settings);
+
+    /**
+     * @brief Comprime una imagen HDR a BC6H (el formato de @p settings debe ser BC6H).
+     *
+     * El alfa se descarta; negativos y NaN pasan a 0 y lo que excede 65504 satura.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si la imagen esta vacia o el formato no es BC6H.
+     */
+    HRESULT encode(const HdrImage& image, const BlockSettings& settings);
+
+    /**
+     * @brief Comprime todos los niveles de @p mips.
+     * @param levels Recibe un BlockImage por nivel.
+     */
+    static HRESULT encodeMips(const MipChain& mips, const BlockSettings& settings, std::vector<BlockImage>& levels);
+
+    /// Igual que encodeMips(const MipChain&) para los niveles de HdrImage::generateMips() (BC6H).
+    static HRESULT encodeMips(const std::vector<HdrImage>& mips, const BlockSettings& settings,
+                              std::vector<BlockImage>& levels);
+
+    /**
+     * @brief Descomprime a RGBA8 (BC4: R,0,0,255; BC5: R,G,0,255).
+     * @return @c S_OK si fue exitoso; @c E_FAIL si no hay datos; @c E_INVALIDARG para BC6H.
+     */
+    HRESULT decode(Image& image) const;
+
+    /**
+     * @brief Descomprime BC6H a RGBA float (alfa 1).
+     * @return @c S_OK si fue exitoso; @c E_FAIL si no hay datos o el formato no es BC6H.
+     */
+    HRESULT decode(HdrImage& image) const;
+
+    /// Libera los bloques.
+    void destroy();
+
+    /// Bytes por fila de bloques (SysMemPitch de D3D11).
+    unsigned int getRowPitch() const { return getBlocksWide() * getBlockBytes(m_format); }
+
+    /// Bloques por fila.
+    unsigned int getBlocksWide() const { return (m_width + 3) / 4; }
+
+    /// Filas de bloques.
+    unsigned int getBlocksHigh() const { return (m_height + 3) / 4; }
+
+    /// @c true si no hay datos.
+    bool empty() const { return m_data.empty(); }
+
+    /// Bytes por bloque de 4x4 de @p format (8 o 16).
+    static unsigned int getBlockBytes(BlockFormat format);
+
+    /**
+     * @brief PSNR en dB entre @p reference y @p decoded en los canales que guarda @p format.
+     *
+     * En BC1 solo cuenta el RGB de los pixeles opacos (alfa >= 128 en @p reference).
+     * @return Infinito si son identicas; 0 si los tamanos no coinciden.
+     */
+    static double computePsnr(const Image& reference, const Image& decoded, BlockFormat format);
+
+public:
+    unsigned int m_width = 0;               ///< Ancho en pixeles.
+    unsigned int m_height = 0;              ///< Alto en pixeles.
+    BlockFormat m_format = BlockFormat::BC7;
+    std::vector<unsigned char> m_data;      ///< Bloques fila por fila.
+};
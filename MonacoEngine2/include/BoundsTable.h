@@ -0,0 +1,79 @@
+/**
+ * @file BoundsTable.h
+ * @brief Declara la clase BoundsTable, volumenes envolventes en espacio de mundo en formato SoA.
+ *
+ * Cada objeto guarda centro y semi-extension de su caja alineada a los ejes (AABB) y el radio
+ * de una esfera centrada en el mismo punto. Cada componente vive en su propio arreglo
+ * contiguo (structure of arrays), de modo que las pruebas de culling cargan 4 u 8 objetos
+ * por instruccion sin reordenar datos.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+
+/**
+ * @class BoundsTable
+ * @brief Tabla de volumenes envolventes indexada por objeto.
+ *
+ * Los indices devueltos por add() son estables mientras no se llame a clear() o remove().
+ */
+class BoundsTable {
+public:
+    BoundsTable() = default;
+    ~BoundsTable() = default;
+
+    /// Reserva espacio para @p count objetos.
+    void reserve(unsigned int count);
+
+    /// Elimina todos los objetos.
+    void clear();
+
+    /**
+     * @brief Agrega un objeto con volumenes en espacio local.
+     * @param localBox    Caja en espacio local.
+     * @param localSphere Esfera en espacio local.
+     * @param world       Matriz de mundo del objeto.
+     * @return Indice del objeto en la tabla.
+     */
+    unsigned int add(const AABB& localBox, const BoundingSphere& localSphere, const Matrix4& world);
+
+    /// Agrega un objeto cuya caja ya esta en espacio de mundo.
+    unsigned int add(const AABB& worldBox);
+
+    /**
+     * @brief Transforma los volumenes locales de un objeto a espacio de mundo.
+     *
+     * La caja resultante envuelve a la caja local transformada; la esfera se recentra en la
+     * caja y su radio se escala por el mayor factor de escala de @p world.
+     */
+    void setTransform(unsigned int index, const AABB& localBox, const BoundingSphere& localSphere,
+                      const Matrix4& world);
+
+    /**
+     * @brief Elimina un objeto moviendo el ultimo a su lugar.
+     * @return Indice anterior del objeto movido (el ultimo) o @p index si era el ultimo.
+     */
+    unsigned int remove(unsigned int index);
+
+    /// Reemplaza los volumenes de un objeto por una caja en espacio de mundo.
+    void setWorldBox(unsigned int index, const AABB& worldBox);
+
+    /// Caja alineada a los ejes que envuelve a @p localBox transformada por @p world.
+    static AABB transformBox(const AABB& localBox, const Matrix4& world);
+
+    /// Caja en espacio de mundo del objeto @p index.
+    AABB getWorldBox(unsigned int index) const;
+
+    /// Numero de objetos.
+    unsigned int size() const { return static_cast<unsigned int>(m_centerX.size()); }
+
+public:
+    std::vector<float> m_centerX;   ///< Centro de la caja (x).
+    std::vector<float> m_centerY;   ///< Centro de la caja (y).
+    std::vector<float> m_centerZ;   ///< Centro de la caja (z).
+    std::vector<float> m_extentX;   ///< Semi-extension de la caja (x).
+    std::vector<float> m_extentY;   ///< Semi-extension de la caja (y).
+    std::vector<float> m_extentZ;   ///< Semi-extension de la caja (z).
+    std::vector<float> m_radius;    ///< Radio de la esfera centrada en la caja.
+};
@@ -0,0 +1,294 @@
+/**
+ * @file Bvh.h
+ * @brief Declara la clase Bvh, jerarquia de volumenes envolventes sobre cajas (AABB).
+ *
+ * La jerarquia se construye con la heuristica de area de superficie (SAH) evaluada en
+ * BIN_COUNT intervalos por eje. Los nodos ocupan 32 bytes y se guardan en un arreglo plano:
+ * los dos hijos de un nodo interior son consecutivos y siempre tienen un indice mayor que su
+ * padre, de modo que recorrer el arreglo al reves recalcula las cajas de abajo hacia arriba.
+ *
+ * Sirve tanto para los objetos de la escena (consultas por region, picking contra cajas y
+ * refit incremental de objetos que se mueven) como base de TriangleBvh. Los rayos se pueden
+ * lanzar de uno en uno o en paquetes de SIMD_LANES rayos que recorren el arbol juntos.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Simd.h"
+
+/**
+ * @struct Ray
+ * @brief Rayo con origen, direccion (no necesita ser unitaria) y distancia maxima.
+ */
+struct Ray {
+    Vector3 origin;
+    Vector3 direction;
+    float    tMax;
+};
+
+/**
+ * @struct RayHit
+ * @brief Resultado de una interseccion. @c primitive es Bvh::INVALID_INDEX si no hubo impacto.
+ */
+struct RayHit {
+    float        t;             ///< Distancia en unidades de la direccion del rayo.
+    unsigned int primitive;     ///< Caja o triangulo impactado.
+    float        u;             ///< Coordenada baricentrica (solo triangulos).
+    float        v;             ///< Coordenada baricentrica (solo triangulos).
+};
+
+/**
+ * @struct RayPacket
+ * @brief SIMD_LANES rayos en formato SoA que se recorren juntos.
+ *
+ * Los carriles sin rayo quedan inactivos (tMax negativo) y nunca reportan impactos.
+ */
+struct RayPacket {
+    float originX[simd::SIMD_LANES], originY[simd::SIMD_LANES], originZ[simd::SIMD_LANES];
+    float dirX[simd::SIMD_LANES], dirY[simd::SIMD_LANES], dirZ[simd::SIMD_LANES];
+    float invX[simd::SIMD_LANES], invY[simd::SIMD_LANES], invZ[simd::SIMD_LANES];
+    float tMax[simd::SIMD_LANES];
+    float u[simd::SIMD_LANES], v[simd::SIMD_LANES];
+    unsigned int primitive[simd::SIMD_LANES];
+
+    /**
+     * @brief Carga hasta SIMD_LANES rayos.
+     * @param rays  Rayos de entrada.
+     * @param count Numero de rayos (los carriles restantes quedan inactivos).
+     */
+    void set(const Ray* rays, unsigned int count);
+
+    /// Resultado del carril @p lane.
+    void getHit(unsigned int lane, RayHit& hit) const;
+};
+
+/**
+ * @class Bvh
+ * @brief BVH binario sobre cajas alineadas a los ejes.
+ */
+class Bvh {
+public:
+    /// Indice invalido (sin primitiva / sin nodo).
+    static const unsigned int INVALID_INDEX = 0xffffffffu;
+
+    /// Intervalos por eje para evaluar la SAH.
+    static const unsigned int BIN_COUNT = 16;
+
+    /// Profundidad a partir de la cual se parte por la mediana (acota la pila de recorrido).
+    static const unsigned int MAX_SAH_DEPTH = 48;
+
+    /// Tamano de la pila de recorrido.
+    static const unsigned int STACK_SIZE = 128;
+
+    /// Factor 1 + 2*gamma(3) (gamma(n) = n*u / (1 - n*u), u = 2^-24) sobre la salida de cada
+    /// losa: sin el, el redondeo de (min - o) * inv deja fuera de la caja a rayos que rozan una
+    /// cara y cuyo impacto esta dentro (Ize 2013).
+    static constexpr float SLAB_EXIT_SCALE = 1.00000036f;
+
+    /**
+     * @struct Node
+     * @brief Nodo de 32 bytes. En hojas @c leftFirst es la primera primitiva de getIndices();
+     *        en nodos interiores es el hijo izquierdo (el derecho es leftFirst + 1).
+     */
+    struct Node {
+        float          min[3];
+        unsigned int   leftFirst;
+        float          max[3];
+        unsigned short count;   ///< Primitivas de la hoja; 0 en nodos interiores.
+        unsigned short axis;    ///< Eje de la particion (orden de recorrido).
+
+        bool isLeaf() const { return count > 0; }
+    };
+
+    Bvh() = default;
+    ~Bvh() = default;
+
+    /**
+     * @brief Construye la jerarquia.
+     * @param boxes       Caja de cada primitiva.
+     * @param count       Numero de primitivas.
+     * @param maxLeafSize Maximo de primitivas por hoja (1 a 255).
+     */
+    HRESULT build(const AABB* boxes, unsigned int count, unsigned int maxLeafSize = 4);
+
+    /// Reemplaza todas las cajas (mismo orden y cantidad que en build()) y recalcula los nodos.
+    void refit(const AABB* boxes);
+
+    /**
+     * @brief Actualiza la caja de una primitiva y solo los nodos de su camino a la raiz.
+     *
+     * Se detiene en cuanto un ancestro no cambia. La topologia no se modifica; si los objetos
+     * se alejan mucho de su posicion original conviene reconstruir (ver getCost()).
+     */
+    void refit(unsigned int primitive, const AABB& box);
+
+    /// Agrega a @p out las primitivas cuya caja se solapa con @p box.
+    void queryAABB(const AABB& box, std::vector<unsigned int>& out) const;
+
+    /// Agrega a @p out las primitivas cuya caja se solapa con la esfera.
+    void querySphere(const Vector3& center, float radius, std::vector<unsigned int>& out) const;
+
+    /**
+     * @brief Caja mas cercana que intersecta el rayo.
+     * @return @c true si hubo impacto; @p hit.t es la distancia de entrada a la caja.
+     */
+    bool raycast(const Ray& ray, RayHit& hit) const;
+
+    /// Caja mas cercana para cada rayo del paquete.
+    void intersectPacket(RayPacket& packet) const;
+
+    /**
+     * @brief Recorre el arbol con un rayo, del nodo mas cercano al mas lejano.
+     * @param leaf Funcion (first, count, tMax&) que prueba las primitivas de una hoja y reduce
+     *             @p tMax si encuentra un impacto mas cercano.
+     */
+    template<class LeafFunc>
+    void traverseRay(const Ray& ray, float& tMax, LeafFunc&& leaf) const;
+
+    /**
+     * @brief Recorre el arbol con un paquete de rayos.
+     * @param leaf Funcion (first, count) que prueba las primitivas de una hoja contra el
+     *             paquete y actualiza sus tMax.
+     */
+    template<class LeafFunc>
+    void traversePacket(RayPacket& packet, LeafFunc&& leaf) const;
+
+    /// Costo SAH del arbol relativo al area de la raiz (menor es mejor).
+    float getCost() const;
+
+    /// Libera los nodos.
+    void destroy();
+
+    const std::vector<Node>& getNodes() const { return m_nodes; }
+    const std::vector<unsigned int>& getIndices() const { return m_indices; }
+    unsigned int getPrimitiveCount() const { return static_cast<unsigned int>(m_boxes.size()); }
+    unsigned int getDepth() const { return m_depth; }
+
+    /// Distancia de entrada del rayo a la caja (conservadora, ver SLAB_EXIT_SCALE) o un valor
+    /// negativo si no la intersecta.
+    static float intersectBox(const float min[3], const float max[3],
+                              const float origin[3], const float invDir[3], float tMax);
+
+    /// Inverso de cada componente de la direccion (acotado para evitar infinitos).
+    static void inverseDirection(const Vector3& direction, float invDir[3]);
+
+private:
+    /// Recalcula la caja del nodo @p nodeIndex a partir de sus hijos o primitivas.
+    void updateNodeBounds(unsigned int nodeIndex);
+
+    /// Mascara de los carriles del paquete que entran a la caja antes de su tMax.
+    static simd::FloatV intersectBoxPacket(const float min[3], const float max[3],
+                                           const simd::FloatV origin[3],
+                                           const simd::FloatV invDir[3],
+                                           simd::FloatV tMax);
+
+private:
+    std::vector<Node> m_nodes;
+    std::vector<unsigned int> m_indices;    ///< Permutacion de primitivas agrupadas por hoja.
+    std::vector<AABB> m_boxes;              ///< Caja de cada primitiva (indice original).
+    std::vector<unsigned int> m_parents;    ///< Padre de cada nodo.
+    std::vector<unsigned int> m_leafOf;     ///< Hoja de cada primitiva.
+    unsigned int m_depth = 0;
+};
+
+template<class LeafFunc>
+void
+Bvh::traverseRay(const Ray& ray, float& tMax, LeafFunc&& leaf) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+    const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+    float invDir[3];
+    inverseDirection(ray.direction, invDir);
+
+    struct Entry { unsigned int node; float t; };
+    Entry stack[STACK_SIZE];
+    unsigned int size = 0;
+
+    float tRoot = intersectBox(m_nodes[0].min, m_nodes[0].max, origin, invDir, tMax);
+    if (tRoot < 0.0f) {
+        return;
+    }
+    stack[size++] = { 0, tRoot };
+
+    while (size > 0) {
+        Entry entry = stack[--size];
+        if (entry.t > tMax) {
+            continue;
+        }
+        const Node& node = m_nodes[entry.node];
+        if (node.isLeaf()) {
+            leaf(node.leftFirst, node.count, tMax);
+            continue;
+        }
+
+        unsigned int nearChild = node.leftFirst;
+        unsigned int farChild = node.leftFirst + 1;
+        float tNear = intersectBox(m_nodes[nearChild].min, m_nodes[nearChild].max, origin, invDir, tMax);
+        float tFar = intersectBox(m_nodes[farChild].min, m_nodes[farChild].max, origin, invDir, tMax);
+        if (tFar >= 0.0f && (tNear < 0.0f || tFar < tNear)) {
+            std::swap(nearChild, farChild);
+            std::swap(tNear, tFar);
+        }
+        if (tFar >= 0.0f) {
+            stack[size++] = { farChild, tFar };
+        }
+        if (tNear >= 0.0f) {
+            stack[size++] = { nearChild, tNear };
+        }
+    }
+}
+
+template<class LeafFunc>
+void
+Bvh::traversePacket(RayPacket& packet, LeafFunc&& leaf) const {
+    using namespace simd;
+    if (m_nodes.empty()) {
+        return;
+    }
+    const FloatV origin[3] = { load(packet.originX), load(packet.originY), load(packet.originZ) };
+    const FloatV invDir[3] = { load(packet.invX), load(packet.invY), load(packet.invZ) };
+    // El primer carril decide el orden de los hijos en todo el paquete (rayos coherentes).
+    const bool negative[3] = { packet.dirX[0] < 0.0f, packet.dirY[0] < 0.0f, packet.dirZ[0] < 0.0f };
+
+    unsigned int stack[STACK_SIZE];
+    unsigned int size = 0;
+    stack[size++] = 0;
+
+    while (size > 0) {
+        const Node& node = m_nodes[stack[--size]];
+        FloatV mask = intersectBoxPacket(node.min, node.max, origin, invDir, load(packet.tMax));
+        if (movemask(mask) == 0) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            leaf(node.leftFirst, node.count);
+            continue;
+        }
+        unsigned int nearChild = node.leftFirst;
+        unsigned int farChild = node.leftFirst + 1;
+        if (negative[node.axis]) {
+            std::swap(nearChild, farChild);
+        }
+        stack[size++] = farChild;
+        stack[size++] = nearChild;
+    }
+}
+
+inline simd::FloatV
+Bvh::intersectBoxPacket(const float min[3], const float max[3],
+                        const simd::FloatV origin[3], const simd::FloatV invDir[3],
+                        simd::FloatV tMax) {
+    using namespace simd;
+    const FloatV exitScale = set1(SLAB_EXIT_SCALE);
+    FloatV tNear = zero();
+    FloatV tFar = tMax;
+    for (int a = 0; a < 3; ++a) {
+        FloatV t0 = mul(sub(set1(min[a]), origin[a]), invDir[a]);
+        FloatV t1 = mul(sub(set1(max[a]), origin[a]), invDir[a]);
+        tNear = simd::max(tNear, simd::min(t0, t1));
+        tFar = simd::min(tFar, mul(simd::max(t0, t1), exitScale));
+    }
+    return cmple(tNear, tFar);
+}
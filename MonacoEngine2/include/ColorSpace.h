@@ -0,0 +1,85 @@
+/**
+ * @file ColorSpace.h
+ * @brief Declara el espacio de color de una textura y las conversiones sRGB <-> lineal.
+ *
+ * Los mapas de color (albedo, emisivo, interfaz) se guardan en sRGB y se suben con formatos
+ * @c _SRGB: la GPU los pasa a lineal al muestrear y el render target @c _SRGB vuelve a codificar
+ * al escribir, asi que la iluminacion y el filtrado trabajan en lineal. Los mapas de datos
+ * (normales, rugosidad, mascaras, alturas) ya son lineales y usan @c UNORM sin conversion.
+ *
+ * Para el trabajo en CPU (mipmaps, compresion) hay tres variantes de cada conversion:
+ * - Exacta (powf), referencia de las demas.
+ * - Tabla de 256 entradas para codigos sRGB de 8 bits (exacta y la mas rapida para decodificar).
+ * - Aproximacion con FloatV, sin tablas ni powf: sRGB a lineal con un polinomio de grado 5
+ *   (error absoluto < 2.2e-5) y lineal a sRGB con un polinomio de grado 4 en x^(1/8) (tres
+ *   raices; error < 3e-6, menos de 1/1000 de codigo de 8 bits).
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Simd.h"
+
+/**
+ * @enum ColorSpace
+ * @brief Como interpretar los canales RGB de una textura (el alfa siempre es lineal).
+ */
+enum class ColorSpace {
+    Srgb,   ///< Color: RGB codificado en sRGB; formatos @c _SRGB.
+    Linear  ///< Datos: valores tal cual; formatos @c UNORM.
+};
+
+namespace color {
+    /// Limite de la parte lineal de la curva sRGB, en codificado y en lineal.
+    const float SRGB_THRESHOLD = 0.04045f;
+    const float LINEAR_THRESHOLD = 0.0031308f;
+
+    /// sRGB (0 a 1) a lineal, exacta.
+    inline float srgbToLinear(float c) {
+        return c <= SRGB_THRESHOLD ? c * (1.0f / 12.92f) : powf((c + 0.055f) * (1.0f / 1.055f), 2.4f);
+    }
+
+    /// Lineal (0 a 1) a sRGB, exacta.
+    inline float linearToSrgb(float l) {
+        return l <= LINEAR_THRESHOLD ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+    }
+
+    /// Valor lineal de cada codigo sRGB de 8 bits (256 entradas).
+    const float* srgb8ToLinearTable();
+
+    /// srgbToLinear() aproximada por lane; entrada en [0, 1].
+    inline simd::FloatV srgbToLinearFast(simd::FloatV c) {
+        using namespace simd;
+        FloatV curve = madd(c, set1(0.0597716610259614f), set1(-0.24114366218459965f));
+        curve = madd(curve, c, set1(0.6113569291452479f));
+        curve = madd(curve, c, set1(0.5388740390556379f));
+        curve = madd(curve, c, set1(0.03015145050375981f));
+        curve = madd(curve, c, set1(0.001010673058535378f));
+        const FloatV ramp = mul(c, set1(1.0f / 12.92f));
+        return select(cmple(c, set1(SRGB_THRESHOLD)), ramp, curve);
+    }
+
+    /// linearToSrgb() aproximada por lane; entrada en [0, 1].
+    inline simd::FloatV linearToSrgbFast(simd::FloatV l) {
+        using namespace simd;
+        const FloatV t = sqrt(sqrt(sqrt(l)));
+        FloatV curve = madd(t, set1(0.18669363612714715f), set1(1.0939189889368164f));
+        curve = madd(curve, t, set1(-0.29579556531310175f));
+        curve = madd(curve, t, set1(0.07995035184387657f));
+        curve = madd(curve, t, set1(-0.06476500596432243f));
+        const FloatV ramp = mul(l, set1(12.92f));
+        return select(cmple(l, set1(LINEAR_THRESHOLD)), ramp, curve);
+    }
+
+    /// Codigos sRGB de 8 bits a lineal, con la tabla.
+    void srgb8ToLinear(const unsigned char* src, float* dst, size_t count);
+
+    /// Lineal a codigos sRGB de 8 bits (redondeo al mas cercano), con linearToSrgbFast(); satura a [0, 1].
+    void linearToSrgb8(const float* src, unsigned char* dst, size_t count);
+
+    /// Pixeles RGBA8 a RGBA lineal en float: RGB segun @p space, alfa / 255.
+    void decodeRgba8(const unsigned char* src, float* dst, size_t pixels, ColorSpace space);
+
+    /// RGBA lineal en float a RGBA8: RGB segun @p space, alfa * 255; satura a [0, 1].
+    void encodeRgba8(const float* src, unsigned char* dst, size_t pixels, ColorSpace space);
+}
@@ -0,0 +1,141 @@
+/**
+ * @file CorePrerequisites.h
+ * @brief Inclusiones y definiciones comunes del nucleo portable del motor.
+ *
+ * El nucleo (mallas, imagenes, matematica, trabajos, perfilado, culling, ECS) no depende de
+ * Direct3D ni de xnamath y compila con MSVC, GCC y Clang (objetivo MonacoCore de
+ * CMakeLists.txt). Prerequisites.h incluye este archivo y agrega lo propio de Direct3D.
+ *
+ * Fuera de Windows se definen HRESULT y sus codigos para que el nucleo mantenga el mismo
+ * manejo de errores en todas las plataformas, y los mensajes de depuracion van a stderr.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+
+// ============================================================================
+// Librerias estandar
+// ============================================================================
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <fstream> // Lectura de archivos (.obj, etc.)
+#include <map>     // Mapa para evitar duplicar vertices
+#include <cstdint>
+#include <cstdio>
+
+// ============================================================================
+// Plataforma
+// ============================================================================
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX   // Evita que windows.h defina min/max como macros (choca con std::min/std::max).
+#endif
+#include <windows.h>
+#else
+typedef int32_t HRESULT;
+
+#define S_OK            ((HRESULT)0)
+#define S_FALSE         ((HRESULT)1)
+#define E_NOTIMPL       ((HRESULT)0x80004001)
+#define E_POINTER       ((HRESULT)0x80004003)
+#define E_ABORT         ((HRESULT)0x80004004)
+#define E_FAIL          ((HRESULT)0x80004005)
+#define E_PENDING       ((HRESULT)0x8000000A)
+#define E_OUTOFMEMORY   ((HRESULT)0x8007000E)
+#define E_INVALIDARG    ((HRESULT)0x80070057)
+#define SUCCEEDED(hr)   (((HRESULT)(hr)) >= 0)
+#define FAILED(hr)      (((HRESULT)(hr)) < 0)
+
+/** Equivalente de OutputDebugStringW: escribe el texto en stderr como UTF-8. */
+inline void
+OutputDebugStringW(const wchar_t* text) {
+    std::string utf8;
+    for (; *text; ++text) {
+        const uint32_t c = static_cast<uint32_t>(*text);
+        if (c < 0x80) {
+            utf8 += static_cast<char>(c);
+        }
+        else if (c < 0x800) {
+            utf8 += static_cast<char>(0xC0 | (c >> 6));
+            utf8 += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else {
+            utf8 += static_cast<char>(0xE0 | ((c >> 12) & 0x0F));
+            utf8 += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    std::fputs(utf8.c_str(), stderr);
+}
+#endif
+
+// ============================================================================
+// Matematica del motor (portable, sin dependencia de xnamath)
+// ============================================================================
+#include "Math/Vector.h"
+#include "Math/Quaternion.h"
+#include "Math/Matrix.h"
+
+// ============================================================================
+// Macros de utilidad
+// ============================================================================
+
+/** Muestra mensaje de creacion de recurso en la consola de depuracion. */
+#define MESSAGE(classObj, method, state)    \
+{                                           \
+   std::wostringstream os_;                 \
+   os_ << classObj << "::" << method        \
+       << " : " << "[CREATION OF RESOURCE : " << state << "]\n"; \
+   OutputDebugStringW(os_.str().c_str());   \
+}
+
+/** Muestra un mensaje de error formateado en la consola de depuracion. */
+#define ERROR(classObj, method, errorMSG)                     \
+{                                                             \
+    try {                                                     \
+        std::wostringstream os_;                              \
+        os_ << L"ERROR : " << classObj << L"::" << method     \
+            << L" : " << errorMSG << L"\n";                   \
+        OutputDebugStringW(os_.str().c_str());                \
+    } catch (...) {                                           \
+        OutputDebugStringW(L"Failed to log error message.\n");\
+    }                                                         \
+}
+
+// ============================================================================
+// Estructuras base
+// ============================================================================
+
+/** Vertice simple con posicion, textura y normal. */
+struct SimpleVertex {
+    Vector3 Pos;
+    Vector2 Tex;
+    Vector3 Norm;
+};
+
+/** Caja alineada a los ejes (AABB) definida por sus esquinas minima y maxima. */
+struct AABB {
+    Vector3 min;
+    Vector3 max;
+};
+
+/** Esfera envolvente definida por su centro y radio. */
+struct BoundingSphere {
+    Vector3 center;
+    float   radius;
+};
+
+// ============================================================================
+// Enumeraciones
+// ============================================================================
+
+/** Tipos de extension soportados. */
+enum ExtensionType {
+    DDS = 0,
+    PNG = 1,
+    JPG = 2,
+    HDR = 3
+};
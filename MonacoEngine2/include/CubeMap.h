@@ -0,0 +1,95 @@
+/**
+ * @file CubeMap.h
+ * @brief Declara la clase CubeMap, un cubemap HDR en CPU (seis caras RGBA float).
+ *
+ * Las caras siguen el orden y la orientacion de Direct3D: +X, -X, +Y, -Y, +Z, -Z, con (u, v)
+ * de la esquina superior izquierda de cada cara. Un cubemap sale de seis imagenes cuadradas o
+ * de un panorama equirectangular (longitud en x, latitud en y, el centro mirando hacia -Z),
+ * y se sube como @c TEXTURECUBE con Texture::init(Device&, const std::vector<CubeMap>&, DdsFormat)
+ * o se cocina con DdsFile::saveToFile(). EnvironmentPrefilter lo convoluciona para IBL.
+ *
+ * El muestreo es bilineal dentro de cada cara y satura en el borde: no filtra entre caras
+ * vecinas, lo que basta para el prefiltrado (los mips de origen suavizan la costura).
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "HdrImage.h"
+
+class JobSystem;
+
+/**
+ * @class CubeMap
+ * @brief Seis caras cuadradas del mismo tamano, en m_faces[0..5].
+ */
+class CubeMap {
+public:
+    /// Caras de un cubemap.
+    static const unsigned int FACE_COUNT = 6;
+
+    CubeMap() = default;
+    ~CubeMap() = default;
+
+    CubeMap(const CubeMap&) = default;
+    CubeMap& operator=(const CubeMap&) = default;
+    CubeMap(CubeMap&&) = default;
+    CubeMap& operator=(CubeMap&&) = default;
+
+    /**
+     * @brief Reserva seis caras de @p size x @p size en negro.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si @p size es 0.
+     */
+    HRESULT init(unsigned int size);
+
+    /**
+     * @brief Toma seis caras ya cargadas (+X, -X, +Y, -Y, +Z, -Z).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si no son seis imagenes cuadradas del mismo tamano.
+     */
+    HRESULT initFromFaces(std::vector<HdrImage>&& faces);
+
+    /**
+     * @brief Carga seis archivos de imagen (ver HdrImage::loadFromFile()) en el orden de las caras.
+     * @return @c S_OK si fue exitoso; @c E_FAIL si un archivo no se pudo leer.
+     */
+    HRESULT loadFaces(const std::vector<std::string>& fileNames);
+
+    /**
+     * @brief Proyecta un panorama equirectangular sobre las seis caras (bilineal, x periodico).
+     * @param size Lado de cada cara; ancho / 4 conserva la resolucion del panorama.
+     * @param jobs Pool para repartir las filas (opcional).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si el panorama esta vacio o @p size es 0.
+     */
+    HRESULT initFromEquirect(const HdrImage& panorama, unsigned int size, JobSystem* jobs = nullptr);
+
+    /// Igual que initFromEquirect() cargando el panorama de @p fileName (.hdr normalmente).
+    HRESULT loadEquirect(const std::string& fileName, unsigned int size, JobSystem* jobs = nullptr);
+
+    /**
+     * @brief Genera los mips de @p base por caras (promedio de 2x2) hasta 1x1.
+     * @param maxLevels Limite de niveles (0 = todos).
+     */
+    static HRESULT generateMips(CubeMap&& base, std::vector<CubeMap>& levels, unsigned int maxLevels = 0);
+
+    /// Color RGB bilineal en la direccion @p dir (no necesita estar normalizada).
+    void sample(const float* dir, float* rgb) const;
+
+    /// Direccion (sin normalizar) del punto (@p u, @p v) en [-1, 1] de la cara @p face.
+    static void faceDirection(unsigned int face, float u, float v, float* dir);
+
+    /// Cara y coordenadas (@p u, @p v) en [-1, 1] de la direccion @p dir.
+    static void directionToFace(const float* dir, unsigned int& face, float& u, float& v);
+
+    /// Angulo solido del texel (@p x, @p y) de una cara de @p size (igual en las seis caras).
+    static float texelSolidAngle(unsigned int x, unsigned int y, unsigned int size);
+
+    /// Libera las caras.
+    void destroy();
+
+    /// @c true si no hay caras.
+    bool empty() const { return m_faces.empty(); }
+
+public:
+    unsigned int m_size = 0;            ///< Lado de cada cara en texeles.
+    std::vector<HdrImage> m_faces;      ///< +X, -X, +Y, -Y, +Z, -Z.
+};
@@ -0,0 +1,231 @@
+/**
+ * @file DdsFile.h
+ * @brief Declara la clase DdsFile, lectura y escritura de archivos DDS sin D3DX.
+ *
+ * loadFromFile() proyecta el archivo en memoria (MappedFile), interpreta la cabecera y calcula
+ * la posicion de cada subrecurso dentro de la proyeccion; Texture::init() pasa esos punteros
+ * tal cual en los @c D3D11_SUBRESOURCE_DATA, sin copiar los niveles a un buffer intermedio.
+ *
+ * Lee cabeceras clasicas (FourCC DXT1-5, ATI1/ATI2, BC4/BC5, codigos D3DFMT de punto flotante y
+ * las mascaras RGB de 8, 16 y 32 bits mas comunes) y la extension DX10 (cualquier formato de
+ * la tabla DdsFormat, arreglos y arreglos de cubemaps). Las texturas de volumen se interpretan
+ * pero Texture todavia no las crea. saveToFile() escribe siempre la extension DX10.
+ *
+ * No depende de Direct3D: el formato se guarda con el mismo valor numerico de DXGI_FORMAT.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "MappedFile.h"
+#include "BlockCompression.h"
+#include "MipChain.h"
+#include "ColorSpace.h"
+#include <limits>
+
+class HdrImage;
+class CubeMap;
+
+/**
+ * @enum DdsFormat
+ * @brief Formatos de DXGI que entiende DdsFile; cada valor coincide con su @c DXGI_FORMAT.
+ */
+enum class DdsFormat : uint32_t {
+    Unknown = 0,
+    R32G32B32A32_FLOAT = 2,
+    R32G32B32_FLOAT = 6,
+    R16G16B16A16_FLOAT = 10,
+    R16G16B16A16_UNORM = 11,
+    R32G32_FLOAT = 16,
+    R10G10B10A2_UNORM = 24,
+    R11G11B10_FLOAT = 26,
+    R8G8B8A8_UNORM = 28,
+    R8G8B8A8_UNORM_SRGB = 29,
+    R16G16_FLOAT = 34,
+    R16G16_UNORM = 35,
+    R32_FLOAT = 41,
+    R8G8_UNORM = 49,
+    R16_FLOAT = 54,
+    R16_UNORM = 56,
+    R8_UNORM = 61,
+    A8_UNORM = 65,
+    BC1_UNORM = 71,
+    BC1_UNORM_SRGB = 72,
+    BC2_UNORM = 74,
+    BC2_UNORM_SRGB = 75,
+    BC3_UNORM = 77,
+    BC3_UNORM_SRGB = 78,
+    BC4_UNORM = 80,
+    BC4_SNORM = 81,
+    BC5_UNORM = 83,
+    BC5_SNORM = 84,
+    B5G6R5_UNORM = 85,
+    B5G5R5A1_UNORM = 86,
+    B8G8R8A8_UNORM = 87,
+    B8G8R8X8_UNORM = 88,
+    B8G8R8A8_UNORM_SRGB = 91,
+    B8G8R8X8_UNORM_SRGB = 93,
+    BC6H_UF16 = 95,
+    BC6H_SF16 = 96,
+    BC7_UNORM = 98,
+    BC7_UNORM_SRGB = 99
+};
+
+/**
+ * @struct DdsDesc
+ * @brief Forma de una textura DDS.
+ */
+struct DdsDesc {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int depth = 1;         ///< Mayor que 1 solo en texturas de volumen.
+    unsigned int mipLevels = 1;
+    unsigned int arraySize = 1;     ///< Elementos del arreglo; en cubemaps, numero de cubos.
+    bool cubemap = false;           ///< Cada elemento tiene 6 caras (+X, -X, +Y, -Y, +Z, -Z).
+    DdsFormat format = DdsFormat::Unknown;
+
+    /// Imagenes 2D del arreglo (arraySize, o arraySize * 6 en cubemaps): ArraySize de D3D11.
+    unsigned int getItemCount() const { return arraySize * (cubemap ? 6u : 1u); }
+
+    /// Subrecursos totales (mip + elemento * mipLevels, como D3D11CalcSubresource).
+    unsigned int getSubresourceCount() const { return getItemCount() * mipLevels; }
+};
+
+/**
+ * @struct DdsSurface
+ * @brief Posicion y tamano de un subrecurso dentro del archivo.
+ */
+struct DdsSurface {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int depth = 1;
+    unsigned int rowPitch = 0;      ///< Bytes por fila (de bloques de 4x4 en formatos BC).
+    unsigned int rowCount = 0;      ///< Filas (de bloques) por corte.
+    size_t offset = 0;              ///< Desde el inicio del archivo.
+    size_t size = 0;                ///< rowPitch * rowCount * depth.
+
+    /// Bytes por corte de volumen (SysMemSlicePitch).
+    unsigned int getSlicePitch() const { return rowPitch * rowCount; }
+};
+
+/**
+ * @struct DdsSubresourceData
+ * @brief Datos de un subrecurso para saveToFile(); las filas pueden tener relleno.
+ */
+struct DdsSubresourceData {
+    const void* data = nullptr;
+    unsigned int rowPitch = 0;      ///< Bytes entre filas en @c data (0 = sin relleno).
+};
+
+/**
+ * @class DdsFile
+ * @brief Textura DDS proyectada en memoria, con la posicion de cada subrecurso.
+ */
+class DdsFile {
+public:
+    DdsFile() = default;
+    ~DdsFile() = default;
+
+    DdsFile(const DdsFile&) = delete;
+    DdsFile& operator=(const DdsFile&) = delete;
+
+    /**
+     * @brief Proyecta @p fileName e interpreta su cabecera.
+     * @return @c S_OK si fue exitoso; @c E_FAIL si no se pudo leer o la cabecera no es valida;
+     *         @c E_NOTIMPL si el formato no esta en DdsFormat.
+     */
+    HRESULT loadFromFile(const std::string& fileName);
+
+    /**
+     * @brief Interpreta un DDS que ya esta en memoria, sin copiarlo.
+     * @param data Archivo completo; debe seguir vivo mientras se use getData().
+     */
+    HRESULT loadFromMemory(const unsigned char* data, size_t size);
+
+    /// Libera la proyeccion y la descripcion.
+    void destroy();
+
+    /// Forma de la textura.
+    const DdsDesc& getDesc() const { return m_desc; }
+
+    /// Subrecurso @p index (mip + elemento * mipLevels).
+    const DdsSurface& getSurface(unsigned int index) const { return m_surfaces[index]; }
+
+    /// Primer byte del subrecurso @p index dentro del archivo.
+    const unsigned char* getData(unsigned int index) const { return m_data + m_surfaces[index].offset; }
+
+    /// Archivo completo (cabecera incluida), p. ej. para calcular su hash de contenido.
+    const unsigned char* getFileData() const { return m_data; }
+
+    /// Bytes del archivo completo.
+    size_t getFileSize() const { return m_size; }
+
+    /// @c true si no hay archivo cargado.
+    bool empty() const { return m_surfaces.empty(); }
+
+    /**
+     * @brief Escribe una textura con la extension DX10.
+     * @param surfaces Un subrecurso por cada getSubresourceCount(), en orden de D3D11.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si la descripcion no es valida o faltan
+     *         subrecursos; @c E_FAIL si no se pudo escribir.
+     */
+    static HRESULT saveToFile(const std::string& fileName, const DdsDesc& desc,
+                              const std::vector<DdsSubresourceData>& surfaces);
+
+    /// Escribe los niveles comprimidos de BlockImage::encodeMips() (salida cocinada).
+    static HRESULT saveToFile(const std::string& fileName, const std::vector<BlockImage>& levels, bool srgb = false);
+
+    /// Escribe una cadena de mipmaps RGBA8.
+    static HRESULT saveToFile(const std::string& fileName, const MipChain& mips, bool srgb = false);
+
+    /**
+     * @brief Escribe niveles HDR empaquetados con HdrImage::pack() en @p format.
+     * @return @c E_INVALIDARG si no hay niveles o @p format no es un formato de HdrImage::pack().
+     */
+    static HRESULT saveToFile(const std::string& fileName, const std::vector<HdrImage>& levels,
+                              DdsFormat format = DdsFormat::R16G16B16A16_FLOAT);
+
+    /// Escribe un cubemap con mips (p. ej. EnvironmentPrefilter::prefilterSpecular()) en @p format.
+    static HRESULT saveToFile(const std::string& fileName, const std::vector<CubeMap>& levels,
+                              DdsFormat format = DdsFormat::R16G16B16A16_FLOAT);
+
+    /**
+     * @brief Calcula la posicion de cada subrecurso a partir de @p dataOffset.
+     * @param totalSize Recibe el fin del ultimo subrecurso.
+     * @param maxSize   Fin maximo aceptado (al leer, el tamano del archivo); se comprueba antes
+     *                  de reservar @p surfaces.
+     * @return @c E_INVALIDARG si la descripcion no es valida o excede los limites de D3D11
+     *         (16384 texels por lado, 2048 en volumenes y elementos de arreglo);
+     *         @c E_NOTIMPL si el formato no se conoce; @c E_FAIL si el fin pasa de @p maxSize.
+     */
+    static HRESULT computeLayout(const DdsDesc& desc, size_t dataOffset, std::vector<DdsSurface>& surfaces,
+                                 size_t& totalSize, size_t maxSize = std::numeric_limits<size_t>::max());
+
+    /**
+     * @brief Tamano de un elemento de @p format.
+     * @param bytes      Recibe bytes por pixel o, si @p compressed, por bloque de 4x4.
+     * @param compressed Recibe @c true para formatos BC.
+     * @return @c false si el formato no se conoce.
+     */
+    static bool getFormatInfo(DdsFormat format, unsigned int& bytes, bool& compressed);
+
+    /// Formato DXGI de @p format, en su variante sRGB si @p srgb y existe (BC1/BC3/BC7).
+    static DdsFormat toDdsFormat(BlockFormat format, bool srgb = false);
+
+    /**
+     * @brief Variante de @p format para @p space: la @c _SRGB para color y la @c UNORM para datos.
+     *
+     * Los formatos sin pareja (BC4, BC5, flotantes, 16 bits...) se devuelven igual.
+     */
+    static DdsFormat withColorSpace(DdsFormat format, ColorSpace space);
+
+    /// @c true si @p format es una variante @c _SRGB.
+    static bool isSrgb(DdsFormat format);
+
+private:
+    MappedFile m_file;
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+    DdsDesc m_desc;
+    std::vector<DdsSurface> m_surfaces;
+};
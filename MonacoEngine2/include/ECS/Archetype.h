@@ -0,0 +1,181 @@
+/**
+ * @file Archetype.h
+ * @brief Declara el registro de tipos de componente y la clase Archetype, almacenamiento por bloques.
+ *
+ * Un arquetipo agrupa a todas las entidades con el mismo conjunto de componentes. Sus datos
+ * viven en bloques (chunks) de 16 KB; dentro de cada bloque cada tipo de componente ocupa un
+ * arreglo contiguo (SoA), de modo que un sistema que lee dos componentes recorre dos arreglos
+ * densos sin punteros intermedios y cada bloque es una unidad de trabajo independiente para
+ * repartir entre hilos.
+ *
+ * Las filas de un arquetipo estan siempre compactas: todos los bloques estan llenos salvo el
+ * ultimo, y eliminar una fila mueve la ultima a su lugar.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "ECS/Entity.h"
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+
+/// Maximo de tipos de componente distintos (un bit de ComponentMask por tipo).
+const unsigned int MAX_COMPONENT_TYPES = 64;
+
+/// Conjunto de tipos de componente: el bit i indica el tipo con id i.
+typedef unsigned long long ComponentMask;
+
+/**
+ * @struct ComponentInfo
+ * @brief Operaciones de un tipo de componente sin conocer el tipo en tiempo de compilacion.
+ */
+struct ComponentInfo {
+    const char* name = "";                          ///< Nombre del tipo (diagnostico).
+    unsigned int size = 0;                          ///< sizeof del tipo.
+    unsigned int alignment = 0;                     ///< alignof del tipo.
+    bool trivial = false;                           ///< Se puede mover con memcpy y no necesita destructor.
+    void (*moveConstruct)(void* dst, void* src) = nullptr;
+    void (*destruct)(void* object) = nullptr;
+};
+
+/**
+ * @class ComponentRegistry
+ * @brief Asigna un id consecutivo a cada tipo de componente la primera vez que se usa.
+ */
+class ComponentRegistry {
+public:
+    /// Id del tipo @p T (lo registra en la primera llamada).
+    template<class T>
+    static unsigned int getId() {
+        static const unsigned int id = registerType(makeInfo<T>());
+        return id;
+    }
+
+    /// Bit del tipo @p T en ComponentMask.
+    template<class T>
+    static ComponentMask getMask() { return ComponentMask(1) << getId<T>(); }
+
+    /// Operaciones del tipo con id @p id.
+    static const ComponentInfo& getInfo(unsigned int id);
+
+    /// Numero de tipos registrados.
+    static unsigned int getTypeCount();
+
+private:
+    /// Registra un tipo y devuelve su id.
+    static unsigned int registerType(const ComponentInfo& info);
+
+    template<class T>
+    static ComponentInfo makeInfo() {
+        static_assert(std::is_move_constructible<T>::value, "Components must be move constructible");
+        ComponentInfo info;
+        info.name = typeid(T).name();
+        info.size = static_cast<unsigned int>(sizeof(T));
+        info.alignment = static_cast<unsigned int>(alignof(T));
+        info.trivial = std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value;
+        info.moveConstruct = [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); };
+        info.destruct = [](void* object) { static_cast<T*>(object)->~T(); };
+        return info;
+    }
+};
+
+/**
+ * @class Archetype
+ * @brief Entidades con el mismo conjunto de componentes, guardadas en bloques SoA de 16 KB.
+ *
+ * Cada bloque contiene primero el arreglo de Entity y despues un arreglo por tipo de
+ * componente, cada uno alineado a 16 bytes para cargas SIMD. Las filas se numeran de forma
+ * global: la fila r esta en el bloque r / capacidad, posicion r % capacidad.
+ */
+class Archetype {
+public:
+    /// Tamano de un bloque (mayor solo si un componente no cabe).
+    static const unsigned int CHUNK_SIZE = 16 * 1024;
+
+    /// Alineacion del inicio de cada bloque (linea de cache).
+    static const unsigned int CHUNK_ALIGNMENT = 64;
+
+    /// Indice de tipo que no pertenece al arquetipo.
+    static const unsigned int INVALID_SLOT = 0xffffffffu;
+
+    /// Crea el arquetipo de los tipos de @p mask y calcula la distribucion de sus bloques.
+    explicit Archetype(ComponentMask mask);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    /**
+     * @brief Agrega una fila al final.
+     *
+     * Los componentes de la fila quedan sin construir: el llamador debe construir cada uno
+     * (placement new) antes de cualquier otra operacion sobre el arquetipo.
+     * @return Indice de la fila.
+     */
+    unsigned int pushRow(Entity entity);
+
+    /**
+     * @brief Destruye los componentes de una fila y mueve la ultima a su lugar.
+     * @return Entidad que ahora ocupa @p row, o una invalida si @p row era la ultima.
+     */
+    Entity removeRow(unsigned int row);
+
+    /// Destruye todas las filas y libera los bloques.
+    void clear();
+
+    /// Posicion del tipo @p typeId dentro del arquetipo, o INVALID_SLOT.
+    unsigned int getSlot(unsigned int typeId) const { return m_slotOfType[typeId]; }
+
+    /// Componente @p slot de la fila @p row.
+    void* getComponent(unsigned int slot, unsigned int row) {
+        return m_chunks[row / m_capacity] + m_offsets[slot] + (row % m_capacity) * m_sizes[slot];
+    }
+
+    /// Entidad de la fila @p row.
+    Entity& getEntity(unsigned int row) {
+        return reinterpret_cast<Entity*>(m_chunks[row / m_capacity])[row % m_capacity];
+    }
+
+    /// Arreglo del componente @p slot en el bloque @p chunk.
+    void* getChunkArray(unsigned int chunk, unsigned int slot) { return m_chunks[chunk] + m_offsets[slot]; }
+
+    /// Arreglo de entidades del bloque @p chunk.
+    const Entity* getChunkEntities(unsigned int chunk) const {
+        return reinterpret_cast<const Entity*>(m_chunks[chunk]);
+    }
+
+    /// Filas ocupadas del bloque @p chunk.
+    unsigned int getChunkRowCount(unsigned int chunk) const {
+        unsigned int begin = chunk * m_capacity;
+        return m_rowCount - begin < m_capacity ? m_rowCount - begin : m_capacity;
+    }
+
+    /// Bloques con al menos una fila.
+    unsigned int getChunkCount() const { return (m_rowCount + m_capacity - 1) / m_capacity; }
+
+    ComponentMask getMask() const { return m_mask; }
+    const std::vector<unsigned int>& getTypes() const { return m_types; }
+    unsigned int getRowCount() const { return m_rowCount; }
+    unsigned int getCapacity() const { return m_capacity; }
+
+private:
+    /// Calcula m_offsets para @p capacity filas y devuelve los bytes del bloque.
+    unsigned int computeLayout(unsigned int capacity);
+
+    /// Destruye los componentes de la fila @p row.
+    void destructRow(unsigned int row);
+
+    ComponentMask m_mask = 0;
+    std::vector<unsigned int> m_types;              ///< Ids de tipo, ordenados.
+    std::vector<unsigned int> m_sizes;              ///< sizeof de cada tipo.
+    std::vector<unsigned int> m_offsets;            ///< Inicio del arreglo de cada tipo en el bloque.
+    std::vector<ComponentInfo> m_infos;             ///< Operaciones de cada tipo.
+    unsigned int m_slotOfType[MAX_COMPONENT_TYPES]; ///< Id de tipo -> posicion en m_types.
+    unsigned int m_capacity = 0;                    ///< Filas por bloque.
+    unsigned int m_chunkBytes = 0;                  ///< Bytes por bloque.
+    unsigned int m_rowCount = 0;                    ///< Filas ocupadas.
+    bool m_trivial = true;                          ///< Todos los tipos son triviales.
+    std::vector<unsigned char*> m_chunks;           ///< Bloques reservados.
+};
@@ -0,0 +1,58 @@
+/**
+ * @file Component.h
+ * @brief Declara la clase base Component para componentes con comportamiento propio.
+ *
+ * El almacenamiento del ECS (Archetype, World) acepta cualquier tipo movible; esta base solo
+ * la usan los componentes que necesitan init/update/render/destroy, como MeshComponent. Los
+ * componentes de datos que los sistemas recorren por bloques (TransformComponent) no derivan
+ * de ella para no cargar un puntero a vtable por entidad.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+
+class DeviceContext;
+
+/**
+ * @enum ComponentType
+ * @brief Tipo de un componente derivado de Component.
+ */
+enum class ComponentType {
+    NONE = 0,       ///< Sin tipo.
+    TRANSFORM,      ///< Posicion, rotacion y escala.
+    MESH,           ///< Geometria.
+    NUM_TYPES       ///< Total de tipos.
+};
+
+/**
+ * @class Component
+ * @brief Base de los componentes con ciclo de vida propio.
+ */
+class Component {
+public:
+    Component() = default;
+
+    /// Construye un componente del tipo indicado.
+    explicit Component(ComponentType type) : m_type(type) {}
+
+    virtual ~Component() = default;
+
+    /// Inicializa el componente.
+    virtual void init() = 0;
+
+    /// Actualiza el componente.
+    virtual void update(float deltaTime) = 0;
+
+    /// Dibuja el componente.
+    virtual void render(DeviceContext& deviceContext) = 0;
+
+    /// Libera los recursos del componente.
+    virtual void destroy() = 0;
+
+    /// Tipo del componente.
+    ComponentType getType() const { return m_type; }
+
+protected:
+    ComponentType m_type = ComponentType::NONE;   ///< Tipo del componente.
+};
@@ -0,0 +1,31 @@
+/**
+ * @file Entity.h
+ * @brief Declara Entity, identificador de una entidad del ECS.
+ *
+ * Una entidad no tiene datos propios: es un indice en la tabla de registros de World mas una
+ * generacion. Al destruir una entidad su indice se recicla con la generacion incrementada, de
+ * modo que los handles viejos dejan de ser validos en lugar de apuntar a otra entidad.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+
+/**
+ * @struct Entity
+ * @brief Handle de una entidad (indice + generacion).
+ */
+struct Entity {
+    /// Indice invalido.
+    static const unsigned int INVALID_INDEX = 0xffffffffu;
+
+    unsigned int index = INVALID_INDEX;     ///< Posicion en la tabla de registros de World.
+    unsigned int generation = 0;            ///< Version del indice.
+
+    /// @c true si el handle fue creado por World (puede haber sido destruido despues).
+    bool isValid() const { return index != INVALID_INDEX; }
+
+    bool operator==(const Entity& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
@@ -0,0 +1,28 @@
+/**
+ * @file System.h
+ * @brief Declara la clase base System, logica que World ejecuta cada frame.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+
+class World;
+
+/**
+ * @class System
+ * @brief Procesa las entidades que tienen cierto conjunto de componentes.
+ *
+ * Los sistemas se ejecutan en el orden en que se agregaron a World. Cada sistema reparte su
+ * trabajo entre hilos por bloques (World::parallelForEachChunk); durante update() no debe
+ * crear ni destruir entidades ni agregar o quitar componentes.
+ */
+class System {
+public:
+    virtual ~System() = default;
+
+    /// Nombre del sistema (muestra del Profiler).
+    virtual const char* getName() const = 0;
+
+    /// Ejecuta el sistema sobre las entidades de @p world.
+    virtual void update(World& world, float deltaTime) = 0;
+};
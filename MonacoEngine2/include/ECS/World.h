@@ -0,0 +1,274 @@
+/**
+ * @file World.h
+ * @brief Declara la clase World, contenedor de entidades, arquetipos y sistemas del ECS.
+ *
+ * World asigna handles de entidad, mueve cada entidad al arquetipo que corresponde a sus
+ * componentes y ofrece iteracion por bloques, en serie o repartida entre los hilos de
+ * JobSystem. Agregar o quitar un componente mueve la entidad de arquetipo (copia de sus
+ * componentes); consultar y modificar componentes existentes es acceso directo.
+ *
+ * Los punteros devueltos por getComponent() son validos hasta el siguiente cambio
+ * estructural (crear o destruir entidades, agregar o quitar componentes).
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "ECS/Archetype.h"
+#include "ECS/Entity.h"
+#include "ECS/System.h"
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+class JobSystem;
+
+/**
+ * @class World
+ * @brief Entidades con sus componentes y los sistemas que las procesan.
+ */
+class World {
+public:
+    World() = default;
+    ~World() { destroy(); }
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    /**
+     * @brief Inicializa un mundo vacio.
+     * @param jobs Pool para la iteracion en paralelo; sin el, todo corre en el hilo que llama.
+     */
+    HRESULT init(JobSystem* jobs = nullptr);
+
+    /// Destruye todas las entidades y sistemas.
+    void destroy();
+
+    /// Crea una entidad sin componentes.
+    Entity createEntity();
+
+    /// Crea una entidad directamente en el arquetipo de sus componentes (sin movimientos intermedios).
+    template<class... Ts>
+    Entity createEntity(Ts... components);
+
+    /// Destruye una entidad y sus componentes. Ignora handles que ya no estan vivos.
+    void destroyEntity(Entity entity);
+
+    /// @c true si @p entity no ha sido destruida.
+    bool isAlive(Entity entity) const {
+        return entity.index < m_records.size()
+            && m_records[entity.index].generation == entity.generation
+            && m_records[entity.index].archetype != nullptr;
+    }
+
+    /// Agrega (o reemplaza) el componente @p T de una entidad viva.
+    template<class T>
+    T& addComponent(Entity entity, T component);
+
+    /// Quita el componente @p T de una entidad (no hace nada si no lo tiene).
+    template<class T>
+    void removeComponent(Entity entity);
+
+    /// Componente @p T de una entidad, o @c nullptr si no lo tiene o no esta viva.
+    template<class T>
+    T* getComponent(Entity entity);
+
+    /// @c true si la entidad esta viva y tiene el componente @p T.
+    template<class T>
+    bool hasComponent(Entity entity) const;
+
+    /**
+     * @brief Recorre en serie los bloques de las entidades que tienen todos los @p Ts.
+     * @param func func(count, entities, Ts*... arreglos) por bloque.
+     */
+    template<class... Ts, class Func>
+    void forEachChunk(Func&& func);
+
+    /// Como forEachChunk() pero repartiendo los bloques entre los hilos del JobSystem.
+    template<class... Ts, class Func>
+    void parallelForEachChunk(Func&& func);
+
+    /// Llama a func(entity, Ts&...) por cada entidad que tiene todos los @p Ts.
+    template<class... Ts, class Func>
+    void forEach(Func&& func);
+
+    /// Como forEach() pero repartiendo los bloques entre los hilos del JobSystem.
+    template<class... Ts, class Func>
+    void parallelForEach(Func&& func);
+
+    /// Agrega un sistema al final del orden de ejecucion.
+    void addSystem(std::unique_ptr<System> system);
+
+    /// Ejecuta todos los sistemas en orden.
+    void update(float deltaTime);
+
+    /// Entidades vivas.
+    unsigned int getEntityCount() const { return m_entityCount; }
+
+    /// Arquetipos creados.
+    unsigned int getArchetypeCount() const { return static_cast<unsigned int>(m_archetypes.size()); }
+
+private:
+    struct EntityRecord {
+        Archetype* archetype = nullptr;     ///< @c nullptr si el indice esta libre.
+        unsigned int row = 0;               ///< Fila dentro del arquetipo.
+        unsigned int generation = 0;        ///< Generacion vigente del indice.
+    };
+
+    /// Bloque de un arquetipo, unidad de trabajo de la iteracion en paralelo.
+    struct ChunkRef {
+        Archetype* archetype;
+        unsigned int chunk;
+    };
+
+    /// Arquetipo de @p mask (lo crea si no existe).
+    Archetype* findOrCreateArchetype(ComponentMask mask);
+
+    /// Reserva un indice de entidad y devuelve su handle.
+    Entity allocateEntity();
+
+    /// Mueve una entidad al arquetipo de @p mask conservando los componentes comunes.
+    void moveEntity(Entity entity, ComponentMask mask);
+
+    /// Actualiza el registro de la entidad que removeRow() movio a @p row.
+    void fixMovedRow(Entity moved, unsigned int row);
+
+    /// Bloques de los arquetipos que contienen todos los tipos de @p mask.
+    void collectChunks(ComponentMask mask, std::vector<ChunkRef>& chunks);
+
+    /// Llama a func con los arreglos de @p Ts del bloque.
+    template<class... Ts, class Func>
+    static void visitChunk(Archetype& archetype, unsigned int chunk, Func& func);
+
+    /// Mascara de los tipos @p Ts.
+    template<class... Ts>
+    static ComponentMask maskOf() {
+        return (ComponentMask(0) | ... | ComponentRegistry::getMask<typename std::remove_const<Ts>::type>());
+    }
+
+    /// Bloques repartidos en paralelo (ver parallelForEachChunk()).
+    void parallelForChunks(const std::vector<ChunkRef>& chunks,
+                           const std::function<void(const ChunkRef&)>& func);
+
+private:
+    JobSystem* m_jobs = nullptr;
+    std::vector<EntityRecord> m_records;
+    std::vector<unsigned int> m_freeIndices;
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::unordered_map<ComponentMask, Archetype*> m_archetypeMap;
+    std::vector<std::unique_ptr<System>> m_systems;
+    unsigned int m_entityCount = 0;
+};
+
+template<class... Ts>
+Entity
+World::createEntity(Ts... components) {
+    Archetype* archetype = findOrCreateArchetype(maskOf<Ts...>());
+    Entity entity = allocateEntity();
+    unsigned int row = archetype->pushRow(entity);
+    (new (archetype->getComponent(archetype->getSlot(ComponentRegistry::getId<Ts>()), row))
+        Ts(std::move(components)), ...);
+
+    EntityRecord& record = m_records[entity.index];
+    record.archetype = archetype;
+    record.row = row;
+    return entity;
+}
+
+template<class T>
+T&
+World::addComponent(Entity entity, T component) {
+    T* existing = getComponent<T>(entity);
+    if (existing) {
+        *existing = std::move(component);
+        return *existing;
+    }
+    moveEntity(entity, m_records[entity.index].archetype->getMask() | ComponentRegistry::getMask<T>());
+    const EntityRecord& record = m_records[entity.index];
+    void* slot = record.archetype->getComponent(record.archetype->getSlot(ComponentRegistry::getId<T>()), record.row);
+    return *new (slot) T(std::move(component));
+}
+
+template<class T>
+void
+World::removeComponent(Entity entity) {
+    if (!hasComponent<T>(entity)) {
+        return;
+    }
+    moveEntity(entity, m_records[entity.index].archetype->getMask() & ~ComponentRegistry::getMask<T>());
+}
+
+template<class T>
+T*
+World::getComponent(Entity entity) {
+    if (!isAlive(entity)) {
+        return nullptr;
+    }
+    const EntityRecord& record = m_records[entity.index];
+    unsigned int slot = record.archetype->getSlot(ComponentRegistry::getId<T>());
+    if (slot == Archetype::INVALID_SLOT) {
+        return nullptr;
+    }
+    return static_cast<T*>(record.archetype->getComponent(slot, record.row));
+}
+
+template<class T>
+bool
+World::hasComponent(Entity entity) const {
+    return isAlive(entity)
+        && (m_records[entity.index].archetype->getMask() & ComponentRegistry::getMask<T>()) != 0;
+}
+
+template<class... Ts, class Func>
+void
+World::visitChunk(Archetype& archetype, unsigned int chunk, Func& func) {
+    func(archetype.getChunkRowCount(chunk),
+         archetype.getChunkEntities(chunk),
+         static_cast<Ts*>(archetype.getChunkArray(chunk,
+             archetype.getSlot(ComponentRegistry::getId<typename std::remove_const<Ts>::type>())))...);
+}
+
+template<class... Ts, class Func>
+void
+World::forEachChunk(Func&& func) {
+    const ComponentMask mask = maskOf<Ts...>();
+    for (const std::unique_ptr<Archetype>& archetype : m_archetypes) {
+        if ((archetype->getMask() & mask) != mask) {
+            continue;
+        }
+        const unsigned int chunks = archetype->getChunkCount();
+        for (unsigned int chunk = 0; chunk < chunks; ++chunk) {
+            visitChunk<Ts...>(*archetype, chunk, func);
+        }
+    }
+}
+
+template<class... Ts, class Func>
+void
+World::parallelForEachChunk(Func&& func) {
+    std::vector<ChunkRef> chunks;
+    collectChunks(maskOf<Ts...>(), chunks);
+    parallelForChunks(chunks, [&func](const ChunkRef& ref) {
+        visitChunk<Ts...>(*ref.archetype, ref.chunk, func);
+    });
+}
+
+template<class... Ts, class Func>
+void
+World::forEach(Func&& func) {
+    forEachChunk<Ts...>([&func](unsigned int count, const Entity* entities, Ts*... arrays) {
+        for (unsigned int i = 0; i < count; ++i) {
+            func(entities[i], arrays[i]...);
+        }
+    });
+}
+
+template<class... Ts, class Func>
+void
+World::parallelForEach(Func&& func) {
+    parallelForEachChunk<Ts...>([&func](unsigned int count, const Entity* entities, Ts*... arrays) {
+        for (unsigned int i = 0; i < count; ++i) {
+            func(entities[i], arrays[i]...);
+        }
+    });
+}
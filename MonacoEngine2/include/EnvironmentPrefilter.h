@@ -0,0 +1,99 @@
+/**
+ * @file EnvironmentPrefilter.h
+ * @brief Declara EnvironmentPrefilter, el horneado en CPU de la iluminacion por imagen (IBL).
+ *
+ * A partir de un CubeMap HDR produce, sin GPU, lo que el sombreado PBR lee en tiempo real:
+ *  - Especular: una cadena de mips donde el nivel m guarda el entorno convolucionado con el
+ *    lobulo GGX de rugosidad m / (niveles - 1) (aproximacion split-sum, N = V = R). Cada
+ *    texel toma muestras de importancia de GGX (secuencia de Hammersley) y lee el mip de
+ *    origen cuyo texel cubre el angulo solido de la muestra (filtered importance sampling),
+ *    lo que elimina el ruido con pocas muestras.
+ *  - Difusa: la irradiancia como 9 coeficientes de armonicos esfericos (SH9) por canal,
+ *    proyectados sobre todos los texeles con su angulo solido.
+ *
+ * Cada cara de cada nivel se reparte por filas en el JobSystem y se cronometra por separado,
+ * para hornear entornos en el pipeline de assets de Linux.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "CubeMap.h"
+
+class JobSystem;
+
+/**
+ * @struct SH9
+ * @brief Armonicos esfericos de orden 2 (bandas 0 a 2) por canal RGB.
+ *
+ * Orden de los coeficientes: Y00, Y1-1, Y10, Y11, Y2-2, Y2-1, Y20, Y21, Y22.
+ */
+struct SH9 {
+    float coefficients[9][3] = {};
+
+    /// Radiancia aproximada en la direccion unitaria @p dir.
+    void evaluate(const float* dir, float* rgb) const;
+
+    /**
+     * @brief Irradiancia en una superficie con normal unitaria @p normal.
+     *
+     * Convoluciona con el coseno (factores pi, 2pi/3 y pi/4 por banda); dividir entre pi da
+     * el difuso de Lambert con albedo 1.
+     */
+    void irradiance(const float* normal, float* rgb) const;
+
+    /// Los 9 valores de la base en la direccion unitaria @p dir.
+    static void basis(const float* dir, float* values);
+};
+
+/**
+ * @struct PrefilterSettings
+ * @brief Opciones de EnvironmentPrefilter::prefilterSpecular().
+ */
+struct PrefilterSettings {
+    unsigned int size = 128;            ///< Lado del nivel 0 (rugosidad 0).
+    unsigned int levels = 6;            ///< Niveles de rugosidad (se recorta a la cadena hasta 1x1).
+    unsigned int sampleCount = 64;      ///< Muestras GGX por texel en los niveles con rugosidad > 0.
+    JobSystem* jobs = nullptr;          ///< Pool para repartir las filas; nullptr = hilo actual.
+};
+
+/**
+ * @struct PrefilterTiming
+ * @brief Tiempo de una cara de un nivel.
+ */
+struct PrefilterTiming {
+    unsigned int level = 0;
+    unsigned int face = 0;
+    unsigned int size = 0;              ///< Lado de la cara en ese nivel.
+    float roughness = 0.0f;
+    double ms = 0.0;
+};
+
+/**
+ * @class EnvironmentPrefilter
+ * @brief Convoluciones de un entorno para IBL.
+ */
+class EnvironmentPrefilter {
+public:
+    /**
+     * @brief Genera la cadena especular de @p source.
+     * @param source  Entorno con sus mips (CubeMap::generateMips()); mas niveles = menos ruido.
+     * @param levels  Recibe un CubeMap por nivel de rugosidad, de settings.size hacia abajo.
+     * @param timings Recibe el tiempo de cada cara de cada nivel (opcional).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si no hay origen o settings.size es 0.
+     */
+    static HRESULT prefilterSpecular(const std::vector<CubeMap>& source, const PrefilterSettings& settings,
+                                     std::vector<CubeMap>& levels, std::vector<PrefilterTiming>* timings = nullptr);
+
+    /**
+     * @brief Proyecta @p source en SH9 (radiancia; SH9::irradiance() da la irradiancia).
+     * @param jobs Pool para repartir las caras (opcional).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si el cubemap esta vacio.
+     */
+    static HRESULT projectSH9(const CubeMap& source, SH9& sh, JobSystem* jobs = nullptr);
+
+    /// Rugosidad del nivel @p level de una cadena de @p levelCount niveles.
+    static float levelRoughness(unsigned int level, unsigned int levelCount) {
+        return levelCount > 1 ? static_cast<float>(level) / (levelCount - 1) : 0.0f;
+    }
+};
@@ -0,0 +1,80 @@
+/**
+ * @file FileWatcher.h
+ * @brief Declara la clase FileWatcher, aviso de cambios en un conjunto de archivos.
+ *
+ * Vigila archivos sueltos (no arboles completos) y los reporta en poll(), que no bloquea y se
+ * llama una vez por frame o por iteracion de una herramienta. Hay dos implementaciones:
+ *  - inotify (Linux): vigila el directorio de cada archivo, asi que tambien detecta los
+ *    guardados que escriben un temporal y lo renombran, y archivos que aun no existen;
+ *  - sondeo (resto de plataformas, o forzado en init()): compara fecha de modificacion y
+ *    tamano de cada archivo en cada poll(); barato para las decenas de fuentes de shaders.
+ * Varios eventos del mismo archivo entre dos poll() se reportan una sola vez.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include <unordered_map>
+
+/**
+ * @class FileWatcher
+ * @brief Archivos vigilados y sus cambios desde el ultimo poll(). No copiable.
+ */
+class FileWatcher {
+public:
+    FileWatcher() = default;
+    ~FileWatcher() { destroy(); }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Prepara el vigilante.
+     * @param forcePolling Usa el sondeo aunque la plataforma tenga notificaciones.
+     * @return @c S_OK si fue exitoso (si inotify no esta disponible se usa el sondeo).
+     */
+    HRESULT init(bool forcePolling = false);
+
+    /// Deja de vigilar todo y libera el descriptor de notificaciones.
+    void destroy();
+
+    /**
+     * @brief Empieza a vigilar @p fileName (puede no existir todavia).
+     * @return @c S_OK si fue exitoso; @c E_FAIL si su directorio no se puede vigilar.
+     */
+    HRESULT watch(const std::string& fileName);
+
+    /// Deja de vigilar @p fileName.
+    void unwatch(const std::string& fileName);
+
+    /**
+     * @brief Archivos vigilados que cambiaron (escritos, creados, renombrados o borrados).
+     * @param changed Recibe las rutas normalizadas (ver normalize()), sin repetidos.
+     * @return Cantidad de archivos en @p changed.
+     */
+    unsigned int poll(std::vector<std::string>& changed);
+
+    /// Archivos vigilados.
+    size_t getWatchCount() const { return m_files.size(); }
+
+    /// @c true si usa notificaciones del sistema (inotify) en lugar del sondeo.
+    bool usesNotifications() const { return m_notifyFd >= 0; }
+
+    /// Ruta absoluta y normalizada con la que se identifica un archivo.
+    static std::string normalize(const std::string& fileName);
+
+private:
+    /// Fecha de modificacion y tamano para el sondeo.
+    struct FileState {
+        bool exists = false;
+        long long writeTime = 0;
+        unsigned long long size = 0;
+    };
+
+    static FileState readState(const std::string& fileName);
+
+    std::unordered_map<std::string, FileState> m_files;     ///< Ruta normalizada -> ultimo estado visto.
+    int m_notifyFd = -1;                                    ///< Descriptor de inotify; -1 con sondeo.
+    std::unordered_map<int, std::string> m_directories;     ///< Vigilancia de inotify -> directorio.
+    std::unordered_map<std::string, int> m_directoryWatches;///< Directorio -> vigilancia de inotify.
+};
@@ -0,0 +1,103 @@
+/**
+ * @file FrustumCuller.h
+ * @brief Declara la clase FrustumCuller, culling por frustum vectorizado sobre una BoundsTable.
+ *
+ * Los seis planos del frustum se extraen de View * Projection y se prueban contra
+ * SIMD_LANES objetos por instruccion (AVX2: 8, SSE: 4) leyendo directamente los arreglos SoA
+ * de la tabla. Para cada plano se usa el menor de los dos radios proyectados (caja y esfera),
+ * de modo que basta con que cualquiera de los dos volumenes quede fuera para descartar.
+ *
+ * La tabla se reparte en bloques entre los hilos del JobSystem; cada bloque escribe su propia
+ * lista de visibles y al final se concatenan en orden de indice.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+
+class JobSystem;
+class BoundsTable;
+
+/**
+ * @struct Frustum
+ * @brief Seis planos (normal hacia dentro, normalizados) en espacio de mundo.
+ */
+struct Frustum {
+    /// Orden: izquierdo, derecho, inferior, superior, cercano, lejano.
+    Vector4 planes[6];
+
+    /// Extrae los planos de una matriz View * Projection con profundidad de Direct3D (0 <= z <= w).
+    void extract(const Matrix4& viewProjection);
+};
+
+/**
+ * @struct FrustumStats
+ * @brief Tiempo y contadores del ultimo cull().
+ */
+struct FrustumStats {
+    double cullMs = 0.0;                ///< Prueba y compactacion de la lista de visibles.
+    unsigned int objectsTested = 0;     ///< Objetos probados.
+    unsigned int objectsVisible = 0;    ///< Objetos dentro del frustum.
+};
+
+/**
+ * @class FrustumCuller
+ * @brief Produce cada frame la lista de objetos de una BoundsTable que intersectan el frustum.
+ *
+ * Uso por frame: update() -> cull().
+ */
+class FrustumCuller {
+public:
+    /// Objetos por tarea del JobSystem.
+    static const unsigned int BLOCK_SIZE = 4096;
+
+    FrustumCuller() = default;
+    ~FrustumCuller() = default;
+
+    /**
+     * @brief Inicializa el culler.
+     * @param jobSystem Pool de hilos para repartir los bloques.
+     */
+    HRESULT init(JobSystem& jobSystem);
+
+    /**
+     * @brief Actualiza los planos del frustum.
+     * @param viewProjection Matriz View * Projection (sin transponer).
+     */
+    void update(const Matrix4& viewProjection);
+
+    /**
+     * @brief Prueba todos los objetos de la tabla contra el frustum.
+     * @param table   Volumenes en espacio de mundo.
+     * @param visible Salida: indices de los objetos visibles, en orden creciente.
+     * @return Numero de objetos visibles.
+     */
+    unsigned int cull(const BoundsTable& table, std::vector<unsigned int>& visible);
+
+    /// Prueba escalar de un objeto de la tabla (misma formula que cull()).
+    bool isVisible(const BoundsTable& table, unsigned int index) const;
+
+    /// Prueba escalar de una caja en espacio de mundo.
+    bool isVisible(const AABB& worldBox) const;
+
+    /// Libera las listas intermedias.
+    void destroy();
+
+    /// Planos del frustum actual.
+    const Frustum& getFrustum() const { return m_frustum; }
+
+    /// Estadisticas del ultimo cull().
+    const FrustumStats& getStats() const { return m_stats; }
+
+private:
+    /// Prueba los objetos [begin, end) y agrega los visibles a @p out.
+    void cullRange(const BoundsTable& table, unsigned int begin, unsigned int end,
+                   std::vector<unsigned int>& out) const;
+
+private:
+    JobSystem* m_jobSystem = nullptr;
+    Frustum m_frustum = {};
+    float m_absNormals[6][3] = {};                          ///< |normal| por plano.
+    std::vector<std::vector<unsigned int>> m_blockVisible;  ///< Visibles por bloque.
+    FrustumStats m_stats;
+};
@@ -0,0 +1,98 @@
+/**
+ * @file HdrImage.h
+ * @brief Declara la clase HdrImage, una imagen RGBA de 32 bits flotantes por canal en CPU.
+ *
+ * Mapas de entorno y lightmaps salen de archivos Radiance .hdr (stbi_loadf) con valores por
+ * encima de 1. En memoria se guardan como RGBA float; para la GPU se empaquetan con pack() en
+ * uno de tres formatos:
+ *  - @c R16G16B16A16_FLOAT: 8 bytes por pixel, con alfa; conversion con simd::storeHalves().
+ *  - @c R11G11B10_FLOAT: 4 bytes por pixel, sin alfa ni negativos (mantisas de 6/6/5 bits);
+ *    se redondea primero a medio float y luego a la mantisa corta.
+ *  - @c R32G32B32A32_FLOAT: 16 bytes por pixel, tal cual.
+ * Para el cocinado, BlockImage::encode(const HdrImage&) comprime a BC6H (1 byte por pixel).
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "DdsFile.h"
+
+class JobSystem;
+
+/**
+ * @class HdrImage
+ * @brief Imagen RGBA float con filas contiguas (4 floats por pixel).
+ */
+class HdrImage {
+public:
+    HdrImage() = default;
+    ~HdrImage() = default;
+
+    HdrImage(const HdrImage&) = default;
+    HdrImage& operator=(const HdrImage&) = default;
+    HdrImage(HdrImage&&) = default;
+    HdrImage& operator=(HdrImage&&) = default;
+
+    /**
+     * @brief Reserva una imagen en negro transparente.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si las dimensiones no son validas.
+     */
+    HRESULT init(unsigned int width, unsigned int height);
+
+    /**
+     * @brief Carga un .hdr (o PNG/JPG/TGA/BMP, que stb pasa a lineal con gamma 2.2) a RGBA float.
+     * @return @c S_OK si fue exitoso; @c E_FAIL si no se pudo leer o decodificar.
+     */
+    HRESULT loadFromFile(const std::string& fileName);
+
+    /// Igual que loadFromFile() con el archivo ya en memoria.
+    HRESULT loadFromMemory(const unsigned char* data, size_t size);
+
+    /// @c true si @p data es un archivo de alto rango (Radiance .hdr).
+    static bool isHdr(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Empaqueta los pixeles en @p format, filas sin relleno (pitch = ancho * bytes por pixel).
+     * @param jobs Pool para repartir las filas (opcional).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si la imagen esta vacia o el formato no es
+     *         R16G16B16A16_FLOAT, R11G11B10_FLOAT ni R32G32B32A32_FLOAT.
+     */
+    HRESULT pack(DdsFormat format, std::vector<unsigned char>& out, JobSystem* jobs = nullptr) const;
+
+    /**
+     * @brief Inverso de pack(): reemplaza la imagen con los pixeles de @p data.
+     *
+     * R11G11B10 no tiene alfa; sale en 1.
+     */
+    HRESULT unpack(DdsFormat format, const unsigned char* data, unsigned int width, unsigned int height);
+
+    /// Nivel siguiente de mipmap: promedio de 2x2 en lineal (la fila o columna impar sobrante se repite).
+    HRESULT halfSize(HdrImage& out) const;
+
+    /**
+     * @brief Genera la cadena de mipmaps de @p base hasta 1x1.
+     * @param maxLevels Limite de niveles (0 = todos).
+     */
+    static HRESULT generateMips(HdrImage&& base, std::vector<HdrImage>& levels, unsigned int maxLevels = 0);
+
+    /// Empaqueta un pixel RGB en R11G11B10_FLOAT (los negativos pasan a 0; satura en el maximo finito).
+    static uint32_t packR11G11B10(float r, float g, float b);
+
+    /// Desempaqueta R11G11B10_FLOAT en @p rgb.
+    static void unpackR11G11B10(uint32_t packed, float* rgb);
+
+    /// Libera la memoria de pixeles.
+    void destroy();
+
+    /// Primer float de la fila @p y.
+    float* row(unsigned int y) { return m_pixels.data() + static_cast<size_t>(y) * m_width * 4; }
+    const float* row(unsigned int y) const { return m_pixels.data() + static_cast<size_t>(y) * m_width * 4; }
+
+    /// @c true si la imagen no tiene pixeles.
+    bool empty() const { return m_pixels.empty(); }
+
+public:
+    unsigned int m_width = 0;       ///< Ancho en pixeles.
+    unsigned int m_height = 0;      ///< Alto en pixeles.
+    std::vector<float> m_pixels;    ///< RGBA, fila por fila.
+};
@@ -0,0 +1,101 @@
+/**
+ * @file Image.h
+ * @brief Declara la clase Image, una imagen RGBA8 en memoria de CPU.
+ *
+ * Se usa como textura y como render target del rasterizador por software, y para
+ * guardar resultados en disco (TGA) en pruebas sin GPU.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+
+class JobSystem;
+
+/**
+ * @struct ImageView
+ * @brief Pixeles RGBA8 en memoria ajena con pitch propio: una textura de staging proyectada,
+ *        una region de UploadArena o una Image (Image::getView()).
+ */
+struct ImageView {
+    unsigned char* data = nullptr;  ///< Primer byte de la fila 0.
+    unsigned int width = 0;         ///< Ancho en pixeles.
+    unsigned int height = 0;        ///< Alto en pixeles.
+    size_t rowPitch = 0;            ///< Bytes entre el inicio de dos filas (>= width * 4).
+
+    /// Puntero al primer byte de la fila @p y.
+    unsigned char* row(unsigned int y) const { return data + y * rowPitch; }
+
+    /// @c true si no apunta a memoria.
+    bool empty() const { return data == nullptr || width == 0 || height == 0; }
+};
+
+/**
+ * @class Image
+ * @brief Imagen de 8 bits por canal con filas contiguas (pitch = width * channels).
+ */
+class Image {
+public:
+    Image() = default;
+    ~Image() = default;
+
+    // El destructor declarado suprime el movimiento implicito; sin esto std::move copia los pixeles.
+    Image(const Image&) = default;
+    Image& operator=(const Image&) = default;
+    Image(Image&&) = default;
+    Image& operator=(Image&&) = default;
+
+    /**
+     * @brief Reserva una imagen vacia (pixeles en cero).
+     * @param width    Ancho en pixeles.
+     * @param height   Alto en pixeles.
+     * @param channels Canales por pixel (1 a 4).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si las dimensiones no son validas.
+     */
+    HRESULT init(unsigned int width, unsigned int height, unsigned int channels = 4);
+
+    /**
+     * @brief Decodifica un archivo PNG/JPG/TGA/BMP a RGBA8 con ImageDecoderRegistry.
+     * @param fileName Ruta completa del archivo (con extension).
+     * @param jobs     Pool para decodificar en paralelo (opcional; ver JpegDecoder y PngDecoder).
+     * @return @c S_OK si fue exitoso; @c E_FAIL si no se pudo leer o decodificar.
+     */
+    HRESULT loadFromFile(const std::string& fileName, JobSystem* jobs = nullptr);
+
+    /**
+     * @brief Decodifica un archivo PNG/JPG/TGA/BMP que ya esta en memoria a RGBA8.
+     * @param data Bytes del archivo.
+     * @param size Tamano en bytes.
+     * @param jobs Pool para decodificar en paralelo (opcional).
+     * @return @c S_OK si fue exitoso; @c E_FAIL si no se pudo decodificar.
+     */
+    HRESULT loadFromMemory(const unsigned char* data, size_t size, JobSystem* jobs = nullptr);
+
+    /**
+     * @brief Guarda la imagen como TGA sin compresion (32 bits BGRA).
+     * @param fileName Ruta del archivo de salida.
+     */
+    HRESULT saveToTGA(const std::string& fileName) const;
+
+    /// Libera la memoria de pixeles.
+    void destroy();
+
+    /// Puntero al primer byte de la fila @p y.
+    unsigned char* row(unsigned int y) { return m_pixels.data() + static_cast<size_t>(y) * getPitch(); }
+    const unsigned char* row(unsigned int y) const { return m_pixels.data() + static_cast<size_t>(y) * getPitch(); }
+
+    /// Vista de los pixeles (solo tiene sentido con 4 canales); valida mientras no cambie el tamano.
+    ImageView getView() { return ImageView{ m_pixels.data(), m_width, m_height, getPitch() }; }
+
+    /// Bytes por fila.
+    unsigned int getPitch() const { return m_width * m_channels; }
+
+    /// @c true si la imagen no tiene pixeles.
+    bool empty() const { return m_pixels.empty(); }
+
+public:
+    unsigned int m_width = 0;            ///< Ancho en pixeles.
+    unsigned int m_height = 0;           ///< Alto en pixeles.
+    unsigned int m_channels = 4;         ///< Canales por pixel.
+    std::vector<unsigned char> m_pixels; ///< Datos de la imagen, fila por fila.
+};
@@ -0,0 +1,130 @@
+/**
+ * @file ImageDecodeQueue.h
+ * @brief Declara la clase ImageDecodeQueue, decodificacion de imagenes en los hilos del JobSystem.
+ *
+ * Cada solicitud se convierte en una tarea que lee y decodifica el archivo (stb_image) fuera
+ * del hilo que la pidio. Las imagenes terminadas quedan en una cola que el hilo principal
+ * vacia con pop(), por ejemplo para crear las texturas de GPU con un presupuesto por frame
+ * (ver TextureUploadQueue). Opcionalmente la misma tarea genera la cadena de mipmaps.
+ * Cada resultado lleva el hash de los bytes del archivo para buscarlo en una ResourceCache.
+ * No depende de Direct3D.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Image.h"
+#include "MipChain.h"
+#include "ColorSpace.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+/**
+ * @struct DecodedImage
+ * @brief Resultado de una solicitud de ImageDecodeQueue.
+ */
+struct DecodedImage {
+    unsigned int ticket = 0;    ///< Valor devuelto por request().
+    std::string name;           ///< Archivo (o nombre dado a requestMemory()).
+    HRESULT result = S_OK;      ///< E_FAIL si no se pudo leer o decodificar.
+    uint64_t contentHash = 0;   ///< ResourceCache::hashContent() de los bytes del archivo (0 si no se leyo).
+    ColorSpace colorSpace = ColorSpace::Srgb;   ///< El de la solicitud; define como se filtraron los mips.
+    Image image;                ///< Pixeles RGBA8 si result tuvo exito (vacia si se generaron mips).
+    MipChain mips;              ///< Cadena de mipmaps, si la cola se inicializo con generateMips.
+    double megapixels = 0.0;    ///< Tamano del nivel 0 en megapixeles.
+    double decodeMs = 0.0;      ///< Tiempo de lectura + decodificacion (+ mips) en el hilo trabajador.
+};
+
+/**
+ * @struct ImageDecodeStats
+ * @brief Totales acumulados desde init().
+ */
+struct ImageDecodeStats {
+    unsigned int requested = 0;     ///< Solicitudes recibidas.
+    unsigned int decoded = 0;       ///< Imagenes terminadas con exito.
+    unsigned int failed = 0;        ///< Imagenes que no se pudieron decodificar.
+    double megapixels = 0.0;        ///< Megapixeles decodificados.
+    double decodeMs = 0.0;          ///< Suma de los tiempos de decodificacion (todos los hilos).
+};
+
+/**
+ * @class ImageDecodeQueue
+ * @brief Cola de decodificacion asincrona con entrega en el hilo principal.
+ */
+class ImageDecodeQueue {
+public:
+    ImageDecodeQueue() = default;
+    ~ImageDecodeQueue() { destroy(); }
+
+    ImageDecodeQueue(const ImageDecodeQueue&) = delete;
+    ImageDecodeQueue& operator=(const ImageDecodeQueue&) = delete;
+
+    /**
+     * @brief Inicializa la cola.
+     * @param jobs         Pool donde se decodifica; sin el, request() decodifica en el hilo que llama.
+     * @param generateMips Si es @c true, cada imagen sale como MipChain en DecodedImage::mips.
+     * @param mipSettings  Opciones de la cadena; cada imagen se filtra en un solo hilo y
+     *                     MipSettings::srgb lo decide el espacio de color de cada solicitud.
+     */
+    HRESULT init(JobSystem* jobs, bool generateMips = false, const MipSettings& mipSettings = MipSettings());
+
+    /// Espera las decodificaciones en curso y descarta los resultados no recogidos.
+    void destroy();
+
+    /**
+     * @brief Pide leer y decodificar un archivo PNG/JPG/TGA/BMP.
+     * @param colorSpace @c Srgb para color; @c Linear para datos (los mips se promedian sin la curva).
+     * @return Ticket que identifica el resultado en pop().
+     */
+    unsigned int request(const std::string& fileName, ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Pide decodificar un archivo ya cargado en memoria.
+     * @param data Bytes del archivo; deben seguir validos hasta que el resultado salga en pop().
+     * @param size Tamano en bytes.
+     * @param name Nombre para el resultado y los mensajes de error.
+     * @param colorSpace Igual que en request().
+     */
+    unsigned int requestMemory(const unsigned char* data, size_t size, const std::string& name,
+                               ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Saca una imagen terminada, si hay.
+     * @return @c false si no hay resultados listos.
+     */
+    bool pop(DecodedImage& out);
+
+    /// Bloquea hasta que todas las solicitudes terminen de decodificarse (ayudando al pool).
+    void waitIdle();
+
+    /// Solicitudes que aun no terminan de decodificarse.
+    unsigned int getInFlight() const { return m_inFlight.load(std::memory_order_acquire); }
+
+    /// Resultados listos que no se han recogido con pop().
+    unsigned int getReadyCount() const;
+
+    /// Totales acumulados.
+    ImageDecodeStats getStats() const;
+
+private:
+    /// Encola (o ejecuta en el hilo actual si no hay pool) la decodificacion de @p ticket.
+    /// @p decode llena image y contentHash del resultado.
+    void schedule(unsigned int ticket, const std::string& name, ColorSpace colorSpace,
+                  std::function<HRESULT(DecodedImage&)> decode);
+
+    /// Guarda el resultado de una tarea en la cola de terminados.
+    void finish(DecodedImage&& result);
+
+    JobSystem* m_jobs = nullptr;
+    bool m_generateMips = false;
+    MipSettings m_mipSettings;
+    JobCounter m_counter;                   ///< Tareas en el pool (para waitIdle/destroy).
+    std::atomic<unsigned int> m_inFlight{ 0 };
+    unsigned int m_nextTicket = 1;
+
+    mutable std::mutex m_mutex;             ///< Protege m_ready y m_stats.
+    std::deque<DecodedImage> m_ready;       ///< Terminados, en orden de llegada.
+    ImageDecodeStats m_stats;
+};
@@ -0,0 +1,119 @@
+/**
+ * @file ImageDecoder.h
+ * @brief Declara la interfaz ImageDecoder y el registro de decodificadores de imagen.
+ *
+ * Image::loadFromFile() y Image::loadFromMemory() pasan por ImageDecoderRegistry: cada
+ * decodificador registrado revisa la firma del archivo y el primero que lo decodifica sin error
+ * gana. Los rapidos (JpegDecoder, PngDecoder) solo cubren las variantes comunes en texturas
+ * grandes; con cualquier otra devuelven @c E_NOTIMPL y el registro sigue con el siguiente, hasta
+ * llegar a stb_image, que acepta todo lo demas.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Image.h"
+#include <memory>
+
+class JobSystem;
+
+/**
+ * @class ImageDecoder
+ * @brief Decodificador de un formato de archivo a RGBA8.
+ *
+ * decodeInto() escribe en memoria del llamador con cualquier pitch, asi que un archivo se puede
+ * decodificar directo a la memoria de subida (UploadArena, textura de staging) sin pasar por
+ * una Image. Las implementaciones no guardan estado y admiten llamadas desde varios hilos.
+ */
+class ImageDecoder {
+public:
+    virtual ~ImageDecoder() = default;
+
+    /// Nombre para mensajes y para el benchmark.
+    virtual const char* getName() const = 0;
+
+    /// @c true si la firma de @p data corresponde a su formato.
+    virtual bool canDecode(const unsigned char* data, size_t size) const = 0;
+
+    /**
+     * @brief Lee solo la cabecera.
+     * @return @c S_OK si fue exitoso; @c E_FAIL si la cabecera esta danada.
+     */
+    virtual HRESULT getInfo(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height) const = 0;
+
+    /**
+     * @brief Decodifica @p data a RGBA8 sobre @p target.
+     * @param target Destino del tamano que da getInfo(); cada fila se escribe completa (no hace
+     *               falta limpiarlo antes).
+     * @param jobs   Pool para repartir el trabajo (opcional; sin el, todo corre en el hilo que llama).
+     * @return @c S_OK si fue exitoso; @c E_NOTIMPL si la variante del formato no esta soportada;
+     *         @c E_FAIL si el archivo esta danado o no coincide con @p target. Los decodificadores
+     *         rapidos no escriben mensajes: el registro prueba el siguiente (stb_image tolera
+     *         algunos archivos truncados).
+     */
+    virtual HRESULT decodeInto(const unsigned char* data, size_t size, const ImageView& target, JobSystem* jobs) const = 0;
+
+    /// getInfo() + una Image nueva + decodeInto().
+    HRESULT decode(const unsigned char* data, size_t size, Image& image, JobSystem* jobs) const;
+};
+
+/**
+ * @class StbImageDecoder
+ * @brief PNG/JPG/TGA/BMP/... con stb_image; sin paralelismo.
+ */
+class StbImageDecoder : public ImageDecoder {
+public:
+    const char* getName() const override { return "stb_image"; }
+    bool canDecode(const unsigned char* data, size_t size) const override;
+    HRESULT getInfo(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height) const override;
+
+    /// Decodifica a un buffer propio de stb_image y copia las filas (no evita la copia).
+    HRESULT decodeInto(const unsigned char* data, size_t size, const ImageView& target, JobSystem* jobs) const override;
+};
+
+/**
+ * @class ImageDecoderRegistry
+ * @brief Lista ordenada de decodificadores; de fabrica: JpegDecoder, PngDecoder y StbImageDecoder.
+ */
+class ImageDecoderRegistry {
+public:
+    ImageDecoderRegistry();
+    ~ImageDecoderRegistry() = default;
+
+    ImageDecoderRegistry(const ImageDecoderRegistry&) = delete;
+    ImageDecoderRegistry& operator=(const ImageDecoderRegistry&) = delete;
+
+    /// Registro global que usa Image.
+    static ImageDecoderRegistry& instance();
+
+    /**
+     * @brief Agrega @p decoder antes de los ya registrados.
+     * @pre No hay decodificaciones en curso (se registra al arrancar).
+     */
+    void add(std::unique_ptr<ImageDecoder> decoder);
+
+    /// Deja solo stb_image (por ejemplo, para comparar resultados).
+    void useStbOnly();
+
+    /**
+     * @brief Dimensiones segun el primer decodificador que reconoce la firma.
+     * @return @c S_OK si fue exitoso; @c E_FAIL si ninguno reconoce el archivo.
+     */
+    HRESULT getInfo(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height) const;
+
+    /**
+     * @brief Decodifica @p data sobre @p target con el primer decodificador que lo acepte.
+     * @param target Destino con las dimensiones que devuelve getInfo().
+     * @return @c S_OK si fue exitoso; @c E_FAIL si ninguno pudo.
+     */
+    HRESULT decodeInto(const unsigned char* data, size_t size, const ImageView& target, JobSystem* jobs = nullptr) const;
+
+    /**
+     * @brief Decodifica @p data en una Image nueva (una sola reserva aunque falle algun decodificador).
+     * @return @c S_OK si fue exitoso; @c E_FAIL si ninguno pudo.
+     */
+    HRESULT decode(const unsigned char* data, size_t size, Image& image, JobSystem* jobs = nullptr) const;
+
+private:
+    std::vector<std::unique_ptr<ImageDecoder>> m_decoders;
+};
@@ -0,0 +1,109 @@
+/**
+ * @file JobSystem.h
+ * @brief Declara la clase JobSystem, un pool de hilos para trabajo de CPU del motor.
+ *
+ * Permite lanzar tareas independientes y repartir rangos de trabajo (parallelFor)
+ * entre los hilos trabajadores. El hilo que llama tambien ejecuta trabajo mientras espera,
+ * por lo que es valido anidar llamadas.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/**
+ * @class JobCounter
+ * @brief Cuenta las tareas pendientes de un grupo para poder esperarlas.
+ */
+class JobCounter {
+public:
+    JobCounter() : m_pending(0) {}
+
+    /// @c true si ya no hay tareas pendientes en el grupo.
+    bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> m_pending;
+};
+
+/**
+ * @class JobSystem
+ * @brief Pool de hilos con cola de tareas y reparto de rangos.
+ */
+class JobSystem {
+public:
+    /// Tarea simple.
+    using JobFunc = std::function<void()>;
+
+    /**
+     * @brief Funcion para un sub-rango de parallelFor.
+     * @param begin  Primer indice del sub-rango.
+     * @param end    Indice final (exclusivo).
+     * @param worker Indice del hilo que ejecuta (0 = hilo que llamo, [0, getNumThreads())).
+     */
+    using RangeFunc = std::function<void(unsigned int begin, unsigned int end, unsigned int worker)>;
+
+    JobSystem() = default;
+    ~JobSystem() { destroy(); }
+
+    /// Instancia global compartida por los sistemas del motor.
+    static JobSystem& instance();
+
+    /**
+     * @brief Crea los hilos trabajadores.
+     * @param numThreads Total de hilos incluyendo al que llama (0 = hardware_concurrency).
+     * @return @c S_OK si fue exitoso.
+     */
+    HRESULT init(unsigned int numThreads = 0);
+
+    /// Detiene y une los hilos trabajadores.
+    void destroy();
+
+    /**
+     * @brief Encola una tarea.
+     * @param job     Tarea a ejecutar.
+     * @param counter Grupo opcional para esperar la tarea con wait().
+     */
+    void submit(JobFunc job, JobCounter* counter = nullptr);
+
+    /// Espera a que el grupo termine, ejecutando tareas pendientes mientras tanto.
+    void wait(JobCounter& counter);
+
+    /**
+     * @brief Divide [0, count) en bloques de @p grainSize y los reparte entre los hilos.
+     *
+     * Bloquea hasta que todos los bloques terminan.
+     */
+    void parallelFor(unsigned int count, unsigned int grainSize, const RangeFunc& func);
+
+    /// Total de hilos que pueden ejecutar trabajo (trabajadores + el que llama).
+    unsigned int getNumThreads() const { return static_cast<unsigned int>(m_workers.size()) + 1; }
+
+    /// Indice del hilo actual (0 para hilos que no son trabajadores).
+    static unsigned int getWorkerIndex();
+
+private:
+    /// Ejecuta una tarea pendiente si existe. Devuelve @c false si la cola estaba vacia.
+    bool executeOne();
+
+    /// Bucle principal de cada hilo trabajador.
+    void workerLoop(unsigned int index);
+
+    struct Job {
+        JobFunc func;
+        JobCounter* counter;
+    };
+
+    std::vector<std::thread> m_workers;   ///< Hilos trabajadores.
+    std::deque<Job> m_queue;              ///< Cola de tareas pendientes.
+    std::mutex m_mutex;                   ///< Protege la cola.
+    std::condition_variable m_wake;       ///< Despierta a los trabajadores.
+    bool m_running = false;               ///< @c false para detener los hilos.
+};
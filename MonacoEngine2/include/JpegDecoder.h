@@ -0,0 +1,34 @@
+/**
+ * @file JpegDecoder.h
+ * @brief Declara la clase JpegDecoder, decodificador JPEG rapido para texturas grandes.
+ *
+ * Huffman con tabla de 9 bits que para los coeficientes AC cortos ya trae la corrida y el
+ * valor, IDCT flotante AAN con FloatV (varias columnas o filas del bloque por instruccion y
+ * la cuantizacion inversa incluida en la tabla), atajo para bloques con solo DC, y conversion
+ * YCbCr a RGB con FloatV. El submuestreo 2x1, 1x2 y 2x2 usa el mismo filtro triangular que
+ * stb_image ("fancy upsampling").
+ *
+ * Con marcadores de reinicio (DRI) cada intervalo empieza con el estado de entropia limpio,
+ * asi que los intervalos se decodifican en paralelo en el JobSystem; sin ellos la entropia es
+ * secuencial y solo la conversion de color se reparte por filas.
+ *
+ * Cubre JPEG baseline/extendido con Huffman (SOF0/SOF1), 8 bits, 1 o 3 componentes en un solo
+ * barrido. Progresivo, aritmetico, 12 bits, CMYK y RGB sin transformar devuelven
+ * @c E_NOTIMPL y pasan a stb_image.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "ImageDecoder.h"
+
+/**
+ * @class JpegDecoder
+ * @brief JPEG baseline a RGBA8.
+ */
+class JpegDecoder : public ImageDecoder {
+public:
+    const char* getName() const override { return "jpeg"; }
+    bool canDecode(const unsigned char* data, size_t size) const override;
+    HRESULT getInfo(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height) const override;
+    HRESULT decodeInto(const unsigned char* data, size_t size, const ImageView& target, JobSystem* jobs) const override;
+};
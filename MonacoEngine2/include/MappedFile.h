@@ -0,0 +1,48 @@
+/**
+ * @file MappedFile.h
+ * @brief Declara la clase MappedFile, proyeccion de un archivo de solo lectura en memoria.
+ *
+ * El sistema operativo carga las paginas del archivo a medida que se leen, sin copiarlo a un
+ * buffer propio: DdsFile apunta los subrecursos de la textura directamente a la proyeccion.
+ * Usa CreateFileMapping/MapViewOfFile en Windows y mmap en el resto.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+
+/**
+ * @class MappedFile
+ * @brief Archivo proyectado en memoria de solo lectura. No copiable.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { destroy(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Proyecta @p fileName completo.
+     * @return @c S_OK si fue exitoso; @c E_FAIL si no existe, esta vacio o no se pudo proyectar.
+     */
+    HRESULT init(const std::string& fileName);
+
+    /// Deshace la proyeccion; los punteros de getData() dejan de ser validos.
+    void destroy();
+
+    /// Primer byte del archivo, o nullptr si no hay archivo proyectado.
+    const unsigned char* getData() const { return m_data; }
+
+    /// Tamano del archivo en bytes.
+    size_t getSize() const { return m_size; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#if defined(_WIN32)
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+};
@@ -0,0 +1,51 @@
+/**
+ * @file MathXna.h
+ * @brief Conversiones entre los tipos de matematica del motor y XNA math (solo Windows).
+ *
+ * Los sistemas de CPU (culling, transformaciones, mallas) trabajan con Vector3, Quaternion y
+ * Matrix4; la capa de Direct3D sigue usando XMMATRIX en los constant buffers. Este archivo es
+ * el unico punto de contacto entre ambas. Las distribuciones en memoria son identicas, asi que
+ * cada conversion es una carga o un guardado.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "Prerequisites.h"
+
+static_assert(sizeof(Matrix4) == sizeof(XMFLOAT4X4), "Matrix4 must match XMFLOAT4X4");
+static_assert(sizeof(Vector3) == sizeof(XMFLOAT3), "Vector3 must match XMFLOAT3");
+static_assert(sizeof(Vector4) == sizeof(XMFLOAT4), "Vector4 must match XMFLOAT4");
+
+namespace math {
+    inline XMMATRIX toXMMATRIX(const Matrix4& m) {
+        return XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(&m));
+    }
+
+    inline Matrix4 fromXMMATRIX(CXMMATRIX m) {
+        Matrix4 r;
+        XMStoreFloat4x4(reinterpret_cast<XMFLOAT4X4*>(&r), m);
+        return r;
+    }
+
+    inline XMVECTOR toXMVECTOR(const Vector3& v, float w = 0.0f) { return XMVectorSet(v.x, v.y, v.z, w); }
+    inline XMVECTOR toXMVECTOR(const Vector4& v) { return XMVectorSet(v.x, v.y, v.z, v.w); }
+    inline XMVECTOR toXMVECTOR(const Quaternion& q) { return XMVectorSet(q.x, q.y, q.z, q.w); }
+
+    inline Vector3 toVector3(FXMVECTOR v) {
+        XMFLOAT4 f;
+        XMStoreFloat4(&f, v);
+        return Vector3(f.x, f.y, f.z);
+    }
+
+    inline Vector4 toVector4(FXMVECTOR v) {
+        XMFLOAT4 f;
+        XMStoreFloat4(&f, v);
+        return Vector4(f.x, f.y, f.z, f.w);
+    }
+
+    inline Quaternion toQuaternion(FXMVECTOR v) {
+        XMFLOAT4 f;
+        XMStoreFloat4(&f, v);
+        return Quaternion(f.x, f.y, f.z, f.w);
+    }
+}
@@ -0,0 +1,160 @@
+/**
+ * @file Matrix.h
+ * @brief Declara Matrix4, matriz 4x4 de floats, y las transformaciones del motor.
+ *
+ * Convencion de XNA math / Direct3D: vectores fila (p' = p * M), filas 0..2 con los ejes
+ * transformados y la fila 3 con la traslacion. multiply(a, b) aplica primero @p a y luego @p b.
+ * La distribucion en memoria es la de XMFLOAT4X4 (16 floats por filas).
+ *
+ * El producto de matrices y la transformacion de vectores usan Float4 (SSE, NEON o escalar,
+ * ver Simd.h): cada fila del resultado es una combinacion lineal de las filas de @p b.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "Math/Vector.h"
+#include "Math/Quaternion.h"
+#include "Simd.h"
+#include <cstddef>
+
+/**
+ * @struct Matrix4
+ * @brief Matriz 4x4 por filas, alineada a 16 bytes.
+ */
+struct alignas(16) Matrix4 {
+    float m[4][4];
+
+    Matrix4() = default;
+    Matrix4(float m00, float m01, float m02, float m03,
+            float m10, float m11, float m12, float m13,
+            float m20, float m21, float m22, float m23,
+            float m30, float m31, float m32, float m33) {
+        m[0][0] = m00; m[0][1] = m01; m[0][2] = m02; m[0][3] = m03;
+        m[1][0] = m10; m[1][1] = m11; m[1][2] = m12; m[1][3] = m13;
+        m[2][0] = m20; m[2][1] = m21; m[2][2] = m22; m[2][3] = m23;
+        m[3][0] = m30; m[3][1] = m31; m[3][2] = m32; m[3][3] = m33;
+    }
+
+    static Matrix4 identity() {
+        return Matrix4(1.0f, 0.0f, 0.0f, 0.0f,
+                       0.0f, 1.0f, 0.0f, 0.0f,
+                       0.0f, 0.0f, 1.0f, 0.0f,
+                       0.0f, 0.0f, 0.0f, 1.0f);
+    }
+};
+
+namespace math {
+    /// a * b: transforma por @p a y luego por @p b (igual que XMMatrixMultiply).
+    inline Matrix4 multiply(const Matrix4& a, const Matrix4& b) {
+        using namespace simd;
+        const Float4 b0 = load4(b.m[0]), b1 = load4(b.m[1]), b2 = load4(b.m[2]), b3 = load4(b.m[3]);
+        Matrix4 r;
+        for (int i = 0; i < 4; ++i) {
+            Float4 row = mul4(splat4(a.m[i][0]), b0);
+            row = madd4(splat4(a.m[i][1]), b1, row);
+            row = madd4(splat4(a.m[i][2]), b2, row);
+            row = madd4(splat4(a.m[i][3]), b3, row);
+            store4(r.m[i], row);
+        }
+        return r;
+    }
+
+    inline Matrix4 transpose(const Matrix4& a) {
+        return Matrix4(a.m[0][0], a.m[1][0], a.m[2][0], a.m[3][0],
+                       a.m[0][1], a.m[1][1], a.m[2][1], a.m[3][1],
+                       a.m[0][2], a.m[1][2], a.m[2][2], a.m[3][2],
+                       a.m[0][3], a.m[1][3], a.m[2][3], a.m[3][3]);
+    }
+
+    /**
+     * @brief Inversa general por cofactores (igual que XMMatrixInverse).
+     * @param determinant Si no es nulo recibe el determinante; con determinante cero el
+     *        resultado no es finito, igual que en XNA.
+     */
+    Matrix4 inverse(const Matrix4& a, float* determinant = nullptr);
+
+    inline Matrix4 translation(float x, float y, float z) {
+        return Matrix4(1.0f, 0.0f, 0.0f, 0.0f,
+                       0.0f, 1.0f, 0.0f, 0.0f,
+                       0.0f, 0.0f, 1.0f, 0.0f,
+                       x, y, z, 1.0f);
+    }
+    inline Matrix4 translation(const Vector3& t) { return translation(t.x, t.y, t.z); }
+
+    inline Matrix4 scaling(float x, float y, float z) {
+        return Matrix4(x, 0.0f, 0.0f, 0.0f,
+                       0.0f, y, 0.0f, 0.0f,
+                       0.0f, 0.0f, z, 0.0f,
+                       0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    Matrix4 rotationX(float angle);
+    Matrix4 rotationY(float angle);
+    Matrix4 rotationZ(float angle);
+
+    /// Escala * rotacion * traslacion en una sola pasada (igual que XMMatrixAffineTransformation con origen cero).
+    inline Matrix4 affineTransformation(const Vector3& scale, const Quaternion& rotation, const Vector3& position) {
+        const float x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+        const float xx = x * x, yy = y * y, zz = z * z;
+        const float xy = x * y, xz = x * z, yz = y * z;
+        const float wx = w * x, wy = w * y, wz = w * z;
+        return Matrix4((1.0f - 2.0f * (yy + zz)) * scale.x, 2.0f * (xy + wz) * scale.x, 2.0f * (xz - wy) * scale.x, 0.0f,
+                       2.0f * (xy - wz) * scale.y, (1.0f - 2.0f * (xx + zz)) * scale.y, 2.0f * (yz + wx) * scale.y, 0.0f,
+                       2.0f * (xz + wy) * scale.z, 2.0f * (yz - wx) * scale.z, (1.0f - 2.0f * (xx + yy)) * scale.z, 0.0f,
+                       position.x, position.y, position.z, 1.0f);
+    }
+
+    /// Rotacion de un cuaternion unitario (igual que XMMatrixRotationQuaternion).
+    inline Matrix4 rotationQuaternion(const Quaternion& rotation) {
+        return affineTransformation(Vector3(1.0f, 1.0f, 1.0f), rotation, Vector3(0.0f, 0.0f, 0.0f));
+    }
+
+    /// Vista de mano izquierda mirando hacia @p focus (igual que XMMatrixLookAtLH).
+    Matrix4 lookAtLH(const Vector3& eye, const Vector3& focus, const Vector3& up);
+
+    /// Vista de mano izquierda mirando en @p direction (igual que XMMatrixLookToLH).
+    Matrix4 lookToLH(const Vector3& eye, const Vector3& direction, const Vector3& up);
+
+    /// Proyeccion en perspectiva con profundidad 0..1 de Direct3D (igual que XMMatrixPerspectiveFovLH).
+    Matrix4 perspectiveFovLH(float fovAngleY, float aspectRatio, float nearZ, float farZ);
+
+    /// Proyeccion ortografica con profundidad 0..1 (igual que XMMatrixOrthographicLH).
+    Matrix4 orthographicLH(float viewWidth, float viewHeight, float nearZ, float farZ);
+
+    /// v * m (igual que XMVector4Transform).
+    inline Vector4 transform(const Vector4& v, const Matrix4& m) {
+        using namespace simd;
+        Float4 r = mul4(splat4(v.x), load4(m.m[0]));
+        r = madd4(splat4(v.y), load4(m.m[1]), r);
+        r = madd4(splat4(v.z), load4(m.m[2]), r);
+        r = madd4(splat4(v.w), load4(m.m[3]), r);
+        Vector4 out;
+        store4(&out.x, r);
+        return out;
+    }
+
+    /// Punto (w = 1) transformado y dividido por w (igual que XMVector3TransformCoord).
+    inline Vector3 transformCoord(const Vector3& p, const Matrix4& m) {
+        Vector4 h = transform(Vector4(p, 1.0f), m);
+        float invW = 1.0f / h.w;
+        return Vector3(h.x * invW, h.y * invW, h.z * invW);
+    }
+
+    /// Direccion (w = 0), sin traslacion (igual que XMVector3TransformNormal).
+    inline Vector3 transformNormal(const Vector3& n, const Matrix4& m) {
+        return Vector3(n.x * m.m[0][0] + n.y * m.m[1][0] + n.z * m.m[2][0],
+                       n.x * m.m[0][1] + n.y * m.m[1][1] + n.z * m.m[2][1],
+                       n.x * m.m[0][2] + n.y * m.m[1][2] + n.z * m.m[2][2]);
+    }
+
+    /**
+     * @brief Transforma @p count puntos (w = 1) a coordenadas homogeneas sin dividir por w.
+     *
+     * Equivale a XMVector3TransformStream sin la division; sirve para llevar los vertices
+     * de una malla a espacio de recorte.
+     * @param input      Primer punto.
+     * @param inputStride Bytes entre puntos consecutivos (sizeof(SimpleVertex) para leer Pos).
+     * @param output     Destino, @p count Vector4 contiguos.
+     */
+    void transformStream(const Vector3* input, size_t inputStride, Vector4* output, size_t count, const Matrix4& m);
+}
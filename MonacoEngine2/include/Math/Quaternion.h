@@ -0,0 +1,67 @@
+/**
+ * @file Quaternion.h
+ * @brief Declara Quaternion, rotaciones como cuaternion unitario (x, y, z, w).
+ *
+ * Sigue las convenciones de XNA math: multiply(q1, q2) es la rotacion q1 seguida de q2
+ * (el producto de Hamilton q2 * q1), igual que XMQuaternionMultiply.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "Math/Vector.h"
+
+/**
+ * @struct Quaternion
+ * @brief Cuaternion (parte vectorial x, y, z y escalar w).
+ */
+struct Quaternion {
+    float x, y, z, w;
+
+    Quaternion() = default;
+    Quaternion(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+
+    /// Rotacion nula.
+    static Quaternion identity() { return Quaternion(0.0f, 0.0f, 0.0f, 1.0f); }
+};
+
+namespace math {
+    inline float dot(const Quaternion& a, const Quaternion& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    /// Rotacion @p q1 seguida de @p q2 (igual que XMQuaternionMultiply).
+    inline Quaternion multiply(const Quaternion& q1, const Quaternion& q2) {
+        return Quaternion(q2.w * q1.x + q2.x * q1.w + q2.y * q1.z - q2.z * q1.y,
+                          q2.w * q1.y - q2.x * q1.z + q2.y * q1.w + q2.z * q1.x,
+                          q2.w * q1.z + q2.x * q1.y - q2.y * q1.x + q2.z * q1.w,
+                          q2.w * q1.w - q2.x * q1.x - q2.y * q1.y - q2.z * q1.z);
+    }
+
+    inline Quaternion conjugate(const Quaternion& q) { return Quaternion(-q.x, -q.y, -q.z, q.w); }
+
+    /// Cuaternion unitario, o cero si @p q es cero.
+    inline Quaternion normalize(const Quaternion& q) {
+        float len = sqrtf(dot(q, q));
+        float inv = len > 0.0f ? 1.0f / len : 0.0f;
+        return Quaternion(q.x * inv, q.y * inv, q.z * inv, q.w * inv);
+    }
+
+    /// Rotacion de @p angle radianes alrededor de @p axis (se normaliza; igual que XMQuaternionRotationAxis).
+    inline Quaternion rotationAxis(const Vector3& axis, float angle) {
+        Vector3 n = normalize(axis);
+        float s = sinf(angle * 0.5f);
+        return Quaternion(n.x * s, n.y * s, n.z * s, cosf(angle * 0.5f));
+    }
+
+    /// Rotacion roll (Z), luego pitch (X), luego yaw (Y), igual que XMQuaternionRotationRollPitchYaw.
+    Quaternion rotationRollPitchYaw(float pitch, float yaw, float roll);
+
+    /// Interpolacion esferica por el arco mas corto (igual que XMQuaternionSlerp).
+    Quaternion slerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+    /// Rota @p v por @p q (igual que XMVector3Rotate).
+    inline Vector3 rotate(const Vector3& v, const Quaternion& q) {
+        // v' = v + 2w (u x v) + 2 u x (u x v), con u la parte vectorial de q.
+        const Vector3 u(q.x, q.y, q.z);
+        const Vector3 t = cross(u, v) * 2.0f;
+        return v + t * q.w + cross(u, t);
+    }
+}
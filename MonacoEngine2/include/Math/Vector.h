@@ -0,0 +1,112 @@
+/**
+ * @file Vector.h
+ * @brief Declara Vector2, Vector3 y Vector4, vectores de floats del motor y sus operaciones.
+ *
+ * Los tipos tienen la misma distribucion en memoria que XMFLOAT2/3/4 (floats contiguos, sin
+ * relleno) para que los vertices y constantes se copien tal cual a la GPU. Las operaciones
+ * siguen la semantica de XNA math (por ejemplo, normalizar el vector cero devuelve cero).
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include <cmath>
+
+/// Constantes de angulos (iguales a XM_PI y derivadas).
+const float MATH_PI = 3.141592654f;
+const float MATH_2PI = 6.283185307f;
+const float MATH_PIDIV2 = 1.570796327f;
+const float MATH_PIDIV4 = 0.785398163f;
+
+/**
+ * @struct Vector2
+ * @brief Dos floats (coordenadas de textura, posiciones en pantalla).
+ */
+struct Vector2 {
+    float x, y;
+
+    Vector2() = default;
+    Vector2(float x_, float y_) : x(x_), y(y_) {}
+};
+
+/**
+ * @struct Vector3
+ * @brief Tres floats (posiciones, normales, escalas).
+ */
+struct Vector3 {
+    float x, y, z;
+
+    Vector3() = default;
+    Vector3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+
+    Vector3& operator+=(const Vector3& v) { x += v.x; y += v.y; z += v.z; return *this; }
+    Vector3& operator-=(const Vector3& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+    Vector3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+};
+
+/**
+ * @struct Vector4
+ * @brief Cuatro floats (coordenadas homogeneas, planos, colores).
+ */
+struct Vector4 {
+    float x, y, z, w;
+
+    Vector4() = default;
+    Vector4(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+    Vector4(const Vector3& v, float w_) : x(v.x), y(v.y), z(v.z), w(w_) {}
+
+    /// Componentes xyz.
+    Vector3 xyz() const { return Vector3(x, y, z); }
+};
+
+inline Vector3 operator+(const Vector3& a, const Vector3& b) { return Vector3(a.x + b.x, a.y + b.y, a.z + b.z); }
+inline Vector3 operator-(const Vector3& a, const Vector3& b) { return Vector3(a.x - b.x, a.y - b.y, a.z - b.z); }
+inline Vector3 operator-(const Vector3& v) { return Vector3(-v.x, -v.y, -v.z); }
+inline Vector3 operator*(const Vector3& v, float s) { return Vector3(v.x * s, v.y * s, v.z * s); }
+inline Vector3 operator*(float s, const Vector3& v) { return v * s; }
+
+inline Vector4 operator+(const Vector4& a, const Vector4& b) { return Vector4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w); }
+inline Vector4 operator-(const Vector4& a, const Vector4& b) { return Vector4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w); }
+inline Vector4 operator*(const Vector4& v, float s) { return Vector4(v.x * s, v.y * s, v.z * s, v.w * s); }
+
+namespace math {
+    inline float dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    inline float dot(const Vector4& a, const Vector4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    /// Producto cruz (igual que XMVector3Cross).
+    inline Vector3 cross(const Vector3& a, const Vector3& b) {
+        return Vector3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+
+    /// Producto componente a componente.
+    inline Vector3 multiply(const Vector3& a, const Vector3& b) { return Vector3(a.x * b.x, a.y * b.y, a.z * b.z); }
+
+    inline float lengthSq(const Vector3& v) { return dot(v, v); }
+    inline float length(const Vector3& v) { return sqrtf(dot(v, v)); }
+
+    /// Vector unitario en la direccion de @p v, o cero si @p v es cero (igual que XMVector3Normalize).
+    inline Vector3 normalize(const Vector3& v) {
+        float len = length(v);
+        return len > 0.0f ? v * (1.0f / len) : Vector3(0.0f, 0.0f, 0.0f);
+    }
+
+    inline Vector3 min(const Vector3& a, const Vector3& b) {
+        return Vector3(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z);
+    }
+    inline Vector3 max(const Vector3& a, const Vector3& b) {
+        return Vector3(a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z);
+    }
+
+    /// a + (b - a) * t.
+    inline Vector3 lerp(const Vector3& a, const Vector3& b, float t) { return a + (b - a) * t; }
+
+    /// Plano (normal, d) dividido por la longitud de la normal (igual que XMPlaneNormalize).
+    inline Vector4 planeNormalize(const Vector4& plane) {
+        float len = length(plane.xyz());
+        return len > 0.0f ? plane * (1.0f / len) : Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    /// Distancia con signo de @p point al plano (igual que XMPlaneDotCoord).
+    inline float planeDotCoord(const Vector4& plane, const Vector3& point) {
+        return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+    }
+}
@@ -0,0 +1,162 @@
+/**
+ * @file VectorBatch.h
+ * @brief Declara Vector3V, QuaternionV y Affine3V: SIMD_LANES vectores procesados a la vez.
+ *
+ * Son las versiones "a lo ancho" (4 lanes con SSE/NEON/escalar, 8 con AVX2) de Vector3,
+ * Quaternion y Matrix4: cada componente es un FloatV con el mismo componente de varios
+ * objetos, cargado directamente de arreglos SoA. Las funciones repiten la semantica de sus
+ * equivalentes escalares, lane por lane.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "Math/Matrix.h"
+#include "Simd.h"
+
+/**
+ * @struct Vector3V
+ * @brief SIMD_LANES vectores de tres componentes (uno por lane).
+ */
+struct Vector3V {
+    simd::FloatV x, y, z;
+};
+
+/**
+ * @struct QuaternionV
+ * @brief SIMD_LANES cuaterniones (uno por lane).
+ */
+struct QuaternionV {
+    simd::FloatV x, y, z, w;
+};
+
+/**
+ * @struct Affine3V
+ * @brief SIMD_LANES matrices afines 4x3 (columna 3 implicita 0, 0, 0, 1).
+ *
+ * m[r * 3 + c] es la fila r, columna c de Matrix4; la fila 3 es la traslacion.
+ */
+struct Affine3V {
+    static const int ELEMENTS = 12;
+    simd::FloatV m[ELEMENTS];
+};
+
+namespace math {
+    /// Carga SIMD_LANES vectores desde tres arreglos SoA.
+    inline Vector3V load(const float* x, const float* y, const float* z) {
+        return Vector3V{ simd::load(x), simd::load(y), simd::load(z) };
+    }
+
+    inline void store(float* x, float* y, float* z, const Vector3V& v) {
+        simd::store(x, v.x);
+        simd::store(y, v.y);
+        simd::store(z, v.z);
+    }
+
+    /// El mismo vector en todas las lanes.
+    inline Vector3V splat(const Vector3& v) {
+        return Vector3V{ simd::set1(v.x), simd::set1(v.y), simd::set1(v.z) };
+    }
+
+    inline Vector3V add(const Vector3V& a, const Vector3V& b) {
+        return Vector3V{ simd::add(a.x, b.x), simd::add(a.y, b.y), simd::add(a.z, b.z) };
+    }
+    inline Vector3V sub(const Vector3V& a, const Vector3V& b) {
+        return Vector3V{ simd::sub(a.x, b.x), simd::sub(a.y, b.y), simd::sub(a.z, b.z) };
+    }
+    inline Vector3V scale(const Vector3V& v, simd::FloatV s) {
+        return Vector3V{ simd::mul(v.x, s), simd::mul(v.y, s), simd::mul(v.z, s) };
+    }
+    /// |x|, |y|, |z| por lane.
+    inline Vector3V abs(const Vector3V& v) {
+        return Vector3V{ simd::abs(v.x), simd::abs(v.y), simd::abs(v.z) };
+    }
+
+    inline simd::FloatV dot(const Vector3V& a, const Vector3V& b) {
+        return simd::madd(a.x, b.x, simd::madd(a.y, b.y, simd::mul(a.z, b.z)));
+    }
+
+    inline Vector3V cross(const Vector3V& a, const Vector3V& b) {
+        return Vector3V{ simd::sub(simd::mul(a.y, b.z), simd::mul(a.z, b.y)),
+                         simd::sub(simd::mul(a.z, b.x), simd::mul(a.x, b.z)),
+                         simd::sub(simd::mul(a.x, b.y), simd::mul(a.y, b.x)) };
+    }
+
+    /// Normaliza cada lane; las lanes con vector cero quedan en cero (igual que normalize()).
+    inline Vector3V normalize(const Vector3V& v) {
+        const simd::FloatV len = simd::sqrt(dot(v, v));
+        const simd::FloatV nonZero = simd::cmpgt(len, simd::zero());
+        const simd::FloatV inv = simd::select(nonZero, simd::div(simd::set1(1.0f), len), simd::zero());
+        return scale(v, inv);
+    }
+
+    /// Distancia con signo de cada lane al plano (igual que planeDotCoord()).
+    inline simd::FloatV planeDotCoord(const Vector4& plane, const Vector3V& p) {
+        return simd::madd(simd::set1(plane.x), p.x,
+               simd::madd(simd::set1(plane.y), p.y, simd::madd(simd::set1(plane.z), p.z, simd::set1(plane.w))));
+    }
+
+    /// Escala * rotacion * traslacion por lane (igual que affineTransformation()).
+    inline Affine3V affineTransformation(const Vector3V& scale, const QuaternionV& rotation, const Vector3V& position) {
+        const simd::FloatV one = simd::set1(1.0f);
+        const simd::FloatV two = simd::set1(2.0f);
+        const simd::FloatV x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+        const simd::FloatV xx = simd::mul(x, x), yy = simd::mul(y, y), zz = simd::mul(z, z);
+        const simd::FloatV xy = simd::mul(x, y), xz = simd::mul(x, z), yz = simd::mul(y, z);
+        const simd::FloatV wx = simd::mul(w, x), wy = simd::mul(w, y), wz = simd::mul(w, z);
+        Affine3V r;
+        r.m[0] = simd::mul(simd::sub(one, simd::mul(two, simd::add(yy, zz))), scale.x);
+        r.m[1] = simd::mul(simd::mul(two, simd::add(xy, wz)), scale.x);
+        r.m[2] = simd::mul(simd::mul(two, simd::sub(xz, wy)), scale.x);
+        r.m[3] = simd::mul(simd::mul(two, simd::sub(xy, wz)), scale.y);
+        r.m[4] = simd::mul(simd::sub(one, simd::mul(two, simd::add(xx, zz))), scale.y);
+        r.m[5] = simd::mul(simd::mul(two, simd::add(yz, wx)), scale.y);
+        r.m[6] = simd::mul(simd::mul(two, simd::add(xz, wy)), scale.z);
+        r.m[7] = simd::mul(simd::mul(two, simd::sub(yz, wx)), scale.z);
+        r.m[8] = simd::mul(simd::sub(one, simd::mul(two, simd::add(xx, yy))), scale.z);
+        r.m[9] = position.x;
+        r.m[10] = position.y;
+        r.m[11] = position.z;
+        return r;
+    }
+
+    /// a * b por lane (igual que multiply() con matrices afines).
+    inline Affine3V multiply(const Affine3V& a, const Affine3V& b) {
+        Affine3V r;
+        for (int row = 0; row < 3; ++row) {
+            for (int c = 0; c < 3; ++c) {
+                r.m[row * 3 + c] = simd::madd(a.m[row * 3], b.m[c],
+                                   simd::madd(a.m[row * 3 + 1], b.m[3 + c], simd::mul(a.m[row * 3 + 2], b.m[6 + c])));
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            r.m[9 + c] = simd::madd(a.m[9], b.m[c],
+                         simd::madd(a.m[10], b.m[3 + c], simd::madd(a.m[11], b.m[6 + c], b.m[9 + c])));
+        }
+        return r;
+    }
+
+    /// La parte afin de @p m en todas las lanes.
+    inline Affine3V splat(const Matrix4& m) {
+        Affine3V r;
+        for (int row = 0; row < 4; ++row) {
+            for (int c = 0; c < 3; ++c) {
+                r.m[row * 3 + c] = simd::set1(m.m[row][c]);
+            }
+        }
+        return r;
+    }
+
+    /// Punto transformado por lane (la division por w no hace falta en una matriz afin).
+    inline Vector3V transformPoint(const Vector3V& p, const Affine3V& m) {
+        return Vector3V{ simd::madd(p.x, m.m[0], simd::madd(p.y, m.m[3], simd::madd(p.z, m.m[6], m.m[9]))),
+                         simd::madd(p.x, m.m[1], simd::madd(p.y, m.m[4], simd::madd(p.z, m.m[7], m.m[10]))),
+                         simd::madd(p.x, m.m[2], simd::madd(p.y, m.m[5], simd::madd(p.z, m.m[8], m.m[11]))) };
+    }
+
+    /// Direccion transformada por lane, sin traslacion (igual que transformNormal()).
+    inline Vector3V transformNormal(const Vector3V& n, const Affine3V& m) {
+        return Vector3V{ simd::madd(n.x, m.m[0], simd::madd(n.y, m.m[3], simd::mul(n.z, m.m[6]))),
+                         simd::madd(n.x, m.m[1], simd::madd(n.y, m.m[4], simd::mul(n.z, m.m[7]))),
+                         simd::madd(n.x, m.m[2], simd::madd(n.y, m.m[5], simd::mul(n.z, m.m[8]))) };
+    }
+}
@@ -1,8 +1,20 @@
 #pragma once
-#include "Prerequisites.h"
-//#include "ECS\Component.h"
+#include "CorePrerequisites.h"
+#include "ECS/Component.h"
 class DeviceContext;
 
+/**
+ * @struct SubMesh
+ * @brief Rango de ndices de un grupo del modelo ("o"/"g" en OBJ) con sus volmenes envolventes.
+ */
+struct SubMesh {
+    std::string    name;        ///< Nombre del grupo.
+    unsigned int   startIndex;  ///< Primer ndice dentro de MeshComponent::m_index.
+    unsigned int   indexCount;  ///< Nmero de ndices del grupo.
+    AABB           bounds;      ///< Caja envolvente en espacio local.
+    BoundingSphere sphere;      ///< Esfera envolvente en espacio local.
+};
+
 /**
  * @class MeshComponent
  * @brief Componente ECS que almacena la geometra (malla) de un actor.
@@ -11,25 +23,39 @@ class DeviceContext;
  *
  * @author Hannin
  */
-class MeshComponent /*: public Component*/ {
+class MeshComponent : public Component {
 public:
     /// Constructor por defecto.
-    MeshComponent() : m_numVertex(0), m_numIndex(0)/*, Component(ComponentType::MESH)*/ {}
+    MeshComponent() : Component(ComponentType::MESH), m_numVertex(0), m_numIndex(0), m_bounds(), m_sphere() {}
 
     /// Destructor por defecto.
     virtual ~MeshComponent() = default;
 
+    MeshComponent(const MeshComponent&) = default;
+    MeshComponent& operator=(const MeshComponent&) = default;
+
+    /// Movible para que World pueda cambiarla de arquetipo sin copiar la geometra.
+    MeshComponent(MeshComponent&&) = default;
+    MeshComponent& operator=(MeshComponent&&) = default;
+
     /// Inicializa el componente de malla (placeholder).
-    void init() /*override {}*/;
+    void init() override {}
 
     /// Actualiza la malla (placeholder).
-    void update(float deltaTime)/* override {}*/;
+    void update(float deltaTime) override {}
 
-    /// Renderiza la malla mediante el contexto del dispositivo.
-    void render(DeviceContext& deviceContext) /*override {}*/;
+    /// Renderiza la malla (placeholder; BaseApp dibuja cada submalla visible).
+    void render(DeviceContext& deviceContext) override {}
 
     /// Libera los recursos asociados (placeholder).
-    void destroy() /*override {}*/;
+    void destroy() override {}
+
+    /**
+     * @brief Calcula la caja y la esfera envolventes de la malla y de cada submalla.
+     *
+     * Si no hay submallas registradas se crea una que cubre todos los ndices.
+     */
+    void computeBounds();
 
 public:
     std::string m_name;                  ///< Nombre de la malla.
@@ -37,4 +63,7 @@ public:
     std::vector<unsigned int> m_index;   ///< Lista de ndices.
     int m_numVertex;                     ///< Total de vrtices.
     int m_numIndex;                      ///< Total de ndices.
+    std::vector<SubMesh> m_subMeshes;    ///< Grupos de ndices del modelo.
+    AABB m_bounds;                       ///< Caja envolvente en espacio local.
+    BoundingSphere m_sphere;             ///< Esfera envolvente en espacio local.
 };
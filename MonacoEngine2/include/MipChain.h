@@ -0,0 +1,104 @@
+/**
+ * @file MipChain.h
+ * @brief Declara la clase MipChain, generacion en CPU de la cadena de mipmaps de una imagen RGBA8.
+ *
+ * Cada nivel se filtra desde el anterior en espacio lineal: los canales RGB se convierten de
+ * sRGB a lineal, se filtran de forma separable (vertical y luego horizontal) con FloatV/Float4 y
+ * se vuelven a codificar en sRGB; el nivel siguiente parte de una copia lineal de 16 bits para
+ * no acumular el error de cuantizacion de 8 bits. Los tamanos que no son potencia de dos usan
+ * pesos por area cubierta (3 texeles por eje cuando la dimension es impar).
+ *
+ * Con alphaCoverageCutoff > 0 el alfa de cada nivel se escala para conservar la fraccion de
+ * pixeles que pasan la prueba de alfa del nivel 0, y el follaje no se adelgaza a distancia.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Image.h"
+
+class JobSystem;
+
+/**
+ * @enum MipFilter
+ * @brief Filtro de reduccion entre niveles.
+ */
+enum class MipFilter {
+    Box,    ///< Promedio por area (2x2, o 3 texeles en ejes impares). El mas rapido.
+    Kaiser  ///< Sinc con ventana de Kaiser (radio 3, alfa 4): mas nitido, sin aliasing.
+};
+
+/**
+ * @struct MipSettings
+ * @brief Opciones de MipChain::generate().
+ */
+struct MipSettings {
+    MipFilter filter = MipFilter::Box;  ///< Filtro de reduccion.
+    bool srgb = true;                   ///< RGB en sRGB (color); @c false para datos lineales (normales, mascaras).
+    float alphaCoverageCutoff = 0.0f;   ///< Umbral de la prueba de alfa a conservar; 0 lo desactiva.
+    unsigned int maxLevels = 0;         ///< Niveles maximos incluyendo el 0; 0 = hasta 1x1.
+    JobSystem* jobs = nullptr;          ///< Pool para repartir las filas; nullptr = hilo actual.
+};
+
+/**
+ * @class MipChain
+ * @brief Niveles de mipmap RGBA8, del 0 (la imagen original) al mas pequeno.
+ */
+class MipChain {
+public:
+    MipChain() = default;
+    ~MipChain() = default;
+
+    // Movible: DecodedImage la entrega por la cola sin copiar los niveles.
+    MipChain(const MipChain&) = default;
+    MipChain& operator=(const MipChain&) = default;
+    MipChain(MipChain&&) = default;
+    MipChain& operator=(MipChain&&) = default;
+
+    /**
+     * @brief Genera la cadena completa a partir de @p base.
+     * @param base     Nivel 0 RGBA8; se mueve a la cadena (usar std::move para evitar la copia).
+     * @param settings Filtro, espacio de color y alfa.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si la imagen esta vacia o no es RGBA8.
+     */
+    HRESULT generate(Image base, const MipSettings& settings = MipSettings());
+
+    /**
+     * @brief Genera los niveles 1 en adelante sobre memoria del llamador, sin reservar nada.
+     *
+     * Es lo que usa generate(); sirve para escribir la cadena directo en la memoria de subida
+     * (ver UploadArena). settings.maxLevels no se usa: manda @p levelCount.
+     * @param levels     Vistas RGBA8; levels[0] ya trae la imagen y cada una mide la mitad
+     *                   (redondeada abajo, minimo 1) de la anterior.
+     * @param levelCount Niveles, incluido el 0.
+     * @param scratch    Al menos scratchBytes() bytes alineados a 2 (nullptr con dos niveles o menos).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si los tamanos no forman una cadena.
+     */
+    static HRESULT generateInto(const ImageView* levels, unsigned int levelCount, void* scratch,
+                                const MipSettings& settings = MipSettings());
+
+    /// Memoria de trabajo (lineal de 16 bits) que necesita generateInto().
+    static size_t scratchBytes(unsigned int width, unsigned int height, unsigned int levelCount);
+
+    /// Libera todos los niveles.
+    void destroy() { m_levels.clear(); }
+
+    /// Numero de niveles generados.
+    unsigned int getLevelCount() const { return static_cast<unsigned int>(m_levels.size()); }
+
+    /// Nivel @p level (0 = mas grande).
+    const Image& getLevel(unsigned int level) const { return m_levels[level]; }
+
+    /// @c true si no hay niveles.
+    bool empty() const { return m_levels.empty(); }
+
+    /// Niveles para una textura de @p width x @p height hasta 1x1.
+    static unsigned int fullLevelCount(unsigned int width, unsigned int height);
+
+    /// Fraccion de pixeles de @p image cuyo alfa supera @p cutoff (0 a 1).
+    static float alphaCoverage(const Image& image, float cutoff);
+    static float alphaCoverage(const ImageView& image, float cutoff);
+
+public:
+    std::vector<Image> m_levels; ///< Niveles RGBA8, cada uno de la mitad (redondeada abajo) del anterior.
+};
@@ -1,9 +1,8 @@
 #pragma once
-#include "Prerequisites.h"
+#include "CorePrerequisites.h"
 
 // Declaraciones anticipadas
 class MeshComponent;
-class Device;
 
 /**
  * @class ModelLoader
@@ -38,9 +37,9 @@ private:
     void parseFace(std::stringstream& ss,
                     std::vector<SimpleVertex>& out_vertices,
                     std::vector<unsigned int>& out_indices,
-                    const std::vector<XMFLOAT3>& temp_positions,
-                    const std::vector<XMFLOAT2>& temp_texcoords,
-                    const std::vector<XMFLOAT3>& temp_normals,
+                    const std::vector<Vector3>& temp_positions,
+                    const std::vector<Vector2>& temp_texcoords,
+                    const std::vector<Vector3>& temp_normals,
                     std::map<std::string, unsigned int>& vertexMap,
                     bool invertTexCoordY);
 
@@ -49,9 +48,9 @@ private:
      */
     unsigned int parseVertexCombo(const std::string& comboToken,
                                     std::vector<SimpleVertex>& out_vertices,
-                                    const std::vector<XMFLOAT3>& temp_positions,
-                                    const std::vector<XMFLOAT2>& temp_texcoords,
-                                    const std::vector<XMFLOAT3>& temp_normals,
+                                    const std::vector<Vector3>& temp_positions,
+                                    const std::vector<Vector2>& temp_texcoords,
+                                    const std::vector<Vector3>& temp_normals,
                                     std::map<std::string, unsigned int>& vertexMap,
                                     bool invertTexCoordY);
 };
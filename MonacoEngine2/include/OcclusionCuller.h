@@ -0,0 +1,149 @@
+/**
+ * @file OcclusionCuller.h
+ * @brief Declara la clase OcclusionCuller, culling por oclusion con un depth buffer de software.
+ *
+ * Las mallas marcadas como oclusores se rasterizan en CPU en un depth buffer de baja resolucion
+ * usando mascaras de cobertura SIMD (AVX2: 8 pixeles, SSE: 4 pixeles). Sobre ese buffer se
+ * construye una jerarquia (Hi-Z) con la profundidad maxima por bloque de 8x8 pixeles, y contra
+ * ella se prueban las cajas (AABB) de los objetos antes de enviar sus draws.
+ *
+ * La prueba es conservadora: un objeto solo se descarta si todos los pixeles que cubre su caja
+ * tienen un oclusor mas cercano que el punto mas cercano de la caja.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+
+class JobSystem;
+class MeshComponent;
+
+/**
+ * @struct OcclusionStats
+ * @brief Tiempos y contadores del ultimo frame de culling.
+ */
+struct OcclusionStats {
+    double setupMs = 0.0;                 ///< Transformacion y setup de triangulos oclusores.
+    double rasterMs = 0.0;                ///< Rasterizacion de oclusores y construccion del Hi-Z.
+    double testMs = 0.0;                  ///< Pruebas de visibilidad de cajas.
+    unsigned int occluders = 0;           ///< Mallas oclusoras del frame.
+    unsigned int occluderTriangles = 0;   ///< Triangulos oclusores rasterizados.
+    unsigned int objectsTested = 0;       ///< Cajas probadas.
+    unsigned int objectsCulled = 0;       ///< Cajas ocultas.
+};
+
+/**
+ * @class OcclusionCuller
+ * @brief Depth buffer jerarquico de baja resolucion para descartar objetos ocultos.
+ *
+ * Uso por frame: update() -> addOccluder() x N -> render() -> isVisible()/testVisibility().
+ */
+class OcclusionCuller {
+public:
+    /// Resolucion por defecto del depth buffer.
+    static const unsigned int DEFAULT_WIDTH = 320;
+    static const unsigned int DEFAULT_HEIGHT = 192;
+
+    /// Lado del bloque del Hi-Z en pixeles.
+    static const unsigned int BLOCK_SIZE = 8;
+
+    OcclusionCuller() = default;
+    ~OcclusionCuller() = default;
+
+    /**
+     * @brief Reserva el depth buffer y el Hi-Z.
+     * @param width     Ancho en pixeles (se redondea a multiplo de BLOCK_SIZE).
+     * @param height    Alto en pixeles (se redondea a multiplo de BLOCK_SIZE).
+     * @param jobSystem Pool de hilos para setup, rasterizado y pruebas.
+     */
+    HRESULT init(unsigned int width, unsigned int height, JobSystem& jobSystem);
+
+    /**
+     * @brief Comienza un frame: guarda View * Projection y descarta los oclusores anteriores.
+     * @param viewProjection Matriz View * Projection (sin transponer).
+     */
+    void update(const Matrix4& viewProjection);
+
+    /**
+     * @brief Registra una malla como oclusor para este frame.
+     * @param mesh  Malla oclusora (debe seguir viva hasta render()).
+     * @param world Matriz de mundo de la malla.
+     */
+    void addOccluder(const MeshComponent& mesh, const Matrix4& world);
+
+    /**
+     * @brief Registra como oclusor solo un rango de indices de la malla (una submalla).
+     * @param mesh       Malla oclusora (debe seguir viva hasta render()).
+     * @param world      Matriz de mundo de la malla.
+     * @param startIndex Primer indice del rango.
+     * @param indexCount Numero de indices del rango.
+     */
+    void addOccluder(const MeshComponent& mesh, const Matrix4& world,
+                     unsigned int startIndex, unsigned int indexCount);
+
+    /// Rasteriza los oclusores registrados y construye el Hi-Z.
+    void render();
+
+    /**
+     * @brief Prueba una caja en espacio de mundo contra el depth buffer.
+     * @return @c false si la caja esta completamente oculta.
+     */
+    bool isVisible(const AABB& worldBox) const;
+
+    /**
+     * @brief Prueba muchas cajas en paralelo y actualiza los contadores.
+     * @param boxes   Cajas en espacio de mundo.
+     * @param count   Numero de cajas.
+     * @param visible Salida: 1 si la caja es visible, 0 si esta oculta.
+     * @return Numero de cajas visibles.
+     */
+    unsigned int testVisibility(const AABB* boxes, unsigned int count, std::vector<unsigned char>& visible);
+
+    /// Libera los buffers.
+    void destroy();
+
+    /// Estadisticas del ultimo frame.
+    const OcclusionStats& getStats() const { return m_stats; }
+
+    /// Depth buffer rasterizado (para depuracion), @c getWidth() x @c getHeight().
+    const std::vector<float>& getDepthBuffer() const { return m_depth; }
+
+    unsigned int getWidth() const { return m_width; }
+    unsigned int getHeight() const { return m_height; }
+
+private:
+    struct Occluder {
+        const MeshComponent* mesh;
+        Matrix4 worldViewProj;
+        unsigned int startIndex;
+        unsigned int indexCount;
+    };
+
+    /// Triangulo o quad convexo listo para rasterizar (los triangulos repiten una arista neutra).
+    struct OccluderTriangle {
+        float edgeA[4], edgeB[4], edgeC[4];
+        float z[3];                     ///< Plano de z/w.
+        int minX, minY, maxX, maxY;
+    };
+
+    /// Transforma y arma los triangulos de un oclusor.
+    void setupOccluder(const Occluder& occluder, std::vector<OccluderTriangle>& out) const;
+
+    /// Rasteriza todos los triangulos en las filas [rowBegin, rowEnd).
+    void rasterizeRows(unsigned int rowBegin, unsigned int rowEnd);
+
+private:
+    unsigned int m_width = 0;
+    unsigned int m_height = 0;
+    unsigned int m_blocksX = 0;
+    unsigned int m_blocksY = 0;
+    JobSystem* m_jobSystem = nullptr;
+
+    Matrix4 m_viewProj = Matrix4::identity();               ///< View * Projection del frame.
+    std::vector<Occluder> m_occluders;                      ///< Oclusores del frame.
+    std::vector<std::vector<OccluderTriangle>> m_triangles; ///< Triangulos por oclusor.
+    std::vector<float> m_depth;                             ///< Profundidad mas cercana por pixel.
+    std::vector<float> m_hiZ;                               ///< Profundidad maxima por bloque.
+
+    OcclusionStats m_stats;
+};
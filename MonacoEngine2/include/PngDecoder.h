@@ -0,0 +1,29 @@
+/**
+ * @file PngDecoder.h
+ * @brief Declara la clase PngDecoder, decodificador PNG rapido para texturas grandes.
+ *
+ * Inflate propio con tablas de un solo acceso para los codigos de hasta 10 bits, buffer de
+ * bits de 64 bits que se recarga con una sola lectura y copias de coincidencias de 8 bytes a la
+ * vez. La reconstruccion de filtros esta especializada por bytes por pixel (1 a 4), y Paeth usa
+ * la forma sin saltos. Inflate y filtros son secuenciales por naturaleza; el JobSystem solo
+ * reparte la expansion final a RGBA.
+ *
+ * Cubre 8 bits por canal sin entrelazado (gris, gris + alfa, RGB, RGBA y paleta, con tRNS);
+ * 16 bits, 1/2/4 bits y Adam7 devuelven @c E_NOTIMPL y pasan a stb_image.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "ImageDecoder.h"
+
+/**
+ * @class PngDecoder
+ * @brief PNG de 8 bits por canal a RGBA8.
+ */
+class PngDecoder : public ImageDecoder {
+public:
+    const char* getName() const override { return "png"; }
+    bool canDecode(const unsigned char* data, size_t size) const override;
+    HRESULT getInfo(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height) const override;
+    HRESULT decodeInto(const unsigned char* data, size_t size, const ImageView& target, JobSystem* jobs) const override;
+};
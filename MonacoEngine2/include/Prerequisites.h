@@ -1,16 +1,10 @@
 #pragma once
 
 // ============================================================================
-// Libreras estndar
+// Nucleo portable (librerias estandar, HRESULT, matematica, estructuras base)
 // ============================================================================
-#include <string>
-#include <sstream>
-#include <vector>
-#include <windows.h>
+#include "CorePrerequisites.h"
 #include <xnamath.h>
-#include <thread>
-#include <fstream> // Lectura de archivos (.obj, etc.)
-#include <map>     // Mapa para evitar duplicar vrtices
 
 // ============================================================================
 // Libreras DirectX
@@ -28,39 +22,10 @@
 /** Libera un recurso COM de forma segura. */
 #define SAFE_RELEASE(x) if(x != nullptr) x->Release(); x = nullptr;
 
-/** Muestra mensaje de creacin de recurso en la consola de depuracin. */
-#define MESSAGE(classObj, method, state)    \
-{                                           \
-   std::wostringstream os_;                 \
-   os_ << classObj << "::" << method        \
-       << " : " << "[CREATION OF RESOURCE : " << state << "]\n"; \
-   OutputDebugStringW(os_.str().c_str());   \
-}
-
-/** Muestra un mensaje de error formateado en la consola de depuracin. */
-#define ERROR(classObj, method, errorMSG)                     \
-{                                                             \
-    try {                                                     \
-        std::wostringstream os_;                              \
-        os_ << L"ERROR : " << classObj << L"::" << method     \
-            << L" : " << errorMSG << L"\n";                   \
-        OutputDebugStringW(os_.str().c_str());                \
-    } catch (...) {                                           \
-        OutputDebugStringW(L"Failed to log error message.\n");\
-    }                                                         \
-}
-
 // ============================================================================
 // Estructuras base
 // ============================================================================
 
-/** Vrtice simple con posicin, textura y normal. */
-struct SimpleVertex {
-    XMFLOAT3 Pos;
-    XMFLOAT2 Tex;
-    XMFLOAT3 Norm;
-};
-
 /** Constantes para vista. */
 struct CBNeverChanges {
     XMMATRIX mView;
@@ -81,13 +46,6 @@ struct CBChangesEveryFrame {
 // Enumeraciones
 // ============================================================================
 
-/** Tipos de extensin soportados. */
-enum ExtensionType {
-    DDS = 0,
-    PNG = 1,
-    JPG = 2
-};
-
 /** Tipos de shader. */
 enum ShaderType {
     VERTEX_SHADER = 0,
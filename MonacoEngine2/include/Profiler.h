@@ -0,0 +1,92 @@
+/**
+ * @file Profiler.h
+ * @brief Declara la clase Profiler para medir tiempos por etapa y contadores del motor.
+ *
+ * Los sistemas de CPU (rasterizador por software, culling, jobs, etc.) registran aqui
+ * sus tiempos y contadores. Es seguro llamarlo desde varios hilos.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include <chrono>
+#include <mutex>
+
+/**
+ * @class Profiler
+ * @brief Acumula muestras de tiempo (ms) y contadores con nombre.
+ *
+ * Cada muestra guarda ultimo valor, minimo, maximo, promedio y numero de llamadas.
+ * Los contadores son enteros que se pueden sumar o asignar por frame.
+ */
+class Profiler {
+public:
+    /**
+     * @brief Estadisticas acumuladas de una muestra de tiempo.
+     */
+    struct Sample {
+        double last = 0.0;          ///< Ultima medicion en ms.
+        double total = 0.0;         ///< Suma de todas las mediciones en ms.
+        double min = 0.0;           ///< Medicion minima en ms.
+        double max = 0.0;           ///< Medicion maxima en ms.
+        unsigned long long calls = 0; ///< Numero de mediciones.
+
+        /// Promedio en ms (0 si no hay mediciones).
+        double average() const { return calls ? total / calls : 0.0; }
+    };
+
+    Profiler() = default;
+    ~Profiler() = default;
+
+    /// Instancia global usada por los sistemas del motor.
+    static Profiler& instance();
+
+    /// Registra una medicion de tiempo en milisegundos.
+    void addSample(const std::string& name, double milliseconds);
+
+    /// Suma @p value al contador indicado.
+    void addCounter(const std::string& name, long long value);
+
+    /// Asigna @p value al contador indicado (valores por frame).
+    void setCounter(const std::string& name, long long value);
+
+    /// Devuelve la muestra indicada (vacia si no existe).
+    Sample getSample(const std::string& name) const;
+
+    /// Devuelve el valor del contador indicado (0 si no existe).
+    long long getCounter(const std::string& name) const;
+
+    /// Genera un reporte de texto con todas las muestras y contadores.
+    std::string report() const;
+
+    /// Borra todas las muestras y contadores.
+    void reset();
+
+    /// Tiempo actual en milisegundos, usado para medir etapas.
+    static double now();
+
+private:
+    mutable std::mutex m_mutex;                   ///< Protege los mapas.
+    std::map<std::string, Sample> m_samples;      ///< Muestras de tiempo por nombre.
+    std::map<std::string, long long> m_counters;  ///< Contadores por nombre.
+};
+
+/**
+ * @class ScopedTimer
+ * @brief Mide el tiempo de un bloque y lo registra en el Profiler al salir de el.
+ */
+class ScopedTimer {
+public:
+    ScopedTimer(const char* name, Profiler& profiler = Profiler::instance())
+        : m_name(name), m_profiler(profiler), m_start(Profiler::now()) {}
+
+    ~ScopedTimer() { m_profiler.addSample(m_name, Profiler::now() - m_start); }
+
+    /// Milisegundos transcurridos desde la creacion.
+    double elapsed() const { return Profiler::now() - m_start; }
+
+private:
+    const char* m_name;
+    Profiler& m_profiler;
+    double m_start;
+};
@@ -0,0 +1,164 @@
+/**
+ * @file ResourceCache.h
+ * @brief Declara la clase ResourceCache, cache de recursos por ruta y contenido con conteo de
+ *        referencias y expulsion LRU.
+ *
+ * Cada entrada guarda un recurso opaco (por ejemplo una vista de textura de GPU), su tamano en
+ * bytes y el hash de los bytes del archivo del que salio. Se encuentra por ruta o, si la ruta es
+ * nueva, por hash de contenido: dos archivos identicos con nombres distintos comparten el mismo
+ * recurso. Las entradas sin referencias quedan residentes en una lista LRU y se liberan, de la
+ * menos usada a la mas reciente, cuando el total supera el presupuesto. Las entradas con
+ * referencias nunca se expulsan, aunque el presupuesto se exceda.
+ *
+ * No depende de Direct3D: TextureCache la usa para las texturas de la aplicacion.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+/**
+ * @struct ResourceHandle
+ * @brief Referencia a una entrada de ResourceCache (indice + generacion).
+ */
+struct ResourceHandle {
+    /// Indice invalido.
+    static const unsigned int INVALID_INDEX = 0xffffffffu;
+
+    unsigned int index = INVALID_INDEX;     ///< Posicion en la tabla de entradas.
+    unsigned int generation = 0;            ///< Version del indice; cambia al expulsar la entrada.
+
+    /// @c true si el handle salio de una busqueda exitosa (la entrada pudo expulsarse despues).
+    bool isValid() const { return index != INVALID_INDEX; }
+
+    bool operator==(const ResourceHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const ResourceHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * @struct ResourceCacheStats
+ * @brief Contadores acumulados desde init() y estado actual.
+ */
+struct ResourceCacheStats {
+    unsigned long long hits = 0;        ///< acquire() resueltos por ruta.
+    unsigned long long contentHits = 0; ///< acquireContent() resueltos: otra ruta con el mismo contenido.
+    unsigned long long misses = 0;      ///< Recursos creados y registrados con insert().
+    unsigned long long evictions = 0;   ///< Entradas liberadas por el presupuesto.
+    size_t residentBytes = 0;           ///< Suma de los tamanos de las entradas vivas.
+    size_t budgetBytes = 0;             ///< Presupuesto configurado.
+    unsigned int entries = 0;           ///< Entradas vivas.
+    unsigned int referenced = 0;        ///< Entradas vivas con al menos una referencia.
+};
+
+/**
+ * @class ResourceCache
+ * @brief Recursos compartidos con referencias contadas y expulsion LRU por presupuesto.
+ *
+ * No es segura entre hilos: se usa desde el hilo que crea los recursos.
+ */
+class ResourceCache {
+public:
+    /// Libera el recurso de una entrada expulsada o destruida.
+    typedef std::function<void(void* resource)> ReleaseFunction;
+
+    ResourceCache() = default;
+    ~ResourceCache() { destroy(); }
+
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    /**
+     * @brief Prepara la cache vacia.
+     * @param budgetBytes Bytes maximos de entradas sin referencias que se conservan.
+     * @param release     Se llama con el recurso de cada entrada que sale de la cache.
+     */
+    void init(size_t budgetBytes, ReleaseFunction release);
+
+    /// Libera todas las entradas, tengan referencias o no.
+    void destroy();
+
+    /**
+     * @brief Busca @p path y, si esta, suma una referencia.
+     * @return Handle de la entrada, o uno invalido si hay que crear el recurso.
+     */
+    ResourceHandle acquire(const std::string& path);
+
+    /**
+     * @brief Busca un recurso con el mismo contenido; si esta, registra @p path como alias y
+     *        suma una referencia.
+     * @param contentHash Valor de hashContent() de los bytes del archivo.
+     */
+    ResourceHandle acquireContent(uint64_t contentHash, const std::string& path);
+
+    /**
+     * @brief Registra un recurso nuevo con una referencia y aplica el presupuesto.
+     * @param contentHash Hash del archivo, o 0 si no se conoce (no se podra encontrar por contenido).
+     * @param bytes       Memoria que ocupa (VRAM en el caso de texturas).
+     */
+    ResourceHandle insert(const std::string& path, uint64_t contentHash, void* resource, size_t bytes);
+
+    /// Suma una referencia a una entrada viva.
+    void addRef(ResourceHandle handle);
+
+    /// Resta una referencia; sin referencias la entrada pasa al final de la lista LRU.
+    void release(ResourceHandle handle);
+
+    /// Recurso de @p handle, o nullptr si la entrada ya no existe.
+    void* getResource(ResourceHandle handle) const;
+
+    /// Referencias de @p handle (0 si la entrada ya no existe).
+    unsigned int getRefCount(ResourceHandle handle) const;
+
+    /// Cambia el presupuesto y expulsa lo que sobre.
+    void setBudget(size_t budgetBytes);
+
+    /**
+     * @brief Expulsa entradas sin referencias, de la menos usada en adelante, hasta quedar
+     *        dentro del presupuesto.
+     * @return Bytes liberados.
+     */
+    size_t trim();
+
+    const ResourceCacheStats& getStats() const { return m_stats; }
+
+    /// Publica los contadores en el Profiler como "<prefix>::hits", "<prefix>::residentBytes", etc.
+    void publishCounters(const std::string& prefix) const;
+
+    /// Hash de 64 bits de @p size bytes (nunca 0). Procesa 8 bytes por paso.
+    static uint64_t hashContent(const void* data, size_t size);
+
+private:
+    struct Entry {
+        void* resource = nullptr;
+        size_t bytes = 0;
+        uint64_t contentHash = 0;
+        unsigned int refCount = 0;
+        unsigned int generation = 0;
+        bool alive = false;
+        std::vector<std::string> paths;         ///< Rutas que apuntan a la entrada.
+        std::list<unsigned int>::iterator lru;  ///< Posicion en m_lru si refCount == 0.
+    };
+
+    /// Entrada viva de @p handle, o nullptr.
+    Entry* find(ResourceHandle handle);
+    const Entry* find(ResourceHandle handle) const;
+
+    /// Suma una referencia a la entrada @p index y la saca de la lista LRU si estaba.
+    ResourceHandle reference(unsigned int index);
+
+    /// Libera la entrada @p index y recicla su indice.
+    void evict(unsigned int index);
+
+    std::vector<Entry> m_entries;
+    std::vector<unsigned int> m_freeIndices;
+    std::unordered_map<std::string, unsigned int> m_byPath;
+    std::unordered_map<uint64_t, unsigned int> m_byContent;
+    std::list<unsigned int> m_lru;              ///< Entradas sin referencias; la primera es la menos usada.
+    ReleaseFunction m_release;
+    ResourceCacheStats m_stats;
+};
@@ -0,0 +1,134 @@
+/**
+ * @file ShaderCache.h
+ * @brief Declara la clase ShaderCache, cache en disco del bytecode compilado de los shaders.
+ *
+ * Compilar HLSL con D3DX11CompileFromFile cuesta cientos de milisegundos por shader en cada
+ * arranque. La cache guarda el bytecode bajo una clave de 64 bits que cubre todo lo que cambia
+ * el resultado de la compilacion:
+ *  - el texto del archivo y, recursivamente, el de cada @c #include "..." que encuentre;
+ *  - el punto de entrada, el perfil (vs_4_0, ps_4_0...) y las banderas de compilacion;
+ *  - los defines (ordenados por nombre: el orden en que se pasan no cambia la clave);
+ *  - la version del compilador indicada en init().
+ * Editar cualquier archivo incluido produce otra clave, asi que nunca se carga un bytecode
+ * viejo; las entradas que ya no se usan se quedan en disco hasta clear().
+ *
+ * Cada entrada es un archivo @c <clave>.cso con una cabecera (clave, version del compilador,
+ * tamano y hash del bytecode) que se valida al cargar: un archivo truncado o ajeno cuenta como
+ * fallo y se borra. store() escribe a un temporal y lo renombra, para que otro proceso nunca
+ * lea una entrada a medias. No depende de Direct3D: el hash y el indice se prueban en Linux.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @struct ShaderDefine
+ * @brief Macro de preprocesador para la compilacion (D3D_SHADER_MACRO).
+ */
+struct ShaderDefine {
+    std::string name;
+    std::string value;
+};
+
+/**
+ * @struct ShaderCompileDesc
+ * @brief Todo lo que define una compilacion de un shader.
+ */
+struct ShaderCompileDesc {
+    std::string fileName;               ///< Archivo HLSL raiz.
+    std::string entryPoint;             ///< Funcion de entrada ("VS", "PS"...).
+    std::string profile;                ///< Perfil de destino ("vs_4_0", "ps_4_0"...).
+    std::vector<ShaderDefine> defines;  ///< Macros adicionales.
+    uint32_t flags = 0;                 ///< Banderas D3DCOMPILE_*.
+};
+
+/**
+ * @struct ShaderCacheStats
+ * @brief Contadores acumulados desde init().
+ */
+struct ShaderCacheStats {
+    unsigned long long hits = 0;        ///< load() que devolvieron bytecode.
+    unsigned long long misses = 0;      ///< load() sin entrada (hay que compilar).
+    unsigned long long rejected = 0;    ///< Entradas danadas o de otra version, borradas al cargar.
+    unsigned long long stores = 0;      ///< Entradas escritas con store().
+    unsigned long long bytesLoaded = 0;
+    unsigned long long bytesStored = 0;
+    double hashMs = 0.0;                ///< Tiempo en computeKey() (lectura y hash de las fuentes).
+    double loadMs = 0.0;                ///< Tiempo en load().
+};
+
+/**
+ * @class ShaderCache
+ * @brief Bytecode de shaders en disco por clave de fuente + opciones. Seguro entre hilos.
+ */
+class ShaderCache {
+public:
+    ShaderCache() = default;
+    ~ShaderCache() = default;
+
+    ShaderCache(const ShaderCache&) = delete;
+    ShaderCache& operator=(const ShaderCache&) = delete;
+
+    /**
+     * @brief Abre (o crea) el directorio de la cache y lee el indice de las entradas existentes.
+     * @param directory       Carpeta de la cache.
+     * @param compilerVersion Version del compilador (p. ej. D3D_COMPILER_VERSION); forma parte
+     *                        de la clave y de la cabecera, asi que cambiarla invalida todo.
+     * @return @c S_OK si fue exitoso; @c E_FAIL si el directorio no se pudo crear.
+     */
+    HRESULT init(const std::string& directory, uint64_t compilerVersion = 0);
+
+    /// Olvida el indice (los archivos se quedan en disco).
+    void destroy();
+
+    /**
+     * @brief Clave de la compilacion @p desc.
+     * @param dependencies Recibe el archivo raiz y cada include encontrado, en orden (opcional).
+     * @return La clave; 0 si el archivo raiz no se pudo leer.
+     */
+    uint64_t computeKey(const ShaderCompileDesc& desc, std::vector<std::string>* dependencies = nullptr);
+
+    /**
+     * @brief Lee el bytecode de @p key.
+     * @return @c true si estaba y su cabecera es valida; @c false cuenta como fallo.
+     */
+    bool load(uint64_t key, std::vector<unsigned char>& bytecode);
+
+    /**
+     * @brief Guarda el bytecode compilado de @p key (reemplaza una entrada previa).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG sin datos o con clave 0; @c E_FAIL si no se pudo escribir.
+     */
+    HRESULT store(uint64_t key, const void* bytecode, size_t size);
+
+    /// @c true si el indice tiene una entrada para @p key.
+    bool contains(uint64_t key) const;
+
+    /// Borra todas las entradas del disco y del indice.
+    void clear();
+
+    /// Entradas en el indice.
+    size_t getEntryCount() const;
+
+    /// Bytes de bytecode de todas las entradas.
+    unsigned long long getTotalBytes() const;
+
+    ShaderCacheStats getStats() const;
+
+    /// Publica los contadores en el Profiler con el prefijo @p prefix.
+    void publishCounters(const std::string& prefix) const;
+
+    /// Nombre del archivo de @p key dentro del directorio ("<16 digitos hex>.cso").
+    static std::string entryFileName(uint64_t key);
+
+private:
+    std::string entryPath(uint64_t key) const;
+
+    std::string m_directory;
+    uint64_t m_compilerVersion = 0;
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, unsigned long long> m_index;  ///< Clave -> bytes de bytecode.
+    ShaderCacheStats m_stats;
+};
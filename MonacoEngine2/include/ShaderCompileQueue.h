@@ -0,0 +1,119 @@
+/**
+ * @file ShaderCompileQueue.h
+ * @brief Declara la clase ShaderCompileQueue, compilacion de shaders en los hilos del JobSystem.
+ *
+ * Cada solicitud se convierte en una tarea que busca el bytecode en la ShaderCache y, si no
+ * esta, lo compila y lo guarda, fuera del hilo que la pidio. Los resultados quedan en una cola
+ * que el hilo principal vacia con pop() (ver ShaderProgramQueue, que crea los shaders de GPU y
+ * los cambia entre frames). Igual que ImageDecodeQueue, pero para bytecode.
+ *
+ * Cada compilacion se registra en el Profiler como la muestra "ShaderCompile::<archivo>:<entrada>"
+ * (con sus defines), y publishCounters() publica la profundidad de la cola.
+ * No depende de Direct3D: el compilador llega como ShaderLibrary::CompileFunc.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "JobSystem.h"
+#include "ShaderLibrary.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+/**
+ * @struct CompiledShader
+ * @brief Resultado de una solicitud de ShaderCompileQueue.
+ */
+struct CompiledShader {
+    unsigned int ticket = 0;                ///< Valor devuelto por request().
+    ShaderCompileDesc desc;                 ///< Lo que se pidio compilar.
+    HRESULT result = S_OK;                  ///< El error del compilador si fallo.
+    std::vector<unsigned char> bytecode;    ///< Bytecode si result tuvo exito.
+    bool fromCache = false;                 ///< @c true si salio de la ShaderCache sin compilar.
+    double waitMs = 0.0;                    ///< Tiempo en la cola antes de empezar.
+    double compileMs = 0.0;                 ///< Clave + cache + compilacion en el hilo trabajador.
+};
+
+/**
+ * @struct ShaderCompileStats
+ * @brief Totales acumulados desde init().
+ */
+struct ShaderCompileStats {
+    unsigned int requested = 0;     ///< Solicitudes recibidas.
+    unsigned int compiled = 0;      ///< Compiladas con exito.
+    unsigned int cached = 0;        ///< Resueltas desde la ShaderCache.
+    unsigned int failed = 0;        ///< Con error de compilacion.
+    double compileMs = 0.0;         ///< Suma de los tiempos de compilacion (todos los hilos).
+    double maxCompileMs = 0.0;      ///< Compilacion mas lenta.
+};
+
+/**
+ * @class ShaderCompileQueue
+ * @brief Cola de compilacion asincrona con entrega en el hilo principal.
+ */
+class ShaderCompileQueue {
+public:
+    ShaderCompileQueue() = default;
+    ~ShaderCompileQueue() { destroy(); }
+
+    ShaderCompileQueue(const ShaderCompileQueue&) = delete;
+    ShaderCompileQueue& operator=(const ShaderCompileQueue&) = delete;
+
+    /**
+     * @brief Inicializa la cola.
+     * @param jobs    Pool donde se compila; sin el, request() compila en el hilo que llama.
+     * @param compile Compilador (debe poder llamarse desde varios hilos).
+     * @param cache   Cache de bytecode (opcional); debe vivir mas que la cola.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG sin compilador.
+     */
+    HRESULT init(JobSystem* jobs, const ShaderLibrary::CompileFunc& compile, ShaderCache* cache = nullptr);
+
+    /// Espera las compilaciones en curso y descarta los resultados no recogidos.
+    void destroy();
+
+    /**
+     * @brief Pide compilar @p desc.
+     * @return Ticket que identifica el resultado en pop().
+     */
+    unsigned int request(const ShaderCompileDesc& desc);
+
+    /**
+     * @brief Saca un shader terminado, si hay.
+     * @return @c false si no hay resultados listos.
+     */
+    bool pop(CompiledShader& out);
+
+    /// Bloquea hasta que todas las solicitudes terminen (ayudando al pool).
+    void waitIdle();
+
+    /// Solicitudes que aun no terminan de compilarse (profundidad de la cola).
+    unsigned int getInFlight() const { return m_inFlight.load(std::memory_order_acquire); }
+
+    /// Resultados listos que no se han recogido con pop().
+    unsigned int getReadyCount() const;
+
+    /// Totales acumulados.
+    ShaderCompileStats getStats() const;
+
+    /// Publica la profundidad de la cola y los totales en el Profiler con el prefijo @p prefix.
+    void publishCounters(const std::string& prefix) const;
+
+    /// Nombre de la muestra del Profiler de @p desc ("<archivo>:<entrada>[DEF=1,...]").
+    static std::string sampleName(const ShaderCompileDesc& desc);
+
+private:
+    /// Guarda el resultado de una tarea en la cola de terminados.
+    void finish(CompiledShader&& result);
+
+    JobSystem* m_jobs = nullptr;
+    ShaderLibrary::CompileFunc m_compile;
+    ShaderCache* m_cache = nullptr;
+    JobCounter m_counter;                   ///< Tareas en el pool (para waitIdle/destroy).
+    std::atomic<unsigned int> m_inFlight{ 0 };
+    unsigned int m_nextTicket = 1;
+
+    mutable std::mutex m_mutex;             ///< Protege m_ready y m_stats.
+    std::deque<CompiledShader> m_ready;     ///< Terminados, en orden de llegada.
+    ShaderCompileStats m_stats;
+};
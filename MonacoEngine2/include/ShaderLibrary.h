@@ -0,0 +1,159 @@
+/**
+ * @file ShaderLibrary.h
+ * @brief Declara ShaderLibrary, las permutaciones de un shader compiladas en un solo archivo.
+ *
+ * Un shader con N palabras clave (features) tiene 2^N variantes: el bit i de la mascara activa
+ * la i-esima palabra, que se pasa al compilador como el define @c NOMBRE=1 (las apagadas no se
+ * definen, asi que el HLSL usa @c #if / @c #ifdef). build() compila todas las variantes de VS y
+ * PS en paralelo con el JobSystem (opcionalmente a traves de una ShaderCache) y las empaqueta:
+ *
+ *   cabecera | nombres de las features | tabla (etapa, mascara) -> blob | blobs | bytecode
+ *
+ * Las variantes que producen el mismo bytecode (p. ej. el VS cuando una feature solo toca el
+ * PS) comparten un blob. En tiempo de ejecucion el archivo se proyecta en memoria y find()
+ * devuelve el bytecode de una variante con un indice directo, sin cadenas ni busquedas; los
+ * nombres solo se usan una vez, en getFeatureMask(), para armar las mascaras.
+ *
+ * No depende de Direct3D: la compilacion llega como CompileFunc (ShaderProgram::compileVariant
+ * en Windows), asi que el empaquetado y la busqueda se prueban en Linux.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "MappedFile.h"
+#include "ShaderCache.h"
+#include <functional>
+
+class JobSystem;
+
+/// Etapa de una variante dentro de la biblioteca.
+enum class ShaderStage : uint32_t {
+    Vertex = 0,
+    Pixel = 1
+};
+
+/**
+ * @struct ShaderLibraryDesc
+ * @brief Que compilar en ShaderLibrary::build().
+ */
+struct ShaderLibraryDesc {
+    std::string fileName;                   ///< Archivo HLSL raiz.
+    std::vector<std::string> features;      ///< Palabras clave; la i-esima es el bit i de la mascara.
+    std::string vertexEntry = "VS";
+    std::string vertexProfile = "vs_4_0";
+    std::string pixelEntry = "PS";
+    std::string pixelProfile = "ps_4_0";
+    uint32_t flags = 0;                     ///< Banderas D3DCOMPILE_*.
+    uint64_t compilerVersion = 0;           ///< Se guarda en la cabecera.
+    JobSystem* jobs = nullptr;              ///< Pool para compilar en paralelo; nullptr = hilo actual.
+    ShaderCache* cache = nullptr;           ///< Cache de bytecode para recompilar solo lo que cambio.
+};
+
+/**
+ * @struct ShaderLibraryBuildStats
+ * @brief Resultado de ShaderLibrary::build().
+ */
+struct ShaderLibraryBuildStats {
+    unsigned int variants = 0;              ///< Variantes (2 etapas x 2^features).
+    unsigned int compiled = 0;              ///< Variantes que paso por CompileFunc.
+    unsigned int cached = 0;                ///< Variantes leidas de la ShaderCache.
+    unsigned int uniqueBlobs = 0;           ///< Bytecodes distintos guardados.
+    unsigned long long bytecodeBytes = 0;   ///< Suma del bytecode de todas las variantes.
+    unsigned long long fileBytes = 0;       ///< Tamano del archivo (con blobs compartidos).
+    double compileMs = 0.0;                 ///< Tiempo de compilacion sumado entre hilos.
+    double totalMs = 0.0;                   ///< Tiempo real de build().
+};
+
+/**
+ * @class ShaderLibrary
+ * @brief Biblioteca de variantes de un shader proyectada en memoria. No copiable.
+ */
+class ShaderLibrary {
+public:
+    /// Maximo de features: 2^16 variantes por etapa.
+    static const unsigned int MAX_FEATURES = 16;
+
+    /**
+     * @brief Compila una variante.
+     * @return @c S_OK y el bytecode en @p bytecode si fue exitoso. Puede llamarse desde varios hilos.
+     */
+    using CompileFunc = std::function<HRESULT(const ShaderCompileDesc& desc, std::vector<unsigned char>& bytecode)>;
+
+    ShaderLibrary() = default;
+    ~ShaderLibrary() = default;
+
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+    /**
+     * @brief Compila todas las variantes de @p desc y escribe la biblioteca en @p outputFile.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG sin archivo o con mas de MAX_FEATURES
+     *         features; el error de la primera variante que no compile; @c E_FAIL al escribir.
+     */
+    static HRESULT build(const ShaderLibraryDesc& desc, const CompileFunc& compile, const std::string& outputFile,
+                         ShaderLibraryBuildStats* stats = nullptr);
+
+    /// Defines de la variante @p mask: @c NOMBRE=1 por cada bit encendido.
+    static std::vector<ShaderDefine> definesForMask(const std::vector<std::string>& features, uint32_t mask);
+
+    /**
+     * @brief Proyecta y valida una biblioteca escrita por build().
+     * @return @c S_OK si fue exitoso; @c E_FAIL si no existe, esta danada o es de otro formato.
+     */
+    HRESULT loadFromFile(const std::string& fileName);
+
+    /// Libera la proyeccion; los punteros de find() dejan de ser validos.
+    void destroy();
+
+    /**
+     * @brief Mascara con los bits de @p names (para hacerla una vez, fuera del frame).
+     *
+     * Los nombres que la biblioteca no tiene se ignoran (y se reportan con ERROR).
+     */
+    uint32_t getFeatureMask(const std::vector<std::string>& names) const;
+
+    /**
+     * @brief Bytecode de la variante (@p stage, @p mask); los bits fuera de las features se ignoran.
+     * @return Puntero dentro del archivo proyectado y su tamano en @p size; nullptr si no hay biblioteca.
+     */
+    const unsigned char* find(ShaderStage stage, uint32_t mask, size_t& size) const {
+        if (m_slots.empty()) {
+            size = 0;
+            return nullptr;
+        }
+        const Slot& slot = m_slots[(static_cast<uint32_t>(stage) << m_featureCount) | (mask & m_maskLimit)];
+        size = slot.size;
+        return slot.data;
+    }
+
+    bool empty() const { return m_slots.empty(); }
+
+    const std::vector<std::string>& getFeatures() const { return m_features; }
+
+    /// Variantes por etapa (2^features).
+    unsigned int getVariantCount() const { return m_maskLimit + 1; }
+
+    /// Bytecodes distintos en el archivo.
+    unsigned int getUniqueBlobCount() const { return m_uniqueBlobs; }
+
+    /// Tamano del archivo proyectado.
+    size_t getFileSize() const { return m_file.getSize(); }
+
+    uint64_t getCompilerVersion() const { return m_compilerVersion; }
+
+private:
+    /// Variante resuelta al cargar: find() es un solo acceso a este arreglo.
+    struct Slot {
+        const unsigned char* data = nullptr;
+        uint32_t size = 0;
+    };
+
+    MappedFile m_file;
+    std::vector<std::string> m_features;
+    std::vector<Slot> m_slots;              ///< (etapa << features) | mascara -> bytecode.
+    unsigned int m_featureCount = 0;
+    uint32_t m_maskLimit = 0;               ///< 2^features - 1.
+    unsigned int m_uniqueBlobs = 0;
+    uint64_t m_compilerVersion = 0;
+};
@@ -9,6 +9,7 @@
 #pragma once
 #include "Prerequisites.h"
 #include "InputLayout.h"
+#include "ShaderLibrary.h"
 
 class Device;
 class DeviceContext;
@@ -25,8 +26,43 @@ public:
     ShaderProgram() = default;
     ~ShaderProgram() = default;
 
-    /// Inicializa los shaders desde un archivo HLSL y crea el Input Layout.
-    HRESULT init(Device& device, const std::string& fileName, std::vector<D3D11_INPUT_ELEMENT_DESC> Layout);
+    /**
+     * @brief Inicializa los shaders desde un archivo HLSL y crea el Input Layout.
+     * @param cache Cache de bytecode en disco (opcional): con una entrada valida el shader se crea
+     *              sin compilar; si no, se compila y se guarda para el siguiente arranque.
+     */
+    HRESULT init(Device& device, const std::string& fileName, std::vector<D3D11_INPUT_ELEMENT_DESC> Layout,
+                 ShaderCache* cache = nullptr);
+
+    /**
+     * @brief Inicializa los shaders con la variante @p featureMask de una biblioteca precompilada.
+     *
+     * No compila ni busca por nombre: el bytecode sale directo del archivo proyectado.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si la biblioteca esta vacia.
+     */
+    HRESULT init(Device& device, const ShaderLibrary& library, uint32_t featureMask,
+                 std::vector<D3D11_INPUT_ELEMENT_DESC> Layout);
+
+    /// Crea los shaders y el Input Layout a partir de bytecode ya compilado.
+    HRESULT initFromBytecode(Device& device, const void* vertexBytecode, size_t vertexSize,
+                             const void* pixelBytecode, size_t pixelSize,
+                             std::vector<D3D11_INPUT_ELEMENT_DESC> Layout);
+
+    /**
+     * @brief Compila "VS" y "PS" desde HLSL en memoria (p. ej. un programa de reemplazo embebido).
+     * @param name Nombre para los mensajes de error del compilador.
+     */
+    HRESULT initFromSource(Device& device, const std::string& source, const std::string& name,
+                           std::vector<D3D11_INPUT_ELEMENT_DESC> Layout);
+
+    /// Usa los shaders e Input Layout de @p other (con su propia referencia) en lugar de los propios.
+    void share(const ShaderProgram& other);
+
+    /// Intercambia todos los recursos con @p other (sin crear ni liberar nada).
+    void swap(ShaderProgram& other);
+
+    /// @c true si tiene VS, PS e Input Layout.
+    bool isReady() const { return m_VertexShader && m_PixelShader && m_inputLayout.m_inputLayout; }
 
     /// Mtodo reservado para futuras actualizaciones dinmicas.
     void update();
@@ -52,13 +88,23 @@ public:
     /// Compila un shader desde archivo usando D3DCompileFromFile.
     HRESULT CompileShaderFromFile(char* szFileName, LPCSTR szEntryPoint, LPCSTR szShaderModel, ID3DBlob** ppBlobOut);
 
+    /// Compila una variante con sus defines (ShaderLibrary::CompileFunc; se puede llamar desde varios hilos).
+    static HRESULT compileVariant(const ShaderCompileDesc& desc, std::vector<unsigned char>& bytecode);
+
+    /// Banderas de compilacion de los shaders del motor (D3DCOMPILE_DEBUG en depuracion).
+    static DWORD getCompileFlags();
+
 public:
     ID3D11VertexShader* m_VertexShader = nullptr;  ///< Vertex Shader creado en GPU.
     ID3D11PixelShader* m_PixelShader = nullptr;  ///< Pixel Shader creado en GPU.
     InputLayout         m_inputLayout;             ///< Layout de entrada para el VS.
 
 private:
+    /// Crea el shader de @p type desde @p shaderData y se queda con el blob.
+    HRESULT CreateShaderFromBlob(Device& device, ShaderType type, ID3DBlob* shaderData);
+
     std::string m_shaderFileName;  ///< Archivo HLSL fuente del programa.
+    ShaderCache* m_cache = nullptr;  ///< Cache de bytecode usada por CreateShader() (opcional).
     ID3DBlob* m_vertexShaderData = nullptr;  ///< Bytecode compilado del VS.
     ID3DBlob* m_pixelShaderData = nullptr;  ///< Bytecode compilado del PS.
 };
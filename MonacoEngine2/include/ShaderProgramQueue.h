@@ -0,0 +1,142 @@
+/**
+ * @file ShaderProgramQueue.h
+ * @brief Declara la clase ShaderProgramQueue, creacion de ShaderProgram sin bloquear el frame.
+ *
+ * request() pide a ShaderCompileQueue el VS y el PS del programa en los hilos del JobSystem
+ * (a traves de la ShaderCache) y, si el programa destino todavia no tiene shaders, lo apunta
+ * a un programa de reemplazo para que se pueda dibujar mientras tanto.
+ * update(), llamado una vez por frame desde el hilo del dispositivo antes de dibujar, crea los
+ * shaders de los programas con sus dos etapas compiladas y los intercambia con los del destino
+ * de una sola vez: ningun draw ve un VS nuevo con un PS viejo. Si la compilacion o la creacion
+ * fallan, el destino conserva lo que tenia (el reemplazo o la version anterior).
+ *
+ * Una solicitud nueva para un programa con otra en curso la reemplaza; el resultado de la
+ * vieja se descarta al llegar.
+ *
+ * Con enableHotReload(), cada programa pedido queda registrado en un ShaderWatcher y update()
+ * vuelve a pedir los que cambiaron en disco (su .fx o cualquier include): la compilacion pasa
+ * por la cache y el cambio llega en un update() posterior, sin reiniciar; con errores de
+ * compilacion el programa sigue con la version anterior.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "Prerequisites.h"
+#include "ShaderCompileQueue.h"
+#include "ShaderProgram.h"
+#include "ShaderWatcher.h"
+#include <unordered_map>
+
+class Device;
+
+/**
+ * @struct ShaderProgramQueueStats
+ * @brief Contadores del ultimo update() y totales.
+ */
+struct ShaderProgramQueueStats {
+    double lastUpdateMs = 0.0;          ///< Duracion del ultimo update().
+    unsigned int lastSwapped = 0;       ///< Programas cambiados en el ultimo update().
+    unsigned int swapped = 0;           ///< Programas cambiados desde init().
+    unsigned int failed = 0;            ///< Solicitudes con error de compilacion o de creacion.
+    unsigned int superseded = 0;        ///< Solicitudes reemplazadas por una mas nueva del mismo programa.
+    unsigned int reloads = 0;           ///< Solicitudes hechas por la recarga en caliente.
+};
+
+/**
+ * @class ShaderProgramQueue
+ * @brief Compilacion en segundo plano + cambio de programas entre frames.
+ */
+class ShaderProgramQueue {
+public:
+    ShaderProgramQueue() = default;
+    ~ShaderProgramQueue() = default;
+
+    ShaderProgramQueue(const ShaderProgramQueue&) = delete;
+    ShaderProgramQueue& operator=(const ShaderProgramQueue&) = delete;
+
+    /**
+     * @brief Inicializa la cola de compilacion.
+     * @param jobs  Pool donde se compilan los shaders.
+     * @param cache Cache de bytecode (opcional); debe vivir mas que la cola.
+     */
+    HRESULT init(JobSystem& jobs, ShaderCache* cache = nullptr);
+
+    /// Espera las compilaciones en curso y olvida las solicitudes pendientes.
+    void destroy();
+
+    /**
+     * @brief Pide compilar "VS"/"PS" de @p fileName con @p defines para @p target sin bloquear.
+     * @param fallback Programa listo que @p target usa mientras no tenga shaders propios (opcional).
+     * @pre @p target vive hasta que la solicitud termina o se llama a cancel().
+     * @return @c S_OK si la solicitud se encolo.
+     */
+    HRESULT request(ShaderProgram& target, const std::string& fileName,
+                    const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout,
+                    const std::vector<ShaderDefine>& defines = std::vector<ShaderDefine>(),
+                    const ShaderProgram* fallback = nullptr);
+
+    /// Olvida la solicitud pendiente de @p target y deja de recargarlo (conserva lo que tiene).
+    void cancel(ShaderProgram& target);
+
+    /**
+     * @brief Recompila los programas pedidos cuando cambian sus fuentes (ver ShaderWatcher).
+     * @param keys         Cache con la que se calculan las claves (la de init()); debe vivir mas.
+     * @param forcePolling Ver FileWatcher::init().
+     */
+    HRESULT enableHotReload(ShaderCache& keys, bool forcePolling = false);
+
+    /**
+     * @brief Cambia los programas cuyas dos etapas ya estan compiladas y, con recarga en
+     *        caliente, pide de nuevo los que cambiaron en disco.
+     * @return Programas cambiados en esta llamada.
+     */
+    unsigned int update(Device& device);
+
+    /// @c true si no quedan solicitudes por compilar ni por cambiar.
+    bool isIdle() const { return m_pending.empty(); }
+
+    /// @c true si @p target tiene una solicitud en curso.
+    bool isPending(const ShaderProgram& target) const;
+
+    /// Bloquea hasta que todo este compilado (se cambia en el proximo update()).
+    void waitCompiled() { m_compiler.waitIdle(); }
+
+    /// Publica la profundidad de la cola y los totales en el Profiler con el prefijo @p prefix.
+    void publishCounters(const std::string& prefix) const;
+
+    const ShaderProgramQueueStats& getStats() const { return m_stats; }
+    ShaderCompileStats getCompileStats() const { return m_compiler.getStats(); }
+
+private:
+    /// Programa en espera de sus dos etapas.
+    struct Pending {
+        std::vector<D3D11_INPUT_ELEMENT_DESC> layout;
+        unsigned int vertexTicket = 0;
+        unsigned int pixelTicket = 0;
+        CompiledShader vertex;
+        CompiledShader pixel;
+        bool vertexDone = false;
+        bool pixelDone = false;
+    };
+
+    /// Ultima solicitud de un programa, para repetirla al recargar.
+    struct Registered {
+        unsigned int id = 0;                ///< Id en m_watcher.
+        std::string fileName;
+        std::vector<D3D11_INPUT_ELEMENT_DESC> layout;
+        std::vector<ShaderDefine> defines;
+    };
+
+    /// Compilaciones VS y PS de @p fileName con @p defines.
+    static std::vector<ShaderCompileDesc> stageDescs(const std::string& fileName,
+                                                     const std::vector<ShaderDefine>& defines);
+
+    ShaderCompileQueue m_compiler;
+    std::unordered_map<ShaderProgram*, Pending> m_pending;      ///< Programa destino -> solicitud vigente.
+    std::unordered_map<unsigned int, ShaderProgram*> m_tickets; ///< Ticket en curso -> programa destino.
+    std::unordered_map<ShaderProgram*, Registered> m_registered;///< Programas pedidos alguna vez.
+    ShaderWatcher m_watcher;
+    bool m_hotReload = false;
+    unsigned int m_nextId = 1;
+    ShaderProgramQueueStats m_stats;
+};
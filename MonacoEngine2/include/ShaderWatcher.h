@@ -0,0 +1,99 @@
+/**
+ * @file ShaderWatcher.h
+ * @brief Declara la clase ShaderWatcher, deteccion de cambios en las fuentes de los shaders.
+ *
+ * Cada programa registrado (un id con sus compilaciones, p. ej. VS y PS) vigila con un
+ * FileWatcher su archivo raiz y todos los includes que ShaderCache::computeKey() encuentra.
+ * Cuando uno cambia, poll() recalcula la clave de los programas que lo usan y reporta solo los
+ * que de verdad cambiaron: guardar sin modificar no recompila nada. Al recalcular se vuelven a
+ * leer los includes, asi que un include agregado en la edicion queda vigilado desde ese momento.
+ *
+ * Es la parte portable de la recarga en caliente (ShaderProgramQueue::enableHotReload() la usa
+ * para recompilar y cambiar los ShaderProgram); no depende de Direct3D.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "FileWatcher.h"
+#include "ShaderCache.h"
+
+/**
+ * @struct ShaderWatcherStats
+ * @brief Totales acumulados desde init().
+ */
+struct ShaderWatcherStats {
+    unsigned int fileEvents = 0;    ///< Archivos reportados por el FileWatcher.
+    unsigned int reloads = 0;       ///< Programas reportados por poll().
+    unsigned int unchanged = 0;     ///< Programas con archivos tocados pero con la misma clave.
+    double pollMs = 0.0;            ///< Tiempo total en poll() (lectura de eventos + claves).
+};
+
+/**
+ * @class ShaderWatcher
+ * @brief Programas de shaders cuyas fuentes cambiaron desde el ultimo poll(). No copiable.
+ */
+class ShaderWatcher {
+public:
+    ShaderWatcher() = default;
+    ~ShaderWatcher() = default;
+
+    ShaderWatcher(const ShaderWatcher&) = delete;
+    ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+    /**
+     * @brief Prepara el vigilante.
+     * @param keys         Cache cuya computeKey() se usa (la misma con la que se compila); debe vivir mas.
+     * @param forcePolling Ver FileWatcher::init().
+     */
+    HRESULT init(ShaderCache& keys, bool forcePolling = false);
+
+    /// Olvida todos los programas.
+    void destroy();
+
+    /**
+     * @brief Registra (o reemplaza) el programa @p id formado por las compilaciones @p stages.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG sin etapas; @c E_FAIL si un archivo no se puede vigilar.
+     */
+    HRESULT add(unsigned int id, const std::vector<ShaderCompileDesc>& stages);
+
+    /// Deja de vigilar el programa @p id.
+    void remove(unsigned int id);
+
+    /**
+     * @brief Programas cuyas fuentes cambiaron.
+     * @param changed Recibe los ids, sin repetidos.
+     * @return Cantidad de ids en @p changed.
+     */
+    unsigned int poll(std::vector<unsigned int>& changed);
+
+    /// Programas registrados.
+    size_t getProgramCount() const { return m_programs.size(); }
+
+    /// Archivos vigilados (raices e includes de todos los programas).
+    size_t getFileCount() const { return m_users.size(); }
+
+    bool usesNotifications() const { return m_watcher.usesNotifications(); }
+
+    const ShaderWatcherStats& getStats() const { return m_stats; }
+
+private:
+    /// Programa registrado con su clave y archivos actuales.
+    struct Program {
+        std::vector<ShaderCompileDesc> stages;
+        uint64_t key = 0;
+        std::vector<std::string> files;     ///< Normalizados con FileWatcher::normalize().
+    };
+
+    /// Recalcula la clave y los archivos de @p id y ajusta la vigilancia.
+    HRESULT refresh(unsigned int id, Program& program);
+
+    /// Quita @p id de los usuarios de sus archivos; deja de vigilar los que quedan sin usuarios.
+    void release(unsigned int id, const Program& program);
+
+    ShaderCache* m_keys = nullptr;
+    FileWatcher m_watcher;
+    std::unordered_map<unsigned int, Program> m_programs;
+    std::unordered_map<std::string, std::vector<unsigned int>> m_users;    ///< Archivo -> ids que lo usan.
+    ShaderWatcherStats m_stats;
+};
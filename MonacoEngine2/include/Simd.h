@@ -0,0 +1,539 @@
+/**
+ * @file Simd.h
+ * @brief Abstraccion minima de registros SIMD de ancho fijo para los sistemas de CPU.
+ *
+ * El backend se elige en tiempo de compilacion:
+ *  - AVX2 (/arch:AVX2, -mavx2): FloatV de 8 floats.
+ *  - SSE2 (x86/x64 por defecto): FloatV de 4 floats.
+ *  - NEON (ARMv7 con NEON, AArch64): FloatV de 4 floats.
+ *  - Escalar: cuatro floats en un struct; se usa en otras arquitecturas o definiendo
+ *    SIMD_FORCE_SCALAR para comparar resultados y tiempos contra los backends vectoriales.
+ *
+ * El codigo que usa FloatV escribe un solo bucle que avanza de SIMD_LANES en SIMD_LANES.
+ * Float4 es siempre de 4 floats (una fila de matriz o un vector xyzw) y sus funciones llevan
+ * el sufijo 4 para no chocar con las de FloatV cuando ambos tipos coinciden. loadBytes(),
+ * storeBytes() y storeRgba() pasan de bytes de imagen a FloatV y de vuelta (los pixeles RGBA8
+ * se empaquetan con R en el byte bajo: memoria little endian, como x86 y ARM). loadHalves() y
+ * storeHalves() hacen lo mismo con medios floats (IEEE 754 binary16, redondeo al par mas
+ * cercano): F16C en AVX2, enteros de SSE2 en SSE, vcvt en AArch64 y floatToHalf() en los demas.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(SIMD_FORCE_SCALAR)
+#define SIMD_BACKEND_SCALAR 1
+#elif defined(__AVX2__)
+#define SIMD_BACKEND_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_BACKEND_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define SIMD_BACKEND_NEON 1
+#include <arm_neon.h>
+#else
+#define SIMD_BACKEND_SCALAR 1
+#endif
+
+namespace simd {
+#if defined(SIMD_BACKEND_AVX2)
+    typedef __m256 FloatV;
+    const int SIMD_LANES = 8;
+    const char* const SIMD_BACKEND = "AVX2";
+
+    inline FloatV set1(float f) { return _mm256_set1_ps(f); }
+    inline FloatV zero() { return _mm256_setzero_ps(); }
+    inline FloatV load(const float* p) { return _mm256_loadu_ps(p); }
+    inline void store(float* p, FloatV v) { _mm256_storeu_ps(p, v); }
+    inline FloatV add(FloatV a, FloatV b) { return _mm256_add_ps(a, b); }
+    inline FloatV sub(FloatV a, FloatV b) { return _mm256_sub_ps(a, b); }
+    inline FloatV mul(FloatV a, FloatV b) { return _mm256_mul_ps(a, b); }
+    inline FloatV div(FloatV a, FloatV b) { return _mm256_div_ps(a, b); }
+#if defined(__FMA__) || defined(_MSC_VER)
+    inline FloatV madd(FloatV a, FloatV b, FloatV c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+    inline FloatV madd(FloatV a, FloatV b, FloatV c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+    inline FloatV sqrt(FloatV a) { return _mm256_sqrt_ps(a); }
+    inline FloatV abs(FloatV a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    inline FloatV min(FloatV a, FloatV b) { return _mm256_min_ps(a, b); }
+    inline FloatV max(FloatV a, FloatV b) { return _mm256_max_ps(a, b); }
+    inline FloatV cmpgt(FloatV a, FloatV b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    inline FloatV cmpge(FloatV a, FloatV b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    inline FloatV cmplt(FloatV a, FloatV b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    inline FloatV cmple(FloatV a, FloatV b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    inline FloatV cmpeq(FloatV a, FloatV b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    inline FloatV andv(FloatV a, FloatV b) { return _mm256_and_ps(a, b); }
+    inline FloatV orv(FloatV a, FloatV b) { return _mm256_or_ps(a, b); }
+    /// mask ? a : b, lane por lane.
+    inline FloatV select(FloatV mask, FloatV a, FloatV b) { return _mm256_blendv_ps(b, a, mask); }
+    inline int movemask(FloatV v) { return _mm256_movemask_ps(v); }
+    /// Centros de pixel 0.5, 1.5, ... para cada lane.
+    inline FloatV laneCenters() { return _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f); }
+    /// Mascara con todos los bits en uno si @p condition es verdadero.
+    inline FloatV maskFrom(bool condition) { return _mm256_castsi256_ps(_mm256_set1_epi32(condition ? -1 : 0)); }
+    inline float horizontalMax(FloatV v) {
+        __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+
+    /// Convierte 8 bytes consecutivos a float (0 a 255).
+    inline FloatV loadBytes(const unsigned char* p) {
+        return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+    }
+    /// Trunca cada lane (ya en [0, 255]) y guarda 8 bytes consecutivos.
+    inline void storeBytes(unsigned char* p, FloatV v) {
+        __m256i i = _mm256_cvttps_epi32(v);
+        __m128i w = _mm_packs_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(w, w));
+    }
+    /// Trunca cada canal (ya en [0, 255]) y guarda 8 pixeles RGBA8 consecutivos.
+    inline void storeRgba(unsigned char* p, FloatV r, FloatV g, FloatV b, FloatV a) {
+        __m256i rg = _mm256_or_si256(_mm256_cvttps_epi32(r), _mm256_slli_epi32(_mm256_cvttps_epi32(g), 8));
+        __m256i ba = _mm256_or_si256(_mm256_slli_epi32(_mm256_cvttps_epi32(b), 16), _mm256_slli_epi32(_mm256_cvttps_epi32(a), 24));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_or_si256(rg, ba));
+    }
+#elif defined(SIMD_BACKEND_SSE)
+    typedef __m128 FloatV;
+    const int SIMD_LANES = 4;
+    const char* const SIMD_BACKEND = "SSE2";
+
+    inline FloatV set1(float f) { return _mm_set1_ps(f); }
+    inline FloatV zero() { return _mm_setzero_ps(); }
+    inline FloatV load(const float* p) { return _mm_loadu_ps(p); }
+    inline void store(float* p, FloatV v) { _mm_storeu_ps(p, v); }
+    inline FloatV add(FloatV a, FloatV b) { return _mm_add_ps(a, b); }
+    inline FloatV sub(FloatV a, FloatV b) { return _mm_sub_ps(a, b); }
+    inline FloatV mul(FloatV a, FloatV b) { return _mm_mul_ps(a, b); }
+    inline FloatV div(FloatV a, FloatV b) { return _mm_div_ps(a, b); }
+    inline FloatV madd(FloatV a, FloatV b, FloatV c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    inline FloatV sqrt(FloatV a) { return _mm_sqrt_ps(a); }
+    inline FloatV abs(FloatV a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    inline FloatV min(FloatV a, FloatV b) { return _mm_min_ps(a, b); }
+    inline FloatV max(FloatV a, FloatV b) { return _mm_max_ps(a, b); }
+    inline FloatV cmpgt(FloatV a, FloatV b) { return _mm_cmpgt_ps(a, b); }
+    inline FloatV cmpge(FloatV a, FloatV b) { return _mm_cmpge_ps(a, b); }
+    inline FloatV cmplt(FloatV a, FloatV b) { return _mm_cmplt_ps(a, b); }
+    inline FloatV cmple(FloatV a, FloatV b) { return _mm_cmple_ps(a, b); }
+    inline FloatV cmpeq(FloatV a, FloatV b) { return _mm_cmpeq_ps(a, b); }
+    inline FloatV andv(FloatV a, FloatV b) { return _mm_and_ps(a, b); }
+    inline FloatV orv(FloatV a, FloatV b) { return _mm_or_ps(a, b); }
+    /// mask ? a : b, lane por lane.
+    inline FloatV select(FloatV mask, FloatV a, FloatV b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    inline int movemask(FloatV v) { return _mm_movemask_ps(v); }
+    /// Centros de pixel 0.5, 1.5, ... para cada lane.
+    inline FloatV laneCenters() { return _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f); }
+    /// Mascara con todos los bits en uno si @p condition es verdadero.
+    inline FloatV maskFrom(bool condition) { return _mm_castsi128_ps(_mm_set1_epi32(condition ? -1 : 0)); }
+    inline float horizontalMax(FloatV v) {
+        __m128 m = _mm_max_ps(v, _mm_movehl_ps(v, v));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+
+    /// Convierte 4 bytes consecutivos a float (0 a 255).
+    inline FloatV loadBytes(const unsigned char* p) {
+        int bytes;
+        memcpy(&bytes, p, sizeof(bytes));
+        const __m128i z = _mm_setzero_si128();
+        __m128i i = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), z), z);
+        return _mm_cvtepi32_ps(i);
+    }
+    /// Trunca cada lane (ya en [0, 255]) y guarda 4 bytes consecutivos.
+    inline void storeBytes(unsigned char* p, FloatV v) {
+        __m128i i = _mm_cvttps_epi32(v);
+        i = _mm_packs_epi32(i, i);
+        int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(i, i));
+        memcpy(p, &bytes, sizeof(bytes));
+    }
+    /// Trunca cada canal (ya en [0, 255]) y guarda 4 pixeles RGBA8 consecutivos.
+    inline void storeRgba(unsigned char* p, FloatV r, FloatV g, FloatV b, FloatV a) {
+        __m128i rg = _mm_or_si128(_mm_cvttps_epi32(r), _mm_slli_epi32(_mm_cvttps_epi32(g), 8));
+        __m128i ba = _mm_or_si128(_mm_slli_epi32(_mm_cvttps_epi32(b), 16), _mm_slli_epi32(_mm_cvttps_epi32(a), 24));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_or_si128(rg, ba));
+    }
+#elif defined(SIMD_BACKEND_NEON)
+    typedef float32x4_t FloatV;
+    const int SIMD_LANES = 4;
+    const char* const SIMD_BACKEND = "NEON";
+
+    inline FloatV set1(float f) { return vdupq_n_f32(f); }
+    inline FloatV zero() { return vdupq_n_f32(0.0f); }
+    inline FloatV load(const float* p) { return vld1q_f32(p); }
+    inline void store(float* p, FloatV v) { vst1q_f32(p, v); }
+    inline FloatV add(FloatV a, FloatV b) { return vaddq_f32(a, b); }
+    inline FloatV sub(FloatV a, FloatV b) { return vsubq_f32(a, b); }
+    inline FloatV mul(FloatV a, FloatV b) { return vmulq_f32(a, b); }
+#if defined(__aarch64__) || defined(_M_ARM64)
+    inline FloatV div(FloatV a, FloatV b) { return vdivq_f32(a, b); }
+    inline FloatV madd(FloatV a, FloatV b, FloatV c) { return vfmaq_f32(c, a, b); }
+    inline FloatV sqrt(FloatV a) { return vsqrtq_f32(a); }
+#else
+    /// ARMv7 no tiene division: estimacion del reciproco y dos pasos de Newton-Raphson.
+    inline FloatV div(FloatV a, FloatV b) {
+        float32x4_t r = vrecpeq_f32(b);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        return vmulq_f32(a, r);
+    }
+    inline FloatV madd(FloatV a, FloatV b, FloatV c) { return vmlaq_f32(c, a, b); }
+    /// sqrt(a) = a * rsqrt(a), con rsqrt refinado; las lanes en cero quedan en cero.
+    inline FloatV sqrt(FloatV a) {
+        float32x4_t r = vrsqrteq_f32(a);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        uint32x4_t isZero = vceqq_f32(a, vdupq_n_f32(0.0f));
+        return vbslq_f32(isZero, a, vmulq_f32(a, r));
+    }
+#endif
+    inline FloatV abs(FloatV a) { return vabsq_f32(a); }
+    inline FloatV min(FloatV a, FloatV b) { return vminq_f32(a, b); }
+    inline FloatV max(FloatV a, FloatV b) { return vmaxq_f32(a, b); }
+    inline FloatV cmpgt(FloatV a, FloatV b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+    inline FloatV cmpge(FloatV a, FloatV b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+    inline FloatV cmplt(FloatV a, FloatV b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+    inline FloatV cmple(FloatV a, FloatV b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+    inline FloatV cmpeq(FloatV a, FloatV b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+    inline FloatV andv(FloatV a, FloatV b) {
+        return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+    }
+    inline FloatV orv(FloatV a, FloatV b) {
+        return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+    }
+    /// mask ? a : b, lane por lane.
+    inline FloatV select(FloatV mask, FloatV a, FloatV b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+    inline int movemask(FloatV v) {
+        uint32x4_t sign = vshrq_n_u32(vreinterpretq_u32_f32(v), 31);
+        return static_cast<int>(vgetq_lane_u32(sign, 0) | (vgetq_lane_u32(sign, 1) << 1)
+                              | (vgetq_lane_u32(sign, 2) << 2) | (vgetq_lane_u32(sign, 3) << 3));
+    }
+    /// Centros de pixel 0.5, 1.5, ... para cada lane.
+    inline FloatV laneCenters() {
+        static const float centers[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+        return vld1q_f32(centers);
+    }
+    /// Mascara con todos los bits en uno si @p condition es verdadero.
+    inline FloatV maskFrom(bool condition) { return vreinterpretq_f32_u32(vdupq_n_u32(condition ? 0xffffffffu : 0u)); }
+    inline float horizontalMax(FloatV v) {
+        float32x2_t m = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+        m = vpmax_f32(m, m);
+        return vget_lane_f32(m, 0);
+    }
+
+    /// Convierte 4 bytes consecutivos a float (0 a 255).
+    inline FloatV loadBytes(const unsigned char* p) {
+        uint32_t bytes;
+        memcpy(&bytes, p, sizeof(bytes));
+        uint16x8_t h = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bytes)));
+        return vcvtq_f32_u32(vmovl_u16(vget_low_u16(h)));
+    }
+    /// Trunca cada lane (ya en [0, 255]) y guarda 4 bytes consecutivos.
+    inline void storeBytes(unsigned char* p, FloatV v) {
+        uint16x4_t h = vmovn_u32(vcvtq_u32_f32(v));
+        uint32_t bytes = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(h, h))), 0);
+        memcpy(p, &bytes, sizeof(bytes));
+    }
+    /// Trunca cada canal (ya en [0, 255]) y guarda 4 pixeles RGBA8 consecutivos.
+    inline void storeRgba(unsigned char* p, FloatV r, FloatV g, FloatV b, FloatV a) {
+        uint32x4_t rg = vorrq_u32(vcvtq_u32_f32(r), vshlq_n_u32(vcvtq_u32_f32(g), 8));
+        uint32x4_t ba = vorrq_u32(vshlq_n_u32(vcvtq_u32_f32(b), 16), vshlq_n_u32(vcvtq_u32_f32(a), 24));
+        vst1q_u8(p, vreinterpretq_u8_u32(vorrq_u32(rg, ba)));
+    }
+#else
+    /// Registro emulado: cuatro floats; las mascaras guardan todos los bits en uno o en cero.
+    struct Float4 {
+        float v[4];
+    };
+    typedef Float4 FloatV;
+    const int SIMD_LANES = 4;
+    const char* const SIMD_BACKEND = "Scalar";
+
+    namespace detail {
+        inline unsigned int bitsOf(float f) { unsigned int u; memcpy(&u, &f, sizeof(u)); return u; }
+        inline float fromBits(unsigned int u) { float f; memcpy(&f, &u, sizeof(f)); return f; }
+        inline float maskBits(bool condition) { return fromBits(condition ? 0xffffffffu : 0u); }
+        template<class Op>
+        inline FloatV map(FloatV a, FloatV b, Op op) {
+            FloatV r;
+            for (int i = 0; i < 4; ++i) {
+                r.v[i] = op(a.v[i], b.v[i]);
+            }
+            return r;
+        }
+    }
+
+    inline FloatV set1(float f) { return FloatV{ { f, f, f, f } }; }
+    inline FloatV zero() { return set1(0.0f); }
+    inline FloatV load(const float* p) { return FloatV{ { p[0], p[1], p[2], p[3] } }; }
+    inline void store(float* p, FloatV v) { memcpy(p, v.v, sizeof(v.v)); }
+    inline FloatV add(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return x + y; }); }
+    inline FloatV sub(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return x - y; }); }
+    inline FloatV mul(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return x * y; }); }
+    inline FloatV div(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return x / y; }); }
+    inline FloatV madd(FloatV a, FloatV b, FloatV c) { return add(mul(a, b), c); }
+    inline FloatV sqrt(FloatV a) { return FloatV{ { sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3]) } }; }
+    inline FloatV abs(FloatV a) { return FloatV{ { fabsf(a.v[0]), fabsf(a.v[1]), fabsf(a.v[2]), fabsf(a.v[3]) } }; }
+    inline FloatV min(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return x < y ? x : y; }); }
+    inline FloatV max(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return x > y ? x : y; }); }
+    inline FloatV cmpgt(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return detail::maskBits(x > y); }); }
+    inline FloatV cmpge(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return detail::maskBits(x >= y); }); }
+    inline FloatV cmplt(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return detail::maskBits(x < y); }); }
+    inline FloatV cmple(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return detail::maskBits(x <= y); }); }
+    inline FloatV cmpeq(FloatV a, FloatV b) { return detail::map(a, b, [](float x, float y) { return detail::maskBits(x == y); }); }
+    inline FloatV andv(FloatV a, FloatV b) {
+        return detail::map(a, b, [](float x, float y) { return detail::fromBits(detail::bitsOf(x) & detail::bitsOf(y)); });
+    }
+    inline FloatV orv(FloatV a, FloatV b) {
+        return detail::map(a, b, [](float x, float y) { return detail::fromBits(detail::bitsOf(x) | detail::bitsOf(y)); });
+    }
+    /// mask ? a : b, lane por lane.
+    inline FloatV select(FloatV mask, FloatV a, FloatV b) {
+        FloatV r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = detail::bitsOf(mask.v[i]) >> 31 ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+    inline int movemask(FloatV v) {
+        int bits = 0;
+        for (int i = 0; i < 4; ++i) {
+            bits |= static_cast<int>(detail::bitsOf(v.v[i]) >> 31) << i;
+        }
+        return bits;
+    }
+    /// Centros de pixel 0.5, 1.5, ... para cada lane.
+    inline FloatV laneCenters() { return FloatV{ { 0.5f, 1.5f, 2.5f, 3.5f } }; }
+    /// Mascara con todos los bits en uno si @p condition es verdadero.
+    inline FloatV maskFrom(bool condition) { return set1(detail::maskBits(condition)); }
+    inline float horizontalMax(FloatV v) {
+        float a = v.v[0] > v.v[1] ? v.v[0] : v.v[1];
+        float b = v.v[2] > v.v[3] ? v.v[2] : v.v[3];
+        return a > b ? a : b;
+    }
+
+    /// Convierte 4 bytes consecutivos a float (0 a 255).
+    inline FloatV loadBytes(const unsigned char* p) {
+        return FloatV{ { static_cast<float>(p[0]), static_cast<float>(p[1]), static_cast<float>(p[2]), static_cast<float>(p[3]) } };
+    }
+    /// Trunca cada lane (ya en [0, 255]) y guarda 4 bytes consecutivos.
+    inline void storeBytes(unsigned char* p, FloatV v) {
+        for (int i = 0; i < 4; ++i) {
+            p[i] = static_cast<unsigned char>(v.v[i]);
+        }
+    }
+    /// Trunca cada canal (ya en [0, 255]) y guarda 4 pixeles RGBA8 consecutivos.
+    inline void storeRgba(unsigned char* p, FloatV r, FloatV g, FloatV b, FloatV a) {
+        for (int i = 0; i < 4; ++i) {
+            p[i * 4] = static_cast<unsigned char>(r.v[i]);
+            p[i * 4 + 1] = static_cast<unsigned char>(g.v[i]);
+            p[i * 4 + 2] = static_cast<unsigned char>(b.v[i]);
+            p[i * 4 + 3] = static_cast<unsigned char>(a.v[i]);
+        }
+    }
+#endif
+
+    // ------------------------------------------------------------------------
+    // Float4: siempre 4 floats (filas de matriz, vectores xyzw).
+    // ------------------------------------------------------------------------
+#if defined(SIMD_BACKEND_AVX2) || defined(SIMD_BACKEND_SSE)
+    typedef __m128 Float4;
+
+    inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+    inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+    inline Float4 set4(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+    inline Float4 splat4(float f) { return _mm_set1_ps(f); }
+    inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+    inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+    inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+    inline Float4 madd4(Float4 a, Float4 b, Float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#elif defined(SIMD_BACKEND_NEON)
+    typedef float32x4_t Float4;
+
+    inline Float4 load4(const float* p) { return vld1q_f32(p); }
+    inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+    inline Float4 set4(float x, float y, float z, float w) {
+        const float values[4] = { x, y, z, w };
+        return vld1q_f32(values);
+    }
+    inline Float4 splat4(float f) { return vdupq_n_f32(f); }
+    inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+    inline Float4 sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+    inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+    inline Float4 madd4(Float4 a, Float4 b, Float4 c) { return vmlaq_f32(c, a, b); }
+#else
+    inline Float4 load4(const float* p) { return load(p); }
+    inline void store4(float* p, Float4 v) { store(p, v); }
+    inline Float4 set4(float x, float y, float z, float w) { return Float4{ { x, y, z, w } }; }
+    inline Float4 splat4(float f) { return set1(f); }
+    inline Float4 add4(Float4 a, Float4 b) { return add(a, b); }
+    inline Float4 sub4(Float4 a, Float4 b) { return sub(a, b); }
+    inline Float4 mul4(Float4 a, Float4 b) { return mul(a, b); }
+    inline Float4 madd4(Float4 a, Float4 b, Float4 c) { return madd(a, b, c); }
+#endif
+
+    // ------------------------------------------------------------------------
+    // Medios floats (binary16): texturas R16G16B16A16_FLOAT.
+    // ------------------------------------------------------------------------
+
+    /// float a binary16 con redondeo al par mas cercano; desborda a infinito y NaN sale silencioso.
+    inline uint16_t floatToHalf(float f) {
+        uint32_t u;
+        memcpy(&u, &f, sizeof(u));
+        const uint32_t sign = u & 0x80000000u;
+        u ^= sign;
+
+        uint32_t h;
+        if (u >= (127u + 16u) << 23) {
+            h = u > 0x7F800000u ? 0x7E00u : 0x7C00u;
+        }
+        else if (u < 113u << 23) {
+            // Subnormal o cero: sumar 0.5 alinea los 10 bits de mantisa al fondo del float
+            // y la suma de punto flotante ya redondea al par.
+            const uint32_t magicBits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+            float value;
+            float magic;
+            memcpy(&value, &u, sizeof(value));
+            memcpy(&magic, &magicBits, sizeof(magic));
+            value += magic;
+            memcpy(&h, &value, sizeof(h));
+            h -= magicBits;
+        }
+        else {
+            const uint32_t odd = (u >> 13) & 1u;
+            u += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFFu + odd;
+            h = u >> 13;
+        }
+        return static_cast<uint16_t>(h | (sign >> 16));
+    }
+
+    /// binary16 a float (exacto; un NaN conserva su carga, sin volverse silencioso).
+    inline float halfToFloat(uint16_t h) {
+        const uint32_t shiftedExp = 0x7C00u << 13;
+        uint32_t u = (h & 0x7FFFu) << 13;
+        const uint32_t exp = u & shiftedExp;
+        u += (127u - 15u) << 23;
+        if (exp == shiftedExp) {
+            u += (128u - 16u) << 23;    // Inf/NaN.
+        }
+        else if (exp == 0) {
+            // Subnormal: se normaliza restando el valor del exponente implicito.
+            u += 1u << 23;
+            const uint32_t magicBits = 113u << 23;
+            float value;
+            float magic;
+            memcpy(&value, &u, sizeof(value));
+            memcpy(&magic, &magicBits, sizeof(magic));
+            value -= magic;
+            memcpy(&u, &value, sizeof(u));
+        }
+        u |= static_cast<uint32_t>(h & 0x8000u) << 16;
+        float f;
+        memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+
+#if defined(SIMD_BACKEND_AVX2) || defined(SIMD_BACKEND_SSE)
+    namespace detail {
+        inline __m128i selectInt(__m128i mask, __m128i a, __m128i b) {
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        /// floatToHalf() de 4 lanes; cada resultado queda en los 16 bits bajos de su lane.
+        inline __m128i floatToHalf4(__m128 f) {
+            const __m128i bits = _mm_castps_si128(f);
+            const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+            const __m128i u = _mm_xor_si128(bits, sign);
+
+            const __m128i isNan = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x7F800000));
+            const __m128i infNan = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(isNan, _mm_set1_epi32(0x0200)));
+            const __m128i overflow = _mm_cmpgt_epi32(u, _mm_set1_epi32(((127 + 16) << 23) - 1));
+
+            const __m128i magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+            const __m128i subnormal = _mm_sub_epi32(
+                _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(u), _mm_castsi128_ps(magic))), magic);
+
+            const __m128i odd = _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(1));
+            __m128i normal = _mm_add_epi32(u, _mm_set1_epi32(static_cast<int>((static_cast<uint32_t>(15 - 127) << 23) + 0xFFFu)));
+            normal = _mm_srli_epi32(_mm_add_epi32(normal, odd), 13);
+
+            __m128i h = selectInt(_mm_cmplt_epi32(u, _mm_set1_epi32(113 << 23)), subnormal, normal);
+            h = selectInt(overflow, infNan, h);
+            return _mm_or_si128(h, _mm_srli_epi32(sign, 16));
+        }
+
+        /// halfToFloat() de 4 lanes; cada medio float en los 16 bits bajos de su lane.
+        inline __m128 halfToFloat4(__m128i h) {
+            const __m128i shiftedExp = _mm_set1_epi32(0x7C00 << 13);
+            __m128i u = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+            const __m128i exp = _mm_and_si128(u, shiftedExp);
+            u = _mm_add_epi32(u, _mm_set1_epi32((127 - 15) << 23));
+            u = _mm_add_epi32(u, _mm_and_si128(_mm_cmpeq_epi32(exp, shiftedExp), _mm_set1_epi32((128 - 16) << 23)));
+
+            const __m128 renormalized = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(u, _mm_set1_epi32(1 << 23))),
+                                                   _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+            u = selectInt(_mm_cmpeq_epi32(exp, _mm_setzero_si128()), _mm_castps_si128(renormalized), u);
+            u = _mm_or_si128(u, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+            return _mm_castsi128_ps(u);
+        }
+
+        /// Junta los 16 bits bajos de cada lane (0 a 0xFFFF) en 4 uint16_t.
+        inline void storeHalves4(uint16_t* p, __m128i h) {
+            // packs_epi32 satura con signo: se extiende el bit 15 para que los valores >= 0x8000 pasen tal cual.
+            const __m128i signExtended = _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(signExtended, signExtended));
+        }
+
+        inline __m128i loadHalves4(const uint16_t* p) {
+            return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128());
+        }
+    }
+#endif
+
+#if defined(SIMD_BACKEND_AVX2)
+    /// Guarda SIMD_LANES medios floats consecutivos.
+    inline void storeHalves(uint16_t* p, FloatV v) {
+#if defined(__F16C__) || defined(_MSC_VER)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+#else
+        detail::storeHalves4(p, detail::floatToHalf4(_mm256_castps256_ps128(v)));
+        detail::storeHalves4(p + 4, detail::floatToHalf4(_mm256_extractf128_ps(v, 1)));
+#endif
+    }
+    /// Lee SIMD_LANES medios floats consecutivos.
+    inline FloatV loadHalves(const uint16_t* p) {
+#if defined(__F16C__) || defined(_MSC_VER)
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+#else
+        return _mm256_set_m128(detail::halfToFloat4(detail::loadHalves4(p + 4)),
+                               detail::halfToFloat4(detail::loadHalves4(p)));
+#endif
+    }
+#elif defined(SIMD_BACKEND_SSE)
+    inline void storeHalves(uint16_t* p, FloatV v) { detail::storeHalves4(p, detail::floatToHalf4(v)); }
+    inline FloatV loadHalves(const uint16_t* p) { return detail::halfToFloat4(detail::loadHalves4(p)); }
+#elif defined(SIMD_BACKEND_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    inline void storeHalves(uint16_t* p, FloatV v) { vst1_u16(p, vreinterpret_u16_f16(vcvt_f16_f32(v))); }
+    inline FloatV loadHalves(const uint16_t* p) { return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(p))); }
+#else
+    inline void storeHalves(uint16_t* p, FloatV v) {
+        float values[SIMD_LANES];
+        store(values, v);
+        for (int i = 0; i < SIMD_LANES; ++i) {
+            p[i] = floatToHalf(values[i]);
+        }
+    }
+    inline FloatV loadHalves(const uint16_t* p) {
+        float values[SIMD_LANES];
+        for (int i = 0; i < SIMD_LANES; ++i) {
+            values[i] = halfToFloat(p[i]);
+        }
+        return load(values);
+    }
+#endif
+}
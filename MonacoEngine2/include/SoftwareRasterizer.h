@@ -0,0 +1,154 @@
+/**
+ * @file SoftwareRasterizer.h
+ * @brief Declara la clase SoftwareRasterizer, un backend de render en CPU sin GPU.
+ *
+ * Consume los mismos vertices/indices que los buffers de D3D11 y las mismas matrices que los
+ * constant buffers, como Matrix4 sin transponer. Reproduce la ruta por defecto de
+ * MonacoEngine2.fx: transformacion World-View-Projection, prueba de profundidad LESS, culling
+ * de caras traseras y color = textura (lineal, WRAP) * vMeshColor.
+ *
+ * La pantalla se divide en tiles; los triangulos se clasifican por tile y cada tile se
+ * rasteriza en paralelo con funciones de borde evaluadas con simd::FloatV (SIMD_LANES pixeles
+ * por instruccion). No depende de Direct3D: es parte de MonacoCore y sirve para comparar
+ * imagenes sin GPU (benchmark "softraster").
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Image.h"
+
+class JobSystem;
+class MeshComponent;
+
+/**
+ * @struct RasterStats
+ * @brief Tiempos por etapa y contadores del ultimo dibujo.
+ */
+struct RasterStats {
+    double vertexMs = 0.0;                  ///< Transformacion de vertices.
+    double binningMs = 0.0;                 ///< Setup, recorte y clasificacion por tile.
+    double rasterMs = 0.0;                  ///< Rasterizacion, profundidad y sombreado.
+    unsigned int trianglesIn = 0;           ///< Triangulos recibidos.
+    unsigned int trianglesCulled = 0;       ///< Descartados (caras traseras, fuera de pantalla, degenerados).
+    unsigned int trianglesClipped = 0;      ///< Triangulos que cruzaron un plano de recorte.
+    unsigned long long pixelsShaded = 0;    ///< Pixeles que pasaron la prueba de profundidad.
+};
+
+/**
+ * @class SoftwareRasterizer
+ * @brief Rasterizador por tiles multihilo con SIMD.
+ */
+class SoftwareRasterizer {
+public:
+    /// Tamano de tile en pixeles (multiplo de simd::SIMD_LANES).
+    static const unsigned int TILE_SIZE = 64;
+
+    /// Triangulos por bloque de clasificacion. Los bloques conservan el orden de dibujo.
+    static const unsigned int TRIANGLES_PER_CHUNK = 2048;
+
+    SoftwareRasterizer() = default;
+    ~SoftwareRasterizer() = default;
+
+    /**
+     * @brief Crea los buffers de color (RGBA8) y profundidad.
+     * @param width     Ancho del render target.
+     * @param height    Alto del render target.
+     * @param jobSystem Pool de hilos usado por todas las etapas.
+     * @return @c S_OK si fue exitoso.
+     */
+    HRESULT init(unsigned int width, unsigned int height, JobSystem& jobSystem);
+
+    /**
+     * @brief Fija las constantes de los siguientes dibujos.
+     * @param worldViewProj World * View * Projection (vector fila, sin transponer).
+     * @param meshColor     vMeshColor del shader.
+     */
+    void update(const Matrix4& worldViewProj, const Vector4& meshColor);
+
+    /// Textura usada en el slot 0. Sin textura se usa blanco.
+    void setTexture(const Image* texture) { m_texture = texture; }
+
+    /// Limpia color y profundidad.
+    void clear(const float color[4], float depth = 1.0f);
+
+    /// Dibuja todos los indices de la malla.
+    void render(const MeshComponent& mesh);
+
+    /**
+     * @brief Equivalente a DrawIndexed sobre arreglos de CPU.
+     * @param vertices    Vertices (mismo formato que el vertex buffer).
+     * @param numVertices Numero de vertices.
+     * @param indices     Indices de 32 bits (lista de triangulos).
+     * @param indexCount  Numero de indices a dibujar.
+     */
+    void drawIndexed(const SimpleVertex* vertices,
+                    unsigned int numVertices,
+                    const unsigned int* indices,
+                    unsigned int indexCount);
+
+    /// Libera los buffers.
+    void destroy();
+
+    /// Buffer de color resultante.
+    const Image& getColorBuffer() const { return m_colorBuffer; }
+
+    /// Buffer de profundidad resultante (z/w en [0, 1]).
+    const std::vector<float>& getDepthBuffer() const { return m_depthBuffer; }
+
+    /// Estadisticas del ultimo drawIndexed.
+    const RasterStats& getStats() const { return m_stats; }
+
+private:
+    /// Vertice en espacio de recorte.
+    struct ClipVertex {
+        float x, y, z, w;
+        float u, v;
+    };
+
+    /// Triangulo listo para rasterizar: funciones de borde y planos de interpolacion.
+    struct SetupTriangle {
+        float edgeA[3], edgeB[3], edgeC[3]; ///< E(x,y) = A*x + B*y + C, positivo adentro.
+        unsigned int topLeft;               ///< Bit i = el borde i cumple la regla top-left.
+        float z[3];                         ///< Plano de profundidad z/w.
+        float invW[3];                      ///< Plano de 1/w.
+        float uOverW[3];                    ///< Plano de u/w.
+        float vOverW[3];                    ///< Plano de v/w.
+        int minX, minY, maxX, maxY;         ///< Caja en pixeles (inclusiva).
+    };
+
+    /// Recorta contra el plano cercano y la banda de guarda; arma y clasifica los triangulos.
+    void setupTriangle(const ClipVertex& v0,
+                        const ClipVertex& v1,
+                        const ClipVertex& v2,
+                        unsigned int chunk,
+                        unsigned int& culled,
+                        unsigned int& clipped);
+
+    /// Convierte un triangulo ya recortado a pantalla y lo agrega a los tiles que toca.
+    bool binTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, unsigned int chunk);
+
+    /// Rasteriza todos los triangulos clasificados en un tile.
+    unsigned long long rasterizeTile(unsigned int tile);
+
+private:
+    unsigned int m_width = 0;
+    unsigned int m_height = 0;
+    unsigned int m_tilesX = 0;
+    unsigned int m_tilesY = 0;
+    JobSystem* m_jobSystem = nullptr;
+
+    Image m_colorBuffer;                    ///< Render target RGBA8.
+    std::vector<float> m_depthBuffer;       ///< Profundidad por pixel.
+    const Image* m_texture = nullptr;       ///< Textura del slot 0.
+
+    Matrix4 m_worldViewProj = Matrix4::identity();          ///< World * View * Projection (vector fila).
+    Vector4 m_meshColor = Vector4(1.0f, 1.0f, 1.0f, 1.0f);  ///< vMeshColor.
+
+    std::vector<ClipVertex> m_clipVertices;                ///< Salida de la etapa de vertices.
+    std::vector<std::vector<SetupTriangle>> m_triangles;   ///< Triangulos por bloque.
+    std::vector<std::vector<unsigned int>> m_bins;         ///< [bloque * tiles + tile] -> triangulos.
+    unsigned int m_numChunks = 0;
+
+    RasterStats m_stats;
+};
@@ -0,0 +1,145 @@
+/**
+ * @file SpatialGrid.h
+ * @brief Declara la clase SpatialGrid, rejilla uniforme dispersa (hash) y holgada para objetos dinamicos.
+ *
+ * Cada objeto se guarda en la celda que contiene el centro de su caja. La rejilla es "holgada":
+ * la caja de una celda se extiende media celda por lado, de modo que cualquier objeto cuya
+ * semi-extension no supere media celda queda completamente dentro de la caja holgada de su
+ * celda. Los objetos mas grandes van a una lista aparte que se prueba en cada consulta.
+ *
+ * Insertar, mover y eliminar son O(1) amortizado: solo existen en memoria las celdas ocupadas
+ * (tabla hash por coordenada) y cada objeto guarda su posicion dentro del arreglo de su
+ * celda, que se elimina intercambiandolo con el ultimo. Mover un objeto sin cambiar de celda
+ * solo actualiza su caja.
+ *
+ * Las consultas por frustum prueban primero las cajas holgadas de todas las celdas ocupadas
+ * con FrustumCuller (SIMD y en paralelo) y despues los objetos de las celdas visibles.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "BoundsTable.h"
+#include <unordered_map>
+
+class FrustumCuller;
+
+/**
+ * @struct SpatialGridStats
+ * @brief Tiempos y contadores de la ultima consulta por frustum.
+ */
+struct SpatialGridStats {
+    double queryMs = 0.0;               ///< Ultima consulta por frustum.
+    unsigned int cellsTested = 0;       ///< Celdas ocupadas probadas.
+    unsigned int cellsVisible = 0;      ///< Celdas que intersectan el frustum.
+    unsigned int objectsTested = 0;     ///< Objetos probados individualmente.
+    unsigned int objectsVisible = 0;    ///< Objetos devueltos.
+};
+
+/**
+ * @class SpatialGrid
+ * @brief Indice espacial para objetos que se mueven cada frame.
+ */
+class SpatialGrid {
+public:
+    /// Handle invalido.
+    static const unsigned int INVALID_HANDLE = 0xffffffffu;
+
+    SpatialGrid() = default;
+    ~SpatialGrid() = default;
+
+    /**
+     * @brief Inicializa una rejilla vacia.
+     * @param cellSize Lado de la celda; conviene del orden del doble del objeto tipico.
+     */
+    HRESULT init(float cellSize);
+
+    /**
+     * @brief Inserta un objeto.
+     * @param box      Caja en espacio de mundo.
+     * @param userData Valor que devuelven las consultas (p. ej. indice de la entidad).
+     * @return Handle del objeto.
+     */
+    unsigned int insert(const AABB& box, unsigned int userData);
+
+    /// Actualiza la caja de un objeto y lo cambia de celda si hace falta.
+    void move(unsigned int handle, const AABB& box);
+
+    /// Elimina un objeto; su handle puede reutilizarse en un insert() posterior.
+    void remove(unsigned int handle);
+
+    /// Elimina todos los objetos y celdas.
+    void clear();
+
+    /**
+     * @brief Objetos cuya caja intersecta el frustum.
+     * @param culler Culler con los planos del frame (FrustumCuller::update()).
+     * @param out    Salida: userData de los objetos visibles.
+     */
+    void queryFrustum(FrustumCuller& culler, std::vector<unsigned int>& out);
+
+    /// Agrega a @p out el userData de los objetos cuya caja se solapa con la esfera.
+    void querySphere(const Vector3& center, float radius, std::vector<unsigned int>& out) const;
+
+    /// Agrega a @p out el userData de los objetos cuya caja se solapa con @p box.
+    void queryAABB(const AABB& box, std::vector<unsigned int>& out) const;
+
+    /// Libera la memoria.
+    void destroy();
+
+    unsigned int getObjectCount() const { return m_objectCount; }
+    unsigned int getCellCount() const { return static_cast<unsigned int>(m_cells.size()); }
+    float getCellSize() const { return m_cellSize; }
+    const SpatialGridStats& getStats() const { return m_stats; }
+
+private:
+    /// Celda de los objetos demasiado grandes para la rejilla.
+    static const unsigned int OVERSIZED_CELL = 0xfffffffeu;
+
+    struct Object {
+        AABB box;
+        unsigned int userData;
+        unsigned int cell;      ///< Indice en m_cells, OVERSIZED_CELL o INVALID_HANDLE si esta libre.
+        unsigned int slot;      ///< Posicion dentro de la lista de su celda.
+    };
+
+    struct Cell {
+        int x, y, z;
+        std::vector<unsigned int> objects;
+    };
+
+    /// Celda (o OVERSIZED_CELL) que corresponde a la caja.
+    unsigned int findOrCreateCell(const AABB& box);
+
+    /// Coordenadas de celda de un punto.
+    void cellCoords(float x, float y, float z, int& cx, int& cy, int& cz) const;
+
+    /// Clave hash de unas coordenadas de celda.
+    static unsigned long long cellKey(int x, int y, int z);
+
+    /// Agrega el objeto a la lista de su celda.
+    void link(unsigned int handle, unsigned int cell);
+
+    /// Quita el objeto de la lista de su celda (y la celda si queda vacia).
+    void unlink(unsigned int handle);
+
+    /// Caja holgada de una celda.
+    AABB looseBounds(const Cell& cell) const;
+
+    /// Llama a @p func(cell) para cada celda cuya caja holgada se solapa con [min, max].
+    template<class CellFunc>
+    void forEachCell(const Vector3& min, const Vector3& max, CellFunc&& func) const;
+
+private:
+    float m_cellSize = 1.0f;
+    float m_invCellSize = 1.0f;
+    std::vector<Object> m_objects;
+    std::vector<unsigned int> m_freeHandles;
+    std::vector<Cell> m_cells;                                  ///< Celdas ocupadas.
+    std::unordered_map<unsigned long long, unsigned int> m_cellMap;
+    BoundsTable m_cellBounds;                                   ///< Cajas holgadas, paralelo a m_cells.
+    std::vector<unsigned int> m_oversized;                      ///< Objetos mas grandes que media celda.
+    std::vector<unsigned int> m_visibleCells;
+    unsigned int m_objectCount = 0;
+    SpatialGridStats m_stats;
+};
@@ -2,6 +2,14 @@
 #include "Prerequisites.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "Image.h"
+#include "MipChain.h"
+#include "UploadArena.h"
+#include "BlockCompression.h"
+#include "DdsFile.h"
+#include "ColorSpace.h"
+#include "HdrImage.h"
+#include "CubeMap.h"
 
 class Device;
 class DeviceContext;
@@ -37,6 +45,8 @@ public:
      * @param device        Dispositivo con el que se crear la textura.
      * @param textureName   Nombre o ruta del archivo de textura.
      * @param extensionType Tipo de extensin de archivo (ej. PNG, JPG, DDS).
+     * @param colorSpace    @c Srgb para mapas de color (formato @c _SRGB); @c Linear para mapas
+     *                      de datos como normales o rugosidad (formato @c UNORM).
      * @return @c S_OK si fue exitoso; cdigo @c HRESULT en caso contrario.
      *
      * @post Si retorna @c S_OK, @c m_texture y @c m_textureFromImg != nullptr.
@@ -44,7 +54,114 @@ public:
     HRESULT
         init(Device& device,
             const std::string& textureName,
-            ExtensionType extensionType);
+            ExtensionType extensionType,
+            ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Inicializa una textura a partir de una imagen RGBA8 ya decodificada.
+     *
+     * Crea la textura (DXGI_FORMAT_R8G8B8A8_UNORM o su variante @c _SRGB, un nivel de mip) y su
+     * @c ShaderResourceView. La usa la textura de reemplazo de TextureUploadQueue.
+     *
+     * @param device     Dispositivo con el que se crear la textura.
+     * @param image      Imagen de 4 canales.
+     * @param colorSpace Espacio de color de los canales RGB.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si la imagen est vaca o no es RGBA8.
+     */
+    HRESULT
+        init(Device& device, const Image& image, ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Inicializa una textura con todos los niveles de una cadena de mipmaps.
+     *
+     * Cada nivel se pasa como un @c D3D11_SUBRESOURCE_DATA y la vista cubre la cadena completa.
+     *
+     * @param device Dispositivo con el que se crear la textura.
+     * @param mips   Niveles RGBA8 generados con MipChain::generate().
+     * @param colorSpace Espacio de color de los canales RGB (debe coincidir con MipSettings::srgb).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si la cadena est vaca.
+     */
+    HRESULT
+        init(Device& device, const MipChain& mips, ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Inicializa una textura con una cadena de mipmaps que est en una UploadArena.
+     *
+     * Los niveles se pasan a D3D11 con el pitch de cada vista, sin copiarlos antes; la arena
+     * puede reutilizarse en cuanto esta funcin regresa.
+     *
+     * @param device Dispositivo con el que se crear la textura.
+     * @param image  Niveles de UploadArena::decodeImage().
+     * @param colorSpace Espacio de color de los canales RGB (debe coincidir con MipSettings::srgb).
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si no hay niveles.
+     */
+    HRESULT
+        init(Device& device, const UploadImage& image, ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Inicializa una textura con niveles ya comprimidos por bloques (BC1/BC3/BC4/BC5/BC7).
+     *
+     * Los bloques se suben tal cual (@c SysMemPitch = BlockImage::getRowPitch()), sin
+     * descomprimir; la GPU los muestrea directamente desde el formato @c DXGI_FORMAT_BCn_UNORM
+     * (o @c BCn_UNORM_SRGB para BC1/BC3/BC7 en @c Srgb; BC4/BC5 siempre son datos).
+     *
+     * @param device Dispositivo con el que se crear la textura.
+     * @param levels Niveles de BlockImage::encodeMips(), del ms grande al ms pequeo.
+     * @param colorSpace Espacio de color de los canales RGB.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si no hay niveles o el nivel 0 no es
+     *         mltiplo de 4 (requisito de D3D11 para formatos de bloque).
+     */
+    HRESULT
+        init(Device& device, const std::vector<BlockImage>& levels, ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Inicializa una textura HDR con los niveles de HdrImage::generateMips().
+     *
+     * Cada nivel se empaqueta con HdrImage::pack() en @p format antes de subirlo; los datos
+     * HDR son lineales, as que no hay variante sRGB.
+     *
+     * @param device Dispositivo con el que se crear la textura.
+     * @param levels Niveles del ms grande al ms pequeo.
+     * @param format @c R16G16B16A16_FLOAT, @c R11G11B10_FLOAT (sin alfa, la mitad de memoria)
+     *               o @c R32G32B32A32_FLOAT.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si no hay niveles o el formato no es vlido.
+     */
+    HRESULT
+        init(Device& device, const std::vector<HdrImage>& levels,
+            DdsFormat format = DdsFormat::R16G16B16A16_FLOAT);
+
+    /**
+     * @brief Inicializa un cubemap (@c TEXTURECUBE) con los niveles de un CubeMap en CPU.
+     *
+     * Sirve tanto para un entorno convertido con CubeMap::initFromEquirect() como para la
+     * cadena especular de EnvironmentPrefilter::prefilterSpecular().
+     *
+     * @param device Dispositivo con el que se crear la textura.
+     * @param levels Niveles del ms grande al ms pequeo; cada uno mide la mitad del anterior.
+     * @param format Igual que en la sobrecarga de HdrImage.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si no hay niveles o el formato no es vlido.
+     */
+    HRESULT
+        init(Device& device, const std::vector<CubeMap>& levels,
+            DdsFormat format = DdsFormat::R16G16B16A16_FLOAT);
+
+    /**
+     * @brief Inicializa una textura 2D, arreglo o cubemap desde un DDS ya cargado.
+     *
+     * Cada @c D3D11_SUBRESOURCE_DATA apunta directamente a los datos de @p dds (la proyeccion
+     * del archivo); D3D11 los copia al crear la textura, as que @p dds puede liberarse despus.
+     *
+     * @param device   Dispositivo con el que se crear la textura.
+     * @param dds      Archivo cargado con DdsFile::loadFromFile().
+     * @param firstMip Primer nivel que se sube; los anteriores se omiten (ver TextureStreamer).
+     * @param colorSpace Elige la variante @c _SRGB o @c UNORM del formato del archivo cuando
+     *                 existe (DdsFile::withColorSpace()); los dems formatos se usan tal cual.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si @p dds est vaco o @p firstMip no
+     *         existe; @c E_NOTIMPL para texturas de volumen.
+     */
+    HRESULT
+        init(Device& device, const DdsFile& dds, unsigned int firstMip = 0,
+            ColorSpace colorSpace = ColorSpace::Srgb);
 
     /**
      * @brief Inicializa una textura creada desde memoria.
@@ -121,6 +238,22 @@ public:
     void
         destroy();
 
+private:
+    /**
+     * @brief Crea la textura y su vista con un subrecurso por nivel de mip y elemento.
+     * @param initData  Datos en orden de D3D11: todos los niveles del elemento 0, luego el 1...
+     * @param arraySize Elementos del arreglo (caras en cubemaps: 6 por cubo).
+     * @param cubemap   Crea la vista como @c TEXTURECUBE (o arreglo de cubos).
+     */
+    HRESULT
+        createFromLevels(Device& device,
+            unsigned int width,
+            unsigned int height,
+            DXGI_FORMAT format,
+            const std::vector<D3D11_SUBRESOURCE_DATA>& initData,
+            unsigned int arraySize = 1,
+            bool cubemap = false);
+
 public:
     /**
      * @brief Recurso base de la textura en GPU.
@@ -138,4 +271,9 @@ public:
      * @brief Nombre o ruta de la textura (si proviene de archivo).
      */
     std::string m_textureName;
+
+    /**
+     * @brief Espacio de color con el que se cre la textura (define el formato @c _SRGB o @c UNORM).
+     */
+    ColorSpace m_colorSpace = ColorSpace::Srgb;
 };
@@ -0,0 +1,159 @@
+/**
+ * @file TextureAtlas.h
+ * @brief Declara la clase TextureAtlas, empaquetado de texturas pequenas en atlas y arreglos.
+ *
+ * Paso de cocinado: las texturas pequenas de los props se juntan en paginas de atlas (MaxRects,
+ * mejor ajuste por lado corto) para que muchos materiales compartan una sola vista. Cada region
+ * se rodea de un margen que repite su borde y se alinea a 2^(mipLevels - 1) pixeles, asi los
+ * primeros mipLevels niveles de la pagina no mezclan regiones vecinas (con filtro Box; Kaiser
+ * lee 3 texeles alrededor en cada nivel y necesita un margen mayor).
+ *
+ * Las texturas que se repiten (UV fuera de 0..1) no pueden vivir en un atlas: se agrupan por
+ * tamano en arreglos (Texture2DArray), y el material indica la capa. Las texturas mayores que
+ * maxRegionSize se dejan como estan.
+ *
+ * Despues de empaquetar, remapUVs() lleva las UV de una submalla a su region de la pagina.
+ * No depende de Direct3D.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Image.h"
+
+class MeshComponent;
+struct SubMesh;
+
+/**
+ * @struct AtlasSettings
+ * @brief Opciones de TextureAtlas::build().
+ */
+struct AtlasSettings {
+    unsigned int maxPageSize = 4096;    ///< Lado maximo de una pagina (potencia de dos).
+    unsigned int maxRegionSize = 512;   ///< Las texturas con un lado mayor no se empaquetan.
+    unsigned int padding = 4;           ///< Margen minimo en pixeles alrededor de cada region.
+    unsigned int mipLevels = 4;         ///< Niveles sin mezcla entre regiones (define la alineacion).
+    bool useArrays = true;              ///< Agrupar las texturas que se repiten en arreglos.
+};
+
+/**
+ * @struct AtlasSource
+ * @brief Textura de entrada.
+ */
+struct AtlasSource {
+    const Image* image = nullptr;       ///< RGBA8; debe seguir viva durante build().
+    bool tiling = false;                ///< Sus UV salen de 0..1 (se repite): va a un arreglo.
+};
+
+/**
+ * @enum AtlasPlacement
+ * @brief Donde quedo una textura de entrada.
+ */
+enum class AtlasPlacement {
+    Page,       ///< Region de una pagina de atlas.
+    ArraySlice, ///< Capa de un arreglo.
+    Skipped     ///< Demasiado grande, o repetida sin useArrays: conserva su propia textura.
+};
+
+/**
+ * @struct AtlasRegion
+ * @brief Ubicacion de una textura de entrada en la salida.
+ */
+struct AtlasRegion {
+    AtlasPlacement placement = AtlasPlacement::Skipped;
+    unsigned int target = 0;            ///< Pagina o arreglo.
+    unsigned int slice = 0;             ///< Capa dentro del arreglo.
+    unsigned int x = 0;                 ///< Esquina de la region en la pagina (sin margen).
+    unsigned int y = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    Vector2 uvOffset = Vector2(0.0f, 0.0f); ///< uv' = uv * uvScale + uvOffset.
+    Vector2 uvScale = Vector2(1.0f, 1.0f);
+};
+
+/**
+ * @struct AtlasArray
+ * @brief Arreglo de texturas del mismo tamano.
+ */
+struct AtlasArray {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::vector<Image> slices;
+};
+
+/**
+ * @struct AtlasStats
+ * @brief Resultado de build().
+ */
+struct AtlasStats {
+    unsigned int sources = 0;
+    unsigned int packed = 0;            ///< En paginas.
+    unsigned int sliced = 0;            ///< En arreglos.
+    unsigned int skipped = 0;
+    unsigned int pages = 0;
+    unsigned int arrays = 0;
+    double efficiency = 0.0;            ///< Pixeles de las regiones entre pixeles de las paginas.
+    double paddedEfficiency = 0.0;      ///< Lo mismo contando margenes y alineacion.
+    double buildMs = 0.0;
+};
+
+/**
+ * @class TextureAtlas
+ * @brief Paginas de atlas y arreglos construidos a partir de muchas texturas pequenas.
+ */
+class TextureAtlas {
+public:
+    TextureAtlas() = default;
+    ~TextureAtlas() = default;
+
+    /**
+     * @brief Empaqueta @p sources.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si alguna entrada no es RGBA8 o las
+     *         opciones no son validas.
+     */
+    HRESULT build(const std::vector<AtlasSource>& sources, const AtlasSettings& settings = AtlasSettings());
+
+    /// Libera paginas, arreglos y regiones.
+    void destroy();
+
+    /// Region de la entrada @p index (mismo orden que en build()).
+    const AtlasRegion& getRegion(unsigned int index) const { return m_regions[index]; }
+
+    const std::vector<Image>& getPages() const { return m_pages; }
+    const std::vector<AtlasArray>& getArrays() const { return m_arrays; }
+    const AtlasStats& getStats() const { return m_stats; }
+
+    /**
+     * @brief Lleva las UV de @p subMesh a @p region (solo regiones de pagina).
+     *
+     * @pre Los vertices de @p subMesh no los comparte otra submalla con otra region.
+     * @return @c S_OK si fue exitoso; @c E_INVALIDARG si alguna UV sale de 0..1 (la textura se
+     *         repite y debe ir a un arreglo) o la region no es de pagina. Sin cambios si falla.
+     */
+    static HRESULT remapUVs(MeshComponent& mesh, const SubMesh& subMesh, const AtlasRegion& region);
+
+private:
+    struct Rect {
+        unsigned int x, y, width, height;
+    };
+
+    /**
+     * @brief MaxRects en una pagina de @p width x @p height.
+     * @param sizes  Tamanos con margen, ya alineados.
+     * @param order  Indices a colocar, del mas grande al mas pequeno.
+     * @param placed Recibe la posicion de cada indice colocado (los demas quedan sin tocar).
+     * @return Indices que no cupieron.
+     */
+    static std::vector<unsigned int> packPage(unsigned int width, unsigned int height,
+                                              const std::vector<Rect>& sizes,
+                                              const std::vector<unsigned int>& order,
+                                              std::vector<Rect>& placed);
+
+    /// Copia @p source en @p page en (x, y) y repite su borde hasta llenar @p cell.
+    static void blit(Image& page, const Image& source, unsigned int x, unsigned int y, const Rect& cell);
+
+    std::vector<Image> m_pages;
+    std::vector<AtlasArray> m_arrays;
+    std::vector<AtlasRegion> m_regions;
+    AtlasStats m_stats;
+};
@@ -0,0 +1,114 @@
+/**
+ * @file TextureCache.h
+ * @brief Declara la clase TextureCache, texturas de GPU compartidas por ruta y por contenido.
+ *
+ * Envuelve una ResourceCache cuyos recursos son las vistas (@c ID3D11ShaderResourceView) de
+ * las texturas cargadas. Dos Texture que piden el mismo archivo, o dos archivos con los mismos
+ * bytes, apuntan a la misma vista: la textura de GPU se crea una sola vez. Las texturas que ya
+ * nadie usa quedan residentes hasta que la VRAM estimada supera el presupuesto; entonces se
+ * liberan las menos usadas.
+ *
+ * Cada Texture ligada guarda su propia referencia COM a la vista, asi que liberar la cache no
+ * invalida las texturas que siguen en uso.
+ *
+ * El espacio de color forma parte de la clave: el mismo archivo pedido como color (@c _SRGB) y
+ * como datos (@c UNORM) son dos texturas distintas.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "Prerequisites.h"
+#include "ResourceCache.h"
+#include "Texture.h"
+#include <unordered_map>
+
+class Device;
+
+/**
+ * @class TextureCache
+ * @brief Texturas compartidas con referencias contadas y presupuesto de VRAM.
+ */
+class TextureCache {
+public:
+    TextureCache() = default;
+    ~TextureCache() { destroy(); }
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    /**
+     * @brief Prepara la cache vacia.
+     * @param budgetBytes VRAM maxima que ocupan las texturas sin usar que se conservan.
+     */
+    HRESULT init(size_t budgetBytes);
+
+    /// Suelta la referencia de la cache a cada vista; las Texture ligadas conservan la suya.
+    void destroy();
+
+    /**
+     * @brief Carga @p textureName en @p texture, reutilizando una textura ya creada si la ruta o
+     *        el contenido del archivo coinciden.
+     *
+     * Version sincrona; TextureUploadQueue usa acquireCached(), acquireContent() e insert() para
+     * la carga en segundo plano.
+     *
+     * @pre @p texture no tiene recursos.
+     * @return @c S_OK si fue exitoso; el @c HRESULT de la carga en caso contrario.
+     */
+    HRESULT acquire(Device& device, Texture& texture, const std::string& textureName, ExtensionType extensionType,
+                    ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Liga @p texture a la textura de @p fileName si ya esta en la cache.
+     * @param fileName Ruta con extension (Texture::m_textureName).
+     * @return @c true si la encontro.
+     */
+    bool acquireCached(Texture& texture, const std::string& fileName, ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Liga @p texture a una textura con el mismo contenido y registra @p fileName como alias.
+     * @return @c true si la encontro.
+     */
+    bool acquireContent(Texture& texture, uint64_t contentHash, const std::string& fileName,
+                        ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /**
+     * @brief Registra la vista recien creada de @p texture con su espacio de color
+     *        (Texture::m_colorSpace); @p texture queda con la primera referencia.
+     * @param contentHash Hash de los bytes del archivo (0 si no se conoce).
+     */
+    void insert(Texture& texture, const std::string& fileName, uint64_t contentHash);
+
+    /// Liga @p texture a la misma vista que @p source, sumando una referencia si esta en la cache.
+    void share(const Texture& source, Texture& texture);
+
+    /**
+     * @brief Suelta la referencia de @p texture; si no venia de la cache, la destruye.
+     * @post @c texture.m_textureFromImg == nullptr.
+     */
+    void release(Texture& texture);
+
+    /// Cambia el presupuesto y libera las texturas sin usar que sobren.
+    void setBudget(size_t budgetBytes) { m_cache.setBudget(budgetBytes); }
+
+    /// Publica los contadores ("TextureCache::hits", "TextureCache::residentBytes", ...) en el Profiler.
+    void update() { m_cache.publishCounters("TextureCache"); }
+
+    const ResourceCacheStats& getStats() const { return m_cache.getStats(); }
+
+    /// VRAM aproximada de la textura detras de @p view (todos sus niveles y elementos).
+    static size_t estimateBytes(ID3D11ShaderResourceView* view);
+
+    /// Clave de ruta de @p fileName en @p colorSpace (la ruta tal cual para color).
+    static std::string cacheKey(const std::string& fileName, ColorSpace colorSpace);
+
+    /// Clave de contenido de @p contentHash en @p colorSpace (el hash tal cual para color).
+    static uint64_t contentKey(uint64_t contentHash, ColorSpace colorSpace);
+
+private:
+    /// Liga @p texture a la vista de @p handle con una referencia COM propia.
+    void bind(Texture& texture, ResourceHandle handle, const std::string& fileName, ColorSpace colorSpace);
+
+    ResourceCache m_cache;
+    std::unordered_map<ID3D11ShaderResourceView*, ResourceHandle> m_handles;  ///< Vista -> entrada.
+};
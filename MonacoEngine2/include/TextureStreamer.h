@@ -0,0 +1,193 @@
+/**
+ * @file TextureStreamer.h
+ * @brief Declara la clase TextureStreamer, residencia de mipmaps por demanda en pantalla.
+ *
+ * Cada textura registrada empieza con solo sus niveles pequenos (los de lado <= residentSize).
+ * Cada frame, beginFrame() recibe la camara y addDemand() cada objeto visible que usa la
+ * textura: con la distancia, el radio y la densidad de UV del objeto (texeles de la textura por
+ * unidad de mundo) se calcula el nivel que hace falta para que un texel cubra un pixel.
+ * update() pide los niveles que faltan, uno por textura y del mas necesario al menos necesario,
+ * mientras quepan en el presupuesto; para hacer lugar suelta primero los niveles que ya nadie
+ * necesita y despues los de menor prioridad que la solicitud. Mientras sobre presupuesto, los
+ * niveles que ya no se necesitan se conservan por si la camara regresa.
+ *
+ * La prioridad de tener el nivel @c m de una textura es su cobertura en pantalla (pixeles)
+ * por (1 + m - nivel pedido), y 0 para niveles mas finos que el pedido: faltar varios niveles
+ * pesa mas que faltar uno, y dos texturas que solo se quitan niveles entre si no oscilan.
+ *
+ * La lectura de cada nivel corre en el JobSystem (LoadFunction) y el cambio de residencia se
+ * avisa en el hilo de update() (ResidencyFunction), por ejemplo para recrear la textura con
+ * Texture::init(device, dds, firstMip). No depende de Direct3D.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "DdsFile.h"
+#include "JobSystem.h"
+#include <functional>
+#include <mutex>
+
+class MeshComponent;
+
+/**
+ * @struct TextureStreamerSettings
+ * @brief Opciones de TextureStreamer.
+ */
+struct TextureStreamerSettings {
+    size_t budgetBytes = 256u << 20;    ///< Memoria total de las texturas (niveles base incluidos).
+    size_t ioBytesPerFrame = 0;         ///< Bytes maximos pedidos por update() (0 = sin limite).
+    unsigned int residentSize = 64;     ///< Los niveles de este lado o menos estan siempre residentes.
+    unsigned int maxInFlight = 8;       ///< Lecturas simultaneas.
+    unsigned int keepFrames = 30;       ///< Frames sin demanda antes de considerar sobrantes sus niveles.
+    float mipBias = 0.0f;               ///< Se suma al nivel pedido (positivo = menos resolucion).
+    JobSystem* jobs = nullptr;          ///< Pool de las lecturas; sin el, se leen dentro de update().
+};
+
+/**
+ * @struct StreamingView
+ * @brief Camara con la que se calcula la demanda.
+ */
+struct StreamingView {
+    Vector3 position;
+    float fovY = 0.785398f;             ///< Campo de vision vertical en radianes.
+    float screenHeight = 1080.0f;       ///< Alto del viewport en pixeles.
+};
+
+/**
+ * @struct TextureStreamerStats
+ * @brief Estado despues del ultimo update() y totales.
+ */
+struct TextureStreamerStats {
+    size_t budgetBytes = 0;
+    size_t residentBytes = 0;           ///< Niveles residentes (base incluida).
+    size_t baseBytes = 0;               ///< Niveles siempre residentes.
+    size_t pendingBytes = 0;            ///< Niveles en lectura (ya reservados en el presupuesto).
+    size_t wantedBytes = 0;             ///< Lo que ocuparia tener cada textura en su nivel pedido.
+    unsigned int textures = 0;
+    unsigned int pendingRequests = 0;   ///< Lecturas en curso.
+    unsigned int missingLevels = 0;     ///< Suma de niveles que faltan para llegar al pedido.
+    unsigned int deniedRequests = 0;    ///< Solicitudes del ultimo update() que no cupieron (presion de presupuesto).
+    unsigned long long completed = 0;   ///< Niveles leidos desde init().
+    unsigned long long evictedLevels = 0;   ///< Niveles soltados desde init().
+    unsigned long long streamedBytes = 0;   ///< Bytes leidos desde init().
+    unsigned int failed = 0;            ///< Lecturas fallidas desde init().
+    double lastUpdateMs = 0.0;
+};
+
+/**
+ * @class TextureStreamer
+ * @brief Decide que mipmaps de cada textura estan en memoria y pide los que faltan.
+ */
+class TextureStreamer {
+public:
+    /// Lee el nivel @p mip de la textura @p texture; corre en un hilo del JobSystem.
+    typedef std::function<HRESULT(unsigned int texture, unsigned int mip)> LoadFunction;
+
+    /// Avisa que la textura @p texture tiene residentes los niveles @p firstMip en adelante.
+    typedef std::function<void(unsigned int texture, unsigned int firstMip)> ResidencyFunction;
+
+    TextureStreamer() = default;
+    ~TextureStreamer() { destroy(); }
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /**
+     * @brief Prepara el streamer sin texturas.
+     * @param load      Lectura de un nivel (debe poder llamarse desde varios hilos).
+     * @param residency Cambio de residencia (opcional); se llama desde update().
+     */
+    HRESULT init(const TextureStreamerSettings& settings, LoadFunction load, ResidencyFunction residency = nullptr);
+
+    /// Espera las lecturas en curso y olvida las texturas.
+    void destroy();
+
+    /**
+     * @brief Registra una textura con sus niveles base residentes.
+     *
+     * El llamador carga los niveles getResidentMip() en adelante; en formatos BC los niveles
+     * base empiezan en uno de lado multiplo de 4, como pide D3D11.
+     * @return Identificador para addDemand() y las consultas.
+     */
+    unsigned int addTexture(const std::string& name, const DdsDesc& desc);
+
+    /// Empieza un frame con la camara @p view.
+    void beginFrame(const StreamingView& view);
+
+    /**
+     * @brief Registra un objeto visible que usa @p texture.
+     * @param center     Centro de la esfera envolvente en mundo.
+     * @param radius     Radio de la esfera.
+     * @param uvDensity  Unidades de UV por unidad de mundo (ver computeUvDensity()).
+     */
+    void addDemand(unsigned int texture, const Vector3& center, float radius, float uvDensity);
+
+    /// Aplica las lecturas terminadas, suelta niveles y pide los que faltan; publica los contadores.
+    void update();
+
+    /// Bloquea hasta que terminen las lecturas en curso (las aplica el proximo update()).
+    void waitIdle();
+
+    /// Nivel mas detallado residente de @p texture.
+    unsigned int getResidentMip(unsigned int texture) const { return m_textures[texture].residentMip; }
+
+    /// Nivel que pide la demanda actual de @p texture.
+    unsigned int getWantedMip(unsigned int texture) const { return m_textures[texture].wantedMip; }
+
+    /// Nivel base (siempre residente) de @p texture.
+    unsigned int getBaseMip(unsigned int texture) const { return m_textures[texture].baseMip; }
+
+    unsigned int getTextureCount() const { return static_cast<unsigned int>(m_textures.size()); }
+
+    const TextureStreamerStats& getStats() const { return m_stats; }
+
+    /**
+     * @brief Unidades de UV por unidad de mundo de @p mesh: raiz del area total en UV entre el
+     *        area total en mundo (promedio ponderado por area de los triangulos).
+     * @return 0 si la malla no tiene area.
+     */
+    static float computeUvDensity(const MeshComponent& mesh);
+
+private:
+    struct StreamedTexture {
+        std::string name;
+        unsigned int width = 0;
+        unsigned int height = 0;
+        std::vector<size_t> levelBytes;     ///< Bytes de cada nivel (todas las caras y elementos).
+        unsigned int baseMip = 0;
+        unsigned int residentMip = 0;
+        unsigned int wantedMip = 0;
+        unsigned int demandFrame = 0;       ///< Ultimo frame con addDemand().
+        float coverage = 0.0f;              ///< Pixeles en pantalla del mayor objeto que la usa.
+        bool loading = false;
+    };
+
+    struct Completion {
+        unsigned int texture;
+        unsigned int mip;
+        HRESULT result;
+    };
+
+    /// Prioridad de tener residente el nivel @p mip de @p texture.
+    float levelPriority(const StreamedTexture& texture, unsigned int mip) const;
+
+    /// Suelta el nivel mas detallado de @p index y avisa el cambio.
+    void evictLevel(unsigned int index);
+
+    /// Aplica las lecturas terminadas.
+    void applyCompletions();
+
+    TextureStreamerSettings m_settings;
+    LoadFunction m_load;
+    ResidencyFunction m_residency;
+    std::vector<StreamedTexture> m_textures;
+    StreamingView m_view;
+    unsigned int m_frame = 0;
+    float m_pixelsPerUnit = 1.0f;           ///< Pixeles por unidad de mundo a distancia 1.
+
+    JobCounter m_counter;
+    std::mutex m_mutex;                     ///< Protege m_completions.
+    std::vector<Completion> m_completions;
+    TextureStreamerStats m_stats;
+};
@@ -0,0 +1,109 @@
+/**
+ * @file TextureUploadQueue.h
+ * @brief Declara la clase TextureUploadQueue, carga de texturas sin bloquear el hilo de render.
+ *
+ * request() deja la textura destino apuntando a una textura de reemplazo (un damero de 8x8)
+ * y pide a ImageDecodeQueue que lea y decodifique el archivo, y genere sus mipmaps, en los
+ * hilos del JobSystem.
+ * update(), llamado una vez por frame desde el hilo del dispositivo, crea las texturas de GPU
+ * de las imagenes ya decodificadas por lotes hasta agotar un presupuesto de tiempo, y cambia
+ * la vista de la textura destino por la definitiva.
+ *
+ * Varias solicitudes del mismo archivo comparten una sola decodificacion. Con una TextureCache,
+ * un archivo ya cargado se liga sin decodificar y uno con el mismo contenido que otro reutiliza
+ * su textura de GPU; las texturas ligadas asi se liberan con TextureCache::release().
+ * Cada solicitud lleva su espacio de color: el mismo archivo como color y como datos son dos
+ * decodificaciones y dos texturas.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "Prerequisites.h"
+#include "ImageDecodeQueue.h"
+#include "Texture.h"
+#include <unordered_map>
+
+class Device;
+class TextureCache;
+
+/**
+ * @struct TextureUploadStats
+ * @brief Contadores del ultimo update() y totales.
+ */
+struct TextureUploadStats {
+    double lastUpdateMs = 0.0;          ///< Duracion del ultimo update().
+    unsigned int lastUploaded = 0;      ///< Texturas creadas en el ultimo update().
+    unsigned int uploaded = 0;          ///< Texturas creadas desde init().
+    unsigned int failed = 0;            ///< Solicitudes que no se pudieron decodificar o crear.
+    unsigned int shared = 0;            ///< Solicitudes que se unieron a una decodificacion en curso.
+};
+
+/**
+ * @class TextureUploadQueue
+ * @brief Decodificacion en segundo plano + creacion de texturas con presupuesto por frame.
+ */
+class TextureUploadQueue {
+public:
+    TextureUploadQueue() = default;
+    ~TextureUploadQueue() = default;
+
+    /**
+     * @brief Crea la textura de reemplazo e inicializa la cola de decodificacion.
+     * @param device Dispositivo para la textura de reemplazo.
+     * @param jobs   Pool donde se decodifican las imagenes.
+     * @param cache  Cache donde se buscan y registran las texturas (opcional); debe vivir mas que la cola.
+     */
+    HRESULT init(Device& device, JobSystem& jobs, TextureCache* cache = nullptr);
+
+    /// Espera las decodificaciones en curso y libera la textura de reemplazo.
+    void destroy();
+
+    /**
+     * @brief Pide cargar @p textureName en @p texture sin bloquear.
+     *
+     * @p texture usa la textura de reemplazo hasta que update() crea la definitiva. DDS se
+     * sigue cargando en el acto (DdsFile proyectado en memoria, sin decodificar), igual que un
+     * archivo que ya esta en la cache; HDR tambien se carga en el acto (Texture::init()).
+     *
+     * @param colorSpace @c Srgb para mapas de color; @c Linear para normales, rugosidad y mascaras.
+     * @pre @p texture no tiene recursos y vive hasta que la carga termina o se llama a cancel().
+     * @return @c S_OK si la solicitud se encolo (o el DDS se cargo).
+     */
+    HRESULT request(Device& device, Texture& texture, const std::string& textureName, ExtensionType extensionType,
+                    ColorSpace colorSpace = ColorSpace::Srgb);
+
+    /// Olvida las solicitudes pendientes de @p texture (la textura conserva el reemplazo).
+    void cancel(Texture& texture);
+
+    /**
+     * @brief Crea las texturas decodificadas hasta gastar @p budgetMs.
+     *
+     * Siempre crea al menos una si hay alguna lista, para que un presupuesto pequeno no
+     * detenga la carga.
+     * @return Texturas creadas en esta llamada.
+     */
+    unsigned int update(Device& device, double budgetMs);
+
+    /// @c true si no quedan solicitudes por decodificar ni por crear.
+    bool isIdle() const { return m_pending.empty(); }
+
+    /// Bloquea hasta que todas las solicitudes esten decodificadas (las crea el proximo update()).
+    void waitDecoded() { m_decoder.waitIdle(); }
+
+    /// Textura de reemplazo.
+    Texture& getPlaceholder() { return m_placeholder; }
+
+    const TextureUploadStats& getStats() const { return m_stats; }
+    ImageDecodeStats getDecodeStats() const { return m_decoder.getStats(); }
+
+private:
+    /// Apunta @p texture a la vista de la textura de reemplazo (con su propia referencia).
+    void bindPlaceholder(Texture& texture);
+
+    ImageDecodeQueue m_decoder;
+    Texture m_placeholder;
+    TextureCache* m_cache = nullptr;
+    std::unordered_map<unsigned int, std::vector<Texture*>> m_pending;  ///< Ticket -> texturas destino.
+    std::unordered_map<std::string, unsigned int> m_tickets;            ///< TextureCache::cacheKey() en curso -> ticket.
+    TextureUploadStats m_stats;
+};
@@ -0,0 +1,27 @@
+/**
+ * @file TransformComponent.h
+ * @brief Declara TransformComponent, posicion, rotacion y escala de una entidad del ECS.
+ *
+ * Es un dato plano (sin vtable ni memoria dinamica): el ECS lo guarda en arreglos contiguos
+ * dentro de cada bloque y lo mueve con memcpy. TransformSystem calcula m_world a partir de los
+ * demas campos.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+
+/**
+ * @struct TransformComponent
+ * @brief Transformacion local de una entidad y su matriz de mundo.
+ */
+struct TransformComponent {
+    TransformComponent()
+        : position(0.0f, 0.0f, 0.0f), rotation(Quaternion::identity()), scale(1.0f, 1.0f, 1.0f),
+          world(Matrix4::identity()) {}
+
+    Vector3    position;    ///< Traslacion.
+    Quaternion rotation;    ///< Cuaternion unitario (x, y, z, w).
+    Vector3    scale;       ///< Escala por eje.
+    Matrix4    world;       ///< Escala * rotacion * traslacion (vector fila), calculada por TransformSystem.
+};
@@ -0,0 +1,154 @@
+/**
+ * @file TransformHierarchy.h
+ * @brief Declara la clase TransformHierarchy, jerarquia padre/hijo de transformaciones en formato SoA.
+ *
+ * Los nodos se guardan ordenados por profundidad (recorrido en anchura): todos los padres de un
+ * nivel estan antes que sus hijos y los hermanos quedan contiguos. Posicion, rotacion, escala y
+ * matriz de mundo viven en arreglos separados por componente, de modo que un lote de 4 u 8
+ * nodos se transforma con SIMD cargando cada componente con una sola instruccion.
+ *
+ * update() recorre los niveles en orden; dentro de un nivel los nodos son independientes y se
+ * reparten por bloques entre los hilos. Solo se recalculan los nodos marcados (cambio local) y
+ * sus descendientes: un nodo se recalcula si cambio su valor local o si se recalculo su padre.
+ *
+ * Los cambios de estructura (crear, destruir, cambiar de padre) solo marcan el orden como
+ * invalido; el siguiente update() lo reconstruye en O(n).
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+
+class JobSystem;
+
+/**
+ * @struct TransformHierarchyStats
+ * @brief Tiempos y contadores del ultimo update().
+ */
+struct TransformHierarchyStats {
+    double updateMs = 0.0;          ///< Duracion del ultimo update().
+    double rebuildMs = 0.0;         ///< Parte de updateMs usada en reconstruir el orden.
+    unsigned int nodesUpdated = 0;  ///< Nodos cuya matriz de mundo se recalculo.
+    unsigned int levels = 0;        ///< Niveles de profundidad.
+};
+
+/**
+ * @class TransformHierarchy
+ * @brief Transformaciones locales (escala, rotacion, traslacion) con padre y matriz de mundo.
+ *
+ * La matriz de mundo de un nodo es local * mundo del padre (vector fila, ver Math/Matrix.h).
+ * Los handles son estables mientras el nodo exista; las posiciones internas cambian al
+ * reconstruir el orden.
+ */
+class TransformHierarchy {
+public:
+    /// Handle invalido (tambien "sin padre").
+    static const unsigned int INVALID_HANDLE = 0xffffffffu;
+
+    /// Nodos por bloque de trabajo de update().
+    static const unsigned int BLOCK_SIZE = 2048;
+
+    TransformHierarchy() = default;
+    ~TransformHierarchy() = default;
+
+    /**
+     * @brief Inicializa una jerarquia vacia.
+     * @param jobs Pool para repartir cada nivel; sin el, update() corre en el hilo que llama.
+     */
+    HRESULT init(JobSystem* jobs = nullptr);
+
+    /// Libera la memoria.
+    void destroy();
+
+    /**
+     * @brief Crea un nodo con transformacion identidad.
+     * @param parent Handle del padre o INVALID_HANDLE para una raiz.
+     * @return Handle del nodo o INVALID_HANDLE si el padre no existe.
+     */
+    unsigned int create(unsigned int parent = INVALID_HANDLE);
+
+    /// Destruye un nodo y todos sus descendientes.
+    void destroyNode(unsigned int handle);
+
+    /**
+     * @brief Cambia el padre de un nodo (el nodo conserva su transformacion local).
+     * @return E_INVALIDARG si @p parent es el propio nodo o uno de sus descendientes.
+     */
+    HRESULT setParent(unsigned int handle, unsigned int parent);
+
+    /// Reemplaza la transformacion local.
+    void setLocal(unsigned int handle, const Vector3& position, const Quaternion& rotation, const Vector3& scale);
+
+    /// Cambia la posicion local.
+    void setPosition(unsigned int handle, const Vector3& position);
+
+    /// Cambia la rotacion local (cuaternion unitario).
+    void setRotation(unsigned int handle, const Quaternion& rotation);
+
+    /// Cambia la escala local.
+    void setScale(unsigned int handle, const Vector3& scale);
+
+    /// Recalcula las matrices de mundo de los nodos modificados y sus descendientes.
+    void update();
+
+    /// Matriz de mundo calculada en el ultimo update().
+    Matrix4 getWorld(unsigned int handle) const;
+
+    /// Padre del nodo o INVALID_HANDLE.
+    unsigned int getParent(unsigned int handle) const { return m_parentHandle[handle]; }
+
+    /// @c true si el handle corresponde a un nodo vivo.
+    bool isValid(unsigned int handle) const {
+        return handle < m_slotOfHandle.size() && m_slotOfHandle[handle] != INVALID_HANDLE;
+    }
+
+    /// Nodos vivos.
+    unsigned int getCount() const { return m_count; }
+
+    const TransformHierarchyStats& getStats() const { return m_stats; }
+
+private:
+    /// Matriz afin 4x3 en SoA: fila r, columna c en m_world[r * 3 + c].
+    static const unsigned int WORLD_ELEMENTS = 12;
+
+    /// Reordena los arreglos en anchura y recalcula padres por posicion y niveles.
+    void rebuildOrder();
+
+    /// Recorre un bloque de un nivel: propaga marcas y recalcula los nodos marcados (devuelve cuantos).
+    unsigned int updateBlock(unsigned int begin, unsigned int end, bool roots);
+
+    /// Recalcula la matriz de mundo de @p count nodos (posiciones crecientes) en lotes SIMD.
+    void computeWorld(const unsigned int* slots, unsigned int count, bool roots);
+
+    /// Agrega @p handle al inicio de la lista de hijos de @p parent.
+    void linkChild(unsigned int handle, unsigned int parent);
+
+    /// Quita @p handle de la lista de hijos de su padre.
+    void unlinkChild(unsigned int handle);
+
+private:
+    JobSystem* m_jobs = nullptr;
+
+    // Datos por posicion (orden por profundidad despues de rebuildOrder()).
+    std::vector<float> m_posX, m_posY, m_posZ;
+    std::vector<float> m_rotX, m_rotY, m_rotZ, m_rotW;
+    std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+    std::vector<float> m_world[WORLD_ELEMENTS];
+    std::vector<unsigned int> m_parentSlot;         ///< Posicion del padre o INVALID_HANDLE.
+    std::vector<unsigned int> m_handleOfSlot;       ///< INVALID_HANDLE en posiciones libres.
+    std::vector<unsigned char> m_localDirty;        ///< Cambio local desde el ultimo update().
+    std::vector<unsigned char> m_changed;           ///< Recalculado en el update() en curso.
+    std::vector<unsigned int> m_levelStart;         ///< Inicio de cada nivel (+ final).
+
+    // Datos por handle.
+    std::vector<unsigned int> m_slotOfHandle;       ///< INVALID_HANDLE en handles libres.
+    std::vector<unsigned int> m_parentHandle;
+    std::vector<unsigned int> m_firstChild;
+    std::vector<unsigned int> m_nextSibling;
+    std::vector<unsigned int> m_prevSibling;
+    std::vector<unsigned int> m_freeHandles;
+
+    unsigned int m_count = 0;
+    bool m_orderDirty = false;
+    TransformHierarchyStats m_stats;
+};
@@ -0,0 +1,28 @@
+/**
+ * @file TransformSystem.h
+ * @brief Declara TransformSystem, calculo de las matrices de mundo de TransformComponent.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "ECS/System.h"
+
+struct TransformComponent;
+
+/**
+ * @class TransformSystem
+ * @brief Compone escala, rotacion y traslacion de cada TransformComponent en su matriz de mundo.
+ *
+ * Reparte los bloques del ECS entre los hilos; cada bloque es un arreglo contiguo de
+ * componentes que se recorre de forma lineal.
+ */
+class TransformSystem : public System {
+public:
+    const char* getName() const override { return "TransformSystem::update"; }
+
+    void update(World& world, float deltaTime) override;
+
+    /// Calcula la matriz de mundo de @p count componentes contiguos.
+    static void computeWorld(TransformComponent* transforms, unsigned int count);
+};
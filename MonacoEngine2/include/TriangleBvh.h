@@ -0,0 +1,72 @@
+/**
+ * @file TriangleBvh.h
+ * @brief Declara la clase TriangleBvh, BVH de triangulos de una malla para lanzar rayos.
+ *
+ * Construye un Bvh sobre las cajas de los triangulos de un MeshComponent y guarda cada
+ * triangulo como vertice + dos aristas en el orden de las hojas, para que la prueba de
+ * Moller-Trumbore lea memoria contigua. Los paquetes de rayos prueban un triangulo contra
+ * SIMD_LANES rayos por instruccion.
+ *
+ * Los rayos se expresan en el espacio local de la malla; para picking en mundo se transforma
+ * el rayo con la inversa de la matriz de mundo.
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Bvh.h"
+
+class MeshComponent;
+
+/**
+ * @class TriangleBvh
+ * @brief Aceleracion de rayos contra los triangulos de una malla.
+ */
+class TriangleBvh {
+public:
+    TriangleBvh() = default;
+    ~TriangleBvh() = default;
+
+    /**
+     * @brief Construye la jerarquia a partir de la malla.
+     * @param mesh        Malla con vertices e indices (listas de triangulos).
+     * @param maxLeafSize Maximo de triangulos por hoja.
+     */
+    HRESULT build(const MeshComponent& mesh, unsigned int maxLeafSize = 4);
+
+    /// Igual que build(mesh), a partir de arreglos de vertices e indices.
+    HRESULT build(const SimpleVertex* vertices,
+                  unsigned int numVertices,
+                  const unsigned int* indices,
+                  unsigned int indexCount,
+                  unsigned int maxLeafSize = 4);
+
+    /**
+     * @brief Triangulo mas cercano que intersecta el rayo (ambas caras).
+     * @param ray Rayo en espacio local de la malla.
+     * @param hit Salida: distancia, triangulo (indice / 3 en la malla) y baricentricas.
+     * @return @c true si hubo impacto.
+     */
+    bool raycast(const Ray& ray, RayHit& hit) const;
+
+    /// Triangulo mas cercano para cada rayo del paquete.
+    void intersectPacket(RayPacket& packet) const;
+
+    /// Libera la jerarquia y los triangulos.
+    void destroy();
+
+    const Bvh& getBvh() const { return m_bvh; }
+    unsigned int getTriangleCount() const { return static_cast<unsigned int>(m_triangles.size()); }
+
+private:
+    /// Triangulo preparado para Moller-Trumbore.
+    struct Triangle {
+        float v0[3];
+        float e1[3];        ///< v1 - v0.
+        float e2[3];        ///< v2 - v0.
+        unsigned int id;    ///< Indice del triangulo en la malla.
+    };
+
+    Bvh m_bvh;
+    std::vector<Triangle> m_triangles;  ///< En el orden de Bvh::getIndices().
+};
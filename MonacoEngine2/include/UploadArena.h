@@ -0,0 +1,101 @@
+/**
+ * @file UploadArena.h
+ * @brief Declara la clase UploadArena, memoria de subida reutilizable para texturas decodificadas.
+ *
+ * Cargar un PNG/JPG con Image + MipChain reserva (y llena de ceros) un buffer por nivel en cada
+ * textura y los libera despues de crearla. La arena es un solo bloque que solo crece: decodeImage()
+ * escribe el nivel 0 directo en ella con ImageDecoderRegistry::decodeInto() y genera los demas
+ * niveles detras con MipChain::generateInto(), asi que despues de la primera textura grande ya
+ * no hay reservas por textura ni paginas nuevas que el sistema tenga que limpiar. Las vistas
+ * apuntan a la arena hasta el siguiente reset(); Texture las pasa tal cual como datos iniciales.
+ *
+ * No es segura entre hilos: cada hilo que carga texturas usa la suya (forThread()).
+ *
+ * @author Hannin Abarca
+ */
+#pragma once
+#include "CorePrerequisites.h"
+#include "Image.h"
+#include "MipChain.h"
+
+/**
+ * @struct UploadImage
+ * @brief Cadena de mipmaps RGBA8 dentro de una UploadArena.
+ */
+struct UploadImage {
+    /// Niveles de una imagen de hasta 2^24 pixeles por lado.
+    static const unsigned int MAX_LEVELS = 25;
+
+    ImageView levels[MAX_LEVELS];   ///< Nivel 0 (el mas grande) en adelante.
+    unsigned int levelCount = 0;    ///< Niveles validos en levels.
+};
+
+/**
+ * @class UploadArena
+ * @brief Bloque de memoria que solo crece, alineado a 64 bytes. No copiable.
+ */
+class UploadArena {
+public:
+    /// Alineacion de cada reserva (linea de cache).
+    static const size_t ALIGNMENT = 64;
+
+    UploadArena() = default;
+    ~UploadArena() { destroy(); }
+
+    UploadArena(const UploadArena&) = delete;
+    UploadArena& operator=(const UploadArena&) = delete;
+
+    /**
+     * @brief Descarta las reservas anteriores y asegura @p capacity bytes libres.
+     *
+     * Solo reserva de nuevo si @p capacity no cabe en el bloque actual; en ese caso los punteros
+     * anteriores dejan de ser validos (tambien dejan de serlo si no crece: la memoria se reutiliza).
+     * @return @c S_OK si fue exitoso; @c E_OUTOFMEMORY si no se pudo reservar.
+     */
+    HRESULT reset(size_t capacity = 0);
+
+    /// Reserva @p bytes alineados a ALIGNMENT; nullptr si no caben en lo pedido a reset().
+    void* allocate(size_t bytes);
+
+    /**
+     * @brief Reserva una imagen RGBA8 (sin limpiar).
+     * @param rowAlignment Alineacion del pitch en bytes (potencia de dos; 256 para copias de D3D12).
+     * @return Vista vacia si no cabe.
+     */
+    ImageView allocateImage(unsigned int width, unsigned int height, unsigned int rowAlignment = 4);
+
+    /// Bytes que ocupa allocateImage() (incluido el relleno de alineacion).
+    static size_t imageBytes(unsigned int width, unsigned int height, unsigned int rowAlignment = 4);
+
+    /**
+     * @brief Decodifica un PNG/JPG/TGA/BMP en memoria y genera su cadena de mipmaps en la arena.
+     *
+     * Hace reset() con el tamano exacto de la cadena mas la memoria de trabajo de MipChain.
+     * @param settings Opciones de la cadena; settings.jobs tambien reparte la decodificacion.
+     * @param out      Vistas de los niveles, validas hasta el siguiente reset().
+     * @return @c S_OK si fue exitoso; @c E_FAIL si el archivo no se pudo decodificar.
+     */
+    HRESULT decodeImage(const unsigned char* data, size_t size, const MipSettings& settings, UploadImage& out);
+
+    /// Libera el bloque.
+    void destroy();
+
+    /// Bytes reservados del sistema.
+    size_t getCapacity() const { return m_capacity; }
+
+    /// Bytes usados desde el ultimo reset().
+    size_t getUsed() const { return m_used; }
+
+    /// Veces que el bloque tuvo que crecer desde que se creo.
+    unsigned int getGrowCount() const { return m_growCount; }
+
+    /// Arena del hilo actual; vive hasta que el hilo termina.
+    static UploadArena& forThread();
+
+private:
+    unsigned char* m_block = nullptr;   ///< Lo que devolvio new[] (sin alinear).
+    unsigned char* m_data = nullptr;    ///< m_block alineado a ALIGNMENT.
+    size_t m_capacity = 0;
+    size_t m_used = 0;
+    unsigned int m_growCount = 0;
+};
@@ -1,4 +1,24 @@
 #include "BaseApp.h"
+#include "Math/MathXna.h"
+#include "ColorSpace.h"
+#include <functional>
+
+namespace {
+    /// Programa de reemplazo mientras compila MonacoEngine2.fx: la malla en vMeshColor, sin textura.
+    const char* FALLBACK_SHADER_SOURCE = R"(
+cbuffer cbNeverChanges : register(b0) { matrix View; };
+cbuffer cbChangeOnResize : register(b1) { matrix Projection; };
+cbuffer cbChangesEveryFrame : register(b2) { matrix World; float4 vMeshColor; };
+
+float4 VS(float4 Pos : POSITION) : SV_POSITION {
+    return mul(mul(mul(Pos, World), View), Projection);
+}
+
+float4 PS(float4 Pos : SV_POSITION) : SV_Target {
+    return vMeshColor;
+}
+)";
+}
 
 BaseApp::BaseApp(HINSTANCE hInst, int nCmdShow)
 {
@@ -49,7 +69,7 @@ BaseApp::init() {
     }
 
     // 2. Inicializar Render Target View
-    hr = m_renderTargetView.init(m_device, m_backBuffer, DXGI_FORMAT_R8G8B8A8_UNORM);
+    hr = m_renderTargetView.init(m_device, m_backBuffer, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice",
             ("Failed to initialize RenderTargetView. HRESULT: " + std::to_string(hr)).c_str());
@@ -100,13 +120,28 @@ BaseApp::init() {
     // CARGA DEL MODELO
     // ---------------------------------------------------------
     // Asegrate que "Espada.obj" est en la carpeta junto al ejecutable (.exe)
-    hr = m_modelLoader.loadFromFile("Espada.obj", m_mesh);
+    hr = JobSystem::instance().init();
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice",
+            ("Failed to initialize JobSystem. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+
+    hr = initScene();
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice",
             ("Failed to load model 'Espada.obj'. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
 
+    // Culling por frustum de las submallas del modelo
+    hr = initCulling();
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice",
+            ("Failed to initialize FrustumCuller. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+
     // 7. Definir Input Layout
     std::vector<D3D11_INPUT_ELEMENT_DESC> Layout;
     D3D11_INPUT_ELEMENT_DESC position;
@@ -139,8 +174,31 @@ BaseApp::init() {
     normal.InstanceDataStepRate = 0;
     Layout.push_back(normal);
 
-    // 8. Inicializar Shader Program
-    hr = m_shaderProgram.init(m_device, "MonacoEngine2.fx", Layout);
+    // 8. Inicializar Shader Program: variante base de la biblioteca precompilada si existe; si no,
+    // MonacoEngine2.fx se compila en segundo plano (con la cache en disco si se pudo abrir) y
+    // mientras tanto se dibuja con el programa de reemplazo.
+    hr = m_fallbackProgram.initFromSource(m_device, FALLBACK_SHADER_SOURCE, "FallbackShader", Layout);
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice",
+            ("Failed to initialize fallback ShaderProgram. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+    if (std::ifstream("MonacoEngine2.shaderlib").good() &&
+        SUCCEEDED(m_shaderLibrary.loadFromFile("MonacoEngine2.shaderlib"))) {
+        hr = m_shaderProgram.init(m_device, m_shaderLibrary, 0, Layout);
+    }
+    else {
+        const bool cached = SUCCEEDED(m_shaderCache.init("ShaderCache", D3D_COMPILER_VERSION));
+        hr = m_shaderPrograms.init(JobSystem::instance(), cached ? &m_shaderCache : nullptr);
+        if (SUCCEEDED(hr) && cached) {
+            // Sin recarga en caliente se sigue funcionando: solo hay que reiniciar para ver cambios.
+            m_shaderPrograms.enableHotReload(m_shaderCache);
+        }
+        if (SUCCEEDED(hr)) {
+            hr = m_shaderPrograms.request(m_shaderProgram, "MonacoEngine2.fx", Layout,
+                std::vector<ShaderDefine>(), &m_fallbackProgram);
+        }
+    }
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice",
             ("Failed to initialize ShaderProgram. HRESULT: " + std::to_string(hr)).c_str());
@@ -148,14 +206,14 @@ BaseApp::init() {
     }
 
     // 9. Inicializar Buffers de Geometra (Vertex e Index)
-    hr = m_vertexBuffer.init(m_device, m_mesh, D3D11_BIND_VERTEX_BUFFER);
+    hr = m_vertexBuffer.init(m_device, getModelMesh(), D3D11_BIND_VERTEX_BUFFER);
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice",
             ("Failed to initialize VertexBuffer. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
 
-    hr = m_indexBuffer.init(m_device, m_mesh, D3D11_BIND_INDEX_BUFFER);
+    hr = m_indexBuffer.init(m_device, getModelMesh(), D3D11_BIND_INDEX_BUFFER);
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice",
             ("Failed to initialize IndexBuffer. HRESULT: " + std::to_string(hr)).c_str());
@@ -190,12 +248,26 @@ BaseApp::init() {
     // ---------------------------------------------------------
     // CARGA DE LA TEXTURA
     // ---------------------------------------------------------
-    // Usamos ExtensionType::PNG gracias a la implementacin de stb_image en Texture.cpp
-    hr = m_textureCube.init(m_device, "crucible_baseColor", ExtensionType::PNG);
+    // La imagen se decodifica en el JobSystem; mientras tanto se dibuja con la textura de
+    // reemplazo y update() crea la definitiva dentro del presupuesto por frame.
+    hr = m_textureCache.init(TEXTURE_CACHE_BUDGET_BYTES);
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice",
+            ("Failed to initialize TextureCache. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
 
+    hr = m_textureUploads.init(m_device, JobSystem::instance(), &m_textureCache);
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice",
-            ("Failed to initialize texture 'crucible_baseColor'. HRESULT: " + std::to_string(hr)).c_str());
+            ("Failed to initialize TextureUploadQueue. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+
+    hr = m_textureUploads.request(m_device, m_textureCube, "crucible_baseColor", ExtensionType::PNG);
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice",
+            ("Failed to request texture 'crucible_baseColor'. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
 
@@ -208,6 +280,13 @@ BaseApp::init() {
     }
 
     // 12. Inicializar Matrices
+    initCamera();
+
+    return S_OK;
+}
+
+void
+BaseApp::initCamera() {
     m_World = XMMatrixIdentity();
 
     // Configurar cmara fija
@@ -219,8 +298,78 @@ BaseApp::init() {
     cbNeverChanges.mView = XMMatrixTranspose(m_View);
     m_Projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, m_window.m_width / (FLOAT)m_window.m_height, 0.01f, 100.0f);
     cbChangesOnResize.mProjection = XMMatrixTranspose(m_Projection);
+}
 
-    return S_OK;
+int
+BaseApp::runHeadless(unsigned int frames, const std::string& outputFile) {
+    // Mismo tamao que el rea cliente de la ventana (ver Window::init).
+    m_window.m_width = 1200;
+    m_window.m_height = 950;
+
+    HRESULT hr = JobSystem::instance().init();
+    if (FAILED(hr)) {
+        ERROR("Main", "runHeadless", "Failed to initialize JobSystem.");
+        return 1;
+    }
+
+    hr = initScene();
+    if (FAILED(hr)) {
+        ERROR("Main", "runHeadless", "Failed to load model 'Espada.obj'.");
+        return 1;
+    }
+
+    hr = m_textureImage.loadFromFile("crucible_baseColor.png");
+    if (FAILED(hr)) {
+        ERROR("Main", "runHeadless", "Failed to load texture 'crucible_baseColor.png'.");
+        return 1;
+    }
+
+    hr = m_softwareRasterizer.init(m_window.m_width, m_window.m_height, JobSystem::instance());
+    if (FAILED(hr)) {
+        ERROR("Main", "runHeadless", "Failed to initialize SoftwareRasterizer.");
+        return 1;
+    }
+    m_softwareRasterizer.setTexture(&m_textureImage);
+
+    hr = initCulling();
+    if (FAILED(hr)) {
+        ERROR("Main", "runHeadless", "Failed to initialize FrustumCuller.");
+        return 1;
+    }
+
+    initCamera();
+
+    float ClearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+    for (unsigned int frame = 0; frame < frames; ++frame) {
+        ScopedTimer frameTimer("SoftwareRasterizer::frame");
+        // Paso fijo, igual que con el driver de referencia en update().
+        updateScene(frame * (float)XM_PI * 0.0125f, (float)XM_PI * 0.0125f);
+        cullScene();
+        m_softwareRasterizer.clear(ClearColor);
+        if (!m_visibleSubMeshes.empty()) {
+            m_softwareRasterizer.update(
+                math::fromXMMATRIX(XMMatrixMultiply(XMMatrixMultiply(m_World, m_View), m_Projection)),
+                Vector4(cb.vMeshColor.x, cb.vMeshColor.y, cb.vMeshColor.z, cb.vMeshColor.w));
+            m_softwareRasterizer.render(getModelMesh());
+        }
+    }
+
+    hr = m_softwareRasterizer.getColorBuffer().saveToTGA(outputFile);
+    std::string report = Profiler::instance().report();
+    MESSAGE("Main", "runHeadless", report.c_str());
+
+    std::ofstream reportFile(outputFile + ".txt");
+    reportFile << report;
+
+    m_spatialGrid.destroy();
+    m_frustumCuller.destroy();
+    m_occlusionCuller.destroy();
+    m_sceneGraph.destroy();
+    m_world.destroy();
+    m_softwareRasterizer.destroy();
+    m_textureImage.destroy();
+    JobSystem::instance().destroy();
+    return FAILED(hr) ? 1 : 0;
 }
 
 void BaseApp::update(float deltaTime)
@@ -240,13 +389,33 @@ void BaseApp::update(float deltaTime)
         t = (dwTimeCur - dwTimeStart) / 1000.0f;
     }
 
+    m_shaderPrograms.update(m_device);
+    m_shaderPrograms.publishCounters("ShaderPrograms");
+    m_shaderCache.publishCounters("ShaderCache");
+    m_textureUploads.update(m_device, TEXTURE_UPLOAD_BUDGET_MS);
+    m_textureCache.update();
+    updateScene(t, deltaTime);
+    cullScene();
+
+    m_cbNeverChanges.update(m_deviceContext, nullptr, 0, nullptr, &cbNeverChanges, 0, 0);
+    m_cbChangeOnResize.update(m_deviceContext, nullptr, 0, nullptr, &cbChangesOnResize, 0, 0);
+
+    // El render target es sRGB: los colores elegidos en pantalla se pasan a lineal para la GPU.
+    // El rasterizador por software sigue trabajando con cb en espacio gamma.
+    CBChangesEveryFrame gpuFrame = cb;
+    gpuFrame.vMeshColor.x = color::srgbToLinear(cb.vMeshColor.x);
+    gpuFrame.vMeshColor.y = color::srgbToLinear(cb.vMeshColor.y);
+    gpuFrame.vMeshColor.z = color::srgbToLinear(cb.vMeshColor.z);
+    m_cbChangesEveryFrame.update(m_deviceContext, nullptr, 0, nullptr, &gpuFrame, 0, 0);
+}
+
+void
+BaseApp::updateScene(float t, float deltaTime) {
     // Actualizar constantes de vista y proyeccin
     cbNeverChanges.mView = XMMatrixTranspose(m_View);
-    m_cbNeverChanges.update(m_deviceContext, nullptr, 0, nullptr, &cbNeverChanges, 0, 0);
 
     m_Projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, m_window.m_width / (FLOAT)m_window.m_height, 0.01f, 100.0f);
     cbChangesOnResize.mProjection = XMMatrixTranspose(m_Projection);
-    m_cbChangeOnResize.update(m_deviceContext, nullptr, 0, nullptr, &cbChangesOnResize, 0, 0);
 
     // Efecto de color pulsante (opcional, afecta al tinte si el shader lo usa)
     m_vMeshColor.x = (sinf(t * 1.0f) + 1.0f) * 0.5f;
@@ -254,19 +423,124 @@ void BaseApp::update(float deltaTime)
     m_vMeshColor.z = (sinf(t * 5.0f) + 1.0f) * 0.5f;
     m_vMeshColor.w = 1.0f;
 
-    // Rotar el modelo sobre el eje Y
-    m_World = XMMatrixRotationY(t);
+    // Rotar el modelo sobre el eje Y; la jerarqua compone la matriz de mundo
+    m_world.update(deltaTime);
+    TransformComponent* transform = m_world.getComponent<TransformComponent>(m_model);
+    transform->rotation = Quaternion(0.0f, sinf(t * 0.5f), 0.0f, cosf(t * 0.5f));
+    m_sceneGraph.setLocal(m_modelNode, transform->position, transform->rotation, transform->scale);
+    m_sceneGraph.update();
+    transform->world = m_sceneGraph.getWorld(m_modelNode);
+    m_World = math::toXMMATRIX(transform->world);
 
     cb.mWorld = XMMatrixTranspose(m_World);
     cb.vMeshColor = m_vMeshColor;
+}
+
+HRESULT
+BaseApp::initScene() {
+    HRESULT hr = m_world.init(&JobSystem::instance());
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    MeshComponent mesh;
+    hr = m_modelLoader.loadFromFile("Espada.obj", mesh);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    m_model = m_world.createEntity(TransformComponent(), std::move(mesh));
+
+    hr = m_sceneGraph.init(&JobSystem::instance());
+    if (FAILED(hr)) {
+        return hr;
+    }
+    m_modelNode = m_sceneGraph.create();
+    return S_OK;
+}
 
-    m_cbChangesEveryFrame.update(m_deviceContext, nullptr, 0, nullptr, &cb, 0, 0);
+HRESULT
+BaseApp::initCulling() {
+    HRESULT hr = m_frustumCuller.init(JobSystem::instance());
+    if (FAILED(hr)) {
+        return hr;
+    }
+    hr = m_occlusionCuller.init(OcclusionCuller::DEFAULT_WIDTH, OcclusionCuller::DEFAULT_HEIGHT,
+        JobSystem::instance());
+    if (FAILED(hr)) {
+        return hr;
+    }
+    // Celda del orden del doble de la submalla ms grande.
+    const MeshComponent& mesh = getModelMesh();
+    float cellSize = 1.0f;
+    for (const SubMesh& subMesh : mesh.m_subMeshes) {
+        cellSize = std::max(cellSize, subMesh.sphere.radius * 2.0f);
+    }
+    hr = m_spatialGrid.init(cellSize);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    m_subMeshHandles.clear();
+    for (unsigned int i = 0; i < mesh.m_subMeshes.size(); ++i) {
+        m_subMeshHandles.push_back(m_spatialGrid.insert(mesh.m_subMeshes[i].bounds, i));
+    }
+    return S_OK;
+}
+
+void
+BaseApp::cullScene() {
+    const MeshComponent& mesh = getModelMesh();
+    const Matrix4 world = math::fromXMMATRIX(m_World);
+    for (unsigned int i = 0; i < mesh.m_subMeshes.size(); ++i) {
+        const SubMesh& subMesh = mesh.m_subMeshes[i];
+        m_spatialGrid.move(m_subMeshHandles[i], BoundsTable::transformBox(subMesh.bounds, world));
+    }
+    const Matrix4 view = math::fromXMMATRIX(m_View);
+    const Matrix4 viewProj = math::fromXMMATRIX(XMMatrixMultiply(m_View, m_Projection));
+    m_frustumCuller.update(viewProj);
+    m_spatialGrid.queryFrustum(m_frustumCuller, m_visibleSubMeshes);
+
+    // Orden de dibujo estable, independiente de la distribucin en celdas.
+    std::sort(m_visibleSubMeshes.begin(), m_visibleSubMeshes.end());
+
+    // Oclusin: las submallas ms grandes en pantalla se rasterizan como oclusores y se
+    // descartan las que quedan completamente detrs de ellas. Una submalla nunca se oculta a
+    // s misma: el punto ms cercano de su caja est delante de su superficie.
+    const unsigned int count = static_cast<unsigned int>(m_visibleSubMeshes.size());
+    m_occlusionBoxes.resize(count);
+    m_occluderCandidates.clear();
+    for (unsigned int i = 0; i < count; ++i) {
+        const AABB box = BoundsTable::transformBox(mesh.m_subMeshes[m_visibleSubMeshes[i]].bounds, world);
+        m_occlusionBoxes[i] = box;
+        const float radius = math::length(box.max - box.min) * 0.5f;
+        const float depth = math::transformCoord((box.min + box.max) * 0.5f, view).z;
+        m_occluderCandidates.push_back(std::make_pair(radius / std::max(depth, 1e-3f), i));
+    }
+    const size_t numCandidates = std::min<size_t>(m_occluderCandidates.size(), MAX_OCCLUDERS);
+    std::partial_sort(m_occluderCandidates.begin(), m_occluderCandidates.begin() + numCandidates,
+        m_occluderCandidates.end(), std::greater<std::pair<float, unsigned int>>());
+
+    m_occlusionCuller.update(viewProj);
+    for (size_t i = 0; i < numCandidates && m_occluderCandidates[i].first >= OCCLUDER_MIN_SIZE; ++i) {
+        const SubMesh& subMesh = mesh.m_subMeshes[m_visibleSubMeshes[m_occluderCandidates[i].second]];
+        m_occlusionCuller.addOccluder(mesh, world, subMesh.startIndex, subMesh.indexCount);
+    }
+    m_occlusionCuller.render();
+    m_occlusionCuller.testVisibility(m_occlusionBoxes.data(), count, m_occlusionVisible);
+
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < count; ++i) {
+        if (m_occlusionVisible[i]) {
+            m_visibleSubMeshes[kept++] = m_visibleSubMeshes[i];
+        }
+    }
+    m_visibleSubMeshes.resize(kept);
 }
 
 void
 BaseApp::render() {
-    // Limpiar pantalla
-    float ClearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+    // Limpiar pantalla (el gris 0.1 en sRGB, expresado en lineal para el render target sRGB)
+    const float gray = color::srgbToLinear(0.1f);
+    float ClearColor[4] = { gray, gray, gray, 1.0f };
     m_renderTargetView.render(m_deviceContext, m_depthStencilView, 1, ClearColor);
 
     // Configurar viewport y depth stencil
@@ -290,8 +564,12 @@ BaseApp::render() {
     m_textureCube.render(m_deviceContext, 0, 1);
     m_samplerState.render(m_deviceContext, 0, 1);
 
-    // Dibujar
-    m_deviceContext.DrawIndexed(m_mesh.m_numIndex, 0, 0);
+    // Dibujar solo las submallas dentro del frustum
+    const MeshComponent& mesh = getModelMesh();
+    for (unsigned int index : m_visibleSubMeshes) {
+        const SubMesh& subMesh = mesh.m_subMeshes[index];
+        m_deviceContext.DrawIndexed(subMesh.indexCount, subMesh.startIndex, 0);
+    }
 
     // Presentar
     m_swapChain.present();
@@ -302,8 +580,17 @@ BaseApp::destroy() {
     if (m_deviceContext.m_deviceContext) m_deviceContext.m_deviceContext->ClearState();
 
     m_modelLoader.destroy();
+    m_sceneGraph.destroy();
+    m_world.destroy();
+    m_spatialGrid.destroy();
+    m_frustumCuller.destroy();
+    m_occlusionCuller.destroy();
+    m_textureUploads.destroy();
+    m_shaderPrograms.destroy();
+    JobSystem::instance().destroy();
     m_samplerState.destroy();
-    m_textureCube.destroy();
+    m_textureCache.release(m_textureCube);
+    m_textureCache.destroy();
 
     m_cbNeverChanges.destroy();
     m_cbChangeOnResize.destroy();
@@ -311,6 +598,9 @@ BaseApp::destroy() {
     m_vertexBuffer.destroy();
     m_indexBuffer.destroy();
     m_shaderProgram.destroy();
+    m_fallbackProgram.destroy();
+    m_shaderCache.destroy();
+    m_shaderLibrary.destroy();
     m_depthStencil.destroy();
     m_depthStencilView.destroy();
     m_renderTargetView.destroy();
@@ -0,0 +1,1477 @@
+#include "BlockCompression.h"
+#include "HdrImage.h"
+#include "JobSystem.h"
+#include "MipChain.h"
+#include "Simd.h"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace simd;
+
+namespace {
+    /// Los 16 pixeles de un bloque por canal (0 a 255 en float).
+    struct Block {
+        alignas(32) float c[4][16];
+    };
+
+    const float ALL_PIXELS[16] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+    // Pesos de interpolacion de BC7 (sobre 64) para indices de 2, 3 y 4 bits.
+    const int BC7_WEIGHTS2[4] = { 0, 21, 43, 64 };
+    const int BC7_WEIGHTS3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+    const int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // Particiones de dos subconjuntos de BC7/BC6H: bit i = 1 si el pixel i es del subconjunto 1.
+    const uint16_t BC7_PARTITIONS2[64] = {
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+        0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+        0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+        0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+        0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+        0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+        0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+        0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+    };
+
+    // Pixel ancla (indice con el bit alto implicito) del subconjunto 1 de cada particion.
+    const unsigned char BC7_ANCHOR2[64] = {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+        15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+         6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+    };
+
+    /// Particiones de BC7 que se codifican por completo en calidad High.
+    const int BC7_PARTITION_CANDIDATES = 4;
+
+    /// Escribe campos de bits en orden, del bit menos significativo del byte 0 en adelante.
+    struct BitWriter {
+        unsigned char* data;
+        unsigned int pos = 0;
+
+        explicit BitWriter(unsigned char* out, unsigned int bytes) : data(out) { memset(out, 0, bytes); }
+
+        void
+        write(unsigned int value, unsigned int bits) {
+            for (unsigned int b = 0; b < bits; ++b, ++pos) {
+                if ((value >> b) & 1u) {
+                    data[pos >> 3] |= static_cast<unsigned char>(1u << (pos & 7));
+                }
+            }
+        }
+    };
+
+    /// Lee campos de bits escritos por BitWriter (o por otro codificador BC7).
+    struct BitReader {
+        const unsigned char* data;
+        unsigned int pos = 0;
+
+        explicit BitReader(const unsigned char* in) : data(in) {}
+
+        unsigned int
+        read(unsigned int bits) {
+            unsigned int value = 0;
+            for (unsigned int b = 0; b < bits; ++b, ++pos) {
+                value |= ((data[pos >> 3] >> (pos & 7)) & 1u) << b;
+            }
+            return value;
+        }
+    };
+
+    inline float
+    clamp255(float v) {
+        return std::min(255.0f, std::max(0.0f, v));
+    }
+
+    void
+    loadBlock(const Image& image, unsigned int bx, unsigned int by, Block& block) {
+        for (unsigned int y = 0; y < 4; ++y) {
+            const unsigned char* row = image.row(std::min(by * 4 + y, image.m_height - 1));
+            for (unsigned int x = 0; x < 4; ++x) {
+                const unsigned char* p = row + std::min(bx * 4 + x, image.m_width - 1) * 4;
+                for (int c = 0; c < 4; ++c) {
+                    block.c[c][y * 4 + x] = p[c];
+                }
+            }
+        }
+    }
+
+    /// Bits del mayor medio float finito (65504); BC6H sin signo no representa nada mayor.
+    const float BC6H_MAX_HALF = 31743.0f;
+
+    /**
+     * Carga un bloque HDR como bits de medio float escalados a 0..255. BC6H interpola sobre
+     * esos bits (casi logaritmicos), asi que el ajuste y la paleta de BC7 sirven tal cual.
+     * Los negativos y los NaN pasan a 0; lo que excede 65504 satura.
+     */
+    void
+    loadHdrBlock(const HdrImage& image, unsigned int bx, unsigned int by, Block& block) {
+        const float scale = 255.0f / BC6H_MAX_HALF;
+        for (unsigned int y = 0; y < 4; ++y) {
+            const float* row = image.row(std::min(by * 4 + y, image.m_height - 1));
+            for (unsigned int x = 0; x < 4; ++x) {
+                const float* p = row + std::min(bx * 4 + x, image.m_width - 1) * 4;
+                for (int c = 0; c < 3; ++c) {
+                    const float v = p[c] > 0.0f ? std::min(p[c], 65504.0f) : 0.0f;
+                    block.c[c][y * 4 + x] = floatToHalf(v) * scale;
+                }
+                block.c[3][y * 4 + x] = 255.0f;
+            }
+        }
+    }
+
+    /**
+     * Indice de la entrada de @p palette mas cercana a cada pixel, usando los canales
+     * [first, first + channels). Devuelve el error cuadratico de los pixeles con mask > 0.
+     */
+    float
+    selectIndices(const Block& block, int first, int channels, const float (*palette)[4], int count,
+                  const float* mask, unsigned char* indices) {
+        alignas(32) float errors[16];
+        alignas(32) float best[SIMD_LANES];
+        for (int i = 0; i < 16; i += SIMD_LANES) {
+            FloatV x[4];
+            for (int c = 0; c < channels; ++c) {
+                x[c] = load(&block.c[first + c][i]);
+            }
+            FloatV bestError = set1(FLT_MAX);
+            FloatV bestIndex = zero();
+            for (int p = 0; p < count; ++p) {
+                FloatV error = zero();
+                for (int c = 0; c < channels; ++c) {
+                    const FloatV diff = sub(x[c], set1(palette[p][c]));
+                    error = madd(diff, diff, error);
+                }
+                const FloatV closer = cmplt(error, bestError);
+                bestError = min(error, bestError);
+                bestIndex = select(closer, set1(static_cast<float>(p)), bestIndex);
+            }
+            store(errors + i, mul(bestError, load(mask + i)));
+            store(best, bestIndex);
+            for (int lane = 0; lane < SIMD_LANES; ++lane) {
+                indices[i + lane] = static_cast<unsigned char>(best[lane]);
+            }
+        }
+        float total = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            total += errors[i];
+        }
+        return total;
+    }
+
+    /// Ajusta una recta (PCA) a los pixeles con mask > 0; @p lo y @p hi reciben los extremos de la proyeccion.
+    void
+    fitLine(const Block& block, int first, int channels, const float* mask, float* lo, float* hi) {
+        float weight = 0.0f;
+        float mean[4] = {};
+        for (int i = 0; i < 16; ++i) {
+            weight += mask[i];
+            for (int c = 0; c < channels; ++c) {
+                mean[c] += mask[i] * block.c[first + c][i];
+            }
+        }
+        if (weight == 0.0f) {
+            for (int c = 0; c < channels; ++c) {
+                lo[c] = hi[c] = 0.0f;
+            }
+            return;
+        }
+        for (int c = 0; c < channels; ++c) {
+            mean[c] /= weight;
+        }
+
+        float cov[4][4] = {};
+        for (int i = 0; i < 16; ++i) {
+            if (mask[i] == 0.0f) {
+                continue;
+            }
+            float d[4];
+            for (int c = 0; c < channels; ++c) {
+                d[c] = block.c[first + c][i] - mean[c];
+            }
+            for (int a = 0; a < channels; ++a) {
+                for (int b = a; b < channels; ++b) {
+                    cov[a][b] += d[a] * d[b];
+                }
+            }
+        }
+        int largest = 0;
+        for (int a = 0; a < channels; ++a) {
+            for (int b = 0; b < a; ++b) {
+                cov[a][b] = cov[b][a];
+            }
+            if (cov[a][a] > cov[largest][largest]) {
+                largest = a;
+            }
+        }
+
+        // Iteracion de potencia desde la fila de mayor varianza.
+        float axis[4] = {};
+        for (int c = 0; c < channels; ++c) {
+            axis[c] = cov[largest][c];
+        }
+        for (int iteration = 0; iteration < 6; ++iteration) {
+            float next[4] = {};
+            float length = 0.0f;
+            for (int a = 0; a < channels; ++a) {
+                for (int b = 0; b < channels; ++b) {
+                    next[a] += cov[a][b] * axis[b];
+                }
+                length += next[a] * next[a];
+            }
+            if (length < 1.0e-12f) {
+                break;
+            }
+            length = sqrtf(length);
+            for (int c = 0; c < channels; ++c) {
+                axis[c] = next[c] / length;
+            }
+        }
+        float axisLength = 0.0f;
+        for (int c = 0; c < channels; ++c) {
+            axisLength += axis[c] * axis[c];
+        }
+        if (axisLength < 1.0e-12f) {
+            // Bloque de un solo color.
+            for (int c = 0; c < channels; ++c) {
+                axis[c] = 0.0f;
+            }
+        }
+        else {
+            axisLength = 1.0f / sqrtf(axisLength);
+            for (int c = 0; c < channels; ++c) {
+                axis[c] *= axisLength;
+            }
+        }
+
+        FloatV tMin = set1(FLT_MAX);
+        FloatV tMax = set1(-FLT_MAX);
+        for (int i = 0; i < 16; i += SIMD_LANES) {
+            FloatV t = zero();
+            for (int c = 0; c < channels; ++c) {
+                t = madd(sub(load(&block.c[first + c][i]), set1(mean[c])), set1(axis[c]), t);
+            }
+            const FloatV active = cmpgt(load(mask + i), zero());
+            tMin = min(tMin, select(active, t, set1(FLT_MAX)));
+            tMax = max(tMax, select(active, t, set1(-FLT_MAX)));
+        }
+        const float low = -horizontalMax(sub(zero(), tMin));
+        const float high = horizontalMax(tMax);
+        for (int c = 0; c < channels; ++c) {
+            lo[c] = clamp255(mean[c] + axis[c] * low);
+            hi[c] = clamp255(mean[c] + axis[c] * high);
+        }
+    }
+
+    /**
+     * Extremos que minimizan el error para indices fijos. @p weights da la posicion de cada
+     * indice entre el extremo 0 (0.0) y el 1 (1.0). Devuelve @c false si el sistema es singular.
+     */
+    bool
+    refineLine(const Block& block, int first, int channels, const float* mask, const unsigned char* indices,
+               const float* weights, float* e0, float* e1) {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        float x0[4] = {};
+        float x1[4] = {};
+        for (int i = 0; i < 16; ++i) {
+            const float w = weights[indices[i]];
+            const float m = mask[i];
+            a += m * (1.0f - w) * (1.0f - w);
+            b += m * (1.0f - w) * w;
+            c += m * w * w;
+            for (int ch = 0; ch < channels; ++ch) {
+                const float v = m * block.c[first + ch][i];
+                x0[ch] += (1.0f - w) * v;
+                x1[ch] += w * v;
+            }
+        }
+        const float det = a * c - b * b;
+        if (fabsf(det) < 1.0e-6f) {
+            return false;
+        }
+        const float inv = 1.0f / det;
+        for (int ch = 0; ch < channels; ++ch) {
+            e0[ch] = clamp255((c * x0[ch] - b * x1[ch]) * inv);
+            e1[ch] = clamp255((a * x1[ch] - b * x0[ch]) * inv);
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // BC1 (y color de BC3)
+    // ---------------------------------------------------------------------------------------
+
+    uint16_t
+    packRgb565(const float* c) {
+        const unsigned int r = static_cast<unsigned int>(c[0] * (31.0f / 255.0f) + 0.5f);
+        const unsigned int g = static_cast<unsigned int>(c[1] * (63.0f / 255.0f) + 0.5f);
+        const unsigned int b = static_cast<unsigned int>(c[2] * (31.0f / 255.0f) + 0.5f);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    void
+    unpackRgb565(uint16_t v, int* out) {
+        const int r = (v >> 11) & 31;
+        const int g = (v >> 5) & 63;
+        const int b = v & 31;
+        out[0] = (r << 3) | (r >> 2);
+        out[1] = (g << 2) | (g >> 4);
+        out[2] = (b << 3) | (b >> 2);
+    }
+
+    /// Paleta RGBA de un bloque de color; @p fourColor fuerza el modo de 4 colores (BC3).
+    void
+    colorPalette(uint16_t c0, uint16_t c1, bool fourColor, int palette[4][4]) {
+        unpackRgb565(c0, palette[0]);
+        unpackRgb565(c1, palette[1]);
+        palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+        for (int c = 0; c < 3; ++c) {
+            if (fourColor || c0 > c1) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+            }
+            else {
+                palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        if (!fourColor && c0 <= c1) {
+            palette[3][3] = 0;
+        }
+    }
+
+    /// Codifica el bloque de color con los extremos dados. Los pixeles con mask 0 quedan transparentes.
+    float
+    encodeColorEndpoints(const Block& block, const float* a, const float* b, bool threeColor, const float* mask,
+                         unsigned char* out, unsigned char* indices) {
+        uint16_t c0 = packRgb565(a);
+        uint16_t c1 = packRgb565(b);
+        // c0 > c1 selecciona 4 colores; c0 <= c1, 3 colores + transparente.
+        if ((!threeColor && c0 < c1) || (threeColor && c0 > c1)) {
+            std::swap(c0, c1);
+        }
+
+        int palette[4][4];
+        colorPalette(c0, c1, !threeColor, palette);
+        float entries[4][4];
+        for (int p = 0; p < 4; ++p) {
+            for (int c = 0; c < 3; ++c) {
+                entries[p][c] = static_cast<float>(palette[p][c]);
+            }
+        }
+        // Con c0 == c1 el hardware usa 3 colores aunque no haya transparencia.
+        const int count = (threeColor || c0 == c1) ? 3 : 4;
+        const float error = selectIndices(block, 0, 3, entries, count, mask, indices);
+
+        uint32_t bits = 0;
+        for (int i = 0; i < 16; ++i) {
+            const unsigned int index = mask[i] > 0.0f ? indices[i] : 3u;
+            bits |= index << (i * 2);
+        }
+        out[0] = static_cast<unsigned char>(c0 & 0xFF);
+        out[1] = static_cast<unsigned char>(c0 >> 8);
+        out[2] = static_cast<unsigned char>(c1 & 0xFF);
+        out[3] = static_cast<unsigned char>(c1 >> 8);
+        for (int i = 0; i < 4; ++i) {
+            out[4 + i] = static_cast<unsigned char>((bits >> (i * 8)) & 0xFF);
+        }
+        return error;
+    }
+
+    float
+    encodeColorBlock(const Block& block, bool allowTransparent, bool high, unsigned char* out) {
+        alignas(32) float mask[16];
+        bool threeColor = false;
+        bool anyOpaque = false;
+        for (int i = 0; i < 16; ++i) {
+            const bool opaque = !allowTransparent || block.c[3][i] >= 128.0f;
+            mask[i] = opaque ? 1.0f : 0.0f;
+            threeColor |= !opaque;
+            anyOpaque |= opaque;
+        }
+        if (!anyOpaque) {
+            // c0 = c1 = 0 (3 colores) y todos los indices en 3: transparente.
+            memset(out, 0, 4);
+            memset(out + 4, 0xFF, 4);
+            return 0.0f;
+        }
+
+        float lo[4];
+        float hi[4];
+        fitLine(block, 0, 3, mask, lo, hi);
+        unsigned char indices[16];
+        float best = encodeColorEndpoints(block, hi, lo, threeColor, mask, out, indices);
+        if (!high || best == 0.0f) {
+            return best;
+        }
+
+        unsigned char candidate[8];
+        unsigned char candidateIndices[16];
+        for (int iteration = 0; iteration < 2; ++iteration) {
+            // Los indices se refieren a los extremos ya ordenados del bloque actual.
+            const uint16_t c0 = static_cast<uint16_t>(out[0] | (out[1] << 8));
+            const uint16_t c1 = static_cast<uint16_t>(out[2] | (out[3] << 8));
+            const bool fourColor = c0 > c1;
+            const float fourWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+            const float threeWeights[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+            float e0[4];
+            float e1[4];
+            if (!refineLine(block, 0, 3, mask, indices, fourColor ? fourWeights : threeWeights, e0, e1)) {
+                break;
+            }
+            const float error = encodeColorEndpoints(block, e0, e1, threeColor, mask, candidate, candidateIndices);
+            if (error >= best) {
+                break;
+            }
+            best = error;
+            memcpy(out, candidate, sizeof(candidate));
+            memcpy(indices, candidateIndices, sizeof(indices));
+        }
+        return best;
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // BC4 (alfa de BC3, canales de BC5)
+    // ---------------------------------------------------------------------------------------
+
+    void
+    singlePalette(int e0, int e1, int palette[8]) {
+        palette[0] = e0;
+        palette[1] = e1;
+        if (e0 > e1) {
+            for (int k = 2; k < 8; ++k) {
+                palette[k] = ((8 - k) * e0 + (k - 1) * e1 + 3) / 7;
+            }
+        }
+        else {
+            for (int k = 2; k < 6; ++k) {
+                palette[k] = ((6 - k) * e0 + (k - 1) * e1 + 2) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    float
+    encodeSingleEndpoints(const Block& block, int channel, int e0, int e1, unsigned char* out, unsigned char* indices) {
+        int palette[8];
+        singlePalette(e0, e1, palette);
+        float entries[8][4];
+        for (int p = 0; p < 8; ++p) {
+            entries[p][0] = static_cast<float>(palette[p]);
+        }
+        const float error = selectIndices(block, channel, 1, entries, 8, ALL_PIXELS, indices);
+
+        uint64_t bits = 0;
+        for (int i = 0; i < 16; ++i) {
+            bits |= static_cast<uint64_t>(indices[i]) << (i * 3);
+        }
+        out[0] = static_cast<unsigned char>(e0);
+        out[1] = static_cast<unsigned char>(e1);
+        for (int i = 0; i < 6; ++i) {
+            out[2 + i] = static_cast<unsigned char>((bits >> (i * 8)) & 0xFF);
+        }
+        return error;
+    }
+
+    float
+    encodeSingleBlock(const Block& block, int channel, bool high, unsigned char* out) {
+        float low = 255.0f;
+        float highValue = 0.0f;
+        float innerLow = 255.0f;
+        float innerHigh = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            const float v = block.c[channel][i];
+            low = std::min(low, v);
+            highValue = std::max(highValue, v);
+            if (v > 0.0f && v < 255.0f) {
+                innerLow = std::min(innerLow, v);
+                innerHigh = std::max(innerHigh, v);
+            }
+        }
+
+        unsigned char indices[16];
+        const int maxValue = static_cast<int>(highValue);
+        const int minValue = static_cast<int>(low);
+        if (maxValue == minValue) {
+            return encodeSingleEndpoints(block, channel, maxValue, minValue, out, indices);
+        }
+        // Modo de 8 valores: e0 > e1.
+        float best = encodeSingleEndpoints(block, channel, maxValue, minValue, out, indices);
+        if (!high || best == 0.0f) {
+            return best;
+        }
+
+        unsigned char candidate[8];
+        unsigned char candidateIndices[16];
+        auto tryEndpoints = [&](int e0, int e1) {
+            e0 = std::min(255, std::max(0, e0));
+            e1 = std::min(255, std::max(0, e1));
+            const float error = encodeSingleEndpoints(block, channel, e0, e1, candidate, candidateIndices);
+            if (error < best) {
+                best = error;
+                memcpy(out, candidate, sizeof(candidate));
+                memcpy(indices, candidateIndices, sizeof(indices));
+            }
+        };
+
+        // Minimos cuadrados sobre los indices del modo de 8 valores.
+        const float weights8[8] = { 0.0f, 1.0f, 1.0f / 7, 2.0f / 7, 3.0f / 7, 4.0f / 7, 5.0f / 7, 6.0f / 7 };
+        for (int iteration = 0; iteration < 2; ++iteration) {
+            if (out[0] <= out[1]) {
+                break;
+            }
+            float e0;
+            float e1;
+            if (!refineLine(block, channel, 1, ALL_PIXELS, indices, weights8, &e0, &e1)) {
+                break;
+            }
+            const int q0 = static_cast<int>(e0 + 0.5f);
+            const int q1 = static_cast<int>(e1 + 0.5f);
+            if (q0 <= q1) {
+                break;
+            }
+            tryEndpoints(q0, q1);
+        }
+        // Vecindad de los extremos encontrados.
+        const int base0 = out[0];
+        const int base1 = out[1];
+        for (int d0 = -1; d0 <= 1; ++d0) {
+            for (int d1 = -1; d1 <= 1; ++d1) {
+                if ((d0 != 0 || d1 != 0) && base0 + d0 > base1 + d1) {
+                    tryEndpoints(base0 + d0, base1 + d1);
+                }
+            }
+        }
+        // Modo de 6 valores + 0 y 255 explicitos, para bloques con extremos saturados.
+        if (innerLow <= innerHigh) {
+            tryEndpoints(static_cast<int>(innerLow), static_cast<int>(innerHigh));
+        }
+        else {
+            tryEndpoints(0, 255);
+        }
+        return best;
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // BC7
+    // ---------------------------------------------------------------------------------------
+
+    /// Extremo del modo 6: 7 bits por canal mas un bit p propio (valor = q * 2 + p).
+    void
+    quantizeMode6(const float* e, int* q, int& p) {
+        float bestError = FLT_MAX;
+        for (int pbit = 0; pbit < 2; ++pbit) {
+            float error = 0.0f;
+            int values[4];
+            for (int c = 0; c < 4; ++c) {
+                values[c] = std::min(127, std::max(0, static_cast<int>((e[c] - pbit) * 0.5f + 0.5f)));
+                const float diff = e[c] - static_cast<float>(values[c] * 2 + pbit);
+                error += diff * diff;
+            }
+            if (error < bestError) {
+                bestError = error;
+                p = pbit;
+                memcpy(q, values, sizeof(values));
+            }
+        }
+    }
+
+    /// Valor de 8 bits de un extremo de 6 bits con bit p compartido (modo 1).
+    inline int
+    expandMode1(int q, int p) {
+        const int v = (q << 1) | p;
+        return (v << 1) | (v >> 6);
+    }
+
+    /// Extremos de un subconjunto del modo 1: 6 bits por canal y un bit p compartido.
+    void
+    quantizeMode1(const float* a, const float* b, int* qa, int* qb, int& p) {
+        float bestError = FLT_MAX;
+        for (int pbit = 0; pbit < 2; ++pbit) {
+            float error = 0.0f;
+            int valuesA[3];
+            int valuesB[3];
+            for (int e = 0; e < 2; ++e) {
+                const float* target = e == 0 ? a : b;
+                int* values = e == 0 ? valuesA : valuesB;
+                for (int c = 0; c < 3; ++c) {
+                    const int guess = static_cast<int>((target[c] * (127.0f / 255.0f) - pbit) * 0.5f + 0.5f);
+                    float channelError = FLT_MAX;
+                    for (int q = std::max(0, guess - 1); q <= std::min(63, guess + 1); ++q) {
+                        const float diff = target[c] - static_cast<float>(expandMode1(q, pbit));
+                        if (diff * diff < channelError) {
+                            channelError = diff * diff;
+                            values[c] = q;
+                        }
+                    }
+                    error += channelError;
+                }
+            }
+            if (error < bestError) {
+                bestError = error;
+                p = pbit;
+                memcpy(qa, valuesA, sizeof(valuesA));
+                memcpy(qb, valuesB, sizeof(valuesB));
+            }
+        }
+    }
+
+    float
+    encodeMode6(const Block& block, const float* a, const float* b, unsigned char* out, unsigned char* indices) {
+        int q[2][4];
+        int p[2];
+        quantizeMode6(a, q[0], p[0]);
+        quantizeMode6(b, q[1], p[1]);
+
+        float palette[16][4];
+        for (int k = 0; k < 16; ++k) {
+            const int w = BC7_WEIGHTS4[k];
+            for (int c = 0; c < 4; ++c) {
+                const int v0 = q[0][c] * 2 + p[0];
+                const int v1 = q[1][c] * 2 + p[1];
+                palette[k][c] = static_cast<float>(((64 - w) * v0 + w * v1 + 32) >> 6);
+            }
+        }
+        const float error = selectIndices(block, 0, 4, palette, 16, ALL_PIXELS, indices);
+
+        // El bit alto del indice del pixel 0 es implicito (0): si no cabe, se invierte el segmento.
+        if (indices[0] >= 8) {
+            std::swap(q[0], q[1]);
+            std::swap(p[0], p[1]);
+            for (int i = 0; i < 16; ++i) {
+                indices[i] = static_cast<unsigned char>(15 - indices[i]);
+            }
+        }
+
+        BitWriter writer(out, 16);
+        writer.write(1u << 6, 7);
+        for (int c = 0; c < 4; ++c) {
+            writer.write(q[0][c], 7);
+            writer.write(q[1][c], 7);
+        }
+        writer.write(p[0], 1);
+        writer.write(p[1], 1);
+        writer.write(indices[0], 3);
+        for (int i = 1; i < 16; ++i) {
+            writer.write(indices[i], 4);
+        }
+        return error;
+    }
+
+    float
+    encodeBC7Mode6(const Block& block, bool high, unsigned char* out) {
+        float lo[4];
+        float hi[4];
+        fitLine(block, 0, 4, ALL_PIXELS, lo, hi);
+        unsigned char indices[16];
+        float best = encodeMode6(block, lo, hi, out, indices);
+        if (!high || best == 0.0f) {
+            return best;
+        }
+
+        float weights[16];
+        for (int k = 0; k < 16; ++k) {
+            weights[k] = BC7_WEIGHTS4[k] / 64.0f;
+        }
+        unsigned char candidate[16];
+        unsigned char candidateIndices[16];
+        for (int iteration = 0; iteration < 2; ++iteration) {
+            float e0[4];
+            float e1[4];
+            if (!refineLine(block, 0, 4, ALL_PIXELS, indices, weights, e0, e1)) {
+                break;
+            }
+            const float error = encodeMode6(block, e0, e1, candidate, candidateIndices);
+            if (error >= best) {
+                break;
+            }
+            best = error;
+            memcpy(out, candidate, sizeof(candidate));
+            memcpy(indices, candidateIndices, sizeof(indices));
+        }
+        return best;
+    }
+
+    /**
+     * Suma de distancias al cuadrado a la recta principal de @p count pixeles RGB, a partir de
+     * sus momentos { r, g, b, rr, rg, rb, gg, gb, bb } (traza de la dispersion menos su mayor autovalor).
+     */
+    float
+    lineResidual(int count, const float* sums) {
+        if (count == 0) {
+            return 0.0f;
+        }
+        const float inv = 1.0f / static_cast<float>(count);
+        const float rr = sums[3] - sums[0] * sums[0] * inv;
+        const float rg = sums[4] - sums[0] * sums[1] * inv;
+        const float rb = sums[5] - sums[0] * sums[2] * inv;
+        const float gg = sums[6] - sums[1] * sums[1] * inv;
+        const float gb = sums[7] - sums[1] * sums[2] * inv;
+        const float bb = sums[8] - sums[2] * sums[2] * inv;
+        const float trace = rr + gg + bb;
+
+        // Iteracion de potencia desde la fila de mayor varianza.
+        float axis[3] = { rr, rg, rb };
+        if (gg > rr && gg >= bb) {
+            axis[0] = rg; axis[1] = gg; axis[2] = gb;
+        }
+        else if (bb > rr && bb > gg) {
+            axis[0] = rb; axis[1] = gb; axis[2] = bb;
+        }
+        float lambda = 0.0f;
+        for (int iteration = 0; iteration < 4; ++iteration) {
+            const float x = rr * axis[0] + rg * axis[1] + rb * axis[2];
+            const float y = rg * axis[0] + gg * axis[1] + gb * axis[2];
+            const float z = rb * axis[0] + gb * axis[1] + bb * axis[2];
+            const float length = sqrtf(x * x + y * y + z * z);
+            if (length < 1.0e-6f) {
+                break;
+            }
+            axis[0] = x / length;
+            axis[1] = y / length;
+            axis[2] = z / length;
+            lambda = length;
+        }
+        return std::max(0.0f, trace - lambda);
+    }
+
+    /// Codifica el modo 1 con la particion y los extremos por subconjunto dados.
+    float
+    encodeMode1(const Block& block, int partition, const float (*lo)[4], const float (*hi)[4],
+                unsigned char* out, unsigned char* indices) {
+        alignas(32) float masks[2][16];
+        for (int i = 0; i < 16; ++i) {
+            masks[1][i] = static_cast<float>((BC7_PARTITIONS2[partition] >> i) & 1);
+            masks[0][i] = 1.0f - masks[1][i];
+        }
+
+        int q[2][2][3];
+        int p[2];
+        float error = 0.0f;
+        unsigned char subsetIndices[2][16];
+        for (int s = 0; s < 2; ++s) {
+            quantizeMode1(lo[s], hi[s], q[s][0], q[s][1], p[s]);
+            float palette[8][4];
+            for (int k = 0; k < 8; ++k) {
+                const int w = BC7_WEIGHTS3[k];
+                for (int c = 0; c < 3; ++c) {
+                    const int v0 = expandMode1(q[s][0][c], p[s]);
+                    const int v1 = expandMode1(q[s][1][c], p[s]);
+                    palette[k][c] = static_cast<float>(((64 - w) * v0 + w * v1 + 32) >> 6);
+                }
+            }
+            error += selectIndices(block, 0, 3, palette, 8, masks[s], subsetIndices[s]);
+        }
+        for (int i = 0; i < 16; ++i) {
+            indices[i] = masks[1][i] > 0.0f ? subsetIndices[1][i] : subsetIndices[0][i];
+        }
+
+        // Anclas: pixel 0 para el subconjunto 0 y la de la tabla para el 1.
+        const int anchors[2] = { 0, BC7_ANCHOR2[partition] };
+        for (int s = 0; s < 2; ++s) {
+            if (indices[anchors[s]] >= 4) {
+                std::swap(q[s][0], q[s][1]);
+                for (int i = 0; i < 16; ++i) {
+                    if (masks[s][i] > 0.0f) {
+                        indices[i] = static_cast<unsigned char>(7 - indices[i]);
+                    }
+                }
+            }
+        }
+
+        BitWriter writer(out, 16);
+        writer.write(1u << 1, 2);
+        writer.write(static_cast<unsigned int>(partition), 6);
+        for (int c = 0; c < 3; ++c) {
+            for (int s = 0; s < 2; ++s) {
+                writer.write(q[s][0][c], 6);
+                writer.write(q[s][1][c], 6);
+            }
+        }
+        writer.write(p[0], 1);
+        writer.write(p[1], 1);
+        for (int i = 0; i < 16; ++i) {
+            writer.write(indices[i], (i == anchors[0] || i == anchors[1]) ? 2 : 3);
+        }
+        return error;
+    }
+
+    float
+    encodeBC7Mode1(const Block& block, unsigned char* out) {
+        // Momentos por pixel (suma, cuadrados y productos RGB): los de un subconjunto se suman
+        // con su mascara y los del otro salen del total, sin recorrer los pixeles por particion.
+        float moments[16][9];
+        float total[9] = {};
+        for (int i = 0; i < 16; ++i) {
+            const float r = block.c[0][i];
+            const float g = block.c[1][i];
+            const float b = block.c[2][i];
+            const float m[9] = { r, g, b, r * r, r * g, r * b, g * g, g * b, b * b };
+            for (int k = 0; k < 9; ++k) {
+                moments[i][k] = m[k];
+                total[k] += m[k];
+            }
+        }
+
+        // Ordena las particiones por el error de ajustar una recta a cada subconjunto.
+        std::pair<float, int> ranking[64];
+        alignas(32) float masks[2][16];
+        for (int partition = 0; partition < 64; ++partition) {
+            float sums[2][9] = {};
+            int count = 0;
+            for (int i = 0; i < 16; ++i) {
+                if ((BC7_PARTITIONS2[partition] >> i) & 1) {
+                    for (int k = 0; k < 9; ++k) {
+                        sums[1][k] += moments[i][k];
+                    }
+                    ++count;
+                }
+            }
+            for (int k = 0; k < 9; ++k) {
+                sums[0][k] = total[k] - sums[1][k];
+            }
+            const float error = lineResidual(16 - count, sums[0]) + lineResidual(count, sums[1]);
+            ranking[partition] = { error, partition };
+        }
+        std::partial_sort(ranking, ranking + BC7_PARTITION_CANDIDATES, ranking + 64);
+
+        float weights[8];
+        for (int k = 0; k < 8; ++k) {
+            weights[k] = BC7_WEIGHTS3[k] / 64.0f;
+        }
+        float best = FLT_MAX;
+        unsigned char candidate[16];
+        unsigned char indices[16];
+        for (int rank = 0; rank < BC7_PARTITION_CANDIDATES; ++rank) {
+            const int partition = ranking[rank].second;
+            for (int i = 0; i < 16; ++i) {
+                masks[1][i] = static_cast<float>((BC7_PARTITIONS2[partition] >> i) & 1);
+                masks[0][i] = 1.0f - masks[1][i];
+            }
+            float lo[2][4];
+            float hi[2][4];
+            for (int s = 0; s < 2; ++s) {
+                fitLine(block, 0, 3, masks[s], lo[s], hi[s]);
+            }
+            float error = encodeMode1(block, partition, lo, hi, candidate, indices);
+            if (error < best) {
+                best = error;
+                memcpy(out, candidate, sizeof(candidate));
+            }
+
+            // Una pasada de minimos cuadrados con los indices (ya orientados) de cada subconjunto.
+            bool refined = true;
+            for (int s = 0; s < 2 && refined; ++s) {
+                refined = refineLine(block, 0, 3, masks[s], indices, weights, lo[s], hi[s]);
+            }
+            if (refined) {
+                error = encodeMode1(block, partition, lo, hi, candidate, indices);
+                if (error < best) {
+                    best = error;
+                    memcpy(out, candidate, sizeof(candidate));
+                }
+            }
+        }
+        return best;
+    }
+
+    float
+    encodeBC7Block(const Block& block, bool high, unsigned char* out) {
+        float best = encodeBC7Mode6(block, high, out);
+        if (!high || best == 0.0f) {
+            return best;
+        }
+        // El modo 1 no guarda alfa: solo compite en bloques opacos.
+        for (int i = 0; i < 16; ++i) {
+            if (block.c[3][i] != 255.0f) {
+                return best;
+            }
+        }
+        unsigned char candidate[16] = {};
+        const float error = encodeBC7Mode1(block, candidate);
+        if (error < best) {
+            best = error;
+            memcpy(out, candidate, sizeof(candidate));
+        }
+        return best;
+    }
+
+    // BC6H (UF16): solo el modo 11, un subconjunto con extremos de 10 bits por canal sin
+    // deltas e indices de 4 bits. Los demas modos ganan precision con deltas o particiones;
+    // el modo 11 basta para mapas de entorno y lightmaps suaves.
+
+    /// Extremo de 10 bits a 16 bits (unquantize de UF16).
+    inline int
+    bc6hUnquantize(int q) {
+        return q == 0 ? 0 : (q == 1023 ? 0xFFFF : q * 64 + 32);
+    }
+
+    /// Valor interpolado (16 bits) a bits de medio float (finish_unquantize de UF16).
+    inline int
+    bc6hFinish(int value) {
+        return (value * 31) >> 6;
+    }
+
+    /// Extremo de 10 bits cuyo medio float final queda mas cerca de @p s (0..255).
+    int
+    quantizeBC6H(float s) {
+        const float half = clamp255(s) * (BC6H_MAX_HALF / 255.0f);
+        const int guess = static_cast<int>((half * 64.0f / 31.0f - 32.0f) / 64.0f + 0.5f);
+        int best = 0;
+        float bestError = FLT_MAX;
+        for (int q = std::max(0, guess - 1); q <= std::min(1023, guess + 1); ++q) {
+            const float error = std::fabs(static_cast<float>(bc6hFinish(bc6hUnquantize(q))) - half);
+            if (error < bestError) {
+                bestError = error;
+                best = q;
+            }
+        }
+        return best;
+    }
+
+    /// Cuantiza los extremos @p a y @p b y escribe un bloque en modo 11.
+    float
+    encodeBC6HMode11(const Block& block, const float* a, const float* b, unsigned char* out,
+                     unsigned char* indices) {
+        int q[2][3];
+        for (int c = 0; c < 3; ++c) {
+            q[0][c] = quantizeBC6H(a[c]);
+            q[1][c] = quantizeBC6H(b[c]);
+        }
+
+        const float scale = 255.0f / BC6H_MAX_HALF;
+        float palette[16][4];
+        for (int k = 0; k < 16; ++k) {
+            const int w = BC7_WEIGHTS4[k];
+            for (int c = 0; c < 3; ++c) {
+                const int u0 = bc6hUnquantize(q[0][c]);
+                const int u1 = bc6hUnquantize(q[1][c]);
+                palette[k][c] = bc6hFinish((u0 * (64 - w) + u1 * w + 32) >> 6) * scale;
+            }
+            palette[k][3] = 255.0f;
+        }
+        const float error = selectIndices(block, 0, 3, palette, 16, ALL_PIXELS, indices);
+
+        if (indices[0] >= 8) {
+            std::swap(q[0], q[1]);
+            for (int i = 0; i < 16; ++i) {
+                indices[i] = static_cast<unsigned char>(15 - indices[i]);
+            }
+        }
+
+        BitWriter writer(out, 16);
+        writer.write(3, 5);
+        for (int e = 0; e < 2; ++e) {
+            for (int c = 0; c < 3; ++c) {
+                writer.write(q[e][c], 10);
+            }
+        }
+        writer.write(indices[0], 3);
+        for (int i = 1; i < 16; ++i) {
+            writer.write(indices[i], 4);
+        }
+        return error;
+    }
+
+    float
+    encodeBC6HBlock(const Block& block, bool high, unsigned char* out) {
+        float lo[4];
+        float hi[4];
+        fitLine(block, 0, 3, ALL_PIXELS, lo, hi);
+        unsigned char indices[16];
+        float best = encodeBC6HMode11(block, lo, hi, out, indices);
+        if (!high || best == 0.0f) {
+            return best;
+        }
+
+        float weights[16];
+        for (int k = 0; k < 16; ++k) {
+            weights[k] = BC7_WEIGHTS4[k] / 64.0f;
+        }
+        unsigned char candidate[16];
+        unsigned char candidateIndices[16];
+        for (int iteration = 0; iteration < 2; ++iteration) {
+            float e0[4];
+            float e1[4];
+            if (!refineLine(block, 0, 3, ALL_PIXELS, indices, weights, e0, e1)) {
+                break;
+            }
+            const float error = encodeBC6HMode11(block, e0, e1, candidate, candidateIndices);
+            if (error >= best) {
+                break;
+            }
+            best = error;
+            memcpy(out, candidate, sizeof(candidate));
+            memcpy(indices, candidateIndices, sizeof(indices));
+        }
+        return best;
+    }
+
+    void
+    encodeBlock(const Block& block, BlockFormat format, bool high, unsigned char* out) {
+        switch (format) {
+        case BlockFormat::BC1:
+            encodeColorBlock(block, true, high, out);
+            break;
+        case BlockFormat::BC3:
+            encodeSingleBlock(block, 3, high, out);
+            encodeColorBlock(block, false, high, out + 8);
+            break;
+        case BlockFormat::BC4:
+            encodeSingleBlock(block, 0, high, out);
+            break;
+        case BlockFormat::BC5:
+            encodeSingleBlock(block, 0, high, out);
+            encodeSingleBlock(block, 1, high, out + 8);
+            break;
+        case BlockFormat::BC7:
+            encodeBC7Block(block, high, out);
+            break;
+        case BlockFormat::BC6H:
+            encodeBC6HBlock(block, high, out);
+            break;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // Decodificadores
+    // ---------------------------------------------------------------------------------------
+
+    void
+    decodeColorBlock(const unsigned char* in, bool fourColor, unsigned char pixels[16][4]) {
+        const uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+        const uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+        int palette[4][4];
+        colorPalette(c0, c1, fourColor, palette);
+        const uint32_t bits = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<uint32_t>(in[7]) << 24);
+        for (int i = 0; i < 16; ++i) {
+            const int* entry = palette[(bits >> (i * 2)) & 3];
+            for (int c = 0; c < 4; ++c) {
+                pixels[i][c] = static_cast<unsigned char>(entry[c]);
+            }
+        }
+    }
+
+    void
+    decodeSingleBlock(const unsigned char* in, unsigned char pixels[16][4], int channel) {
+        int palette[8];
+        singlePalette(in[0], in[1], palette);
+        uint64_t bits = 0;
+        for (int i = 0; i < 6; ++i) {
+            bits |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+        }
+        for (int i = 0; i < 16; ++i) {
+            pixels[i][channel] = static_cast<unsigned char>(palette[(bits >> (i * 3)) & 7]);
+        }
+    }
+
+    /// Descripcion de los modos de BC7.
+    struct Bc7Mode {
+        int subsets;
+        int partitionBits;
+        int rotationBits;
+        int indexSelectionBits;
+        int colorBits;
+        int alphaBits;
+        int endpointPBits;
+        int sharedPBits;
+        int indexBits;
+        int secondaryIndexBits;
+    };
+
+    const Bc7Mode BC7_MODES[8] = {
+        { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+        { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+        { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+        { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+        { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+        { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+        { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+        { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+    };
+
+    inline int
+    bc7Interpolate(int a, int b, int index, int bits) {
+        const int* weights = bits == 2 ? BC7_WEIGHTS2 : (bits == 3 ? BC7_WEIGHTS3 : BC7_WEIGHTS4);
+        return ((64 - weights[index]) * a + weights[index] * b + 32) >> 6;
+    }
+
+    /// Decodifica un bloque BC7; devuelve @c false (bloque en negro) para modos no soportados.
+    bool
+    decodeBC7Block(const unsigned char* in, unsigned char pixels[16][4]) {
+        memset(pixels, 0, 16 * 4);
+        int mode = 0;
+        while (mode < 8 && ((in[0] >> mode) & 1) == 0) {
+            ++mode;
+        }
+        if (mode == 8) {
+            return false;  // Modo reservado: el hardware devuelve ceros.
+        }
+        const Bc7Mode& info = BC7_MODES[mode];
+        if (info.subsets == 3) {
+            return false;
+        }
+
+        BitReader reader(in);
+        reader.read(mode + 1);
+        const unsigned int partition = reader.read(info.partitionBits);
+        const unsigned int rotation = reader.read(info.rotationBits);
+        const unsigned int indexSelection = reader.read(info.indexSelectionBits);
+
+        const int endpoints = info.subsets * 2;
+        int ep[4][4] = {};
+        for (int c = 0; c < 3; ++c) {
+            for (int e = 0; e < endpoints; ++e) {
+                ep[e][c] = static_cast<int>(reader.read(info.colorBits));
+            }
+        }
+        for (int e = 0; e < endpoints && info.alphaBits; ++e) {
+            ep[e][3] = static_cast<int>(reader.read(info.alphaBits));
+        }
+
+        int colorBits = info.colorBits;
+        int alphaBits = info.alphaBits;
+        if (info.endpointPBits || info.sharedPBits) {
+            int pbits[4];
+            if (info.endpointPBits) {
+                for (int e = 0; e < endpoints; ++e) {
+                    pbits[e] = static_cast<int>(reader.read(1));
+                }
+            }
+            else {
+                for (int s = 0; s < info.subsets; ++s) {
+                    pbits[s * 2] = pbits[s * 2 + 1] = static_cast<int>(reader.read(1));
+                }
+            }
+            for (int e = 0; e < endpoints; ++e) {
+                for (int c = 0; c < 4; ++c) {
+                    ep[e][c] = (ep[e][c] << 1) | pbits[e];
+                }
+            }
+            colorBits++;
+            alphaBits = alphaBits ? alphaBits + 1 : 0;
+        }
+        for (int e = 0; e < endpoints; ++e) {
+            for (int c = 0; c < 4; ++c) {
+                const int bits = c < 3 ? colorBits : alphaBits;
+                if (bits == 0) {
+                    ep[e][c] = 255;
+                }
+                else {
+                    ep[e][c] = (ep[e][c] << (8 - bits)) | (ep[e][c] >> (2 * bits - 8));
+                }
+            }
+        }
+
+        const unsigned int anchor = info.subsets == 2 ? BC7_ANCHOR2[partition] : 0u;
+        int primary[16];
+        int secondary[16] = {};
+        for (unsigned int i = 0; i < 16; ++i) {
+            const bool isAnchor = i == 0 || (info.subsets == 2 && i == anchor);
+            primary[i] = static_cast<int>(reader.read(info.indexBits - (isAnchor ? 1 : 0)));
+        }
+        for (unsigned int i = 0; i < 16 && info.secondaryIndexBits; ++i) {
+            secondary[i] = static_cast<int>(reader.read(info.secondaryIndexBits - (i == 0 ? 1 : 0)));
+        }
+
+        for (unsigned int i = 0; i < 16; ++i) {
+            const int subset = info.subsets == 2 ? (BC7_PARTITIONS2[partition] >> i) & 1 : 0;
+            const int* e0 = ep[subset * 2];
+            const int* e1 = ep[subset * 2 + 1];
+            int colorIndex = primary[i];
+            int colorIndexBits = info.indexBits;
+            int alphaIndex = primary[i];
+            int alphaIndexBits = info.indexBits;
+            if (info.secondaryIndexBits) {
+                alphaIndex = secondary[i];
+                alphaIndexBits = info.secondaryIndexBits;
+                if (indexSelection) {
+                    std::swap(colorIndex, alphaIndex);
+                    std::swap(colorIndexBits, alphaIndexBits);
+                }
+            }
+            int out[4];
+            for (int c = 0; c < 3; ++c) {
+                out[c] = bc7Interpolate(e0[c], e1[c], colorIndex, colorIndexBits);
+            }
+            out[3] = bc7Interpolate(e0[3], e1[3], alphaIndex, alphaIndexBits);
+            if (rotation) {
+                std::swap(out[3], out[rotation - 1]);
+            }
+            for (int c = 0; c < 4; ++c) {
+                pixels[i][c] = static_cast<unsigned char>(out[c]);
+            }
+        }
+        return true;
+    }
+
+    /// Decodifica un bloque BC6H (UF16) a medios floats RGB; solo el modo 11, los demas salen en negro.
+    bool
+    decodeBC6HBlock(const unsigned char* in, uint16_t halves[16][3]) {
+        memset(halves, 0, 16 * 3 * sizeof(uint16_t));
+        BitReader reader(in);
+        unsigned int mode = reader.read(2);
+        if (mode >= 2) {
+            mode |= reader.read(3) << 2;
+        }
+        if (mode != 3) {
+            return false;
+        }
+        int u[2][3];
+        for (int e = 0; e < 2; ++e) {
+            for (int c = 0; c < 3; ++c) {
+                u[e][c] = bc6hUnquantize(static_cast<int>(reader.read(10)));
+            }
+        }
+        for (int i = 0; i < 16; ++i) {
+            const int w = BC7_WEIGHTS4[reader.read(i == 0 ? 3 : 4)];
+            for (int c = 0; c < 3; ++c) {
+                halves[i][c] = static_cast<uint16_t>(bc6hFinish((u[0][c] * (64 - w) + u[1][c] * w + 32) >> 6));
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Reparte los bloques de @p target entre @p settings.jobs; @p load llena el bloque (bx, by).
+     * @p target ya tiene tamano, formato y datos reservados.
+     */
+    template<class Loader>
+    void
+    encodeBlocks(BlockImage& target, const BlockSettings& settings, const Loader& load) {
+        const unsigned int blockBytes = BlockImage::getBlockBytes(target.m_format);
+        const unsigned int blocksWide = target.getBlocksWide();
+        const bool high = settings.quality == BlockQuality::High;
+        auto encodeRows = [&](unsigned int begin, unsigned int end, unsigned int) {
+            Block block;
+            for (unsigned int by = begin; by < end; ++by) {
+                unsigned char* out = target.m_data.data() + static_cast<size_t>(by) * target.getRowPitch();
+                for (unsigned int bx = 0; bx < blocksWide; ++bx) {
+                    load(bx, by, block);
+                    encodeBlock(block, target.m_format, high, out + bx * blockBytes);
+                }
+            }
+        };
+        // Filas de unos 256 bloques por tarea.
+        const unsigned int grain = std::max(1u, 256u / blocksWide);
+        if (settings.jobs) {
+            settings.jobs->parallelFor(target.getBlocksHigh(), grain, encodeRows);
+        }
+        else {
+            encodeRows(0, target.getBlocksHigh(), 0);
+        }
+    }
+}
+
+unsigned int
+BlockImage::getBlockBytes(BlockFormat format) {
+    return (format == BlockFormat::BC1 || format == BlockFormat::BC4) ? 8u : 16u;
+}
+
+HRESULT
+BlockImage::encode(const Image& image, const BlockSettings& settings) {
+    destroy();
+    if (image.empty() || image.m_channels != 4) {
+        ERROR("BlockImage", "encode", "Image must be a non-empty RGBA8 image.");
+        return E_INVALIDARG;
+    }
+    if (settings.format == BlockFormat::BC6H) {
+        ERROR("BlockImage", "encode", "BC6H needs an HdrImage.");
+        return E_INVALIDARG;
+    }
+
+    m_width = image.m_width;
+    m_height = image.m_height;
+    m_format = settings.format;
+    m_data.resize(static_cast<size_t>(getRowPitch()) * getBlocksHigh());
+    encodeBlocks(*this, settings, [&](unsigned int bx, unsigned int by, Block& block) {
+        loadBlock(image, bx, by, block);
+    });
+    return S_OK;
+}
+
+HRESULT
+BlockImage::encode(const HdrImage& image, const BlockSettings& settings) {
+    destroy();
+    if (image.empty()) {
+        ERROR("BlockImage", "encode", "HDR image is empty.");
+        return E_INVALIDARG;
+    }
+    if (settings.format != BlockFormat::BC6H) {
+        ERROR("BlockImage", "encode", "HDR images can only be encoded as BC6H.");
+        return E_INVALIDARG;
+    }
+
+    m_width = image.m_width;
+    m_height = image.m_height;
+    m_format = BlockFormat::BC6H;
+    m_data.resize(static_cast<size_t>(getRowPitch()) * getBlocksHigh());
+    encodeBlocks(*this, settings, [&](unsigned int bx, unsigned int by, Block& block) {
+        loadHdrBlock(image, bx, by, block);
+    });
+    return S_OK;
+}
+
+HRESULT
+BlockImage::encodeMips(const MipChain& mips, const BlockSettings& settings, std::vector<BlockImage>& levels) {
+    levels.clear();
+    levels.resize(mips.getLevelCount());
+    for (unsigned int level = 0; level < mips.getLevelCount(); ++level) {
+        HRESULT hr = levels[level].encode(mips.getLevel(level), settings);
+        if (FAILED(hr)) {
+            levels.clear();
+            return hr;
+        }
+    }
+    return S_OK;
+}
+
+HRESULT
+BlockImage::encodeMips(const std::vector<HdrImage>& mips, const BlockSettings& settings,
+                       std::vector<BlockImage>& levels) {
+    levels.clear();
+    levels.resize(mips.size());
+    for (size_t level = 0; level < mips.size(); ++level) {
+        HRESULT hr = levels[level].encode(mips[level], settings);
+        if (FAILED(hr)) {
+            levels.clear();
+            return hr;
+        }
+    }
+    return S_OK;
+}
+
+HRESULT
+BlockImage::decode(Image& image) const {
+    if (empty()) {
+        ERROR("BlockImage", "decode", "No compressed data.");
+        return E_FAIL;
+    }
+    if (m_format == BlockFormat::BC6H) {
+        ERROR("BlockImage", "decode", "BC6H decodes to an HdrImage.");
+        return E_INVALIDARG;
+    }
+    HRESULT hr = image.init(m_width, m_height, 4);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    const unsigned int blockBytes = getBlockBytes(m_format);
+    unsigned char pixels[16][4];
+    for (unsigned int by = 0; by < getBlocksHigh(); ++by) {
+        for (unsigned int bx = 0; bx < getBlocksWide(); ++bx) {
+            const unsigned char* in = m_data.data() + static_cast<size_t>(by) * getRowPitch() + bx * blockBytes;
+            memset(pixels, 0, sizeof(pixels));
+            switch (m_format) {
+            case BlockFormat::BC1:
+                decodeColorBlock(in, false, pixels);
+                break;
+            case BlockFormat::BC3:
+                decodeColorBlock(in + 8, true, pixels);
+                decodeSingleBlock(in, pixels, 3);
+                break;
+            case BlockFormat::BC4:
+                decodeSingleBlock(in, pixels, 0);
+                break;
+            case BlockFormat::BC5:
+                decodeSingleBlock(in, pixels, 0);
+                decodeSingleBlock(in + 8, pixels, 1);
+                break;
+            case BlockFormat::BC7:
+                decodeBC7Block(in, pixels);
+                break;
+            case BlockFormat::BC6H:
+                break;
+            }
+            if (m_format == BlockFormat::BC4 || m_format == BlockFormat::BC5) {
+                for (int i = 0; i < 16; ++i) {
+                    pixels[i][3] = 255;
+                }
+            }
+
+            for (unsigned int y = 0; y < 4 && by * 4 + y < m_height; ++y) {
+                unsigned char* row = image.row(by * 4 + y);
+                for (unsigned int x = 0; x < 4 && bx * 4 + x < m_width; ++x) {
+                    memcpy(row + (bx * 4 + x) * 4, pixels[y * 4 + x], 4);
+                }
+            }
+        }
+    }
+    return S_OK;
+}
+
+HRESULT
+BlockImage::decode(HdrImage& image) const {
+    if (empty() || m_format != BlockFormat::BC6H) {
+        ERROR("BlockImage", "decode", "No BC6H data.");
+        return E_FAIL;
+    }
+    HRESULT hr = image.init(m_width, m_height);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    uint16_t halves[16][3];
+    for (unsigned int by = 0; by < getBlocksHigh(); ++by) {
+        for (unsigned int bx = 0; bx < getBlocksWide(); ++bx) {
+            decodeBC6HBlock(m_data.data() + static_cast<size_t>(by) * getRowPitch() + bx * 16, halves);
+            for (unsigned int y = 0; y < 4 && by * 4 + y < m_height; ++y) {
+                float* row = image.row(by * 4 + y);
+                for (unsigned int x = 0; x < 4 && bx * 4 + x < m_width; ++x) {
+                    float* p = row + (bx * 4 + x) * 4;
+                    for (int c = 0; c < 3; ++c) {
+                        p[c] = halfToFloat(halves[y * 4 + x][c]);
+                    }
+                    p[3] = 1.0f;
+                }
+            }
+        }
+    }
+    return S_OK;
+}
+
+void
+BlockImage::destroy() {
+    m_data.clear();
+    m_data.shrink_to_fit();
+    m_width = 0;
+    m_height = 0;
+}
+
+double
+BlockImage::computePsnr(const Image& reference, const Image& decoded, BlockFormat format) {
+    if (reference.m_width != decoded.m_width || reference.m_height != decoded.m_height ||
+        reference.m_channels != 4 || decoded.m_channels != 4) {
+        return 0.0;
+    }
+    unsigned int channels = 4;
+    switch (format) {
+    case BlockFormat::BC1: channels = 3; break;
+    case BlockFormat::BC4: channels = 1; break;
+    case BlockFormat::BC5: channels = 2; break;
+    default: break;
+    }
+
+    double sum = 0.0;
+    size_t counted = 0;
+    const size_t pixels = static_cast<size_t>(reference.m_width) * reference.m_height;
+    for (size_t p = 0; p < pixels; ++p) {
+        // En BC1 el color de los pixeles transparentes (alfa < 128) se descarta a proposito.
+        if (format == BlockFormat::BC1 && reference.m_pixels[p * 4 + 3] < 128) {
+            continue;
+        }
+        ++counted;
+        for (unsigned int c = 0; c < channels; ++c) {
+            const double diff = static_cast<double>(reference.m_pixels[p * 4 + c]) - decoded.m_pixels[p * 4 + c];
+            sum += diff * diff;
+        }
+    }
+    const double mse = counted ? sum / (static_cast<double>(counted) * channels) : 0.0;
+    if (mse == 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 10.0 * log10(255.0 * 255.0 / mse);
+}
@@ -0,0 +1,133 @@
+#include "BoundsTable.h"
+#include <cmath>
+
+void
+BoundsTable::reserve(unsigned int count) {
+    m_centerX.reserve(count);
+    m_centerY.reserve(count);
+    m_centerZ.reserve(count);
+    m_extentX.reserve(count);
+    m_extentY.reserve(count);
+    m_extentZ.reserve(count);
+    m_radius.reserve(count);
+}
+
+void
+BoundsTable::clear() {
+    m_centerX.clear();
+    m_centerY.clear();
+    m_centerZ.clear();
+    m_extentX.clear();
+    m_extentY.clear();
+    m_extentZ.clear();
+    m_radius.clear();
+}
+
+unsigned int
+BoundsTable::add(const AABB& localBox, const BoundingSphere& localSphere, const Matrix4& world) {
+    unsigned int index = add(localBox);
+    setTransform(index, localBox, localSphere, world);
+    return index;
+}
+
+unsigned int
+BoundsTable::add(const AABB& worldBox) {
+    unsigned int index = size();
+    m_centerX.push_back(0.0f);
+    m_centerY.push_back(0.0f);
+    m_centerZ.push_back(0.0f);
+    m_extentX.push_back(0.0f);
+    m_extentY.push_back(0.0f);
+    m_extentZ.push_back(0.0f);
+    m_radius.push_back(0.0f);
+    setWorldBox(index, worldBox);
+    return index;
+}
+
+unsigned int
+BoundsTable::remove(unsigned int index) {
+    unsigned int last = size() - 1;
+    m_centerX[index] = m_centerX[last];
+    m_centerY[index] = m_centerY[last];
+    m_centerZ[index] = m_centerZ[last];
+    m_extentX[index] = m_extentX[last];
+    m_extentY[index] = m_extentY[last];
+    m_extentZ[index] = m_extentZ[last];
+    m_radius[index] = m_radius[last];
+    m_centerX.pop_back();
+    m_centerY.pop_back();
+    m_centerZ.pop_back();
+    m_extentX.pop_back();
+    m_extentY.pop_back();
+    m_extentZ.pop_back();
+    m_radius.pop_back();
+    return last;
+}
+
+void
+BoundsTable::setTransform(unsigned int index, const AABB& localBox, const BoundingSphere& localSphere,
+                          const Matrix4& world) {
+    setWorldBox(index, transformBox(localBox, world));
+
+    // Esfera recentrada en la caja: se agrega la distancia entre ambos centros.
+    float dx = localSphere.center.x - (localBox.min.x + localBox.max.x) * 0.5f;
+    float dy = localSphere.center.y - (localBox.min.y + localBox.max.y) * 0.5f;
+    float dz = localSphere.center.z - (localBox.min.z + localBox.max.z) * 0.5f;
+    float radius = localSphere.radius + sqrtf(dx * dx + dy * dy + dz * dz);
+
+    float maxScaleSq = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        maxScaleSq = std::max(maxScaleSq,
+            world.m[i][0] * world.m[i][0] + world.m[i][1] * world.m[i][1] + world.m[i][2] * world.m[i][2]);
+    }
+    m_radius[index] = radius * sqrtf(maxScaleSq);
+}
+
+AABB
+BoundsTable::transformBox(const AABB& localBox, const Matrix4& world) {
+    const float c[3] = { (localBox.min.x + localBox.max.x) * 0.5f,
+                         (localBox.min.y + localBox.max.y) * 0.5f,
+                         (localBox.min.z + localBox.max.z) * 0.5f };
+    const float e[3] = { (localBox.max.x - localBox.min.x) * 0.5f,
+                         (localBox.max.y - localBox.min.y) * 0.5f,
+                         (localBox.max.z - localBox.min.z) * 0.5f };
+
+    // Centro transformado como punto; la extension de cada eje de mundo es la suma de las
+    // proyecciones absolutas de los ejes locales (vector fila: p' = p * M).
+    float wc[3], we[3];
+    for (int j = 0; j < 3; ++j) {
+        wc[j] = c[0] * world.m[0][j] + c[1] * world.m[1][j] + c[2] * world.m[2][j] + world.m[3][j];
+        we[j] = e[0] * fabsf(world.m[0][j]) + e[1] * fabsf(world.m[1][j]) + e[2] * fabsf(world.m[2][j]);
+    }
+
+    AABB box;
+    box.min = Vector3(wc[0] - we[0], wc[1] - we[1], wc[2] - we[2]);
+    box.max = Vector3(wc[0] + we[0], wc[1] + we[1], wc[2] + we[2]);
+    return box;
+}
+
+void
+BoundsTable::setWorldBox(unsigned int index, const AABB& worldBox) {
+    float ex = (worldBox.max.x - worldBox.min.x) * 0.5f;
+    float ey = (worldBox.max.y - worldBox.min.y) * 0.5f;
+    float ez = (worldBox.max.z - worldBox.min.z) * 0.5f;
+    m_centerX[index] = (worldBox.min.x + worldBox.max.x) * 0.5f;
+    m_centerY[index] = (worldBox.min.y + worldBox.max.y) * 0.5f;
+    m_centerZ[index] = (worldBox.min.z + worldBox.max.z) * 0.5f;
+    m_extentX[index] = ex;
+    m_extentY[index] = ey;
+    m_extentZ[index] = ez;
+    m_radius[index] = sqrtf(ex * ex + ey * ey + ez * ez);
+}
+
+AABB
+BoundsTable::getWorldBox(unsigned int index) const {
+    AABB box;
+    box.min = Vector3(m_centerX[index] - m_extentX[index],
+                       m_centerY[index] - m_extentY[index],
+                       m_centerZ[index] - m_extentZ[index]);
+    box.max = Vector3(m_centerX[index] + m_extentX[index],
+                       m_centerY[index] + m_extentY[index],
+                       m_centerZ[index] + m_extentZ[index]);
+    return box;
+}
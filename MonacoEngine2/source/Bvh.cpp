@@ -0,0 +1,497 @@
+#include "Bvh.h"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    /// Direcciones mas pequenas que esto se tratan como paralelas al eje.
+    const float MIN_DIRECTION = 1e-20f;
+
+    /// Caja vacia: cualquier union con ella devuelve la otra caja.
+    inline void
+    resetBounds(float min[3], float max[3]) {
+        for (int a = 0; a < 3; ++a) {
+            min[a] = FLT_MAX;
+            max[a] = -FLT_MAX;
+        }
+    }
+
+    inline void
+    growBounds(float min[3], float max[3], const AABB& box) {
+        min[0] = std::min(min[0], box.min.x); max[0] = std::max(max[0], box.max.x);
+        min[1] = std::min(min[1], box.min.y); max[1] = std::max(max[1], box.max.y);
+        min[2] = std::min(min[2], box.min.z); max[2] = std::max(max[2], box.max.z);
+    }
+
+    inline void
+    growBounds(float min[3], float max[3], const float otherMin[3], const float otherMax[3]) {
+        for (int a = 0; a < 3; ++a) {
+            min[a] = std::min(min[a], otherMin[a]);
+            max[a] = std::max(max[a], otherMax[a]);
+        }
+    }
+
+    /// Semi-area de la superficie (el factor 2 no cambia las comparaciones de la SAH).
+    inline float
+    halfArea(const float min[3], const float max[3]) {
+        float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+        if (dx < 0.0f || dy < 0.0f || dz < 0.0f) {
+            return 0.0f;
+        }
+        return dx * dy + dy * dz + dz * dx;
+    }
+
+    inline float
+    centroid(const AABB& box, int axis) {
+        return (&box.min.x)[axis] + (&box.max.x)[axis];
+    }
+
+    inline bool
+    overlaps(const float min[3], const float max[3], const AABB& box) {
+        return min[0] <= box.max.x && max[0] >= box.min.x
+            && min[1] <= box.max.y && max[1] >= box.min.y
+            && min[2] <= box.max.z && max[2] >= box.min.z;
+    }
+
+    /// Distancia al cuadrado de un punto a la caja.
+    inline float
+    distanceSq(const float min[3], const float max[3], const Vector3& point) {
+        const float p[3] = { point.x, point.y, point.z };
+        float d = 0.0f;
+        for (int a = 0; a < 3; ++a) {
+            float v = std::max(std::max(min[a] - p[a], 0.0f), p[a] - max[a]);
+            d += v * v;
+        }
+        return d;
+    }
+
+    /// Nodo pendiente durante la construccion.
+    struct BuildTask {
+        unsigned int node;
+        unsigned int begin;
+        unsigned int end;
+        unsigned int depth;
+    };
+}
+
+const unsigned int Bvh::INVALID_INDEX;
+const unsigned int Bvh::BIN_COUNT;
+const unsigned int Bvh::MAX_SAH_DEPTH;
+const unsigned int Bvh::STACK_SIZE;
+
+void
+RayPacket::set(const Ray* rays, unsigned int count) {
+    for (unsigned int lane = 0; lane < static_cast<unsigned int>(simd::SIMD_LANES); ++lane) {
+        // Carriles vacios: copia del primer rayo con tMax negativo.
+        const Ray& ray = rays[lane < count ? lane : 0];
+        float invDir[3];
+        Bvh::inverseDirection(ray.direction, invDir);
+        originX[lane] = ray.origin.x;
+        originY[lane] = ray.origin.y;
+        originZ[lane] = ray.origin.z;
+        dirX[lane] = ray.direction.x;
+        dirY[lane] = ray.direction.y;
+        dirZ[lane] = ray.direction.z;
+        invX[lane] = invDir[0];
+        invY[lane] = invDir[1];
+        invZ[lane] = invDir[2];
+        tMax[lane] = lane < count ? ray.tMax : -1.0f;
+        u[lane] = 0.0f;
+        v[lane] = 0.0f;
+        primitive[lane] = Bvh::INVALID_INDEX;
+    }
+}
+
+void
+RayPacket::getHit(unsigned int lane, RayHit& hit) const {
+    hit.t = tMax[lane];
+    hit.primitive = primitive[lane];
+    hit.u = u[lane];
+    hit.v = v[lane];
+}
+
+HRESULT
+Bvh::build(const AABB* boxes, unsigned int count, unsigned int maxLeafSize) {
+    if (maxLeafSize == 0 || maxLeafSize > 255) {
+        ERROR("Bvh", "build", "maxLeafSize must be between 1 and 255");
+        return E_INVALIDARG;
+    }
+    destroy();
+    if (count == 0) {
+        return S_OK;
+    }
+
+    m_boxes.assign(boxes, boxes + count);
+    m_indices.resize(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        m_indices[i] = i;
+    }
+    m_leafOf.assign(count, INVALID_INDEX);
+    m_nodes.reserve(static_cast<size_t>(count) * 2);
+    m_parents.reserve(static_cast<size_t>(count) * 2);
+
+    m_nodes.push_back(Node());
+    m_parents.push_back(INVALID_INDEX);
+
+    struct Bin {
+        float min[3], max[3];
+        unsigned int count;
+    };
+
+    std::vector<BuildTask> tasks;
+    tasks.push_back({ 0, 0, count, 0 });
+    while (!tasks.empty()) {
+        BuildTask task = tasks.back();
+        tasks.pop_back();
+        m_depth = std::max(m_depth, task.depth);
+
+        Node& node = m_nodes[task.node];
+        float centroidMin[3], centroidMax[3];
+        resetBounds(node.min, node.max);
+        resetBounds(centroidMin, centroidMax);
+        for (unsigned int i = task.begin; i < task.end; ++i) {
+            const AABB& box = m_boxes[m_indices[i]];
+            growBounds(node.min, node.max, box);
+            for (int a = 0; a < 3; ++a) {
+                float c = centroid(box, a);
+                centroidMin[a] = std::min(centroidMin[a], c);
+                centroidMax[a] = std::max(centroidMax[a], c);
+            }
+        }
+
+        const unsigned int primitives = task.end - task.begin;
+        int bestAxis = -1;
+        unsigned int bestBin = 0;
+        float bestCost = FLT_MAX;
+
+        if (task.depth < MAX_SAH_DEPTH && primitives > 1) {
+            for (int a = 0; a < 3; ++a) {
+                float extent = centroidMax[a] - centroidMin[a];
+                if (extent <= 0.0f) {
+                    continue;
+                }
+                Bin bins[BIN_COUNT];
+                for (Bin& bin : bins) {
+                    resetBounds(bin.min, bin.max);
+                    bin.count = 0;
+                }
+                float scale = BIN_COUNT / extent;
+                for (unsigned int i = task.begin; i < task.end; ++i) {
+                    const AABB& box = m_boxes[m_indices[i]];
+                    unsigned int b = std::min(BIN_COUNT - 1,
+                        static_cast<unsigned int>((centroid(box, a) - centroidMin[a]) * scale));
+                    growBounds(bins[b].min, bins[b].max, box);
+                    bins[b].count++;
+                }
+
+                // Barrido de derecha a izquierda para las areas del lado derecho.
+                float rightArea[BIN_COUNT - 1];
+                unsigned int rightCount[BIN_COUNT - 1];
+                float min[3], max[3];
+                resetBounds(min, max);
+                unsigned int sum = 0;
+                for (unsigned int b = BIN_COUNT - 1; b > 0; --b) {
+                    growBounds(min, max, bins[b].min, bins[b].max);
+                    sum += bins[b].count;
+                    rightArea[b - 1] = halfArea(min, max);
+                    rightCount[b - 1] = sum;
+                }
+                resetBounds(min, max);
+                sum = 0;
+                for (unsigned int b = 0; b < BIN_COUNT - 1; ++b) {
+                    growBounds(min, max, bins[b].min, bins[b].max);
+                    sum += bins[b].count;
+                    if (sum == 0 || rightCount[b] == 0) {
+                        continue;
+                    }
+                    float cost = halfArea(min, max) * sum + rightArea[b] * rightCount[b];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = a;
+                        bestBin = b;
+                    }
+                }
+            }
+        }
+
+        // Costo de recorrer un nodo = 1, de probar una primitiva = 1.
+        float parentArea = halfArea(node.min, node.max);
+        float splitCost = bestAxis >= 0 && parentArea > 0.0f ? 1.0f + bestCost / parentArea : FLT_MAX;
+        if (primitives <= maxLeafSize && splitCost >= static_cast<float>(primitives)) {
+            node.leftFirst = task.begin;
+            node.count = static_cast<unsigned short>(primitives);
+            node.axis = 0;
+            for (unsigned int i = task.begin; i < task.end; ++i) {
+                m_leafOf[m_indices[i]] = task.node;
+            }
+            continue;
+        }
+
+        unsigned int* first = m_indices.data() + task.begin;
+        unsigned int* last = m_indices.data() + task.end;
+        unsigned int* middle = first;
+        if (bestAxis >= 0) {
+            float scale = BIN_COUNT / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+            const float minCentroid = centroidMin[bestAxis];
+            const std::vector<AABB>& allBoxes = m_boxes;
+            middle = std::partition(first, last, [&](unsigned int index) {
+                unsigned int b = std::min(BIN_COUNT - 1,
+                    static_cast<unsigned int>((centroid(allBoxes[index], bestAxis) - minCentroid) * scale));
+                return b <= bestBin;
+            });
+        }
+        if (middle == first || middle == last) {
+            // Sin particion SAH util (centroides iguales o demasiada profundidad): mediana
+            // sobre el eje de mayor extension de los centroides.
+            int axis = 0;
+            for (int a = 1; a < 3; ++a) {
+                if (centroidMax[a] - centroidMin[a] > centroidMax[axis] - centroidMin[axis]) {
+                    axis = a;
+                }
+            }
+            bestAxis = axis;
+            middle = first + primitives / 2;
+            const std::vector<AABB>& allBoxes = m_boxes;
+            std::nth_element(first, middle, last, [&](unsigned int a, unsigned int b) {
+                return centroid(allBoxes[a], axis) < centroid(allBoxes[b], axis);
+            });
+        }
+
+        unsigned int left = static_cast<unsigned int>(m_nodes.size());
+        unsigned int split = static_cast<unsigned int>(middle - m_indices.data());
+        node.leftFirst = left;
+        node.count = 0;
+        node.axis = static_cast<unsigned short>(bestAxis);
+        // node deja de ser valida al crecer m_nodes.
+        m_nodes.push_back(Node());
+        m_nodes.push_back(Node());
+        m_parents.push_back(task.node);
+        m_parents.push_back(task.node);
+        tasks.push_back({ left + 1, split, task.end, task.depth + 1 });
+        tasks.push_back({ left, task.begin, split, task.depth + 1 });
+    }
+
+    return S_OK;
+}
+
+void
+Bvh::refit(const AABB* boxes) {
+    m_boxes.assign(boxes, boxes + m_boxes.size());
+    for (size_t i = m_nodes.size(); i > 0; --i) {
+        updateNodeBounds(static_cast<unsigned int>(i - 1));
+    }
+}
+
+void
+Bvh::refit(unsigned int primitive, const AABB& box) {
+    m_boxes[primitive] = box;
+    unsigned int nodeIndex = m_leafOf[primitive];
+    while (nodeIndex != INVALID_INDEX) {
+        Node& node = m_nodes[nodeIndex];
+        const Node before = node;
+        updateNodeBounds(nodeIndex);
+        if (nodeIndex != m_leafOf[primitive]
+            && memcmp(before.min, node.min, sizeof(node.min)) == 0
+            && memcmp(before.max, node.max, sizeof(node.max)) == 0) {
+            break;
+        }
+        nodeIndex = m_parents[nodeIndex];
+    }
+}
+
+void
+Bvh::updateNodeBounds(unsigned int nodeIndex) {
+    Node& node = m_nodes[nodeIndex];
+    resetBounds(node.min, node.max);
+    if (node.isLeaf()) {
+        for (unsigned int i = 0; i < node.count; ++i) {
+            growBounds(node.min, node.max, m_boxes[m_indices[node.leftFirst + i]]);
+        }
+    }
+    else {
+        const Node& left = m_nodes[node.leftFirst];
+        const Node& right = m_nodes[node.leftFirst + 1];
+        growBounds(node.min, node.max, left.min, left.max);
+        growBounds(node.min, node.max, right.min, right.max);
+    }
+}
+
+void
+Bvh::queryAABB(const AABB& box, std::vector<unsigned int>& out) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+    unsigned int stack[STACK_SIZE];
+    unsigned int size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const Node& node = m_nodes[stack[--size]];
+        if (!overlaps(node.min, node.max, box)) {
+            continue;
+        }
+        if (!node.isLeaf()) {
+            stack[size++] = node.leftFirst;
+            stack[size++] = node.leftFirst + 1;
+            continue;
+        }
+        for (unsigned int i = 0; i < node.count; ++i) {
+            unsigned int primitive = m_indices[node.leftFirst + i];
+            const AABB& other = m_boxes[primitive];
+            const float min[3] = { other.min.x, other.min.y, other.min.z };
+            const float max[3] = { other.max.x, other.max.y, other.max.z };
+            if (overlaps(min, max, box)) {
+                out.push_back(primitive);
+            }
+        }
+    }
+}
+
+void
+Bvh::querySphere(const Vector3& center, float radius, std::vector<unsigned int>& out) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+    const float radiusSq = radius * radius;
+    unsigned int stack[STACK_SIZE];
+    unsigned int size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const Node& node = m_nodes[stack[--size]];
+        if (distanceSq(node.min, node.max, center) > radiusSq) {
+            continue;
+        }
+        if (!node.isLeaf()) {
+            stack[size++] = node.leftFirst;
+            stack[size++] = node.leftFirst + 1;
+            continue;
+        }
+        for (unsigned int i = 0; i < node.count; ++i) {
+            unsigned int primitive = m_indices[node.leftFirst + i];
+            const AABB& other = m_boxes[primitive];
+            const float min[3] = { other.min.x, other.min.y, other.min.z };
+            const float max[3] = { other.max.x, other.max.y, other.max.z };
+            if (distanceSq(min, max, center) <= radiusSq) {
+                out.push_back(primitive);
+            }
+        }
+    }
+}
+
+bool
+Bvh::raycast(const Ray& ray, RayHit& hit) const {
+    const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+    float invDir[3];
+    inverseDirection(ray.direction, invDir);
+
+    hit.t = ray.tMax;
+    hit.primitive = INVALID_INDEX;
+    hit.u = hit.v = 0.0f;
+    float tMax = ray.tMax;
+    traverseRay(ray, tMax, [&](unsigned int first, unsigned int count, float& tLimit) {
+        for (unsigned int i = 0; i < count; ++i) {
+            unsigned int primitive = m_indices[first + i];
+            const AABB& box = m_boxes[primitive];
+            const float min[3] = { box.min.x, box.min.y, box.min.z };
+            const float max[3] = { box.max.x, box.max.y, box.max.z };
+            float t = intersectBox(min, max, origin, invDir, tLimit);
+            if (t >= 0.0f && t < tLimit) {
+                tLimit = t;
+                hit.t = t;
+                hit.primitive = primitive;
+            }
+        }
+    });
+    return hit.primitive != INVALID_INDEX;
+}
+
+void
+Bvh::intersectPacket(RayPacket& packet) const {
+    using namespace simd;
+    const FloatV origin[3] = { load(packet.originX), load(packet.originY), load(packet.originZ) };
+    const FloatV invDir[3] = { load(packet.invX), load(packet.invY), load(packet.invZ) };
+
+    traversePacket(packet, [&](unsigned int first, unsigned int count) {
+        for (unsigned int i = 0; i < count; ++i) {
+            unsigned int primitive = m_indices[first + i];
+            const AABB& box = m_boxes[primitive];
+            const float min[3] = { box.min.x, box.min.y, box.min.z };
+            const float max[3] = { box.max.x, box.max.y, box.max.z };
+
+            // Distancia de entrada por carril; el impacto debe quedar antes del tMax actual.
+            FloatV tMax = load(packet.tMax);
+            FloatV tNear = zero();
+            FloatV tFar = tMax;
+            for (int a = 0; a < 3; ++a) {
+                FloatV t0 = mul(sub(set1(min[a]), origin[a]), invDir[a]);
+                FloatV t1 = mul(sub(set1(max[a]), origin[a]), invDir[a]);
+                tNear = simd::max(tNear, simd::min(t0, t1));
+                tFar = simd::min(tFar, mul(simd::max(t0, t1), set1(SLAB_EXIT_SCALE)));
+            }
+            FloatV hit = andv(cmple(tNear, tFar), cmplt(tNear, tMax));
+            int bits = movemask(hit);
+            if (bits == 0) {
+                continue;
+            }
+            store(packet.tMax, select(hit, tNear, tMax));
+            for (int lane = 0; bits != 0; ++lane, bits >>= 1) {
+                if (bits & 1) {
+                    packet.primitive[lane] = primitive;
+                }
+            }
+        }
+    });
+}
+
+float
+Bvh::getCost() const {
+    if (m_nodes.empty()) {
+        return 0.0f;
+    }
+    float rootArea = halfArea(m_nodes[0].min, m_nodes[0].max);
+    if (rootArea <= 0.0f) {
+        return 0.0f;
+    }
+    float cost = 0.0f;
+    for (const Node& node : m_nodes) {
+        float area = halfArea(node.min, node.max);
+        cost += node.isLeaf() ? area * node.count : area;
+    }
+    return cost / rootArea;
+}
+
+void
+Bvh::destroy() {
+    m_nodes.clear();
+    m_indices.clear();
+    m_boxes.clear();
+    m_parents.clear();
+    m_leafOf.clear();
+    m_depth = 0;
+}
+
+float
+Bvh::intersectBox(const float min[3], const float max[3],
+                  const float origin[3], const float invDir[3], float tMax) {
+    float tNear = 0.0f;
+    float tFar = tMax;
+    for (int a = 0; a < 3; ++a) {
+        float t0 = (min[a] - origin[a]) * invDir[a];
+        float t1 = (max[a] - origin[a]) * invDir[a];
+        tNear = std::max(tNear, std::min(t0, t1));
+        tFar = std::min(tFar, std::max(t0, t1) * SLAB_EXIT_SCALE);
+    }
+    return tNear <= tFar ? tNear : -1.0f;
+}
+
+void
+Bvh::inverseDirection(const Vector3& direction, float invDir[3]) {
+    const float d[3] = { direction.x, direction.y, direction.z };
+    for (int a = 0; a < 3; ++a) {
+        if (fabsf(d[a]) < MIN_DIRECTION) {
+            invDir[a] = d[a] < 0.0f ? -1.0f / MIN_DIRECTION : 1.0f / MIN_DIRECTION;
+        }
+        else {
+            invDir[a] = 1.0f / d[a];
+        }
+    }
+}
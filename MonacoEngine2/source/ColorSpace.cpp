@@ -0,0 +1,104 @@
+#include "ColorSpace.h"
+
+using namespace simd;
+
+namespace {
+    /// Tabla sRGB de 8 bits -> lineal.
+    struct Srgb8Table {
+        float values[256];
+
+        Srgb8Table() {
+            for (int i = 0; i < 256; ++i) {
+                values[i] = color::srgbToLinear(i / 255.0f);
+            }
+        }
+    };
+
+    const Srgb8Table&
+    srgb8Table() {
+        static const Srgb8Table table;
+        return table;
+    }
+
+    /// Mascara con el lane de alfa (cada cuarto lane) en 1.
+    FloatV alphaLanes() {
+        static const float pattern[8] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+        return cmpgt(load(pattern), zero());
+    }
+
+    /// SIMD_LANES floats lineales (ya saturados) a bytes: sRGB donde @p srgbMask, lineal donde no.
+    inline FloatV encodeLanes(FloatV l, FloatV srgbMask) {
+        const FloatV encoded = select(srgbMask, color::linearToSrgbFast(l), l);
+        return madd(encoded, set1(255.0f), set1(0.5f));
+    }
+}
+
+const float*
+color::srgb8ToLinearTable() {
+    return srgb8Table().values;
+}
+
+void
+color::srgb8ToLinear(const unsigned char* src, float* dst, size_t count) {
+    const float* table = srgb8Table().values;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = table[src[i]];
+    }
+}
+
+void
+color::linearToSrgb8(const float* src, unsigned char* dst, size_t count) {
+    const FloatV zeroV = zero();
+    const FloatV oneV = set1(1.0f);
+    const FloatV all = maskFrom(true);
+    size_t i = 0;
+    for (; i + SIMD_LANES <= count; i += SIMD_LANES) {
+        storeBytes(dst + i, encodeLanes(min(max(load(src + i), zeroV), oneV), all));
+    }
+    if (i < count) {
+        // La cola pasa por un bloque completo para dar exactamente los mismos valores.
+        float tail[SIMD_LANES] = {};
+        unsigned char bytes[SIMD_LANES];
+        memcpy(tail, src + i, (count - i) * sizeof(float));
+        storeBytes(bytes, encodeLanes(min(max(load(tail), zeroV), oneV), all));
+        memcpy(dst + i, bytes, count - i);
+    }
+}
+
+void
+color::decodeRgba8(const unsigned char* src, float* dst, size_t pixels, ColorSpace space) {
+    if (space == ColorSpace::Linear) {
+        for (size_t i = 0; i < pixels * 4; ++i) {
+            dst[i] = src[i] * (1.0f / 255.0f);
+        }
+        return;
+    }
+    const float* table = srgb8Table().values;
+    for (size_t p = 0; p < pixels * 4; p += 4) {
+        dst[p + 0] = table[src[p + 0]];
+        dst[p + 1] = table[src[p + 1]];
+        dst[p + 2] = table[src[p + 2]];
+        dst[p + 3] = src[p + 3] * (1.0f / 255.0f);
+    }
+}
+
+void
+color::encodeRgba8(const float* src, unsigned char* dst, size_t pixels, ColorSpace space) {
+    const FloatV zeroV = zero();
+    const FloatV oneV = set1(1.0f);
+    // Lanes RGB en sRGB; el alfa (y todo en lineal) solo se escala.
+    const FloatV mask = space == ColorSpace::Srgb ? select(alphaLanes(), zeroV, maskFrom(true)) : zeroV;
+
+    const size_t count = pixels * 4;
+    size_t i = 0;
+    for (; i + SIMD_LANES <= count; i += SIMD_LANES) {
+        storeBytes(dst + i, encodeLanes(min(max(load(src + i), zeroV), oneV), mask));
+    }
+    if (i < count) {
+        float tail[SIMD_LANES] = {};
+        unsigned char bytes[SIMD_LANES];
+        memcpy(tail, src + i, (count - i) * sizeof(float));
+        storeBytes(bytes, encodeLanes(min(max(load(tail), zeroV), oneV), mask));
+        memcpy(dst + i, bytes, count - i);
+    }
+}
@@ -0,0 +1,231 @@
+#include "CubeMap.h"
+#include "JobSystem.h"
+#include <cmath>
+
+namespace {
+    const float PI = 3.14159265358979f;
+
+    /// RGB bilineal de @p image en el pixel continuo (@p x, @p y); @p wrapX repite en x, si no satura.
+    void sampleBilinear(const HdrImage& image, float x, float y, bool wrapX, float* rgb) {
+        const float fx = std::floor(x);
+        const float fy = std::floor(y);
+        const float tx = x - fx;
+        const float ty = y - fy;
+        const int w = static_cast<int>(image.m_width);
+        const int h = static_cast<int>(image.m_height);
+        int x0 = static_cast<int>(fx);
+        int x1 = x0 + 1;
+        if (wrapX) {
+            x0 = ((x0 % w) + w) % w;
+            x1 = ((x1 % w) + w) % w;
+        }
+        else {
+            x0 = std::min(std::max(x0, 0), w - 1);
+            x1 = std::min(std::max(x1, 0), w - 1);
+        }
+        const int y0 = std::min(std::max(static_cast<int>(fy), 0), h - 1);
+        const int y1 = std::min(std::max(static_cast<int>(fy) + 1, 0), h - 1);
+        const float* r0 = image.row(static_cast<unsigned int>(y0));
+        const float* r1 = image.row(static_cast<unsigned int>(y1));
+        for (int c = 0; c < 3; ++c) {
+            const float top = r0[x0 * 4 + c] + (r0[x1 * 4 + c] - r0[x0 * 4 + c]) * tx;
+            const float bottom = r1[x0 * 4 + c] + (r1[x1 * 4 + c] - r1[x0 * 4 + c]) * tx;
+            rgb[c] = top + (bottom - top) * ty;
+        }
+    }
+
+    /// Area proyectada en la esfera del rectangulo [0, x] x [0, y] de la cara z = 1.
+    inline float areaElement(float x, float y) {
+        return std::atan2(x * y, std::sqrt(x * x + y * y + 1.0f));
+    }
+}
+
+HRESULT
+CubeMap::init(unsigned int size) {
+    if (size == 0) {
+        ERROR("CubeMap", "init", "Face size must be greater than 0");
+        return E_INVALIDARG;
+    }
+    std::vector<HdrImage> faces(FACE_COUNT);
+    for (HdrImage& face : faces) {
+        HRESULT hr = face.init(size, size);
+        if (FAILED(hr)) {
+            return hr;
+        }
+    }
+    m_faces = std::move(faces);
+    m_size = size;
+    return S_OK;
+}
+
+HRESULT
+CubeMap::initFromFaces(std::vector<HdrImage>&& faces) {
+    if (faces.size() != FACE_COUNT || faces[0].empty()) {
+        ERROR("CubeMap", "initFromFaces", "A cube map needs six faces.");
+        return E_INVALIDARG;
+    }
+    const unsigned int size = faces[0].m_width;
+    for (const HdrImage& face : faces) {
+        if (face.m_width != size || face.m_height != size) {
+            ERROR("CubeMap", "initFromFaces", "Cube faces must be square and the same size.");
+            return E_INVALIDARG;
+        }
+    }
+    m_faces = std::move(faces);
+    m_size = size;
+    return S_OK;
+}
+
+HRESULT
+CubeMap::loadFaces(const std::vector<std::string>& fileNames) {
+    if (fileNames.size() != FACE_COUNT) {
+        ERROR("CubeMap", "loadFaces", "A cube map needs six face files.");
+        return E_INVALIDARG;
+    }
+    std::vector<HdrImage> faces(FACE_COUNT);
+    for (unsigned int face = 0; face < FACE_COUNT; ++face) {
+        if (FAILED(faces[face].loadFromFile(fileNames[face]))) {
+            return E_FAIL;
+        }
+    }
+    return initFromFaces(std::move(faces));
+}
+
+HRESULT
+CubeMap::initFromEquirect(const HdrImage& panorama, unsigned int size, JobSystem* jobs) {
+    if (panorama.empty()) {
+        ERROR("CubeMap", "initFromEquirect", "Panorama is empty.");
+        return E_INVALIDARG;
+    }
+    CubeMap result;
+    HRESULT hr = result.init(size);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    // Una fila por cada (cara, y): las seis caras se reparten juntas.
+    const float scale = 2.0f / size;
+    auto convertRows = [&](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int index = begin; index < end; ++index) {
+            const unsigned int face = index / size;
+            const unsigned int y = index % size;
+            float* row = result.m_faces[face].row(y);
+            const float v = (y + 0.5f) * scale - 1.0f;
+            for (unsigned int x = 0; x < size; ++x) {
+                float dir[3];
+                faceDirection(face, (x + 0.5f) * scale - 1.0f, v, dir);
+                const float length = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+                const float longitude = std::atan2(dir[0], -dir[2]);
+                const float latitude = std::acos(std::min(1.0f, std::max(-1.0f, dir[1] / length)));
+                sampleBilinear(panorama, (longitude / (2.0f * PI) + 0.5f) * panorama.m_width - 0.5f,
+                    latitude / PI * panorama.m_height - 0.5f, true, row + x * 4);
+                row[x * 4 + 3] = 1.0f;
+            }
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(FACE_COUNT * size, std::max(1u, 4096u / size), convertRows);
+    }
+    else {
+        convertRows(0, FACE_COUNT * size, 0);
+    }
+    *this = std::move(result);
+    return S_OK;
+}
+
+HRESULT
+CubeMap::loadEquirect(const std::string& fileName, unsigned int size, JobSystem* jobs) {
+    HdrImage panorama;
+    HRESULT hr = panorama.loadFromFile(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    return initFromEquirect(panorama, size, jobs);
+}
+
+HRESULT
+CubeMap::generateMips(CubeMap&& base, std::vector<CubeMap>& levels, unsigned int maxLevels) {
+    levels.clear();
+    if (base.empty()) {
+        ERROR("CubeMap", "generateMips", "Cube map is empty.");
+        return E_INVALIDARG;
+    }
+    levels.push_back(std::move(base));
+    while (levels.back().m_size > 1 && (maxLevels == 0 || levels.size() < maxLevels)) {
+        std::vector<HdrImage> faces(FACE_COUNT);
+        for (unsigned int face = 0; face < FACE_COUNT; ++face) {
+            HRESULT hr = levels.back().m_faces[face].halfSize(faces[face]);
+            if (FAILED(hr)) {
+                return hr;
+            }
+        }
+        CubeMap next;
+        next.m_size = faces[0].m_width;
+        next.m_faces = std::move(faces);
+        levels.push_back(std::move(next));
+    }
+    return S_OK;
+}
+
+void
+CubeMap::sample(const float* dir, float* rgb) const {
+    unsigned int face = 0;
+    float u = 0.0f;
+    float v = 0.0f;
+    directionToFace(dir, face, u, v);
+    const float half = 0.5f * m_size;
+    sampleBilinear(m_faces[face], (u + 1.0f) * half - 0.5f, (v + 1.0f) * half - 0.5f, false, rgb);
+}
+
+void
+CubeMap::faceDirection(unsigned int face, float u, float v, float* dir) {
+    switch (face) {
+    case 0: dir[0] = 1.0f; dir[1] = -v; dir[2] = -u; break;
+    case 1: dir[0] = -1.0f; dir[1] = -v; dir[2] = u; break;
+    case 2: dir[0] = u; dir[1] = 1.0f; dir[2] = v; break;
+    case 3: dir[0] = u; dir[1] = -1.0f; dir[2] = -v; break;
+    case 4: dir[0] = u; dir[1] = -v; dir[2] = 1.0f; break;
+    default: dir[0] = -u; dir[1] = -v; dir[2] = -1.0f; break;
+    }
+}
+
+void
+CubeMap::directionToFace(const float* dir, unsigned int& face, float& u, float& v) {
+    const float ax = std::fabs(dir[0]);
+    const float ay = std::fabs(dir[1]);
+    const float az = std::fabs(dir[2]);
+    if (ax >= ay && ax >= az) {
+        const float inv = ax > 0.0f ? 1.0f / ax : 0.0f;
+        face = dir[0] >= 0.0f ? 0u : 1u;
+        u = (dir[0] >= 0.0f ? -dir[2] : dir[2]) * inv;
+        v = -dir[1] * inv;
+    }
+    else if (ay >= az) {
+        const float inv = 1.0f / ay;
+        face = dir[1] >= 0.0f ? 2u : 3u;
+        u = dir[0] * inv;
+        v = (dir[1] >= 0.0f ? dir[2] : -dir[2]) * inv;
+    }
+    else {
+        const float inv = 1.0f / az;
+        face = dir[2] >= 0.0f ? 4u : 5u;
+        u = (dir[2] >= 0.0f ? dir[0] : -dir[0]) * inv;
+        v = -dir[1] * inv;
+    }
+}
+
+float
+CubeMap::texelSolidAngle(unsigned int x, unsigned int y, unsigned int size) {
+    const float scale = 2.0f / size;
+    const float x0 = x * scale - 1.0f;
+    const float y0 = y * scale - 1.0f;
+    const float x1 = x0 + scale;
+    const float y1 = y0 + scale;
+    return areaElement(x0, y0) - areaElement(x0, y1) - areaElement(x1, y0) + areaElement(x1, y1);
+}
+
+void
+CubeMap::destroy() {
+    m_faces.clear();
+    m_size = 0;
+}
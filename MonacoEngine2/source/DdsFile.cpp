@@ -0,0 +1,636 @@
+#include "DdsFile.h"
+#include "HdrImage.h"
+#include "CubeMap.h"
+#include <cstring>
+
+namespace {
+    const uint32_t DDS_MAGIC = 0x20534444;  // "DDS "
+    const size_t DDS_HEADER_SIZE = 124;
+    const size_t DDS_HEADER_DX10_SIZE = 20;
+
+    // DDS_HEADER::flags
+    const uint32_t DDSD_CAPS = 0x1;
+    const uint32_t DDSD_HEIGHT = 0x2;
+    const uint32_t DDSD_WIDTH = 0x4;
+    const uint32_t DDSD_PITCH = 0x8;
+    const uint32_t DDSD_PIXELFORMAT = 0x1000;
+    const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    const uint32_t DDSD_LINEARSIZE = 0x80000;
+    const uint32_t DDSD_DEPTH = 0x800000;
+
+    // DDS_PIXELFORMAT::flags
+    const uint32_t DDPF_ALPHAPIXELS = 0x1;
+    const uint32_t DDPF_ALPHA = 0x2;
+    const uint32_t DDPF_FOURCC = 0x4;
+    const uint32_t DDPF_RGB = 0x40;
+    const uint32_t DDPF_LUMINANCE = 0x20000;
+
+    // DDS_HEADER::caps y caps2
+    const uint32_t DDSCAPS_COMPLEX = 0x8;
+    const uint32_t DDSCAPS_TEXTURE = 0x1000;
+    const uint32_t DDSCAPS_MIPMAP = 0x400000;
+    const uint32_t DDSCAPS2_CUBEMAP = 0x200;
+    const uint32_t DDSCAPS2_CUBEMAP_ALLFACES = 0xFC00;
+    const uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+    // DDS_HEADER_DXT10
+    const uint32_t DIMENSION_TEXTURE2D = 3;
+    const uint32_t DIMENSION_TEXTURE3D = 4;
+    const uint32_t MISC_TEXTURECUBE = 0x4;
+
+    // Desplazamientos dentro de DDS_HEADER (sin contar el numero magico).
+    const size_t OFFSET_FLAGS = 4;
+    const size_t OFFSET_HEIGHT = 8;
+    const size_t OFFSET_WIDTH = 12;
+    const size_t OFFSET_PITCH = 16;
+    const size_t OFFSET_DEPTH = 20;
+    const size_t OFFSET_MIPCOUNT = 24;
+    const size_t OFFSET_PF_SIZE = 72;
+    const size_t OFFSET_PF_FLAGS = 76;
+    const size_t OFFSET_PF_FOURCC = 80;
+    const size_t OFFSET_PF_BITCOUNT = 84;
+    const size_t OFFSET_PF_MASKS = 88;
+    const size_t OFFSET_CAPS = 104;
+    const size_t OFFSET_CAPS2 = 108;
+
+    // Limites de D3D11; la cabecera no es confiable y con ellos ningun calculo de tamano desborda.
+    const unsigned int MAX_DIMENSION = 16384;       // D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION
+    const unsigned int MAX_VOLUME_DIMENSION = 2048; // D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION
+    const unsigned int MAX_ARRAY_SIZE = 2048;       // D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION
+
+    constexpr uint32_t
+    makeFourCC(char a, char b, char c, char d) {
+        return static_cast<uint32_t>(static_cast<unsigned char>(a)) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(c)) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(d)) << 24);
+    }
+
+    inline uint32_t
+    readU32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    inline void
+    writeU32(unsigned char* p, uint32_t value) {
+        p[0] = static_cast<unsigned char>(value & 0xFF);
+        p[1] = static_cast<unsigned char>((value >> 8) & 0xFF);
+        p[2] = static_cast<unsigned char>((value >> 16) & 0xFF);
+        p[3] = static_cast<unsigned char>((value >> 24) & 0xFF);
+    }
+
+    /// Formato de una cabecera clasica (sin DX10) a partir de su DDS_PIXELFORMAT.
+    DdsFormat
+    legacyFormat(const unsigned char* header) {
+        const uint32_t flags = readU32(header + OFFSET_PF_FLAGS);
+        const uint32_t bits = readU32(header + OFFSET_PF_BITCOUNT);
+        const uint32_t r = readU32(header + OFFSET_PF_MASKS);
+        const uint32_t g = readU32(header + OFFSET_PF_MASKS + 4);
+        const uint32_t b = readU32(header + OFFSET_PF_MASKS + 8);
+        const uint32_t a = readU32(header + OFFSET_PF_MASKS + 12);
+
+        if (flags & DDPF_FOURCC) {
+            switch (readU32(header + OFFSET_PF_FOURCC)) {
+            case makeFourCC('D', 'X', 'T', '1'): return DdsFormat::BC1_UNORM;
+            case makeFourCC('D', 'X', 'T', '2'):
+            case makeFourCC('D', 'X', 'T', '3'): return DdsFormat::BC2_UNORM;
+            case makeFourCC('D', 'X', 'T', '4'):
+            case makeFourCC('D', 'X', 'T', '5'): return DdsFormat::BC3_UNORM;
+            case makeFourCC('A', 'T', 'I', '1'):
+            case makeFourCC('B', 'C', '4', 'U'): return DdsFormat::BC4_UNORM;
+            case makeFourCC('B', 'C', '4', 'S'): return DdsFormat::BC4_SNORM;
+            case makeFourCC('A', 'T', 'I', '2'):
+            case makeFourCC('B', 'C', '5', 'U'): return DdsFormat::BC5_UNORM;
+            case makeFourCC('B', 'C', '5', 'S'): return DdsFormat::BC5_SNORM;
+            // Codigos D3DFMT guardados como FourCC.
+            case 36: return DdsFormat::R16G16B16A16_UNORM;
+            case 111: return DdsFormat::R16_FLOAT;
+            case 112: return DdsFormat::R16G16_FLOAT;
+            case 113: return DdsFormat::R16G16B16A16_FLOAT;
+            case 114: return DdsFormat::R32_FLOAT;
+            case 115: return DdsFormat::R32G32_FLOAT;
+            case 116: return DdsFormat::R32G32B32A32_FLOAT;
+            default: return DdsFormat::Unknown;
+            }
+        }
+        if (flags & DDPF_RGB) {
+            if (bits == 32) {
+                if (r == 0x000000FF && g == 0x0000FF00 && b == 0x00FF0000) {
+                    return DdsFormat::R8G8B8A8_UNORM;
+                }
+                if (r == 0x00FF0000 && g == 0x0000FF00 && b == 0x000000FF) {
+                    return ((flags & DDPF_ALPHAPIXELS) && a) ? DdsFormat::B8G8R8A8_UNORM : DdsFormat::B8G8R8X8_UNORM;
+                }
+                if (r == 0x3FF00000 && g == 0x000FFC00 && b == 0x000003FF) {
+                    // D3DX escribia R10G10B10A2 con las mascaras invertidas.
+                    return DdsFormat::R10G10B10A2_UNORM;
+                }
+                if (r == 0x0000FFFF && g == 0xFFFF0000) {
+                    return DdsFormat::R16G16_UNORM;
+                }
+                if (r == 0xFFFFFFFF) {
+                    return DdsFormat::R32_FLOAT;
+                }
+            }
+            else if (bits == 16) {
+                if (r == 0xF800 && g == 0x07E0 && b == 0x001F) {
+                    return DdsFormat::B5G6R5_UNORM;
+                }
+                if (r == 0x7C00 && g == 0x03E0 && b == 0x001F && a == 0x8000) {
+                    return DdsFormat::B5G5R5A1_UNORM;
+                }
+            }
+            return DdsFormat::Unknown;
+        }
+        if (flags & DDPF_LUMINANCE) {
+            if (bits == 8 && r == 0xFF) {
+                return DdsFormat::R8_UNORM;
+            }
+            if (bits == 16 && r == 0xFFFF) {
+                return DdsFormat::R16_UNORM;
+            }
+            if (bits == 16 && r == 0x00FF && a == 0xFF00) {
+                return DdsFormat::R8G8_UNORM;
+            }
+            return DdsFormat::Unknown;
+        }
+        if ((flags & DDPF_ALPHA) && bits == 8) {
+            return DdsFormat::A8_UNORM;
+        }
+        return DdsFormat::Unknown;
+    }
+
+    bool
+    isCompressed(DdsFormat format) {
+        unsigned int bytes = 0;
+        bool compressed = false;
+        return DdsFile::getFormatInfo(format, bytes, compressed) && compressed;
+    }
+}
+
+bool
+DdsFile::getFormatInfo(DdsFormat format, unsigned int& bytes, bool& compressed) {
+    compressed = false;
+    switch (format) {
+    case DdsFormat::R32G32B32A32_FLOAT:
+        bytes = 16;
+        return true;
+    case DdsFormat::R32G32B32_FLOAT:
+        bytes = 12;
+        return true;
+    case DdsFormat::R16G16B16A16_FLOAT:
+    case DdsFormat::R16G16B16A16_UNORM:
+    case DdsFormat::R32G32_FLOAT:
+        bytes = 8;
+        return true;
+    case DdsFormat::R10G10B10A2_UNORM:
+    case DdsFormat::R11G11B10_FLOAT:
+    case DdsFormat::R8G8B8A8_UNORM:
+    case DdsFormat::R8G8B8A8_UNORM_SRGB:
+    case DdsFormat::R16G16_FLOAT:
+    case DdsFormat::R16G16_UNORM:
+    case DdsFormat::R32_FLOAT:
+    case DdsFormat::B8G8R8A8_UNORM:
+    case DdsFormat::B8G8R8X8_UNORM:
+    case DdsFormat::B8G8R8A8_UNORM_SRGB:
+    case DdsFormat::B8G8R8X8_UNORM_SRGB:
+        bytes = 4;
+        return true;
+    case DdsFormat::R8G8_UNORM:
+    case DdsFormat::R16_FLOAT:
+    case DdsFormat::R16_UNORM:
+    case DdsFormat::B5G6R5_UNORM:
+    case DdsFormat::B5G5R5A1_UNORM:
+        bytes = 2;
+        return true;
+    case DdsFormat::R8_UNORM:
+    case DdsFormat::A8_UNORM:
+        bytes = 1;
+        return true;
+    case DdsFormat::BC1_UNORM:
+    case DdsFormat::BC1_UNORM_SRGB:
+    case DdsFormat::BC4_UNORM:
+    case DdsFormat::BC4_SNORM:
+        bytes = 8;
+        compressed = true;
+        return true;
+    case DdsFormat::BC2_UNORM:
+    case DdsFormat::BC2_UNORM_SRGB:
+    case DdsFormat::BC3_UNORM:
+    case DdsFormat::BC3_UNORM_SRGB:
+    case DdsFormat::BC5_UNORM:
+    case DdsFormat::BC5_SNORM:
+    case DdsFormat::BC6H_UF16:
+    case DdsFormat::BC6H_SF16:
+    case DdsFormat::BC7_UNORM:
+    case DdsFormat::BC7_UNORM_SRGB:
+        bytes = 16;
+        compressed = true;
+        return true;
+    default:
+        bytes = 0;
+        return false;
+    }
+}
+
+DdsFormat
+DdsFile::toDdsFormat(BlockFormat format, bool srgb) {
+    switch (format) {
+    case BlockFormat::BC1: return srgb ? DdsFormat::BC1_UNORM_SRGB : DdsFormat::BC1_UNORM;
+    case BlockFormat::BC3: return srgb ? DdsFormat::BC3_UNORM_SRGB : DdsFormat::BC3_UNORM;
+    case BlockFormat::BC4: return DdsFormat::BC4_UNORM;
+    case BlockFormat::BC5: return DdsFormat::BC5_UNORM;
+    case BlockFormat::BC7: return srgb ? DdsFormat::BC7_UNORM_SRGB : DdsFormat::BC7_UNORM;
+    case BlockFormat::BC6H: return DdsFormat::BC6H_UF16;
+    }
+    return DdsFormat::Unknown;
+}
+
+DdsFormat
+DdsFile::withColorSpace(DdsFormat format, ColorSpace space) {
+    static const DdsFormat PAIRS[][2] = {
+        { DdsFormat::R8G8B8A8_UNORM, DdsFormat::R8G8B8A8_UNORM_SRGB },
+        { DdsFormat::B8G8R8A8_UNORM, DdsFormat::B8G8R8A8_UNORM_SRGB },
+        { DdsFormat::B8G8R8X8_UNORM, DdsFormat::B8G8R8X8_UNORM_SRGB },
+        { DdsFormat::BC1_UNORM, DdsFormat::BC1_UNORM_SRGB },
+        { DdsFormat::BC2_UNORM, DdsFormat::BC2_UNORM_SRGB },
+        { DdsFormat::BC3_UNORM, DdsFormat::BC3_UNORM_SRGB },
+        { DdsFormat::BC7_UNORM, DdsFormat::BC7_UNORM_SRGB },
+    };
+    for (const DdsFormat* pair : PAIRS) {
+        if (pair[0] == format || pair[1] == format) {
+            return pair[space == ColorSpace::Srgb ? 1 : 0];
+        }
+    }
+    return format;
+}
+
+bool
+DdsFile::isSrgb(DdsFormat format) {
+    return withColorSpace(format, ColorSpace::Linear) != format;
+}
+
+HRESULT
+DdsFile::computeLayout(const DdsDesc& desc, size_t dataOffset, std::vector<DdsSurface>& surfaces,
+                       size_t& totalSize, size_t maxSize) {
+    surfaces.clear();
+    totalSize = dataOffset;
+    if (desc.width == 0 || desc.height == 0 || desc.depth == 0 || desc.arraySize == 0 || desc.mipLevels == 0) {
+        return E_INVALIDARG;
+    }
+    const unsigned int maxDimension = desc.depth > 1 ? MAX_VOLUME_DIMENSION : MAX_DIMENSION;
+    if (desc.width > maxDimension || desc.height > maxDimension || desc.depth > MAX_VOLUME_DIMENSION ||
+        desc.arraySize > MAX_ARRAY_SIZE) {
+        return E_INVALIDARG;
+    }
+    if (desc.cubemap && (desc.width != desc.height || desc.depth != 1)) {
+        return E_INVALIDARG;
+    }
+    unsigned int largest = std::max(desc.width, std::max(desc.height, desc.depth));
+    unsigned int fullLevels = 1;
+    while (largest > 1) {
+        largest >>= 1;
+        ++fullLevels;
+    }
+    if (desc.mipLevels > fullLevels) {
+        return E_INVALIDARG;
+    }
+
+    unsigned int bytes = 0;
+    bool compressed = false;
+    if (!getFormatInfo(desc.format, bytes, compressed)) {
+        return E_NOTIMPL;
+    }
+
+    // En el archivo cada elemento (o cara) guarda todos sus niveles seguidos, asi que todos los
+    // elementos miden lo mismo. Con los limites de arriba el total cabe en 64 bits (< 2^47); se
+    // compara con @p maxSize antes de reservar nada.
+    std::vector<DdsSurface> levels(desc.mipLevels);
+    uint64_t itemSize = 0;
+    unsigned int width = desc.width;
+    unsigned int height = desc.height;
+    unsigned int depth = desc.depth;
+    for (DdsSurface& surface : levels) {
+        surface.width = width;
+        surface.height = height;
+        surface.depth = depth;
+        if (compressed) {
+            surface.rowPitch = std::max(1u, (width + 3) / 4) * bytes;
+            surface.rowCount = std::max(1u, (height + 3) / 4);
+        }
+        else {
+            surface.rowPitch = width * bytes;
+            surface.rowCount = height;
+        }
+        surface.offset = static_cast<size_t>(itemSize);
+        const uint64_t surfaceSize = static_cast<uint64_t>(surface.rowPitch) * surface.rowCount * depth;
+        surface.size = static_cast<size_t>(surfaceSize);
+        itemSize += surfaceSize;
+
+        width = std::max(1u, width / 2);
+        height = std::max(1u, height / 2);
+        depth = std::max(1u, depth / 2);
+    }
+    const uint64_t end = dataOffset + itemSize * desc.getItemCount();
+    if (end > maxSize) {
+        return E_FAIL;
+    }
+
+    surfaces.reserve(desc.getSubresourceCount());
+    for (unsigned int item = 0; item < desc.getItemCount(); ++item) {
+        const size_t itemOffset = dataOffset + static_cast<size_t>(itemSize) * item;
+        for (const DdsSurface& level : levels) {
+            surfaces.push_back(level);
+            surfaces.back().offset += itemOffset;
+        }
+    }
+    totalSize = static_cast<size_t>(end);
+    return S_OK;
+}
+
+HRESULT
+DdsFile::loadFromFile(const std::string& fileName) {
+    destroy();
+    HRESULT hr = m_file.init(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    hr = loadFromMemory(m_file.getData(), m_file.getSize());
+    if (FAILED(hr)) {
+        ERROR("DdsFile", "loadFromFile", ("Invalid or unsupported DDS file: " + fileName).c_str());
+        m_file.destroy();
+    }
+    return hr;
+}
+
+HRESULT
+DdsFile::loadFromMemory(const unsigned char* data, size_t size) {
+    m_surfaces.clear();
+    m_desc = DdsDesc();
+    m_data = nullptr;
+    m_size = 0;
+
+    if (!data || size < 4 + DDS_HEADER_SIZE || readU32(data) != DDS_MAGIC) {
+        ERROR("DdsFile", "loadFromMemory", "Missing DDS magic number or header.");
+        return E_FAIL;
+    }
+    const unsigned char* header = data + 4;
+    if (readU32(header) != DDS_HEADER_SIZE || readU32(header + OFFSET_PF_SIZE) != 32) {
+        ERROR("DdsFile", "loadFromMemory", "Invalid DDS header size.");
+        return E_FAIL;
+    }
+
+    DdsDesc desc;
+    desc.width = readU32(header + OFFSET_WIDTH);
+    desc.height = readU32(header + OFFSET_HEIGHT);
+    desc.mipLevels = std::max(1u, readU32(header + OFFSET_MIPCOUNT));
+    const uint32_t flags = readU32(header + OFFSET_FLAGS);
+    const uint32_t caps2 = readU32(header + OFFSET_CAPS2);
+    size_t dataOffset = 4 + DDS_HEADER_SIZE;
+
+    const bool dx10 = (readU32(header + OFFSET_PF_FLAGS) & DDPF_FOURCC) &&
+                      readU32(header + OFFSET_PF_FOURCC) == makeFourCC('D', 'X', '1', '0');
+    if (dx10) {
+        if (size < dataOffset + DDS_HEADER_DX10_SIZE) {
+            ERROR("DdsFile", "loadFromMemory", "Truncated DX10 header.");
+            return E_FAIL;
+        }
+        const unsigned char* ext = data + dataOffset;
+        dataOffset += DDS_HEADER_DX10_SIZE;
+        desc.format = static_cast<DdsFormat>(readU32(ext));
+        const uint32_t dimension = readU32(ext + 4);
+        desc.cubemap = (readU32(ext + 8) & MISC_TEXTURECUBE) != 0;
+        desc.arraySize = readU32(ext + 12);
+        if (dimension == DIMENSION_TEXTURE3D) {
+            desc.depth = std::max(1u, readU32(header + OFFSET_DEPTH));
+            if (desc.arraySize != 1 || desc.cubemap) {
+                ERROR("DdsFile", "loadFromMemory", "Volume textures cannot be arrays or cubemaps.");
+                return E_FAIL;
+            }
+        }
+        else if (dimension != DIMENSION_TEXTURE2D) {
+            ERROR("DdsFile", "loadFromMemory", "Only 2D and volume textures are supported.");
+            return E_NOTIMPL;
+        }
+    }
+    else {
+        desc.format = legacyFormat(header);
+        if (caps2 & DDSCAPS2_CUBEMAP) {
+            // Las cabeceras clasicas permiten cubos parciales; D3D11 no.
+            if ((caps2 & DDSCAPS2_CUBEMAP_ALLFACES) != DDSCAPS2_CUBEMAP_ALLFACES) {
+                ERROR("DdsFile", "loadFromMemory", "Partial cubemaps are not supported.");
+                return E_NOTIMPL;
+            }
+            desc.cubemap = true;
+        }
+        else if ((caps2 & DDSCAPS2_VOLUME) && (flags & DDSD_DEPTH)) {
+            desc.depth = std::max(1u, readU32(header + OFFSET_DEPTH));
+        }
+    }
+
+    unsigned int bytes = 0;
+    bool compressed = false;
+    if (!getFormatInfo(desc.format, bytes, compressed)) {
+        ERROR("DdsFile", "loadFromMemory", "Unsupported DDS pixel format.");
+        return E_NOTIMPL;
+    }
+
+    size_t totalSize = 0;
+    HRESULT hr = computeLayout(desc, dataOffset, m_surfaces, totalSize, size);
+    if (FAILED(hr)) {
+        ERROR("DdsFile", "loadFromMemory",
+            (hr == E_FAIL ? "DDS file is truncated." : "Invalid DDS dimensions, array size or mip count."));
+        return hr;
+    }
+
+    m_desc = desc;
+    m_data = data;
+    m_size = size;
+    return S_OK;
+}
+
+void
+DdsFile::destroy() {
+    m_surfaces.clear();
+    m_desc = DdsDesc();
+    m_data = nullptr;
+    m_size = 0;
+    m_file.destroy();
+}
+
+HRESULT
+DdsFile::saveToFile(const std::string& fileName, const DdsDesc& desc, const std::vector<DdsSubresourceData>& surfaces) {
+    std::vector<DdsSurface> layout;
+    size_t totalSize = 0;
+    const size_t dataOffset = 4 + DDS_HEADER_SIZE + DDS_HEADER_DX10_SIZE;
+    if (FAILED(computeLayout(desc, dataOffset, layout, totalSize)) || surfaces.size() != layout.size()) {
+        ERROR("DdsFile", "saveToFile", "Invalid description or subresource count.");
+        return E_INVALIDARG;
+    }
+    for (const DdsSubresourceData& surface : surfaces) {
+        if (!surface.data) {
+            ERROR("DdsFile", "saveToFile", "Subresource data is null.");
+            return E_INVALIDARG;
+        }
+    }
+
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file.is_open()) {
+        ERROR("DdsFile", "saveToFile", ("Could not open file: " + fileName).c_str());
+        return E_FAIL;
+    }
+
+    const bool compressed = isCompressed(desc.format);
+    unsigned char header[dataOffset] = {};
+    writeU32(header, DDS_MAGIC);
+    unsigned char* h = header + 4;
+    uint32_t flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT;
+    flags |= compressed ? DDSD_LINEARSIZE : DDSD_PITCH;
+    flags |= desc.mipLevels > 1 ? DDSD_MIPMAPCOUNT : 0;
+    flags |= desc.depth > 1 ? DDSD_DEPTH : 0;
+    writeU32(h, DDS_HEADER_SIZE);
+    writeU32(h + OFFSET_FLAGS, flags);
+    writeU32(h + OFFSET_HEIGHT, desc.height);
+    writeU32(h + OFFSET_WIDTH, desc.width);
+    writeU32(h + OFFSET_PITCH, compressed ? static_cast<uint32_t>(layout[0].size) : layout[0].rowPitch);
+    writeU32(h + OFFSET_DEPTH, desc.depth > 1 ? desc.depth : 0);
+    writeU32(h + OFFSET_MIPCOUNT, desc.mipLevels);
+    writeU32(h + OFFSET_PF_SIZE, 32);
+    writeU32(h + OFFSET_PF_FLAGS, DDPF_FOURCC);
+    writeU32(h + OFFSET_PF_FOURCC, makeFourCC('D', 'X', '1', '0'));
+    uint32_t caps = DDSCAPS_TEXTURE;
+    if (desc.mipLevels > 1) {
+        caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+    }
+    if (desc.cubemap || desc.arraySize > 1 || desc.depth > 1) {
+        caps |= DDSCAPS_COMPLEX;
+    }
+    writeU32(h + OFFSET_CAPS, caps);
+    writeU32(h + OFFSET_CAPS2, desc.cubemap ? DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_ALLFACES
+                                            : (desc.depth > 1 ? DDSCAPS2_VOLUME : 0));
+
+    unsigned char* ext = h + DDS_HEADER_SIZE;
+    writeU32(ext, static_cast<uint32_t>(desc.format));
+    writeU32(ext + 4, desc.depth > 1 ? DIMENSION_TEXTURE3D : DIMENSION_TEXTURE2D);
+    writeU32(ext + 8, desc.cubemap ? MISC_TEXTURECUBE : 0);
+    writeU32(ext + 12, desc.arraySize);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    // Filas sin relleno, en el orden del archivo.
+    for (size_t i = 0; i < layout.size(); ++i) {
+        const DdsSurface& surface = layout[i];
+        const unsigned char* src = static_cast<const unsigned char*>(surfaces[i].data);
+        const unsigned int srcPitch = surfaces[i].rowPitch ? surfaces[i].rowPitch : surface.rowPitch;
+        if (srcPitch == surface.rowPitch) {
+            file.write(reinterpret_cast<const char*>(src), surface.size);
+            continue;
+        }
+        const unsigned int rows = surface.rowCount * surface.depth;
+        for (unsigned int row = 0; row < rows; ++row) {
+            file.write(reinterpret_cast<const char*>(src + static_cast<size_t>(row) * srcPitch), surface.rowPitch);
+        }
+    }
+    return file.good() ? S_OK : E_FAIL;
+}
+
+HRESULT
+DdsFile::saveToFile(const std::string& fileName, const std::vector<HdrImage>& levels, DdsFormat format) {
+    if (levels.empty() || levels[0].empty()) {
+        ERROR("DdsFile", "saveToFile", "No HDR levels.");
+        return E_INVALIDARG;
+    }
+    DdsDesc desc;
+    desc.width = levels[0].m_width;
+    desc.height = levels[0].m_height;
+    desc.mipLevels = static_cast<unsigned int>(levels.size());
+    desc.format = format;
+
+    unsigned int bytes = 0;
+    bool compressed = false;
+    getFormatInfo(format, bytes, compressed);
+    std::vector<std::vector<unsigned char>> packed(levels.size());
+    std::vector<DdsSubresourceData> surfaces(levels.size());
+    for (size_t level = 0; level < levels.size(); ++level) {
+        HRESULT hr = levels[level].pack(format, packed[level]);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        surfaces[level].data = packed[level].data();
+        surfaces[level].rowPitch = levels[level].m_width * bytes;
+    }
+    return saveToFile(fileName, desc, surfaces);
+}
+
+HRESULT
+DdsFile::saveToFile(const std::string& fileName, const std::vector<CubeMap>& levels, DdsFormat format) {
+    if (levels.empty() || levels[0].empty()) {
+        ERROR("DdsFile", "saveToFile", "No cube map levels.");
+        return E_INVALIDARG;
+    }
+    DdsDesc desc;
+    desc.width = levels[0].m_size;
+    desc.height = levels[0].m_size;
+    desc.mipLevels = static_cast<unsigned int>(levels.size());
+    desc.cubemap = true;
+    desc.format = format;
+
+    // Orden de D3D11: todos los niveles de +X, luego los de -X...
+    unsigned int bytes = 0;
+    bool compressed = false;
+    getFormatInfo(format, bytes, compressed);
+    std::vector<std::vector<unsigned char>> packed(desc.getSubresourceCount());
+    std::vector<DdsSubresourceData> surfaces(desc.getSubresourceCount());
+    for (unsigned int face = 0; face < CubeMap::FACE_COUNT; ++face) {
+        for (unsigned int level = 0; level < desc.mipLevels; ++level) {
+            const unsigned int index = face * desc.mipLevels + level;
+            HRESULT hr = levels[level].m_faces[face].pack(format, packed[index]);
+            if (FAILED(hr)) {
+                return hr;
+            }
+            surfaces[index].data = packed[index].data();
+            surfaces[index].rowPitch = levels[level].m_size * bytes;
+        }
+    }
+    return saveToFile(fileName, desc, surfaces);
+}
+
+HRESULT
+DdsFile::saveToFile(const std::string& fileName, const std::vector<BlockImage>& levels, bool srgb) {
+    if (levels.empty() || levels[0].empty()) {
+        ERROR("DdsFile", "saveToFile", "No compressed levels.");
+        return E_INVALIDARG;
+    }
+    DdsDesc desc;
+    desc.width = levels[0].m_width;
+    desc.height = levels[0].m_height;
+    desc.mipLevels = static_cast<unsigned int>(levels.size());
+    desc.format = toDdsFormat(levels[0].m_format, srgb);
+
+    std::vector<DdsSubresourceData> surfaces(levels.size());
+    for (size_t level = 0; level < levels.size(); ++level) {
+        surfaces[level].data = levels[level].m_data.data();
+        surfaces[level].rowPitch = levels[level].getRowPitch();
+    }
+    return saveToFile(fileName, desc, surfaces);
+}
+
+HRESULT
+DdsFile::saveToFile(const std::string& fileName, const MipChain& mips, bool srgb) {
+    if (mips.empty()) {
+        ERROR("DdsFile", "saveToFile", "Mip chain is empty.");
+        return E_INVALIDARG;
+    }
+    DdsDesc desc;
+    desc.width = mips.getLevel(0).m_width;
+    desc.height = mips.getLevel(0).m_height;
+    desc.mipLevels = mips.getLevelCount();
+    desc.format = srgb ? DdsFormat::R8G8B8A8_UNORM_SRGB : DdsFormat::R8G8B8A8_UNORM;
+
+    std::vector<DdsSubresourceData> surfaces(mips.getLevelCount());
+    for (unsigned int level = 0; level < mips.getLevelCount(); ++level) {
+        surfaces[level].data = mips.getLevel(level).m_pixels.data();
+        surfaces[level].rowPitch = mips.getLevel(level).getPitch();
+    }
+    return saveToFile(fileName, desc, surfaces);
+}
@@ -0,0 +1,156 @@
+#include "ECS/Archetype.h"
+#include <cstdlib>
+#include <mutex>
+
+const unsigned int Archetype::CHUNK_SIZE;
+const unsigned int Archetype::CHUNK_ALIGNMENT;
+const unsigned int Archetype::INVALID_SLOT;
+
+namespace {
+    /// Alineacion minima de cada arreglo dentro del bloque (un registro SSE).
+    const unsigned int ARRAY_ALIGNMENT = 16;
+
+    ComponentInfo g_componentInfos[MAX_COMPONENT_TYPES];
+    unsigned int g_componentCount = 0;
+    std::mutex g_registryMutex;
+
+    inline unsigned int
+    alignUp(unsigned int value, unsigned int alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+unsigned int
+ComponentRegistry::registerType(const ComponentInfo& info) {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    if (g_componentCount >= MAX_COMPONENT_TYPES) {
+        // Un bit por tipo en ComponentMask: no hay forma de seguir sin corromper las mascaras.
+        ERROR("ComponentRegistry", "registerType", "Too many component types");
+        std::abort();
+    }
+    g_componentInfos[g_componentCount] = info;
+    return g_componentCount++;
+}
+
+const ComponentInfo&
+ComponentRegistry::getInfo(unsigned int id) {
+    return g_componentInfos[id];
+}
+
+unsigned int
+ComponentRegistry::getTypeCount() {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    return g_componentCount;
+}
+
+Archetype::Archetype(ComponentMask mask) : m_mask(mask) {
+    for (unsigned int i = 0; i < MAX_COMPONENT_TYPES; ++i) {
+        m_slotOfType[i] = INVALID_SLOT;
+    }
+
+    unsigned int rowBytes = static_cast<unsigned int>(sizeof(Entity));
+    for (unsigned int id = 0; id < MAX_COMPONENT_TYPES; ++id) {
+        if ((mask & (ComponentMask(1) << id)) == 0) {
+            continue;
+        }
+        const ComponentInfo& info = ComponentRegistry::getInfo(id);
+        m_slotOfType[id] = static_cast<unsigned int>(m_types.size());
+        m_types.push_back(id);
+        m_sizes.push_back(info.size);
+        m_infos.push_back(info);
+        m_trivial = m_trivial && info.trivial;
+        rowBytes += info.size;
+    }
+    m_offsets.resize(m_types.size());
+
+    // Tantas filas como quepan en CHUNK_SIZE contando el relleno de alineacion.
+    m_capacity = std::max(CHUNK_SIZE / rowBytes, 1u);
+    while (m_capacity > 1 && computeLayout(m_capacity) > CHUNK_SIZE) {
+        --m_capacity;
+    }
+    m_chunkBytes = std::max(computeLayout(m_capacity), CHUNK_SIZE);
+}
+
+Archetype::~Archetype() {
+    clear();
+}
+
+unsigned int
+Archetype::pushRow(Entity entity) {
+    unsigned int row = m_rowCount;
+    if (row / m_capacity == m_chunks.size()) {
+        m_chunks.push_back(static_cast<unsigned char*>(
+            ::operator new(m_chunkBytes, std::align_val_t(CHUNK_ALIGNMENT))));
+    }
+    ++m_rowCount;
+    getEntity(row) = entity;
+    return row;
+}
+
+Entity
+Archetype::removeRow(unsigned int row) {
+    const unsigned int last = m_rowCount - 1;
+    Entity moved;
+    if (row != last) {
+        for (unsigned int slot = 0; slot < m_types.size(); ++slot) {
+            const ComponentInfo& info = m_infos[slot];
+            void* dst = getComponent(slot, row);
+            void* src = getComponent(slot, last);
+            if (info.trivial) {
+                memcpy(dst, src, info.size);
+            }
+            else {
+                info.destruct(dst);
+                info.moveConstruct(dst, src);
+            }
+        }
+        moved = getEntity(last);
+        getEntity(row) = moved;
+    }
+    destructRow(last);
+    --m_rowCount;
+
+    // Se conserva un bloque vacio de reserva para no liberar y reservar en cada alta y baja.
+    while (m_chunks.size() > getChunkCount() + 1) {
+        ::operator delete(m_chunks.back(), std::align_val_t(CHUNK_ALIGNMENT));
+        m_chunks.pop_back();
+    }
+    return moved;
+}
+
+void
+Archetype::clear() {
+    if (!m_trivial) {
+        for (unsigned int row = 0; row < m_rowCount; ++row) {
+            destructRow(row);
+        }
+    }
+    m_rowCount = 0;
+    for (unsigned char* chunk : m_chunks) {
+        ::operator delete(chunk, std::align_val_t(CHUNK_ALIGNMENT));
+    }
+    m_chunks.clear();
+}
+
+unsigned int
+Archetype::computeLayout(unsigned int capacity) {
+    unsigned int offset = static_cast<unsigned int>(sizeof(Entity)) * capacity;
+    for (unsigned int slot = 0; slot < m_types.size(); ++slot) {
+        offset = alignUp(offset, std::max(m_infos[slot].alignment, ARRAY_ALIGNMENT));
+        m_offsets[slot] = offset;
+        offset += m_sizes[slot] * capacity;
+    }
+    return offset;
+}
+
+void
+Archetype::destructRow(unsigned int row) {
+    if (m_trivial) {
+        return;
+    }
+    for (unsigned int slot = 0; slot < m_types.size(); ++slot) {
+        if (!m_infos[slot].trivial) {
+            m_infos[slot].destruct(getComponent(slot, row));
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include "ECS/World.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+HRESULT
+World::init(JobSystem* jobs) {
+    destroy();
+    m_jobs = jobs;
+    return S_OK;
+}
+
+void
+World::destroy() {
+    m_systems.clear();
+    m_archetypeMap.clear();
+    m_archetypes.clear();
+    m_records.clear();
+    m_freeIndices.clear();
+    m_entityCount = 0;
+}
+
+Entity
+World::createEntity() {
+    return createEntity<>();
+}
+
+void
+World::destroyEntity(Entity entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    EntityRecord& record = m_records[entity.index];
+    fixMovedRow(record.archetype->removeRow(record.row), record.row);
+    record.archetype = nullptr;
+    ++record.generation;
+    m_freeIndices.push_back(entity.index);
+    --m_entityCount;
+}
+
+void
+World::addSystem(std::unique_ptr<System> system) {
+    m_systems.push_back(std::move(system));
+}
+
+void
+World::update(float deltaTime) {
+    Profiler& profiler = Profiler::instance();
+    for (const std::unique_ptr<System>& system : m_systems) {
+        double start = Profiler::now();
+        system->update(*this, deltaTime);
+        profiler.addSample(system->getName(), Profiler::now() - start);
+    }
+}
+
+Archetype*
+World::findOrCreateArchetype(ComponentMask mask) {
+    auto it = m_archetypeMap.find(mask);
+    if (it != m_archetypeMap.end()) {
+        return it->second;
+    }
+    m_archetypes.push_back(std::unique_ptr<Archetype>(new Archetype(mask)));
+    Archetype* archetype = m_archetypes.back().get();
+    m_archetypeMap.emplace(mask, archetype);
+    return archetype;
+}
+
+Entity
+World::allocateEntity() {
+    Entity entity;
+    if (!m_freeIndices.empty()) {
+        entity.index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    }
+    else {
+        entity.index = static_cast<unsigned int>(m_records.size());
+        m_records.push_back(EntityRecord());
+    }
+    entity.generation = m_records[entity.index].generation;
+    ++m_entityCount;
+    return entity;
+}
+
+void
+World::moveEntity(Entity entity, ComponentMask mask) {
+    EntityRecord& record = m_records[entity.index];
+    Archetype* from = record.archetype;
+    Archetype* to = findOrCreateArchetype(mask);
+    unsigned int row = to->pushRow(entity);
+
+    // Los componentes comunes se mueven; removeRow() destruye los que quedan en el origen.
+    const std::vector<unsigned int>& types = from->getTypes();
+    for (unsigned int slot = 0; slot < types.size(); ++slot) {
+        unsigned int toSlot = to->getSlot(types[slot]);
+        if (toSlot != Archetype::INVALID_SLOT) {
+            ComponentRegistry::getInfo(types[slot]).moveConstruct(to->getComponent(toSlot, row),
+                                                                  from->getComponent(slot, record.row));
+        }
+    }
+    fixMovedRow(from->removeRow(record.row), record.row);
+    record.archetype = to;
+    record.row = row;
+}
+
+void
+World::fixMovedRow(Entity moved, unsigned int row) {
+    if (moved.isValid()) {
+        m_records[moved.index].row = row;
+    }
+}
+
+void
+World::collectChunks(ComponentMask mask, std::vector<ChunkRef>& chunks) {
+    chunks.clear();
+    for (const std::unique_ptr<Archetype>& archetype : m_archetypes) {
+        if ((archetype->getMask() & mask) != mask) {
+            continue;
+        }
+        const unsigned int count = archetype->getChunkCount();
+        for (unsigned int chunk = 0; chunk < count; ++chunk) {
+            ChunkRef ref = { archetype.get(), chunk };
+            chunks.push_back(ref);
+        }
+    }
+}
+
+void
+World::parallelForChunks(const std::vector<ChunkRef>& chunks,
+                         const std::function<void(const ChunkRef&)>& func) {
+    const unsigned int count = static_cast<unsigned int>(chunks.size());
+    if (!m_jobs) {
+        for (const ChunkRef& ref : chunks) {
+            func(ref);
+        }
+        return;
+    }
+    // Un bloque ya es una unidad de trabajo de varios cientos de entidades.
+    m_jobs->parallelFor(count, 1, [&](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int i = begin; i < end; ++i) {
+            func(chunks[i]);
+        }
+    });
+}
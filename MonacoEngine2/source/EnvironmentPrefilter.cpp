@@ -0,0 +1,285 @@
+#include "EnvironmentPrefilter.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <cmath>
+
+namespace {
+    const float PI = 3.14159265358979f;
+
+    /// Direccion de muestreo en el espacio de la normal (z = N) con su peso (N.L) y el mip de origen.
+    struct GgxSample {
+        float l[3];
+        float weight;
+        float lod;
+    };
+
+    /// Inverso radical en base 2 (segunda coordenada de Hammersley).
+    inline float radicalInverse(uint32_t bits) {
+        bits = (bits << 16u) | (bits >> 16u);
+        bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+        bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+        bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+        bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+        return static_cast<float>(bits) * 2.3283064365386963e-10f;
+    }
+
+    /**
+     * Muestras de un nivel: con rugosidad 0 solo la reflexion; si no, @p count muestras de GGX
+     * con N = V. @p baseLod es el mip de origen que corresponde al tamano de salida: ninguna
+     * muestra lee uno mas detallado.
+     */
+    std::vector<GgxSample> buildSamples(float roughness, unsigned int count, unsigned int sourceSize, float baseLod) {
+        std::vector<GgxSample> samples;
+        if (roughness <= 0.0f) {
+            samples.push_back({ { 0.0f, 0.0f, 1.0f }, 1.0f, baseLod });
+            return samples;
+        }
+        const float alpha = roughness * roughness;
+        const float alpha2 = alpha * alpha;
+        const float texelSolidAngle = 4.0f * PI / (6.0f * sourceSize * sourceSize);
+        samples.reserve(count);
+        for (unsigned int i = 0; i < count; ++i) {
+            const float phi = 2.0f * PI * (static_cast<float>(i) + 0.5f) / count;
+            const float xi = radicalInverse(i);
+            const float cosTheta = std::sqrt((1.0f - xi) / (1.0f + (alpha2 - 1.0f) * xi));
+            const float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+            // L = reflejo de V = N sobre H.
+            GgxSample sample;
+            sample.l[0] = 2.0f * cosTheta * sinTheta * std::cos(phi);
+            sample.l[1] = 2.0f * cosTheta * sinTheta * std::sin(phi);
+            sample.l[2] = 2.0f * cosTheta * cosTheta - 1.0f;
+            if (sample.l[2] <= 0.0f) {
+                continue;
+            }
+            sample.weight = sample.l[2];
+            // pdf(L) = D(H) * N.H / (4 V.H) = D(H) / 4 con N = V.
+            const float d = cosTheta * cosTheta * (alpha2 - 1.0f) + 1.0f;
+            const float pdf = alpha2 / (PI * d * d) * 0.25f;
+            const float sampleSolidAngle = 1.0f / (count * pdf + 1.0e-6f);
+            sample.lod = std::max(baseLod, 0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f);
+            samples.push_back(sample);
+        }
+        return samples;
+    }
+
+    /// Muestra trilineal de la cadena @p source en @p lod.
+    void sampleLod(const std::vector<CubeMap>& source, const float* dir, float lod, float* rgb) {
+        lod = std::min(std::max(lod, 0.0f), static_cast<float>(source.size() - 1));
+        const unsigned int level = static_cast<unsigned int>(lod);
+        const float t = lod - level;
+        source[level].sample(dir, rgb);
+        if (t > 0.0f && level + 1 < source.size()) {
+            float next[3];
+            source[level + 1].sample(dir, next);
+            for (int c = 0; c < 3; ++c) {
+                rgb[c] += (next[c] - rgb[c]) * t;
+            }
+        }
+    }
+
+    /// Reparte @p rows(begin, end) en @p jobs si hay.
+    template<class Rows>
+    void forRows(unsigned int count, unsigned int grain, JobSystem* jobs, const Rows& rows) {
+        if (jobs) {
+            jobs->parallelFor(count, grain, [&](unsigned int begin, unsigned int end, unsigned int) { rows(begin, end); });
+        }
+        else {
+            rows(0, count);
+        }
+    }
+}
+
+void
+SH9::basis(const float* dir, float* values) {
+    const float x = dir[0];
+    const float y = dir[1];
+    const float z = dir[2];
+    values[0] = 0.282095f;
+    values[1] = 0.488603f * y;
+    values[2] = 0.488603f * z;
+    values[3] = 0.488603f * x;
+    values[4] = 1.092548f * x * y;
+    values[5] = 1.092548f * y * z;
+    values[6] = 0.315392f * (3.0f * z * z - 1.0f);
+    values[7] = 1.092548f * x * z;
+    values[8] = 0.546274f * (x * x - y * y);
+}
+
+void
+SH9::evaluate(const float* dir, float* rgb) const {
+    float values[9];
+    basis(dir, values);
+    for (int c = 0; c < 3; ++c) {
+        rgb[c] = 0.0f;
+        for (int i = 0; i < 9; ++i) {
+            rgb[c] += coefficients[i][c] * values[i];
+        }
+    }
+}
+
+void
+SH9::irradiance(const float* normal, float* rgb) const {
+    // Coseno recortado en SH: A0 = pi, A1 = 2pi/3, A2 = pi/4.
+    static const float BAND[9] = { PI, 2.0f * PI / 3.0f, 2.0f * PI / 3.0f, 2.0f * PI / 3.0f,
+                                   PI / 4.0f, PI / 4.0f, PI / 4.0f, PI / 4.0f, PI / 4.0f };
+    float values[9];
+    basis(normal, values);
+    for (int c = 0; c < 3; ++c) {
+        rgb[c] = 0.0f;
+        for (int i = 0; i < 9; ++i) {
+            rgb[c] += BAND[i] * coefficients[i][c] * values[i];
+        }
+    }
+}
+
+HRESULT
+EnvironmentPrefilter::prefilterSpecular(const std::vector<CubeMap>& source, const PrefilterSettings& settings,
+                                        std::vector<CubeMap>& levels, std::vector<PrefilterTiming>* timings) {
+    levels.clear();
+    if (timings) {
+        timings->clear();
+    }
+    if (source.empty() || source[0].empty() || settings.size == 0) {
+        ERROR("EnvironmentPrefilter", "prefilterSpecular", "Source cube map is empty or size is 0.");
+        return E_INVALIDARG;
+    }
+
+    unsigned int levelCount = 1;
+    while (levelCount < settings.levels && (settings.size >> levelCount) > 0) {
+        ++levelCount;
+    }
+    const unsigned int sourceSize = source[0].m_size;
+    const unsigned int sampleCount = std::max(1u, settings.sampleCount);
+
+    levels.resize(levelCount);
+    for (unsigned int level = 0; level < levelCount; ++level) {
+        const unsigned int size = std::max(1u, settings.size >> level);
+        HRESULT hr = levels[level].init(size);
+        if (FAILED(hr)) {
+            levels.clear();
+            return hr;
+        }
+        const float roughness = levelRoughness(level, levelCount);
+        const float baseLod = std::max(0.0f, std::log2(static_cast<float>(sourceSize) / size));
+        const std::vector<GgxSample> samples = buildSamples(roughness, sampleCount, sourceSize, baseLod);
+
+        const float scale = 2.0f / size;
+        for (unsigned int face = 0; face < CubeMap::FACE_COUNT; ++face) {
+            const double start = Profiler::now();
+            HdrImage& target = levels[level].m_faces[face];
+            forRows(size, std::max(1u, 1024u / size), settings.jobs, [&](unsigned int begin, unsigned int end) {
+                for (unsigned int y = begin; y < end; ++y) {
+                    float* row = target.row(y);
+                    const float v = (y + 0.5f) * scale - 1.0f;
+                    for (unsigned int x = 0; x < size; ++x) {
+                        float n[3];
+                        CubeMap::faceDirection(face, (x + 0.5f) * scale - 1.0f, v, n);
+                        const float inv = 1.0f / std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                        n[0] *= inv;
+                        n[1] *= inv;
+                        n[2] *= inv;
+                        // Base tangente alrededor de N.
+                        const float up[3] = { std::fabs(n[2]) < 0.999f ? 0.0f : 1.0f, 0.0f,
+                                              std::fabs(n[2]) < 0.999f ? 1.0f : 0.0f };
+                        float t[3] = { up[1] * n[2] - up[2] * n[1], up[2] * n[0] - up[0] * n[2],
+                                       up[0] * n[1] - up[1] * n[0] };
+                        const float tInv = 1.0f / std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+                        t[0] *= tInv;
+                        t[1] *= tInv;
+                        t[2] *= tInv;
+                        const float b[3] = { n[1] * t[2] - n[2] * t[1], n[2] * t[0] - n[0] * t[2],
+                                             n[0] * t[1] - n[1] * t[0] };
+
+                        float sum[3] = {};
+                        float weight = 0.0f;
+                        for (const GgxSample& sample : samples) {
+                            const float l[3] = {
+                                t[0] * sample.l[0] + b[0] * sample.l[1] + n[0] * sample.l[2],
+                                t[1] * sample.l[0] + b[1] * sample.l[1] + n[1] * sample.l[2],
+                                t[2] * sample.l[0] + b[2] * sample.l[1] + n[2] * sample.l[2],
+                            };
+                            float rgb[3];
+                            sampleLod(source, l, sample.lod, rgb);
+                            sum[0] += rgb[0] * sample.weight;
+                            sum[1] += rgb[1] * sample.weight;
+                            sum[2] += rgb[2] * sample.weight;
+                            weight += sample.weight;
+                        }
+                        const float normalize = weight > 0.0f ? 1.0f / weight : 0.0f;
+                        row[x * 4 + 0] = sum[0] * normalize;
+                        row[x * 4 + 1] = sum[1] * normalize;
+                        row[x * 4 + 2] = sum[2] * normalize;
+                        row[x * 4 + 3] = 1.0f;
+                    }
+                }
+            });
+            if (timings) {
+                PrefilterTiming timing;
+                timing.level = level;
+                timing.face = face;
+                timing.size = size;
+                timing.roughness = roughness;
+                timing.ms = Profiler::now() - start;
+                timings->push_back(timing);
+            }
+        }
+    }
+    return S_OK;
+}
+
+HRESULT
+EnvironmentPrefilter::projectSH9(const CubeMap& source, SH9& sh, JobSystem* jobs) {
+    if (source.empty()) {
+        ERROR("EnvironmentPrefilter", "projectSH9", "Source cube map is empty.");
+        return E_INVALIDARG;
+    }
+
+    // Sumas por cara en double, combinadas en orden fijo: el resultado no depende de los hilos.
+    const unsigned int size = source.m_size;
+    double sums[CubeMap::FACE_COUNT][9][3] = {};
+    double weights[CubeMap::FACE_COUNT] = {};
+    const float scale = 2.0f / size;
+    forRows(CubeMap::FACE_COUNT, 1, jobs, [&](unsigned int begin, unsigned int end) {
+        for (unsigned int face = begin; face < end; ++face) {
+            for (unsigned int y = 0; y < size; ++y) {
+                const float* row = source.m_faces[face].row(y);
+                const float v = (y + 0.5f) * scale - 1.0f;
+                for (unsigned int x = 0; x < size; ++x) {
+                    float dir[3];
+                    CubeMap::faceDirection(face, (x + 0.5f) * scale - 1.0f, v, dir);
+                    const float inv = 1.0f / std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+                    dir[0] *= inv;
+                    dir[1] *= inv;
+                    dir[2] *= inv;
+                    float values[9];
+                    SH9::basis(dir, values);
+                    const float solidAngle = CubeMap::texelSolidAngle(x, y, size);
+                    weights[face] += solidAngle;
+                    for (int i = 0; i < 9; ++i) {
+                        const float w = values[i] * solidAngle;
+                        for (int c = 0; c < 3; ++c) {
+                            sums[face][i][c] += row[x * 4 + c] * w;
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    // Corrige el redondeo del angulo solido total para que un entorno constante sea exacto.
+    double total = 0.0;
+    for (double weight : weights) {
+        total += weight;
+    }
+    const double normalize = 4.0 * 3.14159265358979323846 / total;
+    for (int i = 0; i < 9; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            double value = 0.0;
+            for (unsigned int face = 0; face < CubeMap::FACE_COUNT; ++face) {
+                value += sums[face][i][c];
+            }
+            sh.coefficients[i][c] = static_cast<float>(value * normalize);
+        }
+    }
+    return S_OK;
+}
@@ -0,0 +1,140 @@
+#include "FileWatcher.h"
+#include <filesystem>
+#include <unordered_set>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+#if defined(__linux__)
+    /// Eventos del directorio que pueden cambiar el contenido de un archivo vigilado.
+    const uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+#endif
+}
+
+HRESULT
+FileWatcher::init(bool forcePolling) {
+    destroy();
+#if defined(__linux__)
+    if (!forcePolling) {
+        m_notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_notifyFd < 0) {
+            ERROR("FileWatcher", "init", "inotify is not available; falling back to polling.");
+        }
+    }
+#else
+    (void)forcePolling;
+#endif
+    MESSAGE("FileWatcher", "init", (usesNotifications() ? "inotify" : "sondeo"));
+    return S_OK;
+}
+
+void
+FileWatcher::destroy() {
+#if defined(__linux__)
+    if (m_notifyFd >= 0) {
+        close(m_notifyFd);  // Cierra tambien todas sus vigilancias.
+        m_notifyFd = -1;
+    }
+#endif
+    m_directories.clear();
+    m_directoryWatches.clear();
+    m_files.clear();
+}
+
+HRESULT
+FileWatcher::watch(const std::string& fileName) {
+    const std::string path = normalize(fileName);
+    if (m_files.find(path) != m_files.end()) {
+        return S_OK;
+    }
+#if defined(__linux__)
+    if (m_notifyFd >= 0) {
+        const std::string directory = fs::path(path).parent_path().string();
+        if (m_directoryWatches.find(directory) == m_directoryWatches.end()) {
+            const int wd = inotify_add_watch(m_notifyFd, directory.c_str(), WATCH_EVENTS);
+            if (wd < 0) {
+                ERROR("FileWatcher", "watch", ("Could not watch directory: " + directory).c_str());
+                return E_FAIL;
+            }
+            m_directoryWatches[directory] = wd;
+            m_directories[wd] = directory;
+        }
+    }
+#endif
+    m_files[path] = readState(path);
+    return S_OK;
+}
+
+void
+FileWatcher::unwatch(const std::string& fileName) {
+    // La vigilancia del directorio se queda: otros archivos pueden compartirla y sus eventos
+    // se filtran por m_files.
+    m_files.erase(normalize(fileName));
+}
+
+unsigned int
+FileWatcher::poll(std::vector<std::string>& changed) {
+    changed.clear();
+    std::unordered_set<std::string> seen;
+
+#if defined(__linux__)
+    if (m_notifyFd >= 0) {
+        alignas(struct inotify_event) char buffer[4096];
+        for (;;) {
+            const ssize_t length = read(m_notifyFd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;  // EAGAIN: no quedan eventos.
+            }
+            for (ssize_t offset = 0; offset < length;) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+                offset += sizeof(struct inotify_event) + event->len;
+                const auto directory = m_directories.find(event->wd);
+                if (directory == m_directories.end() || event->len == 0) {
+                    continue;
+                }
+                const std::string path = (fs::path(directory->second) / event->name).string();
+                if (m_files.find(path) != m_files.end() && seen.insert(path).second) {
+                    changed.push_back(path);
+                }
+            }
+        }
+        return static_cast<unsigned int>(changed.size());
+    }
+#endif
+
+    for (auto& file : m_files) {
+        const FileState state = readState(file.first);
+        if (state.exists != file.second.exists || state.writeTime != file.second.writeTime ||
+            state.size != file.second.size) {
+            file.second = state;
+            changed.push_back(file.first);
+        }
+    }
+    return static_cast<unsigned int>(changed.size());
+}
+
+std::string
+FileWatcher::normalize(const std::string& fileName) {
+    std::error_code error;
+    const fs::path absolute = fs::absolute(fileName, error);
+    return (error ? fs::path(fileName) : absolute).lexically_normal().string();
+}
+
+FileWatcher::FileState
+FileWatcher::readState(const std::string& fileName) {
+    FileState state;
+    std::error_code error;
+    const fs::file_time_type writeTime = fs::last_write_time(fileName, error);
+    if (error) {
+        return state;
+    }
+    state.exists = true;
+    state.writeTime = static_cast<long long>(writeTime.time_since_epoch().count());
+    state.size = static_cast<unsigned long long>(fs::file_size(fileName, error));
+    return state;
+}
@@ -0,0 +1,190 @@
+#include "FrustumCuller.h"
+#include "BoundsTable.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Math/VectorBatch.h"
+#include <cmath>
+#include <cstring>
+
+void
+Frustum::extract(const Matrix4& viewProjection) {
+    const Matrix4& m = viewProjection;
+
+    // Con vector fila (clip = p * M) cada plano es una combinacion de columnas de M.
+    for (int c = 0; c < 4; ++c) {
+        const float col0 = m.m[c][0];
+        const float col1 = m.m[c][1];
+        const float col2 = m.m[c][2];
+        const float col3 = m.m[c][3];
+        (&planes[0].x)[c] = col3 + col0;   // -w <= x
+        (&planes[1].x)[c] = col3 - col0;   //  x <= w
+        (&planes[2].x)[c] = col3 + col1;   // -w <= y
+        (&planes[3].x)[c] = col3 - col1;   //  y <= w
+        (&planes[4].x)[c] = col2;          //  0 <= z
+        (&planes[5].x)[c] = col3 - col2;   //  z <= w
+    }
+
+    for (Vector4& plane : planes) {
+        plane = math::planeNormalize(plane);
+    }
+}
+
+HRESULT
+FrustumCuller::init(JobSystem& jobSystem) {
+    m_jobSystem = &jobSystem;
+    m_stats = FrustumStats();
+    update(Matrix4::identity());
+
+    MESSAGE("FrustumCuller", "init",
+        ("Lanes SIMD: " + std::to_string(simd::SIMD_LANES)).c_str());
+    return S_OK;
+}
+
+void
+FrustumCuller::update(const Matrix4& viewProjection) {
+    m_frustum.extract(viewProjection);
+    for (int p = 0; p < 6; ++p) {
+        m_absNormals[p][0] = fabsf(m_frustum.planes[p].x);
+        m_absNormals[p][1] = fabsf(m_frustum.planes[p].y);
+        m_absNormals[p][2] = fabsf(m_frustum.planes[p].z);
+    }
+}
+
+unsigned int
+FrustumCuller::cull(const BoundsTable& table, std::vector<unsigned int>& visible) {
+    double start = Profiler::now();
+    const unsigned int count = table.size();
+    const unsigned int numBlocks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    if (m_blockVisible.size() < numBlocks) {
+        m_blockVisible.resize(numBlocks);
+    }
+
+    m_jobSystem->parallelFor(numBlocks, 1, [&](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int block = begin; block < end; ++block) {
+            std::vector<unsigned int>& out = m_blockVisible[block];
+            out.clear();
+            cullRange(table, block * BLOCK_SIZE, std::min(count, (block + 1) * BLOCK_SIZE), out);
+        }
+    });
+
+    // Compactar en orden de bloque.
+    size_t total = 0;
+    for (unsigned int block = 0; block < numBlocks; ++block) {
+        total += m_blockVisible[block].size();
+    }
+    visible.resize(total);
+    size_t offset = 0;
+    for (unsigned int block = 0; block < numBlocks; ++block) {
+        const std::vector<unsigned int>& out = m_blockVisible[block];
+        if (!out.empty()) {
+            memcpy(visible.data() + offset, out.data(), out.size() * sizeof(unsigned int));
+            offset += out.size();
+        }
+    }
+
+    m_stats.cullMs = Profiler::now() - start;
+    m_stats.objectsTested = count;
+    m_stats.objectsVisible = static_cast<unsigned int>(total);
+
+    Profiler& profiler = Profiler::instance();
+    profiler.addSample("FrustumCuller::cull", m_stats.cullMs);
+    profiler.setCounter("FrustumCuller::objectsTested", m_stats.objectsTested);
+    profiler.setCounter("FrustumCuller::objectsVisible", m_stats.objectsVisible);
+    return m_stats.objectsVisible;
+}
+
+void
+FrustumCuller::cullRange(const BoundsTable& table, unsigned int begin, unsigned int end,
+                         std::vector<unsigned int>& out) const {
+    using namespace simd;
+
+    const float* cx = table.m_centerX.data();
+    const float* cy = table.m_centerY.data();
+    const float* cz = table.m_centerZ.data();
+    const float* ex = table.m_extentX.data();
+    const float* ey = table.m_extentY.data();
+    const float* ez = table.m_extentZ.data();
+    const float* radius = table.m_radius.data();
+
+    Vector3V normal[6], absNormal[6];
+    FloatV planeD[6];
+    for (int p = 0; p < 6; ++p) {
+        normal[p] = math::splat(m_frustum.planes[p].xyz());
+        absNormal[p] = math::splat(Vector3(m_absNormals[p][0], m_absNormals[p][1], m_absNormals[p][2]));
+        planeD[p] = set1(m_frustum.planes[p].w);
+    }
+    const FloatV zeroV = zero();
+
+    unsigned int i = begin;
+    for (; i + SIMD_LANES <= end; i += SIMD_LANES) {
+        const Vector3V center = math::load(cx + i, cy + i, cz + i);
+        const Vector3V extent = math::load(ex + i, ey + i, ez + i);
+        FloatV r = load(radius + i);
+
+        FloatV inside = maskFrom(true);
+        for (int p = 0; p < 6; ++p) {
+            // Distancia con signo del centro y radio proyectado de la caja sobre la normal.
+            FloatV distance = add(math::dot(normal[p], center), planeD[p]);
+            FloatV boxRadius = math::dot(absNormal[p], extent);
+            inside = andv(inside, cmpge(add(distance, min(boxRadius, r)), zeroV));
+        }
+
+        int bits = movemask(inside);
+        for (int lane = 0; bits != 0; ++lane, bits >>= 1) {
+            if (bits & 1) {
+                out.push_back(i + lane);
+            }
+        }
+    }
+
+    // Cola que no llena un registro.
+    for (; i < end; ++i) {
+        if (isVisible(table, i)) {
+            out.push_back(i);
+        }
+    }
+}
+
+bool
+FrustumCuller::isVisible(const BoundsTable& table, unsigned int index) const {
+    const float x = table.m_centerX[index];
+    const float y = table.m_centerY[index];
+    const float z = table.m_centerZ[index];
+    for (int p = 0; p < 6; ++p) {
+        const Vector4& plane = m_frustum.planes[p];
+        float distance = plane.x * x + plane.y * y + plane.z * z + plane.w;
+        float boxRadius = m_absNormals[p][0] * table.m_extentX[index]
+                        + m_absNormals[p][1] * table.m_extentY[index]
+                        + m_absNormals[p][2] * table.m_extentZ[index];
+        if (distance + std::min(boxRadius, table.m_radius[index]) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+FrustumCuller::isVisible(const AABB& worldBox) const {
+    const float c[3] = { (worldBox.min.x + worldBox.max.x) * 0.5f,
+                         (worldBox.min.y + worldBox.max.y) * 0.5f,
+                         (worldBox.min.z + worldBox.max.z) * 0.5f };
+    const float e[3] = { (worldBox.max.x - worldBox.min.x) * 0.5f,
+                         (worldBox.max.y - worldBox.min.y) * 0.5f,
+                         (worldBox.max.z - worldBox.min.z) * 0.5f };
+    for (int p = 0; p < 6; ++p) {
+        const Vector4& plane = m_frustum.planes[p];
+        float distance = plane.x * c[0] + plane.y * c[1] + plane.z * c[2] + plane.w;
+        float boxRadius = m_absNormals[p][0] * e[0] + m_absNormals[p][1] * e[1] + m_absNormals[p][2] * e[2];
+        if (distance + boxRadius < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+FrustumCuller::destroy() {
+    m_blockVisible.clear();
+    m_blockVisible.shrink_to_fit();
+    m_jobSystem = nullptr;
+}
@@ -0,0 +1,257 @@
+#include "HdrImage.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "Simd.h"
+#include "stb_image.h"
+
+using namespace simd;
+
+namespace {
+    /// Mayor valor finito de R11G11B10 (mantisa de 6 bits, exponente 15).
+    const float R11G11B10_MAX = 65024.0f;
+
+    /// Quita @p shift bits de mantisa a un medio float positivo con redondeo al par.
+    inline uint32_t shortenHalf(uint32_t half, unsigned int shift, uint32_t maxFinite) {
+        const uint32_t rounded = (half + (1u << (shift - 1)) - 1u + ((half >> shift) & 1u)) >> shift;
+        return std::min(rounded, maxFinite);
+    }
+
+    /// Tres medios floats (ya saturados a [0, R11G11B10_MAX]) a R11G11B10.
+    inline uint32_t packHalves(uint16_t r, uint16_t g, uint16_t b) {
+        return shortenHalf(r & 0x7FFFu, 4, 0x7BFu) | (shortenHalf(g & 0x7FFFu, 4, 0x7BFu) << 11) |
+               (shortenHalf(b & 0x7FFFu, 5, 0x3DFu) << 22);
+    }
+
+    /// Convierte @p count floats a medios floats; si @p clampRgb, satura antes a [0, R11G11B10_MAX].
+    void floatsToHalves(const float* src, uint16_t* dst, size_t count, bool clampRgb) {
+        const FloatV lo = zero();
+        const FloatV hi = set1(clampRgb ? R11G11B10_MAX : 0.0f);
+        size_t i = 0;
+        for (; i + SIMD_LANES <= count; i += SIMD_LANES) {
+            FloatV v = load(src + i);
+            if (clampRgb) {
+                v = min(max(v, lo), hi);
+            }
+            storeHalves(dst + i, v);
+        }
+        for (; i < count; ++i) {
+            // Como max() de SSE: un NaN satura a 0.
+            const float v = src[i];
+            dst[i] = floatToHalf(clampRgb ? (v == v ? std::min(std::max(v, 0.0f), R11G11B10_MAX) : 0.0f) : v);
+        }
+    }
+
+    void halvesToFloats(const uint16_t* src, float* dst, size_t count) {
+        size_t i = 0;
+        for (; i + SIMD_LANES <= count; i += SIMD_LANES) {
+            store(dst + i, loadHalves(src + i));
+        }
+        for (; i < count; ++i) {
+            dst[i] = halfToFloat(src[i]);
+        }
+    }
+
+    /// Llama a @p rows(begin, end) por bloques de filas, en @p jobs si hay.
+    template<class Rows>
+    void forRows(unsigned int height, JobSystem* jobs, const Rows& rows) {
+        if (jobs) {
+            jobs->parallelFor(height, 16, [&](unsigned int begin, unsigned int end, unsigned int) { rows(begin, end); });
+        }
+        else {
+            rows(0, height);
+        }
+    }
+}
+
+HRESULT
+HdrImage::init(unsigned int width, unsigned int height) {
+    if (width == 0 || height == 0) {
+        ERROR("HdrImage", "init", "Width and height must be greater than 0");
+        return E_INVALIDARG;
+    }
+    m_width = width;
+    m_height = height;
+    m_pixels.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+    return S_OK;
+}
+
+HRESULT
+HdrImage::loadFromFile(const std::string& fileName) {
+    MappedFile file;
+    HRESULT hr = file.init(fileName);
+    if (FAILED(hr)) {
+        ERROR("HdrImage", "loadFromFile", ("Failed to open image " + fileName).c_str());
+        return E_FAIL;
+    }
+    hr = loadFromMemory(file.getData(), file.getSize());
+    if (FAILED(hr)) {
+        ERROR("HdrImage", "loadFromFile", ("Failed to load image " + fileName).c_str());
+        return E_FAIL;
+    }
+    return S_OK;
+}
+
+HRESULT
+HdrImage::loadFromMemory(const unsigned char* data, size_t size) {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    float* pixels = stbi_loadf_from_memory(data, static_cast<int>(size), &width, &height, &channels, 4);
+    if (!pixels) {
+        return E_FAIL;
+    }
+    m_width = static_cast<unsigned int>(width);
+    m_height = static_cast<unsigned int>(height);
+    m_pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+    return S_OK;
+}
+
+bool
+HdrImage::isHdr(const unsigned char* data, size_t size) {
+    return stbi_is_hdr_from_memory(data, static_cast<int>(size)) != 0;
+}
+
+uint32_t
+HdrImage::packR11G11B10(float r, float g, float b) {
+    auto clampChannel = [](float v) { return v == v ? std::min(std::max(v, 0.0f), R11G11B10_MAX) : 0.0f; };
+    return packHalves(floatToHalf(clampChannel(r)), floatToHalf(clampChannel(g)), floatToHalf(clampChannel(b)));
+}
+
+void
+HdrImage::unpackR11G11B10(uint32_t packed, float* rgb) {
+    rgb[0] = halfToFloat(static_cast<uint16_t>((packed & 0x7FFu) << 4));
+    rgb[1] = halfToFloat(static_cast<uint16_t>(((packed >> 11) & 0x7FFu) << 4));
+    rgb[2] = halfToFloat(static_cast<uint16_t>(((packed >> 22) & 0x3FFu) << 5));
+}
+
+HRESULT
+HdrImage::pack(DdsFormat format, std::vector<unsigned char>& out, JobSystem* jobs) const {
+    if (empty()) {
+        ERROR("HdrImage", "pack", "Image is empty.");
+        return E_INVALIDARG;
+    }
+    const size_t rowFloats = static_cast<size_t>(m_width) * 4;
+
+    switch (format) {
+    case DdsFormat::R32G32B32A32_FLOAT:
+        out.resize(m_pixels.size() * sizeof(float));
+        memcpy(out.data(), m_pixels.data(), out.size());
+        return S_OK;
+
+    case DdsFormat::R16G16B16A16_FLOAT:
+        out.resize(m_pixels.size() * sizeof(uint16_t));
+        forRows(m_height, jobs, [&](unsigned int begin, unsigned int end) {
+            uint16_t* dst = reinterpret_cast<uint16_t*>(out.data());
+            for (unsigned int y = begin; y < end; ++y) {
+                floatsToHalves(row(y), dst + y * rowFloats, rowFloats, false);
+            }
+        });
+        return S_OK;
+
+    case DdsFormat::R11G11B10_FLOAT:
+        out.resize(static_cast<size_t>(m_width) * m_height * sizeof(uint32_t));
+        forRows(m_height, jobs, [&](unsigned int begin, unsigned int end) {
+            // Medios floats de una fila (el alfa se convierte pero no se usa: el bucle queda sin huecos).
+            std::vector<uint16_t> halves(rowFloats);
+            for (unsigned int y = begin; y < end; ++y) {
+                floatsToHalves(row(y), halves.data(), rowFloats, true);
+                uint32_t* dst = reinterpret_cast<uint32_t*>(out.data()) + static_cast<size_t>(y) * m_width;
+                for (unsigned int x = 0; x < m_width; ++x) {
+                    dst[x] = packHalves(halves[x * 4], halves[x * 4 + 1], halves[x * 4 + 2]);
+                }
+            }
+        });
+        return S_OK;
+
+    default:
+        ERROR("HdrImage", "pack", "Unsupported HDR format.");
+        return E_INVALIDARG;
+    }
+}
+
+HRESULT
+HdrImage::unpack(DdsFormat format, const unsigned char* data, unsigned int width, unsigned int height) {
+    HdrImage result;
+    HRESULT hr = result.init(width, height);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    const size_t count = result.m_pixels.size();
+    switch (format) {
+    case DdsFormat::R32G32B32A32_FLOAT:
+        memcpy(result.m_pixels.data(), data, count * sizeof(float));
+        break;
+    case DdsFormat::R16G16B16A16_FLOAT:
+        halvesToFloats(reinterpret_cast<const uint16_t*>(data), result.m_pixels.data(), count);
+        break;
+    case DdsFormat::R11G11B10_FLOAT:
+        for (size_t p = 0; p < count / 4; ++p) {
+            uint32_t packed;
+            memcpy(&packed, data + p * 4, sizeof(packed));
+            unpackR11G11B10(packed, &result.m_pixels[p * 4]);
+            result.m_pixels[p * 4 + 3] = 1.0f;
+        }
+        break;
+    default:
+        ERROR("HdrImage", "unpack", "Unsupported HDR format.");
+        return E_INVALIDARG;
+    }
+    *this = std::move(result);
+    return S_OK;
+}
+
+HRESULT
+HdrImage::halfSize(HdrImage& out) const {
+    if (empty()) {
+        ERROR("HdrImage", "halfSize", "Image is empty.");
+        return E_INVALIDARG;
+    }
+    HdrImage result;
+    HRESULT hr = result.init(std::max(1u, m_width / 2), std::max(1u, m_height / 2));
+    if (FAILED(hr)) {
+        return hr;
+    }
+    for (unsigned int y = 0; y < result.m_height; ++y) {
+        const float* row0 = row(std::min(y * 2, m_height - 1));
+        const float* row1 = row(std::min(y * 2 + 1, m_height - 1));
+        float* dst = result.row(y);
+        for (unsigned int x = 0; x < result.m_width; ++x) {
+            const unsigned int x0 = std::min(x * 2, m_width - 1) * 4;
+            const unsigned int x1 = std::min(x * 2 + 1, m_width - 1) * 4;
+            for (unsigned int c = 0; c < 4; ++c) {
+                dst[x * 4 + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+            }
+        }
+    }
+    out = std::move(result);
+    return S_OK;
+}
+
+HRESULT
+HdrImage::generateMips(HdrImage&& base, std::vector<HdrImage>& levels, unsigned int maxLevels) {
+    levels.clear();
+    if (base.empty()) {
+        ERROR("HdrImage", "generateMips", "Image is empty.");
+        return E_INVALIDARG;
+    }
+    levels.push_back(std::move(base));
+    while ((levels.back().m_width > 1 || levels.back().m_height > 1) &&
+           (maxLevels == 0 || levels.size() < maxLevels)) {
+        HdrImage next;
+        HRESULT hr = levels.back().halfSize(next);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        levels.push_back(std::move(next));
+    }
+    return S_OK;
+}
+
+void
+HdrImage::destroy() {
+    m_pixels.clear();
+    m_pixels.shrink_to_fit();
+    m_width = 0;
+    m_height = 0;
+}
@@ -0,0 +1,95 @@
+#include "Image.h"
+#include "ImageDecoder.h"
+#include "MappedFile.h"
+
+HRESULT
+Image::init(unsigned int width, unsigned int height, unsigned int channels) {
+    if (width == 0 || height == 0) {
+        ERROR("Image", "init", "Width and height must be greater than 0");
+        return E_INVALIDARG;
+    }
+    if (channels == 0 || channels > 4) {
+        ERROR("Image", "init", "Channels must be between 1 and 4");
+        return E_INVALIDARG;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+    m_pixels.assign(static_cast<size_t>(width) * height * channels, 0);
+    return S_OK;
+}
+
+HRESULT
+Image::loadFromFile(const std::string& fileName, JobSystem* jobs) {
+    MappedFile file;
+    HRESULT hr = file.init(fileName);
+    if (FAILED(hr)) {
+        ERROR("Image", "loadFromFile", ("Failed to open image " + fileName).c_str());
+        return E_FAIL;
+    }
+
+    hr = ImageDecoderRegistry::instance().decode(file.getData(), file.getSize(), *this, jobs);
+    if (FAILED(hr)) {
+        ERROR("Image", "loadFromFile", ("Failed to load image " + fileName).c_str());
+        return E_FAIL;
+    }
+    return S_OK;
+}
+
+HRESULT
+Image::loadFromMemory(const unsigned char* data, size_t size, JobSystem* jobs) {
+    return ImageDecoderRegistry::instance().decode(data, size, *this, jobs);
+}
+
+HRESULT
+Image::saveToTGA(const std::string& fileName) const {
+    if (empty()) {
+        ERROR("Image", "saveToTGA", "Image is empty.");
+        return E_FAIL;
+    }
+
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file.is_open()) {
+        ERROR("Image", "saveToTGA", ("Could not open file: " + fileName).c_str());
+        return E_FAIL;
+    }
+
+    // Cabecera TGA tipo 2 (true color sin compresion), origen arriba a la izquierda.
+    unsigned char header[18] = {};
+    header[2] = 2;
+    header[12] = static_cast<unsigned char>(m_width & 0xFF);
+    header[13] = static_cast<unsigned char>((m_width >> 8) & 0xFF);
+    header[14] = static_cast<unsigned char>(m_height & 0xFF);
+    header[15] = static_cast<unsigned char>((m_height >> 8) & 0xFF);
+    header[16] = 32;
+    header[17] = 0x28;
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    std::vector<unsigned char> line(static_cast<size_t>(m_width) * 4);
+    for (unsigned int y = 0; y < m_height; ++y) {
+        const unsigned char* src = row(y);
+        for (unsigned int x = 0; x < m_width; ++x) {
+            const unsigned char* p = src + x * m_channels;
+            unsigned char r = p[0];
+            unsigned char g = m_channels > 1 ? p[1] : r;
+            unsigned char b = m_channels > 2 ? p[2] : r;
+            unsigned char a = m_channels > 3 ? p[3] : 255;
+            line[x * 4 + 0] = b;
+            line[x * 4 + 1] = g;
+            line[x * 4 + 2] = r;
+            line[x * 4 + 3] = a;
+        }
+        file.write(reinterpret_cast<const char*>(line.data()), line.size());
+    }
+
+    return file.good() ? S_OK : E_FAIL;
+}
+
+void
+Image::destroy() {
+    m_pixels.clear();
+    m_pixels.shrink_to_fit();
+    m_width = 0;
+    m_height = 0;
+}
@@ -0,0 +1,145 @@
+#include "ImageDecodeQueue.h"
+#include "Profiler.h"
+#include "ResourceCache.h"
+#include <fstream>
+
+HRESULT
+ImageDecodeQueue::init(JobSystem* jobs, bool generateMips, const MipSettings& mipSettings) {
+    destroy();
+    m_jobs = jobs;
+    m_generateMips = generateMips;
+    m_mipSettings = mipSettings;
+    // Las imagenes ya se reparten entre hilos; repartir ademas sus filas solo agrega esperas.
+    m_mipSettings.jobs = nullptr;
+    m_nextTicket = 1;
+    m_stats = ImageDecodeStats();
+    MESSAGE("ImageDecodeQueue", "init",
+        ("Hilos: " + std::to_string(jobs ? jobs->getNumThreads() : 1)).c_str());
+    return S_OK;
+}
+
+void
+ImageDecodeQueue::destroy() {
+    waitIdle();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ready.clear();
+    m_jobs = nullptr;
+}
+
+unsigned int
+ImageDecodeQueue::request(const std::string& fileName, ColorSpace colorSpace) {
+    const unsigned int ticket = m_nextTicket++;
+    schedule(ticket, fileName, colorSpace, [fileName](DecodedImage& result) {
+        // Se lee el archivo aqui (y no con stbi_load) para calcular su hash sobre los mismos bytes.
+        std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+        if (!file) {
+            ERROR("ImageDecodeQueue", "request", ("Failed to open image file: " + fileName).c_str());
+            return E_FAIL;
+        }
+        std::vector<unsigned char> bytes(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (bytes.empty() || !file.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+            ERROR("ImageDecodeQueue", "request", ("Failed to read image file: " + fileName).c_str());
+            return E_FAIL;
+        }
+        result.contentHash = ResourceCache::hashContent(bytes.data(), bytes.size());
+        return result.image.loadFromMemory(bytes.data(), bytes.size());
+    });
+    return ticket;
+}
+
+unsigned int
+ImageDecodeQueue::requestMemory(const unsigned char* data, size_t size, const std::string& name,
+                                ColorSpace colorSpace) {
+    const unsigned int ticket = m_nextTicket++;
+    schedule(ticket, name, colorSpace, [data, size](DecodedImage& result) {
+        result.contentHash = ResourceCache::hashContent(data, size);
+        return result.image.loadFromMemory(data, size);
+    });
+    return ticket;
+}
+
+void
+ImageDecodeQueue::schedule(unsigned int ticket, const std::string& name, ColorSpace colorSpace,
+                           std::function<HRESULT(DecodedImage&)> decode) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.requested++;
+    }
+    m_inFlight.fetch_add(1, std::memory_order_acq_rel);
+
+    auto job = [this, ticket, name, colorSpace, decode]() {
+        DecodedImage result;
+        result.ticket = ticket;
+        result.name = name;
+        result.colorSpace = colorSpace;
+        const double start = Profiler::now();
+        result.result = decode(result);
+        if (SUCCEEDED(result.result)) {
+            result.megapixels = static_cast<double>(result.image.m_width) * result.image.m_height / 1.0e6;
+            if (m_generateMips) {
+                MipSettings settings = m_mipSettings;
+                settings.srgb = colorSpace == ColorSpace::Srgb;
+                result.result = result.mips.generate(std::move(result.image), settings);
+                result.image = Image();
+            }
+        }
+        result.decodeMs = Profiler::now() - start;
+        finish(std::move(result));
+    };
+
+    if (m_jobs) {
+        m_jobs->submit(job, &m_counter);
+    }
+    else {
+        job();
+    }
+}
+
+void
+ImageDecodeQueue::finish(DecodedImage&& result) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (SUCCEEDED(result.result)) {
+            m_stats.decoded++;
+            m_stats.megapixels += result.megapixels;
+        }
+        else {
+            m_stats.failed++;
+        }
+        m_stats.decodeMs += result.decodeMs;
+        m_ready.push_back(std::move(result));
+    }
+    // Despues de publicar: quien vea getInFlight() == 0 encuentra el resultado en m_ready.
+    m_inFlight.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool
+ImageDecodeQueue::pop(DecodedImage& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_ready.empty()) {
+        return false;
+    }
+    out = std::move(m_ready.front());
+    m_ready.pop_front();
+    return true;
+}
+
+void
+ImageDecodeQueue::waitIdle() {
+    if (m_jobs) {
+        m_jobs->wait(m_counter);
+    }
+}
+
+unsigned int
+ImageDecodeQueue::getReadyCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<unsigned int>(m_ready.size());
+}
+
+ImageDecodeStats
+ImageDecodeQueue::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
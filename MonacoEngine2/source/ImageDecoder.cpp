@@ -0,0 +1,152 @@
+#include "ImageDecoder.h"
+#include "Image.h"
+#include "JpegDecoder.h"
+#include "PngDecoder.h"
+// Definimos esto ANTES de incluir el header para que la libreria implemente su codigo aqui.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include <cstring>
+
+HRESULT
+ImageDecoder::decode(const unsigned char* data, size_t size, Image& image, JobSystem* jobs) const {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    HRESULT hr = getInfo(data, size, width, height);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    Image result;
+    hr = result.init(width, height, 4);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    hr = decodeInto(data, size, result.getView(), jobs);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    image = std::move(result);
+    return S_OK;
+}
+
+bool
+StbImageDecoder::canDecode(const unsigned char* data, size_t size) const {
+    return data != nullptr && size > 0;
+}
+
+HRESULT
+StbImageDecoder::getInfo(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height) const {
+    int w, h, channels;
+    if (!stbi_info_from_memory(data, static_cast<int>(size), &w, &h, &channels)) {
+        return E_FAIL;
+    }
+    width = static_cast<unsigned int>(w);
+    height = static_cast<unsigned int>(h);
+    return S_OK;
+}
+
+HRESULT
+StbImageDecoder::decodeInto(const unsigned char* data, size_t size, const ImageView& target, JobSystem* jobs) const {
+    (void)jobs;
+    int width, height, channels;
+    unsigned char* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 4);
+    if (!pixels) {
+        ERROR("StbImageDecoder", "decode",
+            ("Failed to decode image: " + std::string(stbi_failure_reason())).c_str());
+        return E_FAIL;
+    }
+    if (static_cast<unsigned int>(width) != target.width || static_cast<unsigned int>(height) != target.height) {
+        stbi_image_free(pixels);
+        ERROR("StbImageDecoder", "decode", "Image size does not match the target.");
+        return E_FAIL;
+    }
+
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    for (unsigned int y = 0; y < target.height; ++y) {
+        memcpy(target.row(y), pixels + y * rowBytes, rowBytes);
+    }
+    stbi_image_free(pixels);
+    return S_OK;
+}
+
+ImageDecoderRegistry::ImageDecoderRegistry() {
+    m_decoders.push_back(std::make_unique<JpegDecoder>());
+    m_decoders.push_back(std::make_unique<PngDecoder>());
+    m_decoders.push_back(std::make_unique<StbImageDecoder>());
+}
+
+ImageDecoderRegistry&
+ImageDecoderRegistry::instance() {
+    static ImageDecoderRegistry registry;
+    return registry;
+}
+
+void
+ImageDecoderRegistry::add(std::unique_ptr<ImageDecoder> decoder) {
+    if (decoder) {
+        m_decoders.insert(m_decoders.begin(), std::move(decoder));
+    }
+}
+
+void
+ImageDecoderRegistry::useStbOnly() {
+    m_decoders.clear();
+    m_decoders.push_back(std::make_unique<StbImageDecoder>());
+}
+
+HRESULT
+ImageDecoderRegistry::getInfo(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height) const {
+    if (!data || size == 0) {
+        ERROR("ImageDecoderRegistry", "getInfo", "Empty image data.");
+        return E_INVALIDARG;
+    }
+
+    for (const std::unique_ptr<ImageDecoder>& decoder : m_decoders) {
+        if (decoder->canDecode(data, size) && SUCCEEDED(decoder->getInfo(data, size, width, height))) {
+            return S_OK;
+        }
+    }
+
+    ERROR("ImageDecoderRegistry", "getInfo", "Unknown or damaged image header.");
+    return E_FAIL;
+}
+
+HRESULT
+ImageDecoderRegistry::decodeInto(const unsigned char* data, size_t size, const ImageView& target, JobSystem* jobs) const {
+    if (!data || size == 0 || target.empty()) {
+        ERROR("ImageDecoderRegistry", "decodeInto", "Empty image data or target.");
+        return E_INVALIDARG;
+    }
+
+    for (const std::unique_ptr<ImageDecoder>& decoder : m_decoders) {
+        if (!decoder->canDecode(data, size)) {
+            continue;
+        }
+        if (SUCCEEDED(decoder->decodeInto(data, size, target, jobs))) {
+            return S_OK;
+        }
+    }
+
+    ERROR("ImageDecoderRegistry", "decodeInto", "No decoder could decode the image.");
+    return E_FAIL;
+}
+
+HRESULT
+ImageDecoderRegistry::decode(const unsigned char* data, size_t size, Image& image, JobSystem* jobs) const {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    HRESULT hr = getInfo(data, size, width, height);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    Image result;
+    hr = result.init(width, height, 4);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    hr = decodeInto(data, size, result.getView(), jobs);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    image = std::move(result);
+    return S_OK;
+}
@@ -0,0 +1,174 @@
+#include "JobSystem.h"
+
+namespace {
+    thread_local unsigned int t_workerIndex = 0;
+}
+
+JobSystem&
+JobSystem::instance() {
+    static JobSystem s_jobSystem;
+    return s_jobSystem;
+}
+
+unsigned int
+JobSystem::getWorkerIndex() {
+    return t_workerIndex;
+}
+
+HRESULT
+JobSystem::init(unsigned int numThreads) {
+    if (m_running) {
+        return S_OK;
+    }
+    if (numThreads == 0) {
+        numThreads = std::thread::hardware_concurrency();
+        if (numThreads == 0) {
+            numThreads = 1;
+        }
+    }
+
+    m_running = true;
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+
+    MESSAGE("JobSystem", "init", ("Hilos: " + std::to_string(numThreads)).c_str());
+    return S_OK;
+}
+
+void
+JobSystem::destroy() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+
+    // Las tareas que quedaron en cola se ejecutan en el hilo que destruye.
+    while (executeOne()) {}
+}
+
+void
+JobSystem::submit(JobFunc job, JobCounter* counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (m_workers.empty()) {
+        job();
+        if (counter) {
+            counter->m_pending.fetch_sub(1, std::memory_order_release);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back({ std::move(job), counter });
+    }
+    m_wake.notify_one();
+}
+
+void
+JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        if (!executeOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool
+JobSystem::executeOne() {
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) {
+            return false;
+        }
+        job = std::move(m_queue.front());
+        m_queue.pop_front();
+    }
+    job.func();
+    if (job.counter) {
+        job.counter->m_pending.fetch_sub(1, std::memory_order_release);
+    }
+    return true;
+}
+
+void
+JobSystem::workerLoop(unsigned int index) {
+    t_workerIndex = index;
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        job.func();
+        if (job.counter) {
+            job.counter->m_pending.fetch_sub(1, std::memory_order_release);
+        }
+    }
+}
+
+void
+JobSystem::parallelFor(unsigned int count, unsigned int grainSize, const RangeFunc& func) {
+    if (count == 0) {
+        return;
+    }
+    if (grainSize == 0) {
+        grainSize = 1;
+    }
+    const unsigned int numChunks = (count + grainSize - 1) / grainSize;
+    if (numChunks == 1 || m_workers.empty()) {
+        func(0, count, getWorkerIndex());
+        return;
+    }
+
+    // Estado compartido: los ayudantes que empiecen tarde solo encuentran el contador agotado.
+    struct RangeState {
+        std::atomic<unsigned int> next{ 0 };
+        std::atomic<unsigned int> done{ 0 };
+    };
+    std::shared_ptr<RangeState> state = std::make_shared<RangeState>();
+    const RangeFunc* range = &func;
+
+    auto runChunks = [state, range, count, grainSize, numChunks]() {
+        for (;;) {
+            unsigned int chunk = state->next.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= numChunks) {
+                return;
+            }
+            unsigned int begin = chunk * grainSize;
+            unsigned int end = (begin + grainSize < count) ? begin + grainSize : count;
+            (*range)(begin, end, getWorkerIndex());
+            state->done.fetch_add(1, std::memory_order_acq_rel);
+        }
+    };
+
+    unsigned int helpers = static_cast<unsigned int>(m_workers.size());
+    if (helpers > numChunks - 1) {
+        helpers = numChunks - 1;
+    }
+    for (unsigned int i = 0; i < helpers; ++i) {
+        submit(runChunks);
+    }
+
+    runChunks();
+    while (state->done.load(std::memory_order_acquire) < numChunks) {
+        if (!executeOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
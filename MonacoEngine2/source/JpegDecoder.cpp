@@ -0,0 +1,876 @@
+#include "JpegDecoder.h"
+#include "Image.h"
+#include "JobSystem.h"
+#include "Simd.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+using namespace simd;
+
+namespace {
+    const unsigned int FAST_BITS = 9;
+    const unsigned int FAST_SIZE = 1u << FAST_BITS;
+
+    /**
+     * Orden zigzag -> posicion en el bloque transpuesto (columna * 8 + fila): asi la primera
+     * pasada de la IDCT lee filas contiguas. Los 16 de mas absorben corridas que se pasan del bloque.
+     */
+    const uint8_t ZIGZAG[64 + 16] = {
+         0,  8,  1,  2,  9, 16, 24, 17, 10,  3,  4, 11, 18, 25, 32, 40,
+        33, 26, 19, 12,  5,  6, 13, 20, 27, 34, 41, 48, 56, 49, 42, 35,
+        28, 21, 14,  7, 15, 22, 29, 36, 43, 50, 57, 58, 51, 44, 37, 30,
+        23, 31, 38, 45, 52, 59, 60, 53, 46, 39, 47, 54, 61, 62, 55, 63,
+        63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63
+    };
+
+    /**
+     * Tabla de Huffman de JPEG. @c fast resuelve los codigos de hasta FAST_BITS bits; @c fastAc
+     * ademas trae la corrida y el valor del coeficiente cuando codigo + magnitud caben en
+     * FAST_BITS: (valor << 8) | (corrida << 4) | bits totales, 0 si no.
+     */
+    struct Huffman {
+        uint8_t fast[FAST_SIZE];
+        int16_t fastAc[FAST_SIZE];
+        uint16_t codes[256];
+        uint8_t values[256];
+        uint8_t sizes[257];
+        uint32_t maxCode[18];       ///< Primer codigo que ya no tiene esa longitud, alineado a 16 bits.
+        int delta[17];              ///< Indice del simbolo menos el codigo, por longitud.
+        bool defined = false;
+
+        bool build(const uint8_t* counts, const uint8_t* symbols) {
+            unsigned int k = 0;
+            for (unsigned int i = 0; i < 16; ++i) {
+                for (unsigned int j = 0; j < counts[i]; ++j) {
+                    if (k >= 256) {
+                        return false;
+                    }
+                    sizes[k++] = static_cast<uint8_t>(i + 1);
+                }
+            }
+            sizes[k] = 0;
+            memcpy(values, symbols, k);
+
+            unsigned int code = 0;
+            k = 0;
+            for (unsigned int bits = 1; bits <= 16; ++bits) {
+                delta[bits] = static_cast<int>(k) - static_cast<int>(code);
+                if (sizes[k] == bits) {
+                    while (sizes[k] == bits) {
+                        codes[k++] = static_cast<uint16_t>(code++);
+                    }
+                    if (code - 1 >= (1u << bits)) {
+                        return false;
+                    }
+                }
+                maxCode[bits] = code << (16 - bits);
+                code <<= 1;
+            }
+            maxCode[17] = 0xffffffffu;
+
+            memset(fast, 255, sizeof(fast));
+            for (unsigned int i = 0; i < k; ++i) {
+                unsigned int length = sizes[i];
+                if (length <= FAST_BITS) {
+                    unsigned int first = codes[i] << (FAST_BITS - length);
+                    memset(fast + first, static_cast<int>(i), 1u << (FAST_BITS - length));
+                }
+            }
+
+            for (unsigned int i = 0; i < FAST_SIZE; ++i) {
+                fastAc[i] = 0;
+                if (fast[i] == 255) {
+                    continue;
+                }
+                unsigned int symbol = values[fast[i]];
+                unsigned int run = symbol >> 4;
+                unsigned int magnitude = symbol & 15u;
+                unsigned int length = sizes[fast[i]];
+                if (magnitude && length + magnitude <= FAST_BITS) {
+                    int value = static_cast<int>(((i << length) & (FAST_SIZE - 1)) >> (FAST_BITS - magnitude));
+                    if (value < (1 << (magnitude - 1))) {
+                        value -= (1 << magnitude) - 1;
+                    }
+                    if (value >= -128 && value <= 127) {
+                        fastAc[i] = static_cast<int16_t>(value * 256 + static_cast<int>(run * 16 + length + magnitude));
+                    }
+                }
+            }
+            defined = true;
+            return true;
+        }
+    };
+
+    /**
+     * Lector de bits de un intervalo de entropia (el primero es el bit alto). Quita el relleno
+     * 0xFF00 y se detiene en cualquier marcador, despues del cual solo entrega ceros. Si los 8
+     * bytes siguientes no tienen 0xFF se recargan con una sola lectura.
+     */
+    struct BitReader {
+        const uint8_t* p;
+        const uint8_t* end;
+        uint64_t buffer = 0;
+        unsigned int count = 0;         ///< Bits validos (alineados arriba).
+
+        BitReader(const uint8_t* begin, const uint8_t* finish) : p(begin), end(finish) {}
+
+        void refill() {
+            if (end - p >= 8) {
+                uint64_t word = 0;
+                for (unsigned int i = 0; i < 8; ++i) {
+                    word = (word << 8) | p[i];
+                }
+                // Sin bytes 0xFF: todos son datos y se toman los que caben.
+                uint64_t inverted = ~word;
+                if (((inverted - 0x0101010101010101ull) & ~inverted & 0x8080808080808080ull) == 0) {
+                    buffer |= word >> count;
+                    p += (63 - count) >> 3;
+                    count |= 56;
+                    return;
+                }
+            }
+            while (count <= 56) {
+                unsigned int byte = 0;
+                if (p < end) {
+                    byte = *p++;
+                    if (byte == 0xff) {
+                        if (p < end && *p == 0) {
+                            ++p;
+                        }
+                        else {
+                            byte = 0;
+                            p = end;
+                        }
+                    }
+                }
+                buffer |= static_cast<uint64_t>(byte) << (56 - count);
+                count += 8;
+            }
+        }
+
+        /// Simbolo siguiente; -1 si el codigo no existe. @pre count >= 16.
+        int decode(const Huffman& table) {
+            unsigned int index = table.fast[buffer >> (64 - FAST_BITS)];
+            if (index < 255) {
+                unsigned int length = table.sizes[index];
+                buffer <<= length;
+                count -= length;
+                return table.values[index];
+            }
+            uint32_t code = static_cast<uint32_t>(buffer >> 48);
+            unsigned int length = FAST_BITS + 1;
+            while (code >= table.maxCode[length]) {
+                ++length;
+            }
+            if (length > 16) {
+                return -1;
+            }
+            int symbol = static_cast<int>(code >> (16 - length)) + table.delta[length];
+            if (symbol < 0 || symbol >= 256 || table.sizes[symbol] != length) {
+                return -1;
+            }
+            buffer <<= length;
+            count -= length;
+            return table.values[symbol];
+        }
+
+        /// Valor con signo de @p bits bits (1 a 16). @pre count >= bits.
+        int extend(unsigned int bits) {
+            int value = static_cast<int>(buffer >> (64 - bits));
+            buffer <<= bits;
+            count -= bits;
+            if (value < (1 << (bits - 1))) {
+                value -= (1 << bits) - 1;
+            }
+            return value;
+        }
+    };
+
+    struct Component {
+        unsigned int id = 0;
+        unsigned int h = 1;             ///< Muestreo horizontal.
+        unsigned int v = 1;             ///< Muestreo vertical.
+        unsigned int quant = 0;
+        unsigned int dcTable = 0;
+        unsigned int acTable = 0;
+        unsigned int width = 0;         ///< Muestras reales: ceil(ancho * h / hMax).
+        unsigned int height = 0;
+        unsigned int stride = 0;        ///< Bytes por fila del plano (multiplo de 8).
+        std::vector<uint8_t> plane;     ///< Muestras con el relleno del ultimo MCU.
+    };
+
+    /// Estado del archivo; se reserva en el heap (las tablas ocupan unos 25 KB).
+    struct Frame {
+        alignas(32) float quant[4][64]; ///< Cuantizacion inversa con la escala AAN y el 1/8, orden transpuesto.
+        bool quantDefined[4] = {};
+        Huffman dc[4];
+        Huffman ac[4];
+        unsigned int width = 0;
+        unsigned int height = 0;
+        unsigned int hMax = 1;
+        unsigned int vMax = 1;
+        unsigned int mcusX = 0;
+        unsigned int mcusY = 0;
+        unsigned int restartInterval = 0;
+        int adobeTransform = -1;
+        std::vector<Component> components;
+        std::vector<unsigned int> scan;  ///< Componentes del barrido, en su orden.
+    };
+
+    inline unsigned int loadBE16(const uint8_t* p) {
+        return (static_cast<unsigned int>(p[0]) << 8) | p[1];
+    }
+
+    /// IDCT 1D AAN flotante (jidctflt de libjpeg) sobre 8 vectores; cada lane es una columna o fila.
+    inline void idct8(FloatV* v) {
+        const FloatV sqrt2 = set1(1.414213562f);
+        FloatV tmp10 = add(v[0], v[4]);
+        FloatV tmp11 = sub(v[0], v[4]);
+        FloatV tmp13 = add(v[2], v[6]);
+        FloatV tmp12 = sub(mul(sub(v[2], v[6]), sqrt2), tmp13);
+        FloatV even0 = add(tmp10, tmp13);
+        FloatV even3 = sub(tmp10, tmp13);
+        FloatV even1 = add(tmp11, tmp12);
+        FloatV even2 = sub(tmp11, tmp12);
+
+        FloatV z13 = add(v[5], v[3]);
+        FloatV z10 = sub(v[5], v[3]);
+        FloatV z11 = add(v[1], v[7]);
+        FloatV z12 = sub(v[1], v[7]);
+        FloatV odd7 = add(z11, z13);
+        FloatV odd11 = mul(sub(z11, z13), sqrt2);
+        FloatV z5 = mul(add(z10, z12), set1(1.847759065f));
+        FloatV odd10 = sub(mul(z12, set1(1.082392200f)), z5);
+        FloatV odd12 = madd(z10, set1(-2.613125930f), z5);
+        FloatV odd6 = sub(odd12, odd7);
+        FloatV odd5 = sub(odd11, odd6);
+        FloatV odd4 = add(odd10, odd5);
+
+        v[0] = add(even0, odd7);
+        v[7] = sub(even0, odd7);
+        v[1] = add(even1, odd6);
+        v[6] = sub(even1, odd6);
+        v[2] = add(even2, odd5);
+        v[5] = sub(even2, odd5);
+        v[4] = add(even3, odd4);
+        v[3] = sub(even3, odd4);
+    }
+
+    /**
+     * IDCT 8x8 de @p block (descuantizado y transpuesto) hacia @p out. La primera pasada
+     * transforma las filas con SIMD_LANES filas por vector y se guarda transpuesta; la segunda
+     * transforma las columnas con SIMD_LANES pixeles contiguos por vector, que se escriben
+     * directo como bytes.
+     */
+    void idctBlock(const float* block, uint8_t* out, unsigned int stride) {
+        alignas(32) float work[64];
+        alignas(32) float lanes[SIMD_LANES];
+        FloatV v[8];
+
+        for (unsigned int r0 = 0; r0 < 8; r0 += SIMD_LANES) {
+            for (unsigned int u = 0; u < 8; ++u) {
+                v[u] = load(block + u * 8 + r0);
+            }
+            idct8(v);
+            for (unsigned int x = 0; x < 8; ++x) {
+                store(lanes, v[x]);
+                for (unsigned int l = 0; l < SIMD_LANES; ++l) {
+                    work[(r0 + l) * 8 + x] = lanes[l];
+                }
+            }
+        }
+
+        // +128 del nivel y +0.5 para redondear al truncar.
+        const FloatV bias = set1(128.5f);
+        const FloatV low = zero();
+        const FloatV high = set1(255.0f);
+        for (unsigned int x0 = 0; x0 < 8; x0 += SIMD_LANES) {
+            for (unsigned int r = 0; r < 8; ++r) {
+                v[r] = load(work + r * 8 + x0);
+            }
+            idct8(v);
+            for (unsigned int y = 0; y < 8; ++y) {
+                storeBytes(out + y * stride + x0, min(max(add(v[y], bias), low), high));
+            }
+        }
+    }
+
+    /// Bloque con solo DC: todos los pixeles valen lo mismo.
+    void fillBlock(float dc, uint8_t* out, unsigned int stride) {
+        float value = dc + 128.5f;
+        value = value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+        uint8_t pixel = static_cast<uint8_t>(value);
+        for (unsigned int y = 0; y < 8; ++y) {
+            memset(out + y * stride, pixel, 8);
+        }
+    }
+
+    /// Decodifica un bloque y lo escribe en @p out.
+    bool decodeBlock(BitReader& bits, const Huffman& dc, const Huffman& ac, const float* quant,
+                     int& predictor, uint8_t* out, unsigned int stride) {
+        alignas(32) float block[64];
+
+        if (bits.count < 32) {
+            bits.refill();
+        }
+        int category = bits.decode(dc);
+        if (category < 0 || category > 11) {
+            return false;
+        }
+        if (category) {
+            predictor += bits.extend(static_cast<unsigned int>(category));
+        }
+
+        memset(block, 0, sizeof(block));
+        block[0] = static_cast<float>(predictor) * quant[0];
+        bool hasAc = false;
+        unsigned int k = 1;
+        do {
+            if (bits.count < 32) {
+                bits.refill();
+            }
+            int fast = ac.fastAc[bits.buffer >> (64 - FAST_BITS)];
+            if (fast) {
+                k += (fast >> 4) & 15;
+                unsigned int length = fast & 15;
+                bits.buffer <<= length;
+                bits.count -= length;
+                unsigned int position = ZIGZAG[k++];
+                block[position] = static_cast<float>(fast >> 8) * quant[position];
+                hasAc = true;
+                continue;
+            }
+            int symbol = bits.decode(ac);
+            if (symbol < 0) {
+                return false;
+            }
+            unsigned int magnitude = symbol & 15;
+            unsigned int run = static_cast<unsigned int>(symbol) >> 4;
+            if (magnitude == 0) {
+                if (run != 15) {
+                    break;
+                }
+                k += 16;
+                continue;
+            }
+            k += run;
+            unsigned int position = ZIGZAG[k++];
+            block[position] = static_cast<float>(bits.extend(magnitude)) * quant[position];
+            hasAc = true;
+        } while (k < 64);
+
+        if (hasAc) {
+            idctBlock(block, out, stride);
+        }
+        else {
+            fillBlock(block[0], out, stride);
+        }
+        return true;
+    }
+
+    /// Decodifica los MCU [@p first, @p first + @p count) de un intervalo de reinicio.
+    bool decodeInterval(Frame& frame, const uint8_t* begin, const uint8_t* end,
+                        unsigned int first, unsigned int count) {
+        BitReader bits(begin, end);
+        int predictors[3] = { 0, 0, 0 };
+
+        if (frame.scan.size() == 1) {
+            // Barrido de un componente: un bloque por MCU, sin el relleno del MCU.
+            Component& c = frame.components[frame.scan[0]];
+            unsigned int blocksX = (c.width + 7) / 8;
+            for (unsigned int m = first; m < first + count; ++m) {
+                unsigned int bx = m % blocksX;
+                unsigned int by = m / blocksX;
+                uint8_t* out = c.plane.data() + static_cast<size_t>(by) * 8 * c.stride + bx * 8;
+                if (!decodeBlock(bits, frame.dc[c.dcTable], frame.ac[c.acTable], frame.quant[c.quant],
+                                 predictors[0], out, c.stride)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        for (unsigned int m = first; m < first + count; ++m) {
+            unsigned int mx = m % frame.mcusX;
+            unsigned int my = m / frame.mcusX;
+            for (size_t s = 0; s < frame.scan.size(); ++s) {
+                Component& c = frame.components[frame.scan[s]];
+                for (unsigned int v = 0; v < c.v; ++v) {
+                    for (unsigned int h = 0; h < c.h; ++h) {
+                        unsigned int bx = mx * c.h + h;
+                        unsigned int by = my * c.v + v;
+                        uint8_t* out = c.plane.data() + static_cast<size_t>(by) * 8 * c.stride + bx * 8;
+                        if (!decodeBlock(bits, frame.dc[c.dcTable], frame.ac[c.acTable], frame.quant[c.quant],
+                                         predictors[s], out, c.stride)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Busca los marcadores de reinicio entre @p begin y el fin del barrido.
+     * @param starts Recibe el inicio de cada intervalo y, al final, el fin del barrido.
+     * @return Posicion del marcador que termina el barrido.
+     */
+    const uint8_t* findIntervals(const uint8_t* begin, const uint8_t* end, std::vector<const uint8_t*>& starts) {
+        starts.push_back(begin);
+        const uint8_t* p = begin;
+        while (p + 1 < end) {
+            const uint8_t* marker = static_cast<const uint8_t*>(memchr(p, 0xff, static_cast<size_t>(end - p - 1)));
+            if (!marker) {
+                break;
+            }
+            uint8_t next = marker[1];
+            if (next == 0x00 || next == 0xff) {
+                p = marker + 1 + (next == 0x00);
+                continue;
+            }
+            if (next >= 0xd0 && next <= 0xd7) {
+                starts.push_back(marker + 2);
+                p = marker + 2;
+                continue;
+            }
+            starts.push_back(marker);
+            return marker;
+        }
+        starts.push_back(end);
+        return end;
+    }
+
+    /// Decodifica el barrido que empieza en @p begin; devuelve el marcador que lo termina.
+    HRESULT decodeScan(Frame& frame, const uint8_t* begin, const uint8_t* end, JobSystem* jobs, const uint8_t*& scanEnd) {
+        unsigned int total;
+        if (frame.scan.size() == 1) {
+            const Component& c = frame.components[frame.scan[0]];
+            total = ((c.width + 7) / 8) * ((c.height + 7) / 8);
+        }
+        else {
+            total = frame.mcusX * frame.mcusY;
+        }
+
+        std::vector<const uint8_t*> starts;
+        scanEnd = findIntervals(begin, end, starts);
+        unsigned int intervals = static_cast<unsigned int>(starts.size() - 1);
+        unsigned int perInterval = frame.restartInterval ? frame.restartInterval : total;
+        if (!frame.restartInterval) {
+            intervals = 1;
+            starts[1] = scanEnd;
+        }
+
+        std::atomic<bool> failed(false);
+        auto decodeRange = [&](unsigned int first, unsigned int last, unsigned int) {
+            for (unsigned int i = first; i < last && !failed.load(std::memory_order_relaxed); ++i) {
+                unsigned int mcu = i * perInterval;
+                if (mcu >= total) {
+                    break;
+                }
+                unsigned int count = std::min(perInterval, total - mcu);
+                if (!decodeInterval(frame, starts[i], starts[i + 1], mcu, count)) {
+                    failed = true;
+                }
+            }
+        };
+
+        if (jobs && intervals > 1) {
+            // Unos 1024 MCU por tarea para que los intervalos cortos no se vuelvan puro despacho.
+            unsigned int grain = std::max(1u, 1024u / perInterval);
+            jobs->parallelFor(intervals, grain, decodeRange);
+        }
+        else {
+            decodeRange(0, intervals, 0);
+        }
+        return failed ? E_FAIL : S_OK;
+    }
+
+    inline uint8_t div4(int x) { return static_cast<uint8_t>(x >> 2); }
+    inline uint8_t div16(int x) { return static_cast<uint8_t>(x >> 4); }
+
+    /**
+     * Fila @p y del componente @p c a resolucion completa. 2x1, 1x2 y 2x2 usan el filtro
+     * triangular de stb_image (3/4 de la muestra cercana y 1/4 de la lejana); las demas
+     * proporciones repiten la muestra.
+     */
+    const uint8_t* upsampleRow(const Frame& frame, const Component& c, unsigned int y, uint8_t* scratch) {
+        unsigned int hs = frame.hMax / c.h;
+        unsigned int vs = frame.vMax / c.v;
+        if (hs == 1 && vs == 1) {
+            return c.plane.data() + static_cast<size_t>(y) * c.stride;
+        }
+
+        unsigned int w = c.width;
+        if ((hs == 1 || hs == 2) && (vs == 1 || vs == 2)) {
+            unsigned int nearRow = vs == 2 ? y >> 1 : y;
+            int farRow = vs == 2 ? ((y & 1) ? static_cast<int>(nearRow) + 1 : static_cast<int>(nearRow) - 1) : static_cast<int>(nearRow);
+            farRow = std::max(0, std::min(farRow, static_cast<int>(c.height) - 1));
+            const uint8_t* near = c.plane.data() + static_cast<size_t>(nearRow) * c.stride;
+            const uint8_t* far = c.plane.data() + static_cast<size_t>(farRow) * c.stride;
+
+            if (hs == 1) {
+                for (unsigned int i = 0; i < w; ++i) {
+                    scratch[i] = div4(3 * near[i] + far[i] + 2);
+                }
+                return scratch;
+            }
+            if (vs == 1) {
+                if (w == 1) {
+                    scratch[0] = scratch[1] = near[0];
+                    return scratch;
+                }
+                scratch[0] = near[0];
+                scratch[1] = div4(near[0] * 3 + near[1] + 2);
+                unsigned int i = 1;
+                for (; i < w - 1; ++i) {
+                    int n = 3 * near[i] + 2;
+                    scratch[i * 2] = div4(n + near[i - 1]);
+                    scratch[i * 2 + 1] = div4(n + near[i + 1]);
+                }
+                scratch[i * 2] = div4(near[w - 2] * 3 + near[w - 1] + 2);
+                scratch[i * 2 + 1] = near[w - 1];
+                return scratch;
+            }
+            int t1 = 3 * near[0] + far[0];
+            if (w == 1) {
+                scratch[0] = scratch[1] = div4(t1 + 2);
+                return scratch;
+            }
+            scratch[0] = div4(t1 + 2);
+            for (unsigned int i = 1; i < w; ++i) {
+                int t0 = t1;
+                t1 = 3 * near[i] + far[i];
+                scratch[i * 2 - 1] = div16(3 * t0 + t1 + 8);
+                scratch[i * 2] = div16(3 * t1 + t0 + 8);
+            }
+            scratch[w * 2 - 1] = div4(t1 + 2);
+            return scratch;
+        }
+
+        const uint8_t* row = c.plane.data() + static_cast<size_t>(std::min(y / vs, c.height - 1)) * c.stride;
+        for (unsigned int x = 0; x < frame.width; ++x) {
+            scratch[x] = row[x / hs];
+        }
+        return scratch;
+    }
+
+    /**
+     * YCbCr (JFIF) a RGBA con FloatV; @p gray repite Y. Las filas de entrada se pueden leer
+     * hasta el siguiente multiplo de SIMD_LANES; el ultimo tramo se escribe por separado.
+     */
+    void convertRow(const uint8_t* yRow, const uint8_t* cbRow, const uint8_t* crRow, uint8_t* out,
+                    unsigned int width, bool gray) {
+        const FloatV half = set1(0.5f);
+        const FloatV center = set1(128.0f);
+        const FloatV crToR = set1(1.402f);
+        const FloatV cbToG = set1(-0.344136f);
+        const FloatV crToG = set1(-0.714136f);
+        const FloatV cbToB = set1(1.772f);
+        const FloatV low = zero();
+        const FloatV high = set1(255.0f);
+        const FloatV alpha = set1(255.0f);
+
+        alignas(32) uint8_t tail[SIMD_LANES * 4];
+        for (unsigned int x = 0; x < width; x += SIMD_LANES) {
+            uint8_t* target = (x + SIMD_LANES <= width) ? out + static_cast<size_t>(x) * 4 : tail;
+            FloatV y = loadBytes(yRow + x);
+            if (gray) {
+                storeRgba(target, y, y, y, alpha);
+            }
+            else {
+                y = add(y, half);
+                FloatV cb = sub(loadBytes(cbRow + x), center);
+                FloatV cr = sub(loadBytes(crRow + x), center);
+                FloatV r = min(max(madd(cr, crToR, y), low), high);
+                FloatV g = min(max(madd(cb, cbToG, madd(cr, crToG, y)), low), high);
+                FloatV b = min(max(madd(cb, cbToB, y), low), high);
+                storeRgba(target, r, g, b, alpha);
+            }
+            if (target == tail) {
+                memcpy(out + static_cast<size_t>(x) * 4, tail, static_cast<size_t>(width - x) * 4);
+            }
+        }
+    }
+
+    /// Factores de la IDCT AAN: 1 y cos(k * pi / 16) * sqrt(2).
+    const float AAN_SCALE[8] = { 1.0f, 1.387039845f, 1.306562965f, 1.175875602f,
+                                 1.0f, 0.785694958f, 0.541196100f, 0.275899379f };
+
+    /// Lee los marcadores hasta el primer barrido y lo decodifica.
+    HRESULT decodeFrame(Frame& frame, const uint8_t* data, size_t size, JobSystem* jobs) {
+        const uint8_t* p = data + 2;
+        const uint8_t* end = data + size;
+        bool frameSeen = false;
+        bool scanDone = false;
+
+        while (p < end) {
+            if (*p != 0xff) {
+                ++p;
+                continue;
+            }
+            while (p < end && *p == 0xff) {
+                ++p;
+            }
+            if (p >= end) {
+                break;
+            }
+            unsigned int marker = *p++;
+            if (marker == 0xd9) {
+                break;
+            }
+            if (marker == 0xd8 || (marker >= 0xd0 && marker <= 0xd7) || marker == 0x01) {
+                continue;
+            }
+            if (end - p < 2) {
+                return E_FAIL;
+            }
+            unsigned int length = loadBE16(p);
+            if (length < 2 || static_cast<size_t>(end - p) < length) {
+                return E_FAIL;
+            }
+            const uint8_t* segment = p + 2;
+            const uint8_t* segmentEnd = p + length;
+            p = segmentEnd;
+
+            switch (marker) {
+            case 0xdb: {
+                const uint8_t* q = segment;
+                while (q < segmentEnd) {
+                    unsigned int precision = *q >> 4;
+                    unsigned int id = *q & 15u;
+                    ++q;
+                    if (id > 3 || precision > 1 || segmentEnd - q < (precision ? 128 : 64)) {
+                        return E_FAIL;
+                    }
+                    for (unsigned int i = 0; i < 64; ++i) {
+                        unsigned int value = precision ? loadBE16(q + i * 2) : q[i];
+                        unsigned int position = ZIGZAG[i];
+                        frame.quant[id][position] = static_cast<float>(value) *
+                            AAN_SCALE[position >> 3] * AAN_SCALE[position & 7] * 0.125f;
+                    }
+                    q += precision ? 128 : 64;
+                    frame.quantDefined[id] = true;
+                }
+                break;
+            }
+            case 0xc4: {
+                const uint8_t* q = segment;
+                while (q < segmentEnd) {
+                    if (segmentEnd - q < 17) {
+                        return E_FAIL;
+                    }
+                    unsigned int tableClass = *q >> 4;
+                    unsigned int id = *q & 15u;
+                    const uint8_t* counts = q + 1;
+                    unsigned int total = 0;
+                    for (unsigned int i = 0; i < 16; ++i) {
+                        total += counts[i];
+                    }
+                    q += 17;
+                    if (tableClass > 1 || id > 3 || total > 256 || static_cast<unsigned int>(segmentEnd - q) < total) {
+                        return E_FAIL;
+                    }
+                    Huffman& table = tableClass ? frame.ac[id] : frame.dc[id];
+                    if (!table.build(counts, q)) {
+                        return E_FAIL;
+                    }
+                    q += total;
+                }
+                break;
+            }
+            case 0xdd:
+                if (length != 4) {
+                    return E_FAIL;
+                }
+                frame.restartInterval = loadBE16(segment);
+                break;
+            case 0xee:
+                if (length >= 14 && memcmp(segment, "Adobe", 5) == 0) {
+                    frame.adobeTransform = segment[11];
+                }
+                break;
+            case 0xc0:
+            case 0xc1: {
+                if (frameSeen || length < 8) {
+                    return E_FAIL;
+                }
+                unsigned int precision = segment[0];
+                frame.height = loadBE16(segment + 1);
+                frame.width = loadBE16(segment + 3);
+                unsigned int count = segment[5];
+                if (precision != 8 || frame.height == 0 || (count != 1 && count != 3)) {
+                    return E_NOTIMPL;
+                }
+                if (frame.width == 0 || length != 8 + 3 * count) {
+                    return E_FAIL;
+                }
+                frame.components.resize(count);
+                for (unsigned int i = 0; i < count; ++i) {
+                    Component& c = frame.components[i];
+                    c.id = segment[6 + i * 3];
+                    c.h = segment[7 + i * 3] >> 4;
+                    c.v = segment[7 + i * 3] & 15u;
+                    c.quant = segment[8 + i * 3];
+                    if (c.h < 1 || c.h > 4 || c.v < 1 || c.v > 4 || c.quant > 3) {
+                        return E_FAIL;
+                    }
+                    frame.hMax = std::max(frame.hMax, c.h);
+                    frame.vMax = std::max(frame.vMax, c.v);
+                }
+                if (count == 3 && (frame.components[0].id == 'R' && frame.components[1].id == 'G' && frame.components[2].id == 'B')) {
+                    return E_NOTIMPL;
+                }
+                frame.mcusX = (frame.width + frame.hMax * 8 - 1) / (frame.hMax * 8);
+                frame.mcusY = (frame.height + frame.vMax * 8 - 1) / (frame.vMax * 8);
+                for (Component& c : frame.components) {
+                    if (frame.hMax % c.h != 0 || frame.vMax % c.v != 0) {
+                        return E_NOTIMPL;
+                    }
+                    c.width = (frame.width * c.h + frame.hMax - 1) / frame.hMax;
+                    c.height = (frame.height * c.v + frame.vMax - 1) / frame.vMax;
+                    c.stride = frame.mcusX * c.h * 8;
+                    c.plane.resize(static_cast<size_t>(c.stride) * frame.mcusY * c.v * 8);
+                }
+                frameSeen = true;
+                break;
+            }
+            case 0xda: {
+                if (!frameSeen) {
+                    return E_FAIL;
+                }
+                if (scanDone) {
+                    // Varios barridos baseline (componentes sin intercalar): lo resuelve stb_image.
+                    return E_NOTIMPL;
+                }
+                unsigned int count = segment[0];
+                if (count != frame.components.size() || length != 6 + 2 * count) {
+                    return count < 1 || count > 4 ? E_FAIL : E_NOTIMPL;
+                }
+                frame.scan.clear();
+                for (unsigned int i = 0; i < count; ++i) {
+                    unsigned int id = segment[1 + i * 2];
+                    unsigned int tables = segment[2 + i * 2];
+                    unsigned int index = 0;
+                    while (index < frame.components.size() && frame.components[index].id != id) {
+                        ++index;
+                    }
+                    if (index == frame.components.size()) {
+                        return E_FAIL;
+                    }
+                    Component& c = frame.components[index];
+                    c.dcTable = tables >> 4;
+                    c.acTable = tables & 15u;
+                    if (c.dcTable > 3 || c.acTable > 3 || !frame.dc[c.dcTable].defined ||
+                        !frame.ac[c.acTable].defined || !frame.quantDefined[c.quant]) {
+                        return E_FAIL;
+                    }
+                    frame.scan.push_back(index);
+                }
+                if (count == 3 && frame.adobeTransform == 0) {
+                    return E_NOTIMPL;
+                }
+
+                const uint8_t* scanEnd = nullptr;
+                HRESULT hr = decodeScan(frame, segmentEnd, end, jobs, scanEnd);
+                if (FAILED(hr)) {
+                    return hr;
+                }
+                p = scanEnd;
+                scanDone = true;
+                break;
+            }
+            case 0xc2: case 0xc3: case 0xc5: case 0xc6: case 0xc7:
+            case 0xc9: case 0xca: case 0xcb: case 0xcd: case 0xce: case 0xcf:
+            case 0xdc:
+                // Progresivo, sin perdida, jerarquico, aritmetico o DNL.
+                return E_NOTIMPL;
+            default:
+                break;
+            }
+        }
+        return scanDone ? S_OK : E_FAIL;
+    }
+}
+
+bool
+JpegDecoder::canDecode(const unsigned char* data, size_t size) const {
+    return size >= 4 && data[0] == 0xff && data[1] == 0xd8 && data[2] == 0xff;
+}
+
+HRESULT
+JpegDecoder::getInfo(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height) const {
+    if (!canDecode(data, size)) {
+        return E_FAIL;
+    }
+
+    // Segmentos hasta el primer SOF (cualquier tipo: las dimensiones no dependen del proceso).
+    const uint8_t* p = data + 2;
+    const uint8_t* end = data + size;
+    while (end - p >= 4) {
+        if (p[0] != 0xff) {
+            return E_FAIL;
+        }
+        unsigned int marker = p[1];
+        if (marker == 0xff) {
+            ++p;
+            continue;
+        }
+        unsigned int length = loadBE16(p + 2);
+        if (length < 2 || static_cast<size_t>(end - p - 2) < length) {
+            return E_FAIL;
+        }
+        const bool isFrame = marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc;
+        if (isFrame) {
+            if (length < 8) {
+                return E_FAIL;
+            }
+            height = loadBE16(p + 5);
+            width = loadBE16(p + 7);
+            return width != 0 && height != 0 ? S_OK : E_FAIL;
+        }
+        p += 2 + length;
+    }
+    return E_FAIL;
+}
+
+HRESULT
+JpegDecoder::decodeInto(const unsigned char* data, size_t size, const ImageView& target, JobSystem* jobs) const {
+    if (!canDecode(data, size)) {
+        return E_FAIL;
+    }
+
+    std::unique_ptr<Frame> frame(new Frame());
+    HRESULT hr = decodeFrame(*frame, data, size, jobs);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    if (frame->width != target.width || frame->height != target.height) {
+        return E_FAIL;
+    }
+
+    const Frame& f = *frame;
+    auto convert = [&](unsigned int begin, unsigned int end, unsigned int) {
+        size_t scratchSize = static_cast<size_t>(f.width) * 2 + 16;
+        std::vector<uint8_t> scratch(scratchSize * f.components.size());
+        for (unsigned int y = begin; y < end; ++y) {
+            uint8_t* out = target.row(y);
+            const uint8_t* luma = upsampleRow(f, f.components[0], y, scratch.data());
+            if (f.components.size() == 1) {
+                convertRow(luma, nullptr, nullptr, out, f.width, true);
+                continue;
+            }
+            const uint8_t* cb = upsampleRow(f, f.components[1], y, scratch.data() + scratchSize);
+            const uint8_t* cr = upsampleRow(f, f.components[2], y, scratch.data() + scratchSize * 2);
+            convertRow(luma, cb, cr, out, f.width, false);
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(f.height, 32, convert);
+    }
+    else {
+        convert(0, f.height, 0);
+    }
+    return S_OK;
+}
@@ -0,0 +1,85 @@
+#include "MappedFile.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+HRESULT
+MappedFile::init(const std::string& fileName) {
+    destroy();
+
+#if defined(_WIN32)
+    m_file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        ERROR("MappedFile", "init", ("Could not open file: " + fileName).c_str());
+        return E_FAIL;
+    }
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+        ERROR("MappedFile", "init", ("File is empty: " + fileName).c_str());
+        destroy();
+        return E_FAIL;
+    }
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        ERROR("MappedFile", "init", ("Could not map file: " + fileName).c_str());
+        destroy();
+        return E_FAIL;
+    }
+    m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) {
+        ERROR("MappedFile", "init", ("Could not map file: " + fileName).c_str());
+        destroy();
+        return E_FAIL;
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ERROR("MappedFile", "init", ("Could not open file: " + fileName).c_str());
+        return E_FAIL;
+    }
+    struct stat info = {};
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ERROR("MappedFile", "init", ("File is empty: " + fileName).c_str());
+        close(fd);
+        return E_FAIL;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // La proyeccion mantiene su propia referencia al archivo.
+    if (data == MAP_FAILED) {
+        ERROR("MappedFile", "init", ("Could not map file: " + fileName).c_str());
+        return E_FAIL;
+    }
+    m_data = static_cast<const unsigned char*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+    return S_OK;
+}
+
+void
+MappedFile::destroy() {
+#if defined(_WIN32)
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_data) {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
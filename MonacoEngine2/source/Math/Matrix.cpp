@@ -0,0 +1,123 @@
+#include "Math/Matrix.h"
+
+namespace math {
+    Matrix4
+    inverse(const Matrix4& a, float* determinant) {
+        // Adjunta por cofactores 2x2 de las dos mitades de filas (mismo orden de operaciones
+        // que la version escalar de XMMatrixInverse).
+        const float* m = &a.m[0][0];
+        const float s0 = m[0] * m[5] - m[4] * m[1];
+        const float s1 = m[0] * m[6] - m[4] * m[2];
+        const float s2 = m[0] * m[7] - m[4] * m[3];
+        const float s3 = m[1] * m[6] - m[5] * m[2];
+        const float s4 = m[1] * m[7] - m[5] * m[3];
+        const float s5 = m[2] * m[7] - m[6] * m[3];
+        const float c5 = m[10] * m[15] - m[14] * m[11];
+        const float c4 = m[9] * m[15] - m[13] * m[11];
+        const float c3 = m[9] * m[14] - m[13] * m[10];
+        const float c2 = m[8] * m[15] - m[12] * m[11];
+        const float c1 = m[8] * m[14] - m[12] * m[10];
+        const float c0 = m[8] * m[13] - m[12] * m[9];
+
+        const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (determinant) {
+            *determinant = det;
+        }
+        const float inv = 1.0f / det;
+
+        return Matrix4(( m[5] * c5 - m[6] * c4 + m[7] * c3) * inv,
+                       (-m[1] * c5 + m[2] * c4 - m[3] * c3) * inv,
+                       ( m[13] * s5 - m[14] * s4 + m[15] * s3) * inv,
+                       (-m[9] * s5 + m[10] * s4 - m[11] * s3) * inv,
+
+                       (-m[4] * c5 + m[6] * c2 - m[7] * c1) * inv,
+                       ( m[0] * c5 - m[2] * c2 + m[3] * c1) * inv,
+                       (-m[12] * s5 + m[14] * s2 - m[15] * s1) * inv,
+                       ( m[8] * s5 - m[10] * s2 + m[11] * s1) * inv,
+
+                       ( m[4] * c4 - m[5] * c2 + m[7] * c0) * inv,
+                       (-m[0] * c4 + m[1] * c2 - m[3] * c0) * inv,
+                       ( m[12] * s4 - m[13] * s2 + m[15] * s0) * inv,
+                       (-m[8] * s4 + m[9] * s2 - m[11] * s0) * inv,
+
+                       (-m[4] * c3 + m[5] * c1 - m[6] * c0) * inv,
+                       ( m[0] * c3 - m[1] * c1 + m[2] * c0) * inv,
+                       (-m[12] * s3 + m[13] * s1 - m[14] * s0) * inv,
+                       ( m[8] * s3 - m[9] * s1 + m[10] * s0) * inv);
+    }
+
+    Matrix4
+    rotationX(float angle) {
+        const float s = sinf(angle), c = cosf(angle);
+        return Matrix4(1.0f, 0.0f, 0.0f, 0.0f,
+                       0.0f, c, s, 0.0f,
+                       0.0f, -s, c, 0.0f,
+                       0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    Matrix4
+    rotationY(float angle) {
+        const float s = sinf(angle), c = cosf(angle);
+        return Matrix4(c, 0.0f, -s, 0.0f,
+                       0.0f, 1.0f, 0.0f, 0.0f,
+                       s, 0.0f, c, 0.0f,
+                       0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    Matrix4
+    rotationZ(float angle) {
+        const float s = sinf(angle), c = cosf(angle);
+        return Matrix4(c, s, 0.0f, 0.0f,
+                       -s, c, 0.0f, 0.0f,
+                       0.0f, 0.0f, 1.0f, 0.0f,
+                       0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    Matrix4
+    lookAtLH(const Vector3& eye, const Vector3& focus, const Vector3& up) {
+        return lookToLH(eye, focus - eye, up);
+    }
+
+    Matrix4
+    lookToLH(const Vector3& eye, const Vector3& direction, const Vector3& up) {
+        const Vector3 axisZ = normalize(direction);
+        const Vector3 axisX = normalize(cross(up, axisZ));
+        const Vector3 axisY = cross(axisZ, axisX);
+        return Matrix4(axisX.x, axisY.x, axisZ.x, 0.0f,
+                       axisX.y, axisY.y, axisZ.y, 0.0f,
+                       axisX.z, axisY.z, axisZ.z, 0.0f,
+                       -dot(axisX, eye), -dot(axisY, eye), -dot(axisZ, eye), 1.0f);
+    }
+
+    Matrix4
+    perspectiveFovLH(float fovAngleY, float aspectRatio, float nearZ, float farZ) {
+        const float height = cosf(fovAngleY * 0.5f) / sinf(fovAngleY * 0.5f);
+        const float width = height / aspectRatio;
+        const float range = farZ / (farZ - nearZ);
+        return Matrix4(width, 0.0f, 0.0f, 0.0f,
+                       0.0f, height, 0.0f, 0.0f,
+                       0.0f, 0.0f, range, 1.0f,
+                       0.0f, 0.0f, -range * nearZ, 0.0f);
+    }
+
+    Matrix4
+    orthographicLH(float viewWidth, float viewHeight, float nearZ, float farZ) {
+        const float range = 1.0f / (farZ - nearZ);
+        return Matrix4(2.0f / viewWidth, 0.0f, 0.0f, 0.0f,
+                       0.0f, 2.0f / viewHeight, 0.0f, 0.0f,
+                       0.0f, 0.0f, range, 0.0f,
+                       0.0f, 0.0f, -range * nearZ, 1.0f);
+    }
+
+    void
+    transformStream(const Vector3* input, size_t inputStride, Vector4* output, size_t count, const Matrix4& m) {
+        using namespace simd;
+        const Float4 r0 = load4(m.m[0]), r1 = load4(m.m[1]), r2 = load4(m.m[2]), r3 = load4(m.m[3]);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(input);
+        for (size_t i = 0; i < count; ++i, bytes += inputStride) {
+            const Vector3& p = *reinterpret_cast<const Vector3*>(bytes);
+            Float4 h = madd4(splat4(p.x), r0, madd4(splat4(p.y), r1, madd4(splat4(p.z), r2, r3)));
+            store4(&output[i].x, h);
+        }
+    }
+}
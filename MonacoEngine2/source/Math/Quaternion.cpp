@@ -0,0 +1,41 @@
+#include "Math/Quaternion.h"
+
+namespace math {
+    Quaternion
+    rotationRollPitchYaw(float pitch, float yaw, float roll) {
+        const float sp = sinf(pitch * 0.5f), cp = cosf(pitch * 0.5f);
+        const float sy = sinf(yaw * 0.5f), cy = cosf(yaw * 0.5f);
+        const float sr = sinf(roll * 0.5f), cr = cosf(roll * 0.5f);
+        return Quaternion(cr * sp * cy + sr * cp * sy,
+                          cr * cp * sy - sr * sp * cy,
+                          sr * cp * cy - cr * sp * sy,
+                          cr * cp * cy + sr * sp * sy);
+    }
+
+    Quaternion
+    slerp(const Quaternion& q0, const Quaternion& q1, float t) {
+        // Mismo umbral que XNA: cerca de cos = 1 se interpola linealmente.
+        const float oneMinusEpsilon = 1.0f - 0.00001f;
+        float cosOmega = dot(q0, q1);
+        float sign = 1.0f;
+        if (cosOmega < 0.0f) {
+            cosOmega = -cosOmega;
+            sign = -1.0f;
+        }
+
+        float scale0, scale1;
+        if (cosOmega < oneMinusEpsilon) {
+            const float omega = acosf(cosOmega);
+            const float invSin = 1.0f / sinf(omega);
+            scale0 = sinf((1.0f - t) * omega) * invSin;
+            scale1 = sinf(t * omega) * invSin;
+        }
+        else {
+            scale0 = 1.0f - t;
+            scale1 = t;
+        }
+        scale1 *= sign;
+        return Quaternion(q0.x * scale0 + q1.x * scale1, q0.y * scale0 + q1.y * scale1,
+                          q0.z * scale0 + q1.z * scale1, q0.w * scale0 + q1.w * scale1);
+    }
+}
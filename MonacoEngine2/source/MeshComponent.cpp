@@ -0,0 +1,52 @@
+#include "MeshComponent.h"
+#include <cmath>
+
+namespace {
+    /// Caja y esfera de los vertices referenciados por indices[0, count).
+    void
+    boundsFromIndices(const std::vector<SimpleVertex>& vertices,
+                      const unsigned int* indices,
+                      unsigned int count,
+                      AABB& box,
+                      BoundingSphere& sphere) {
+        if (count == 0) {
+            box.min = box.max = Vector3(0.0f, 0.0f, 0.0f);
+            sphere.center = Vector3(0.0f, 0.0f, 0.0f);
+            sphere.radius = 0.0f;
+            return;
+        }
+
+        box.min = box.max = vertices[indices[0]].Pos;
+        for (unsigned int i = 1; i < count; ++i) {
+            const Vector3& p = vertices[indices[i]].Pos;
+            box.min = math::min(box.min, p);
+            box.max = math::max(box.max, p);
+        }
+
+        // Centro de la caja y radio al vertice mas lejano (mas ajustado que media diagonal).
+        sphere.center = (box.min + box.max) * 0.5f;
+        float radiusSq = 0.0f;
+        for (unsigned int i = 0; i < count; ++i) {
+            radiusSq = std::max(radiusSq, math::lengthSq(vertices[indices[i]].Pos - sphere.center));
+        }
+        sphere.radius = sqrtf(radiusSq);
+    }
+}
+
+void
+MeshComponent::computeBounds() {
+    if (m_subMeshes.empty()) {
+        SubMesh whole = {};
+        whole.name = m_name;
+        whole.startIndex = 0;
+        whole.indexCount = static_cast<unsigned int>(m_index.size());
+        m_subMeshes.push_back(whole);
+    }
+
+    for (SubMesh& subMesh : m_subMeshes) {
+        boundsFromIndices(m_vertex, m_index.data() + subMesh.startIndex, subMesh.indexCount,
+            subMesh.bounds, subMesh.sphere);
+    }
+    boundsFromIndices(m_vertex, m_index.data(), static_cast<unsigned int>(m_index.size()),
+        m_bounds, m_sphere);
+}
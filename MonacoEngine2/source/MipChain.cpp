@@ -0,0 +1,480 @@
+#include "MipChain.h"
+#include "ColorSpace.h"
+#include "JobSystem.h"
+#include "Simd.h"
+#include <mutex>
+
+using namespace simd;
+
+namespace {
+    const float KAISER_RADIUS = 3.0f;   // En pixeles del nivel destino.
+    const float KAISER_ALPHA = 4.0f;
+
+    /// Pesos de un eje: para cada pixel destino, @c taps indices de origen y sus pesos.
+    struct FilterTaps {
+        unsigned int taps = 0;
+        std::vector<unsigned int> index;
+        std::vector<float> weight;
+    };
+
+    /// Conversiones de 8 bits a lineal y de lineal de 16 bits a 8 bits (sRGB o lineal).
+    struct ColorTables {
+        float toLinear[256];
+        unsigned char fromLinear[65536];
+    };
+
+    /// Fila de origen en lineal, filas ya filtradas en horizontal y fila destino, por hilo.
+    thread_local std::vector<float> t_source;
+    thread_local std::vector<float> t_rows;
+    thread_local std::vector<float> t_output;
+
+    float
+    besselI0(float x) {
+        // Serie de potencias; converge rapido para los argumentos de la ventana (<= alfa).
+        float sum = 1.0f;
+        float term = 1.0f;
+        const float halfX = x * 0.5f;
+        for (int k = 1; k < 32; ++k) {
+            term *= halfX / static_cast<float>(k);
+            sum += term * term;
+            if (term * term < sum * 1.0e-8f) {
+                break;
+            }
+        }
+        return sum;
+    }
+
+    float
+    kaiser(float x) {
+        if (fabsf(x) >= KAISER_RADIUS) {
+            return 0.0f;
+        }
+        const float ratio = x / KAISER_RADIUS;
+        const float window = besselI0(KAISER_ALPHA * sqrtf(1.0f - ratio * ratio)) / besselI0(KAISER_ALPHA);
+        const float px = MATH_PI * x;
+        const float sinc = fabsf(x) < 1.0e-5f ? 1.0f : sinf(px) / px;
+        return sinc * window;
+    }
+
+    void
+    buildTaps(unsigned int src, unsigned int dst, MipFilter filter, FilterTaps& out) {
+        if (src == dst) {
+            // Eje que ya llego a 1: copia directa.
+            out.taps = 1;
+            out.index.resize(dst);
+            out.weight.assign(dst, 1.0f);
+            for (unsigned int i = 0; i < dst; ++i) {
+                out.index[i] = i;
+            }
+            return;
+        }
+
+        const float scale = static_cast<float>(src) / static_cast<float>(dst);
+        std::vector<std::vector<std::pair<unsigned int, float>>> perPixel(dst);
+        out.taps = 0;
+        for (unsigned int i = 0; i < dst; ++i) {
+            std::vector<std::pair<unsigned int, float>>& taps = perPixel[i];
+            float total = 0.0f;
+            if (filter == MipFilter::Box) {
+                // Fraccion de cada texel de origen dentro del pixel destino [i, i + 1) * scale.
+                const float begin = i * scale;
+                const float end = (i + 1) * scale;
+                for (unsigned int s = static_cast<unsigned int>(begin); static_cast<float>(s) < end && s < src; ++s) {
+                    const float overlap = std::min(end, s + 1.0f) - std::max(begin, static_cast<float>(s));
+                    if (overlap > 1.0e-6f) {
+                        taps.push_back({ s, overlap });
+                        total += overlap;
+                    }
+                }
+            }
+            else {
+                const float center = (i + 0.5f) * scale;
+                const float radius = KAISER_RADIUS * scale;
+                const int first = static_cast<int>(floorf(center - radius));
+                const int last = static_cast<int>(ceilf(center + radius));
+                for (int s = first; s <= last; ++s) {
+                    const float w = kaiser((s + 0.5f - center) / scale);
+                    if (w == 0.0f) {
+                        continue;
+                    }
+                    // Borde en modo clamp: los texeles de fuera suman al del borde.
+                    const unsigned int clamped = static_cast<unsigned int>(std::min(std::max(s, 0), static_cast<int>(src) - 1));
+                    if (!taps.empty() && taps.back().first == clamped) {
+                        taps.back().second += w;
+                    }
+                    else {
+                        taps.push_back({ clamped, w });
+                    }
+                    total += w;
+                }
+            }
+            for (std::pair<unsigned int, float>& tap : taps) {
+                tap.second /= total;
+            }
+            out.taps = std::max(out.taps, static_cast<unsigned int>(taps.size()));
+        }
+
+        // Tabla rectangular: los pixeles con menos pesos se rellenan con peso 0.
+        out.index.assign(static_cast<size_t>(dst) * out.taps, 0);
+        out.weight.assign(static_cast<size_t>(dst) * out.taps, 0.0f);
+        for (unsigned int i = 0; i < dst; ++i) {
+            const std::vector<std::pair<unsigned int, float>>& taps = perPixel[i];
+            for (unsigned int t = 0; t < out.taps; ++t) {
+                const size_t slot = static_cast<size_t>(i) * out.taps + t;
+                out.index[slot] = t < taps.size() ? taps[t].first : taps.back().first;
+                out.weight[slot] = t < taps.size() ? taps[t].second : 0.0f;
+            }
+        }
+    }
+
+    const ColorTables&
+    colorTables(bool srgb) {
+        static ColorTables tables[2];
+        static std::once_flag once;
+        std::call_once(once, []() {
+            for (int mode = 0; mode < 2; ++mode) {
+                ColorTables& table = tables[mode];
+                for (int i = 0; i < 256; ++i) {
+                    table.toLinear[i] = mode == 0 ? i / 255.0f : color::srgb8ToLinearTable()[i];
+                }
+                for (int i = 0; i < 65536; ++i) {
+                    const float l = i / 65535.0f;
+                    const float c = mode == 0 ? l : color::linearToSrgb(l);
+                    table.fromLinear[i] = static_cast<unsigned char>(std::min(255.0f, c * 255.0f + 0.5f));
+                }
+            }
+        });
+        return tables[srgb ? 1 : 0];
+    }
+
+    /// Nivel de origen: RGBA8 (nivel 0) o lineal de 16 bits (niveles ya filtrados).
+    struct LevelSource {
+        unsigned int width = 0;
+        unsigned int height = 0;
+        const ImageView* image = nullptr;
+        const uint16_t* linear = nullptr;
+    };
+
+    /// Convierte la fila @p y del origen a RGBA lineal en float.
+    void
+    loadRow(const LevelSource& source, unsigned int y, const ColorTables& tables, float* out) {
+        const unsigned int count = source.width * 4;
+        if (source.image) {
+            const unsigned char* row = source.image->row(y);
+            for (unsigned int i = 0; i < count; i += 4) {
+                out[i + 0] = tables.toLinear[row[i + 0]];
+                out[i + 1] = tables.toLinear[row[i + 1]];
+                out[i + 2] = tables.toLinear[row[i + 2]];
+                out[i + 3] = row[i + 3] * (1.0f / 255.0f);
+            }
+        }
+        else {
+            const uint16_t* row = source.linear + static_cast<size_t>(y) * count;
+            for (unsigned int i = 0; i < count; ++i) {
+                out[i] = row[i] * (1.0f / 65535.0f);
+            }
+        }
+    }
+
+    /// Filtra las filas destino [rowBegin, rowEnd) de @p dst.
+    void
+    filterRows(const LevelSource& source, const FilterTaps& tapsX, const FilterTaps& tapsY,
+               const ColorTables& tables, unsigned int rowBegin, unsigned int rowEnd,
+               const ImageView& dst, uint16_t* dstLinear) {
+        const unsigned int dstCount = dst.width * 4;
+
+        // Filas de origen que necesita este bloque.
+        unsigned int first = source.height;
+        unsigned int last = 0;
+        for (size_t slot = static_cast<size_t>(rowBegin) * tapsY.taps; slot < static_cast<size_t>(rowEnd) * tapsY.taps; ++slot) {
+            first = std::min(first, tapsY.index[slot]);
+            last = std::max(last, tapsY.index[slot]);
+        }
+        t_source.resize(static_cast<size_t>(source.width) * 4);
+        t_rows.resize(static_cast<size_t>(last - first + 1) * dstCount);
+        t_output.resize(dstCount);
+
+        // Horizontal primero, una vez por fila de origen: la pasada vertical recorre la mitad de datos.
+        // Un Float4 (RGBA) por pixel destino.
+        for (unsigned int y = first; y <= last; ++y) {
+            loadRow(source, y, tables, t_source.data());
+            const float* src = t_source.data();
+            float* row = t_rows.data() + static_cast<size_t>(y - first) * dstCount;
+            for (unsigned int x = 0; x < dst.width; ++x) {
+                const unsigned int* index = &tapsX.index[static_cast<size_t>(x) * tapsX.taps];
+                const float* weight = &tapsX.weight[static_cast<size_t>(x) * tapsX.taps];
+                Float4 sum = mul4(load4(src + index[0] * 4), splat4(weight[0]));
+                for (unsigned int t = 1; t < tapsX.taps; ++t) {
+                    sum = madd4(load4(src + index[t] * 4), splat4(weight[t]), sum);
+                }
+                store4(row + x * 4, sum);
+            }
+        }
+
+        const unsigned int vectorCount = dstCount - dstCount % SIMD_LANES;
+        for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+            // Vertical: combinacion de filas completas, SIMD_LANES floats por paso.
+            float* output = t_output.data();
+            const unsigned int* rowIndex = &tapsY.index[static_cast<size_t>(y) * tapsY.taps];
+            const float* rowWeight = &tapsY.weight[static_cast<size_t>(y) * tapsY.taps];
+            for (unsigned int t = 0; t < tapsY.taps; ++t) {
+                const float* row = t_rows.data() + static_cast<size_t>(rowIndex[t] - first) * dstCount;
+                const FloatV w = set1(rowWeight[t]);
+                unsigned int i = 0;
+                if (t == 0) {
+                    for (; i < vectorCount; i += SIMD_LANES) {
+                        store(output + i, mul(load(row + i), w));
+                    }
+                    for (; i < dstCount; ++i) {
+                        output[i] = row[i] * rowWeight[t];
+                    }
+                }
+                else {
+                    for (; i < vectorCount; i += SIMD_LANES) {
+                        store(output + i, madd(load(row + i), w, load(output + i)));
+                    }
+                    for (; i < dstCount; ++i) {
+                        output[i] += row[i] * rowWeight[t];
+                    }
+                }
+            }
+
+            // Los lobulos negativos de Kaiser pueden salir de [0, 1].
+            const FloatV zeroV = zero();
+            const FloatV oneV = set1(1.0f);
+            const FloatV scaleV = set1(65535.0f);
+            const FloatV halfV = set1(0.5f);
+            unsigned int i = 0;
+            for (; i < vectorCount; i += SIMD_LANES) {
+                store(output + i, madd(min(max(load(output + i), zeroV), oneV), scaleV, halfV));
+            }
+            for (; i < dstCount; ++i) {
+                output[i] = std::min(std::max(output[i], 0.0f), 1.0f) * 65535.0f + 0.5f;
+            }
+
+            unsigned char* dstRow = dst.row(y);
+            uint16_t* linearRow = dstLinear ? dstLinear + static_cast<size_t>(y) * dstCount : nullptr;
+            for (unsigned int c = 0; c < dstCount; c += 4) {
+                const uint16_t r = static_cast<uint16_t>(output[c + 0]);
+                const uint16_t g = static_cast<uint16_t>(output[c + 1]);
+                const uint16_t b = static_cast<uint16_t>(output[c + 2]);
+                const uint16_t a = static_cast<uint16_t>(output[c + 3]);
+                dstRow[c + 0] = tables.fromLinear[r];
+                dstRow[c + 1] = tables.fromLinear[g];
+                dstRow[c + 2] = tables.fromLinear[b];
+                dstRow[c + 3] = static_cast<unsigned char>((a * 255u + 32767u) / 65535u);
+                if (linearRow) {
+                    linearRow[c + 0] = r;
+                    linearRow[c + 1] = g;
+                    linearRow[c + 2] = b;
+                    linearRow[c + 3] = a;
+                }
+            }
+        }
+    }
+
+    /// Escala el alfa de @p image para que su cobertura sobre @p cutoff sea @p target.
+    void
+    scaleAlphaToCoverage(const ImageView& image, float cutoff, float target) {
+        unsigned int histogram[256] = {};
+        const size_t pixels = static_cast<size_t>(image.width) * image.height;
+        for (unsigned int y = 0; y < image.height; ++y) {
+            const unsigned char* row = image.row(y);
+            for (unsigned int x = 0; x < image.width; ++x) {
+                histogram[row[x * 4 + 3]]++;
+            }
+        }
+
+        const float threshold = cutoff * 255.0f;
+        auto scaled = [](int a, float scale) {
+            return std::min(255.0f, floorf(a * scale + 0.5f));
+        };
+        auto coverage = [&](float scale) {
+            size_t passed = 0;
+            for (int a = 0; a < 256; ++a) {
+                if (scaled(a, scale) > threshold) {
+                    passed += histogram[a];
+                }
+            }
+            return static_cast<float>(passed) / static_cast<float>(pixels);
+        };
+
+        // La cobertura crece con la escala: busqueda binaria.
+        float low = 0.0f;
+        float high = 4.0f;
+        while (coverage(high) < target && high < 256.0f) {
+            high *= 2.0f;
+        }
+        for (int step = 0; step < 16; ++step) {
+            const float mid = 0.5f * (low + high);
+            if (coverage(mid) < target) {
+                low = mid;
+            }
+            else {
+                high = mid;
+            }
+        }
+        const float scale = high;
+        if (fabsf(scale - 1.0f) < 1.0e-3f) {
+            return;
+        }
+
+        unsigned char remap[256];
+        for (int a = 0; a < 256; ++a) {
+            remap[a] = static_cast<unsigned char>(scaled(a, scale));
+        }
+        for (unsigned int y = 0; y < image.height; ++y) {
+            unsigned char* row = image.row(y);
+            for (unsigned int x = 0; x < image.width; ++x) {
+                row[x * 4 + 3] = remap[row[x * 4 + 3]];
+            }
+        }
+    }
+}
+
+unsigned int
+MipChain::fullLevelCount(unsigned int width, unsigned int height) {
+    unsigned int levels = 1;
+    unsigned int size = std::max(width, height);
+    while (size > 1) {
+        size >>= 1;
+        levels++;
+    }
+    return levels;
+}
+
+float
+MipChain::alphaCoverage(const Image& image, float cutoff) {
+    if (image.empty() || image.m_channels != 4) {
+        return 1.0f;
+    }
+    // Solo lectura: la vista no modifica los pixeles.
+    return alphaCoverage(ImageView{ const_cast<unsigned char*>(image.m_pixels.data()), image.m_width, image.m_height,
+                                    image.getPitch() }, cutoff);
+}
+
+float
+MipChain::alphaCoverage(const ImageView& image, float cutoff) {
+    if (image.empty()) {
+        return 1.0f;
+    }
+    const float threshold = cutoff * 255.0f;
+    size_t passed = 0;
+    for (unsigned int y = 0; y < image.height; ++y) {
+        const unsigned char* row = image.row(y);
+        for (unsigned int x = 0; x < image.width; ++x) {
+            passed += row[x * 4 + 3] > threshold ? 1 : 0;
+        }
+    }
+    return static_cast<float>(passed) / (static_cast<float>(image.width) * image.height);
+}
+
+size_t
+MipChain::scratchBytes(unsigned int width, unsigned int height, unsigned int levelCount) {
+    // Dos buffers lineales que se alternan: el nivel 1 y el nivel 2 son los mas grandes de cada paridad.
+    size_t bytes = 0;
+    for (unsigned int level = 1; level < 3 && level + 1 < levelCount; ++level) {
+        bytes += static_cast<size_t>(std::max(1u, width >> level)) * std::max(1u, height >> level) * 4 * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+HRESULT
+MipChain::generate(Image base, const MipSettings& settings) {
+    destroy();
+    if (base.empty() || base.m_channels != 4) {
+        ERROR("MipChain", "generate", "Base level must be a non-empty RGBA8 image.");
+        return E_INVALIDARG;
+    }
+
+    unsigned int levels = fullLevelCount(base.m_width, base.m_height);
+    if (settings.maxLevels > 0) {
+        levels = std::min(levels, settings.maxLevels);
+    }
+
+    m_levels.resize(levels);
+    m_levels[0] = std::move(base);
+    std::vector<ImageView> views(levels);
+    views[0] = m_levels[0].getView();
+    for (unsigned int level = 1; level < levels; ++level) {
+        HRESULT hr = m_levels[level].init(std::max(1u, views[level - 1].width / 2),
+            std::max(1u, views[level - 1].height / 2), 4);
+        if (FAILED(hr)) {
+            destroy();
+            return hr;
+        }
+        views[level] = m_levels[level].getView();
+    }
+
+    std::vector<uint16_t> scratch(scratchBytes(views[0].width, views[0].height, levels) / sizeof(uint16_t));
+    HRESULT hr = generateInto(views.data(), levels, scratch.data(), settings);
+    if (FAILED(hr)) {
+        destroy();
+    }
+    return hr;
+}
+
+HRESULT
+MipChain::generateInto(const ImageView* levels, unsigned int levelCount, void* scratch, const MipSettings& settings) {
+    if (!levels || levelCount == 0 || levels[0].empty()) {
+        ERROR("MipChain", "generateInto", "Base level must be a non-empty RGBA8 image.");
+        return E_INVALIDARG;
+    }
+    for (unsigned int level = 1; level < levelCount; ++level) {
+        if (levels[level].empty() || levels[level].width != std::max(1u, levels[level - 1].width / 2) ||
+            levels[level].height != std::max(1u, levels[level - 1].height / 2)) {
+            ERROR("MipChain", "generateInto", "Each level must be half the size of the previous one.");
+            return E_INVALIDARG;
+        }
+    }
+    if (levelCount > 2 && !scratch) {
+        ERROR("MipChain", "generateInto", "Scratch memory is required for more than two levels.");
+        return E_POINTER;
+    }
+
+    const bool keepCoverage = settings.alphaCoverageCutoff > 0.0f;
+    const float targetCoverage = keepCoverage ? alphaCoverage(levels[0], settings.alphaCoverageCutoff) : 1.0f;
+    const ColorTables& tables = colorTables(settings.srgb);
+
+    // Buffers lineales: el de los niveles impares va primero (el 1 es el mas grande).
+    uint16_t* linear[2] = { static_cast<uint16_t*>(scratch), nullptr };
+    if (levelCount > 2) {
+        linear[1] = linear[0] + static_cast<size_t>(levels[1].width) * levels[1].height * 4;
+    }
+
+    FilterTaps tapsX;
+    FilterTaps tapsY;
+    for (unsigned int level = 1; level < levelCount; ++level) {
+        const ImageView& dst = levels[level];
+        LevelSource source;
+        source.width = levels[level - 1].width;
+        source.height = levels[level - 1].height;
+        if (level == 1) {
+            source.image = &levels[0];
+        }
+        else {
+            source.linear = linear[level & 1u];
+        }
+        uint16_t* dstLinear = level + 1 < levelCount ? linear[(level + 1) & 1u] : nullptr;
+
+        buildTaps(source.width, dst.width, settings.filter, tapsX);
+        buildTaps(source.height, dst.height, settings.filter, tapsY);
+
+        // Bloques de unas 32K muestras destino: suficiente trabajo por tarea y pocas filas repetidas.
+        const unsigned int grain = std::max(4u, 32768u / dst.width);
+        auto runRows = [&](unsigned int begin, unsigned int end, unsigned int) {
+            filterRows(source, tapsX, tapsY, tables, begin, end, dst, dstLinear);
+        };
+        if (settings.jobs) {
+            settings.jobs->parallelFor(dst.height, grain, runRows);
+        }
+        else {
+            runRows(0, dst.height, 0);
+        }
+
+        if (keepCoverage) {
+            scaleAlphaToCoverage(dst, settings.alphaCoverageCutoff, targetCoverage);
+        }
+    }
+    return S_OK;
+}
@@ -1,6 +1,5 @@
 #include "ModelLoader.h"
 #include "MeshComponent.h"
-#include "Device.h"
 
 HRESULT
 ModelLoader::init() {
@@ -16,14 +15,15 @@ ModelLoader::destroy() {
 HRESULT
 ModelLoader::loadFromFile(const std::string& fileName, MeshComponent& mesh, bool invertTexCoordY) {
 
-    std::vector<XMFLOAT3> temp_positions;
-    std::vector<XMFLOAT2> temp_texcoords;
-    std::vector<XMFLOAT3> temp_normals;
+    std::vector<Vector3> temp_positions;
+    std::vector<Vector2> temp_texcoords;
+    std::vector<Vector3> temp_normals;
 
     std::vector<SimpleVertex> out_vertices;
     std::vector<unsigned int> out_indices;
 
     std::map<std::string, unsigned int> vertexMap;
+    std::vector<SubMesh> subMeshes;
 
     std::ifstream file(fileName);
     if (!file.is_open()) {
@@ -44,20 +44,27 @@ ModelLoader::loadFromFile(const std::string& fileName, MeshComponent& mesh, bool
         ss >> prefix;
 
         if (prefix == "v") {
-            XMFLOAT3 pos;
+            Vector3 pos;
             ss >> pos.x >> pos.y >> pos.z;
             temp_positions.push_back(pos);
         }
         else if (prefix == "vt") {
-            XMFLOAT2 tex;
+            Vector2 tex;
             ss >> tex.x >> tex.y;
             temp_texcoords.push_back(tex);
         }
         else if (prefix == "vn") {
-            XMFLOAT3 norm;
+            Vector3 norm;
             ss >> norm.x >> norm.y >> norm.z;
             temp_normals.push_back(norm);
         }
+        else if (prefix == "o" || prefix == "g") {
+            // Cada grupo inicia una submalla nueva; las vacas se descartan al final.
+            SubMesh subMesh = {};
+            std::getline(ss >> std::ws, subMesh.name);
+            subMesh.startIndex = static_cast<unsigned int>(out_indices.size());
+            subMeshes.push_back(subMesh);
+        }
         else if (prefix == "f") {
             parseFace(ss,
                 out_vertices,
@@ -72,14 +79,36 @@ ModelLoader::loadFromFile(const std::string& fileName, MeshComponent& mesh, bool
 
     file.close();
 
+    // Cerrar los rangos de cada grupo.
+    mesh.m_subMeshes.clear();
+    for (size_t i = 0; i < subMeshes.size(); ++i) {
+        unsigned int end = i + 1 < subMeshes.size()
+            ? subMeshes[i + 1].startIndex
+            : static_cast<unsigned int>(out_indices.size());
+        subMeshes[i].indexCount = end - subMeshes[i].startIndex;
+        if (subMeshes[i].indexCount > 0) {
+            mesh.m_subMeshes.push_back(subMeshes[i]);
+        }
+    }
+    // Caras antes del primer grupo.
+    if (!subMeshes.empty() && subMeshes[0].startIndex > 0) {
+        SubMesh head = {};
+        head.name = fileName;
+        head.startIndex = 0;
+        head.indexCount = subMeshes[0].startIndex;
+        mesh.m_subMeshes.insert(mesh.m_subMeshes.begin(), head);
+    }
+
     mesh.m_vertex = out_vertices;
     mesh.m_index = out_indices;
     mesh.m_numVertex = static_cast<int>(out_vertices.size());
     mesh.m_numIndex = static_cast<int>(out_indices.size());
     mesh.m_name = fileName;
+    mesh.computeBounds();
 
     std::string msg = "Modelo cargado: " + fileName + ". Vrtices nicos: "
-        + std::to_string(mesh.m_numVertex) + ", ndices: " + std::to_string(mesh.m_numIndex);
+        + std::to_string(mesh.m_numVertex) + ", ndices: " + std::to_string(mesh.m_numIndex)
+        + ", submallas: " + std::to_string(mesh.m_subMeshes.size());
     MESSAGE("ModelLoader", "loadFromFile", msg.c_str());
 
     return S_OK;
@@ -89,9 +118,9 @@ void
 ModelLoader::parseFace(std::stringstream& ss,
                         std::vector<SimpleVertex>& out_vertices,
                         std::vector<unsigned int>& out_indices,
-                        const std::vector<XMFLOAT3>& temp_positions,
-                        const std::vector<XMFLOAT2>& temp_texcoords,
-                        const std::vector<XMFLOAT3>& temp_normals,
+                        const std::vector<Vector3>& temp_positions,
+                        const std::vector<Vector2>& temp_texcoords,
+                        const std::vector<Vector3>& temp_normals,
                         std::map<std::string, unsigned int>& vertexMap,
                         bool invertTexCoordY)
 {
@@ -119,9 +148,9 @@ ModelLoader::parseFace(std::stringstream& ss,
 unsigned int
 ModelLoader::parseVertexCombo(const std::string& comboToken,
                                 std::vector<SimpleVertex>& out_vertices,
-                                const std::vector<XMFLOAT3>& temp_positions,
-                                const std::vector<XMFLOAT2>& temp_texcoords,
-                                const std::vector<XMFLOAT3>& temp_normals,
+                                const std::vector<Vector3>& temp_positions,
+                                const std::vector<Vector2>& temp_texcoords,
+                                const std::vector<Vector3>& temp_normals,
                                 std::map<std::string, unsigned int>& vertexMap,
                                 bool invertTexCoordY)
 {
@@ -153,7 +182,7 @@ ModelLoader::parseVertexCombo(const std::string& comboToken,
         vtIdx = -1;
     }
 
-    if (vIdx >= 0 && vIdx < temp_positions.size()) {
+    if (vIdx >= 0 && static_cast<size_t>(vIdx) < temp_positions.size()) {
         newVertex.Pos = temp_positions[vIdx];
     }
     else {
@@ -161,7 +190,7 @@ ModelLoader::parseVertexCombo(const std::string& comboToken,
         newVertex.Pos = { 0.0f, 0.0f, 0.0f };
     }
 
-    if (vtIdx >= 0 && vtIdx < temp_texcoords.size()) {
+    if (vtIdx >= 0 && static_cast<size_t>(vtIdx) < temp_texcoords.size()) {
         newVertex.Tex = temp_texcoords[vtIdx];
         if (invertTexCoordY) {
             newVertex.Tex.y = 1.0f - newVertex.Tex.y;
@@ -171,7 +200,7 @@ ModelLoader::parseVertexCombo(const std::string& comboToken,
         newVertex.Tex = { 0.0f, 0.0f };
     }
 
-    if (vnIdx >= 0 && vnIdx < temp_normals.size()) {
+    if (vnIdx >= 0 && static_cast<size_t>(vnIdx) < temp_normals.size()) {
         newVertex.Norm = temp_normals[vnIdx];
     }
     else {
@@ -0,0 +1,474 @@
+#include "OcclusionCuller.h"
+#include "MeshComponent.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Simd.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    /// Triangulos fuera de esta banda (en multiplos de w) no se usan como oclusores.
+    const float GUARD_BAND = 4.0f;
+
+    /// Desvio maximo en z/w de la cuarta esquina para unir dos triangulos en un quad plano.
+    const float COPLANAR_TOLERANCE = 1e-5f;
+
+    /// Vertice de un oclusor en pixeles y z/w.
+    struct ScreenVertex {
+        float x, y, z;
+        bool usable;
+    };
+}
+
+HRESULT
+OcclusionCuller::init(unsigned int width, unsigned int height, JobSystem& jobSystem) {
+    if (width == 0 || height == 0) {
+        ERROR("OcclusionCuller", "init", "Width and height must be greater than 0");
+        return E_INVALIDARG;
+    }
+
+    m_width = (width + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    m_height = (height + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    m_blocksX = m_width / BLOCK_SIZE;
+    m_blocksY = m_height / BLOCK_SIZE;
+    m_jobSystem = &jobSystem;
+
+    m_depth.assign(static_cast<size_t>(m_width) * m_height, 1.0f);
+    m_hiZ.assign(static_cast<size_t>(m_blocksX) * m_blocksY, 1.0f);
+
+    MESSAGE("OcclusionCuller", "init",
+        ("Depth buffer " + std::to_string(m_width) + "x" + std::to_string(m_height)
+            + ", lanes SIMD: " + std::to_string(simd::SIMD_LANES)).c_str());
+    return S_OK;
+}
+
+void
+OcclusionCuller::update(const Matrix4& viewProjection) {
+    m_viewProj = viewProjection;
+
+    m_occluders.clear();
+    m_stats = OcclusionStats();
+}
+
+void
+OcclusionCuller::addOccluder(const MeshComponent& mesh, const Matrix4& world) {
+    addOccluder(mesh, world, 0, static_cast<unsigned int>(std::max(mesh.m_numIndex, 0)));
+}
+
+void
+OcclusionCuller::addOccluder(const MeshComponent& mesh, const Matrix4& world,
+                             unsigned int startIndex, unsigned int indexCount) {
+    if (mesh.m_vertex.empty() || mesh.m_index.size() < 3 || indexCount < 3) {
+        return;
+    }
+
+    Occluder occluder;
+    occluder.mesh = &mesh;
+    occluder.worldViewProj = math::multiply(world, m_viewProj);
+    occluder.startIndex = startIndex;
+    occluder.indexCount = indexCount;
+    m_occluders.push_back(occluder);
+}
+
+void
+OcclusionCuller::setupOccluder(const Occluder& occluder, std::vector<OccluderTriangle>& out) const {
+    out.clear();
+    const MeshComponent& mesh = *occluder.mesh;
+
+    const size_t numVertices = mesh.m_vertex.size();
+    const size_t available = std::min(mesh.m_index.size(), static_cast<size_t>(std::max(mesh.m_numIndex, 0)));
+    const size_t first = std::min(static_cast<size_t>(occluder.startIndex), available);
+    const size_t last = first + std::min(static_cast<size_t>(occluder.indexCount), available - first) / 3 * 3;
+
+    // Solo se transforma el tramo de vertices que usa el rango (una submalla de un modelo grande).
+    unsigned int minVertex = 0xffffffffu, maxVertex = 0;
+    for (size_t i = first; i < last; ++i) {
+        if (mesh.m_index[i] < numVertices) {
+            minVertex = std::min(minVertex, mesh.m_index[i]);
+            maxVertex = std::max(maxVertex, mesh.m_index[i]);
+        }
+    }
+    if (minVertex > maxVertex) {
+        return;
+    }
+
+    thread_local std::vector<Vector4> clip;
+    clip.resize(static_cast<size_t>(maxVertex - minVertex) + 1);
+    math::transformStream(&mesh.m_vertex[minVertex].Pos, sizeof(SimpleVertex), clip.data(), clip.size(),
+                          occluder.worldViewProj);
+
+    // Vertices en pantalla. Los que quedan detras del plano cercano o fuera de la banda de guarda
+    // invalidan sus triangulos: descartar oclusores nunca produce culling incorrecto.
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+    thread_local std::vector<ScreenVertex> screen;
+    screen.resize(clip.size());
+    for (size_t i = 0; i < clip.size(); ++i) {
+        const Vector4& v = clip[i];
+        const float guard = GUARD_BAND * v.w;
+        ScreenVertex& s = screen[i];
+        s.usable = v.z >= 0.0f && v.w > 0.0f
+            && v.x <= guard && v.x >= -guard && v.y <= guard && v.y >= -guard;
+        if (s.usable) {
+            const float invW = 1.0f / v.w;
+            s.x = (v.x * invW * 0.5f + 0.5f) * width;
+            s.y = (0.5f - v.y * invW * 0.5f) * height;
+            s.z = v.z * invW;
+        }
+    }
+
+    // Triangulos utilizables y de frente, tres esquinas (indices locales) por triangulo.
+    thread_local std::vector<unsigned int> corners;
+    corners.clear();
+    for (size_t t = first; t < last; t += 3) {
+        unsigned int idx[3] = { mesh.m_index[t], mesh.m_index[t + 1], mesh.m_index[t + 2] };
+        if (idx[0] >= numVertices || idx[1] >= numVertices || idx[2] >= numVertices) {
+            continue;
+        }
+        const ScreenVertex& v0 = screen[idx[0] - minVertex];
+        const ScreenVertex& v1 = screen[idx[1] - minVertex];
+        const ScreenVertex& v2 = screen[idx[2] - minVertex];
+        if (!v0.usable || !v1.usable || !v2.usable) {
+            continue;
+        }
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+        if (!(area > 0.0f)) {
+            continue;
+        }
+        corners.push_back(idx[0] - minVertex);
+        corners.push_back(idx[1] - minVertex);
+        corners.push_back(idx[2] - minVertex);
+    }
+    const size_t numTriangles = corners.size() / 3;
+
+    // Arma un triangulo o un quad convexo (esquinas en el orden de la malla). Devuelve false si el
+    // poligono no es convexo o si sus esquinas no son coplanares en z/w.
+    auto emit = [&](const unsigned int* v, int count) {
+        float sx[4], sy[4], sz[4];
+        for (int i = 0; i < count; ++i) {
+            sx[i] = screen[v[i]].x;
+            sy[i] = screen[v[i]].y;
+            sz[i] = screen[v[i]].z;
+        }
+        for (int i = 0; i < count; ++i) {
+            int j = (i + 1) % count, k = (i + 2) % count;
+            float turn = (sx[j] - sx[i]) * (sy[k] - sy[i]) - (sy[j] - sy[i]) * (sx[k] - sx[i]);
+            if (!(turn > 0.0f)) {
+                return false;
+            }
+        }
+
+        float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+        float invArea = 1.0f / area;
+        float dx1 = sx[1] - sx[0], dy1 = sy[1] - sy[0];
+        float dx2 = sx[2] - sx[0], dy2 = sy[2] - sy[0];
+        float dz1 = sz[1] - sz[0], dz2 = sz[2] - sz[0];
+        OccluderTriangle tri;
+        tri.z[0] = (dz1 * dy2 - dz2 * dy1) * invArea;
+        tri.z[1] = (dz2 * dx1 - dz1 * dx2) * invArea;
+        tri.z[2] = sz[0] - tri.z[0] * sx[0] - tri.z[1] * sy[0];
+
+        // La cuarta esquina se aparta del plano como mucho en su desvio, que se suma al plano
+        // para que siga siendo conservador en todo el quad.
+        float deviation = 0.0f;
+        if (count == 4) {
+            deviation = std::fabs(tri.z[0] * sx[3] + tri.z[1] * sy[3] + tri.z[2] - sz[3]);
+            if (!(deviation <= COPLANAR_TOLERANCE)) {
+                return false;
+            }
+        }
+
+        float minX = sx[0], minY = sy[0], maxX = sx[0], maxY = sy[0];
+        for (int i = 1; i < count; ++i) {
+            minX = std::min(minX, sx[i]);
+            minY = std::min(minY, sy[i]);
+            maxX = std::max(maxX, sx[i]);
+            maxY = std::max(maxY, sy[i]);
+        }
+        tri.minX = std::max(0, static_cast<int>(std::floor(minX)));
+        tri.minY = std::max(0, static_cast<int>(std::floor(minY)));
+        tri.maxX = std::min(static_cast<int>(m_width) - 1, static_cast<int>(std::ceil(maxX)));
+        tri.maxY = std::min(static_cast<int>(m_height) - 1, static_cast<int>(std::ceil(maxY)));
+        if (tri.minX > tri.maxX || tri.minY > tri.maxY) {
+            return true;
+        }
+
+        // Cobertura y profundidad se evaluan en el centro del pixel, pero el oclusor debe tapar el
+        // pixel completo: cada arista se recorre medio pixel hacia adentro (el centro solo pasa si
+        // la esquina menos cubierta esta dentro) y el plano de z se sube a su valor mas lejano
+        // dentro del pixel. Los triangulos completan la cuarta arista con una que siempre pasa.
+        for (int i = 0; i < 4; ++i) {
+            if (i >= count) {
+                tri.edgeA[i] = 0.0f;
+                tri.edgeB[i] = 0.0f;
+                tri.edgeC[i] = 1.0f;
+                continue;
+            }
+            int j = (i + 1) % count;
+            tri.edgeA[i] = sy[i] - sy[j];
+            tri.edgeB[i] = sx[j] - sx[i];
+            tri.edgeC[i] = -(tri.edgeA[i] * sx[i] + tri.edgeB[i] * sy[i])
+                - 0.5f * (std::fabs(tri.edgeA[i]) + std::fabs(tri.edgeB[i]));
+        }
+        tri.z[2] += 0.5f * (std::fabs(tri.z[0]) + std::fabs(tri.z[1])) + deviation;
+        out.push_back(tri);
+        return true;
+    };
+
+    // Dos triangulos coplanares que comparten una arista (la diagonal de un quad) se rasterizan
+    // como un solo quad: recortada medio pixel por cada lado, la diagonal dejaria una grieta de
+    // un pixel sin escribir a lo largo de toda la cara.
+    thread_local std::vector<std::pair<unsigned long long, unsigned int>> edges;
+    thread_local std::vector<unsigned char> merged;
+    edges.clear();
+    merged.assign(numTriangles, 0);
+    for (size_t t = 0; t < numTriangles; ++t) {
+        for (unsigned int i = 0; i < 3; ++i) {
+            unsigned long long a = corners[t * 3 + i], b = corners[t * 3 + (i + 1) % 3];
+            edges.push_back(std::make_pair((std::min(a, b) << 32) | std::max(a, b),
+                                           static_cast<unsigned int>(t * 3 + i)));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (size_t e = 0; e + 1 < edges.size(); ++e) {
+        // Solo aristas compartidas por exactamente dos triangulos.
+        if (edges[e].first != edges[e + 1].first
+            || (e > 0 && edges[e - 1].first == edges[e].first)
+            || (e + 2 < edges.size() && edges[e + 2].first == edges[e].first)) {
+            continue;
+        }
+        unsigned int ta = edges[e].second / 3, ia = edges[e].second % 3;
+        unsigned int tb = edges[e + 1].second / 3, ib = edges[e + 1].second % 3;
+        if (ta == tb || merged[ta] || merged[tb]
+            || corners[tb * 3 + ib] != corners[ta * 3 + (ia + 1) % 3]) {
+            continue;
+        }
+        const unsigned int quad[4] = { corners[ta * 3 + ia], corners[tb * 3 + (ib + 2) % 3],
+                                       corners[ta * 3 + (ia + 1) % 3], corners[ta * 3 + (ia + 2) % 3] };
+        if (emit(quad, 4)) {
+            merged[ta] = 1;
+            merged[tb] = 1;
+        }
+    }
+    for (size_t t = 0; t < numTriangles; ++t) {
+        if (!merged[t]) {
+            emit(&corners[t * 3], 3);
+        }
+    }
+}
+
+void
+OcclusionCuller::render() {
+    if (m_depth.empty() || !m_jobSystem) {
+        ERROR("OcclusionCuller", "render", "OcclusionCuller not initialized.");
+        return;
+    }
+
+    double start = Profiler::now();
+    const unsigned int numOccluders = static_cast<unsigned int>(m_occluders.size());
+    if (m_triangles.size() < numOccluders) {
+        m_triangles.resize(numOccluders);
+    }
+    m_jobSystem->parallelFor(numOccluders, 1, [&](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int i = begin; i < end; ++i) {
+            setupOccluder(m_occluders[i], m_triangles[i]);
+        }
+    });
+    double setupEnd = Profiler::now();
+
+    unsigned int triangles = 0;
+    for (unsigned int i = 0; i < numOccluders; ++i) {
+        triangles += static_cast<unsigned int>(m_triangles[i].size());
+    }
+
+    // Cada fila de bloques del Hi-Z es independiente: limpia, rasteriza y reduce su franja.
+    m_jobSystem->parallelFor(m_blocksY, 1, [&](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int by = begin; by < end; ++by) {
+            unsigned int rowBegin = by * BLOCK_SIZE;
+            unsigned int rowEnd = rowBegin + BLOCK_SIZE;
+            std::fill(m_depth.begin() + static_cast<size_t>(rowBegin) * m_width,
+                m_depth.begin() + static_cast<size_t>(rowEnd) * m_width, 1.0f);
+
+            rasterizeRows(rowBegin, rowEnd);
+
+            for (unsigned int bx = 0; bx < m_blocksX; ++bx) {
+                simd::FloatV farthest = simd::zero();
+                for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+                    const float* row = m_depth.data() + static_cast<size_t>(y) * m_width + bx * BLOCK_SIZE;
+                    for (unsigned int x = 0; x < BLOCK_SIZE; x += simd::SIMD_LANES) {
+                        farthest = simd::max(farthest, simd::load(row + x));
+                    }
+                }
+                m_hiZ[by * m_blocksX + bx] = simd::horizontalMax(farthest);
+            }
+        }
+    });
+    double rasterEnd = Profiler::now();
+
+    m_stats.setupMs = setupEnd - start;
+    m_stats.rasterMs = rasterEnd - setupEnd;
+    m_stats.occluders = numOccluders;
+    m_stats.occluderTriangles = triangles;
+
+    Profiler& profiler = Profiler::instance();
+    profiler.addSample("OcclusionCuller::setup", m_stats.setupMs);
+    profiler.addSample("OcclusionCuller::raster", m_stats.rasterMs);
+    profiler.setCounter("OcclusionCuller::occluders", numOccluders);
+    profiler.setCounter("OcclusionCuller::occluderTriangles", triangles);
+}
+
+void
+OcclusionCuller::rasterizeRows(unsigned int rowBegin, unsigned int rowEnd) {
+    using namespace simd;
+    const int lanes = SIMD_LANES;
+    const FloatV centers = laneCenters();
+    const FloatV zeroV = zero();
+
+    for (size_t o = 0; o < m_occluders.size(); ++o) {
+        for (const OccluderTriangle& tri : m_triangles[o]) {
+            int y0 = std::max(tri.minY, static_cast<int>(rowBegin));
+            int y1 = std::min(tri.maxY, static_cast<int>(rowEnd) - 1);
+            if (y0 > y1) {
+                continue;
+            }
+            int x0 = tri.minX / lanes * lanes;
+            int x1 = tri.maxX;
+
+            const FloatV a0 = set1(tri.edgeA[0]), a1 = set1(tri.edgeA[1]);
+            const FloatV a2 = set1(tri.edgeA[2]), a3 = set1(tri.edgeA[3]);
+            const FloatV zA = set1(tri.z[0]);
+
+            for (int y = y0; y <= y1; ++y) {
+                float py = y + 0.5f;
+                const FloatV r0 = set1(tri.edgeB[0] * py + tri.edgeC[0]);
+                const FloatV r1 = set1(tri.edgeB[1] * py + tri.edgeC[1]);
+                const FloatV r2 = set1(tri.edgeB[2] * py + tri.edgeC[2]);
+                const FloatV r3 = set1(tri.edgeB[3] * py + tri.edgeC[3]);
+                const FloatV zRow = set1(tri.z[1] * py + tri.z[2]);
+                float* depthRow = m_depth.data() + static_cast<size_t>(y) * m_width;
+
+                for (int x = x0; x <= x1; x += lanes) {
+                    const FloatV px = add(set1(static_cast<float>(x)), centers);
+                    // Aristas recorridas medio pixel en setupOccluder(): E > 0 en el centro solo
+                    // si el triangulo cubre el pixel entero, asi que nunca tapa de mas.
+                    FloatV mask = andv(andv(cmpgt(madd(a0, px, r0), zeroV),
+                                            cmpgt(madd(a1, px, r1), zeroV)),
+                                       andv(cmpgt(madd(a2, px, r2), zeroV),
+                                            cmpgt(madd(a3, px, r3), zeroV)));
+                    if (movemask(mask) == 0) {
+                        continue;
+                    }
+                    FloatV depth = load(depthRow + x);
+                    FloatV z = madd(zA, px, zRow);
+                    store(depthRow + x, select(mask, min(depth, z), depth));
+                }
+            }
+        }
+    }
+}
+
+bool
+OcclusionCuller::isVisible(const AABB& box) const {
+    if (m_depth.empty()) {
+        return true;
+    }
+
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+    float nearestZ = 1e30f;
+    for (int i = 0; i < 8; ++i) {
+        const Vector4 corner = math::transform(Vector4((i & 1) ? box.max.x : box.min.x,
+                                                       (i & 2) ? box.max.y : box.min.y,
+                                                       (i & 4) ? box.max.z : box.min.z, 1.0f), m_viewProj);
+        // La caja cruza el plano cercano: se considera visible.
+        if (corner.w <= 1e-6f || corner.z < 0.0f) {
+            return true;
+        }
+        float invW = 1.0f / corner.w;
+        float sx = (corner.x * invW * 0.5f + 0.5f) * m_width;
+        float sy = (0.5f - corner.y * invW * 0.5f) * m_height;
+        minX = std::min(minX, sx);
+        maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy);
+        maxY = std::max(maxY, sy);
+        nearestZ = std::min(nearestZ, corner.z * invW);
+    }
+
+    int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+    int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+    int x1 = std::min(static_cast<int>(m_width) - 1, static_cast<int>(std::floor(maxX)));
+    int y1 = std::min(static_cast<int>(m_height) - 1, static_cast<int>(std::floor(maxY)));
+    if (x0 > x1 || y0 > y1) {
+        // Fuera de pantalla: le corresponde al frustum culling, no a la oclusion.
+        return true;
+    }
+
+    using namespace simd;
+    const FloatV nearest = set1(nearestZ);
+    const FloatV centers = laneCenters();
+    const FloatV left = set1(static_cast<float>(x0));
+    const FloatV right = set1(static_cast<float>(x1 + 1));
+
+    for (int by = y0 / static_cast<int>(BLOCK_SIZE); by <= y1 / static_cast<int>(BLOCK_SIZE); ++by) {
+        for (int bx = x0 / static_cast<int>(BLOCK_SIZE); bx <= x1 / static_cast<int>(BLOCK_SIZE); ++bx) {
+            // Todo el bloque tiene oclusores mas cercanos que la caja.
+            if (nearestZ > m_hiZ[by * m_blocksX + bx]) {
+                continue;
+            }
+
+            int rowBegin = std::max(y0, by * static_cast<int>(BLOCK_SIZE));
+            int rowEnd = std::min(y1, by * static_cast<int>(BLOCK_SIZE) + static_cast<int>(BLOCK_SIZE) - 1);
+            for (int y = rowBegin; y <= rowEnd; ++y) {
+                const float* row = m_depth.data() + static_cast<size_t>(y) * m_width;
+                for (int x = bx * static_cast<int>(BLOCK_SIZE); x < (bx + 1) * static_cast<int>(BLOCK_SIZE); x += SIMD_LANES) {
+                    FloatV px = add(set1(static_cast<float>(x)), centers);
+                    FloatV inside = andv(cmpgt(px, left), cmplt(px, right));
+                    FloatV uncovered = cmpge(load(row + x), nearest);
+                    if (movemask(andv(inside, uncovered)) != 0) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+unsigned int
+OcclusionCuller::testVisibility(const AABB* boxes, unsigned int count, std::vector<unsigned char>& visible) {
+    visible.resize(count);
+    if (!m_jobSystem || count == 0) {
+        return 0;
+    }
+
+    double start = Profiler::now();
+    std::atomic<unsigned int> visibleCount(0);
+    m_jobSystem->parallelFor(count, 256, [&](unsigned int begin, unsigned int end, unsigned int) {
+        unsigned int local = 0;
+        for (unsigned int i = begin; i < end; ++i) {
+            visible[i] = isVisible(boxes[i]) ? 1 : 0;
+            local += visible[i];
+        }
+        visibleCount += local;
+    });
+
+    m_stats.testMs = Profiler::now() - start;
+    m_stats.objectsTested = count;
+    m_stats.objectsCulled = count - visibleCount.load();
+
+    Profiler& profiler = Profiler::instance();
+    profiler.addSample("OcclusionCuller::test", m_stats.testMs);
+    profiler.setCounter("OcclusionCuller::objectsTested", m_stats.objectsTested);
+    profiler.setCounter("OcclusionCuller::objectsCulled", m_stats.objectsCulled);
+    return visibleCount.load();
+}
+
+void
+OcclusionCuller::destroy() {
+    m_depth.clear();
+    m_hiZ.clear();
+    m_occluders.clear();
+    m_triangles.clear();
+    m_jobSystem = nullptr;
+}
@@ -0,0 +1,78 @@
+#include "Profiler.h"
+#include <iomanip>
+
+Profiler&
+Profiler::instance() {
+    static Profiler s_profiler;
+    return s_profiler;
+}
+
+double
+Profiler::now() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+void
+Profiler::addSample(const std::string& name, double milliseconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Sample& sample = m_samples[name];
+    if (sample.calls == 0 || milliseconds < sample.min) {
+        sample.min = milliseconds;
+    }
+    if (sample.calls == 0 || milliseconds > sample.max) {
+        sample.max = milliseconds;
+    }
+    sample.last = milliseconds;
+    sample.total += milliseconds;
+    sample.calls++;
+}
+
+void
+Profiler::addCounter(const std::string& name, long long value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters[name] += value;
+}
+
+void
+Profiler::setCounter(const std::string& name, long long value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters[name] = value;
+}
+
+Profiler::Sample
+Profiler::getSample(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_samples.find(name);
+    return it != m_samples.end() ? it->second : Sample();
+}
+
+long long
+Profiler::getCounter(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_counters.find(name);
+    return it != m_counters.end() ? it->second : 0;
+}
+
+std::string
+Profiler::report() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(3);
+    for (const auto& it : m_samples) {
+        const Sample& s = it.second;
+        os << it.first << " : avg " << s.average() << " ms, min " << s.min
+           << " ms, max " << s.max << " ms, last " << s.last << " ms (" << s.calls << " calls)\n";
+    }
+    for (const auto& it : m_counters) {
+        os << it.first << " : " << it.second << "\n";
+    }
+    return os.str();
+}
+
+void
+Profiler::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_samples.clear();
+    m_counters.clear();
+}
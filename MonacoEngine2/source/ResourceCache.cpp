@@ -0,0 +1,251 @@
+#include "ResourceCache.h"
+#include "Profiler.h"
+#include <cstring>
+
+void
+ResourceCache::init(size_t budgetBytes, ReleaseFunction release) {
+    destroy();
+    m_release = release;
+    m_stats = ResourceCacheStats();
+    m_stats.budgetBytes = budgetBytes;
+}
+
+void
+ResourceCache::destroy() {
+    for (unsigned int index = 0; index < m_entries.size(); ++index) {
+        if (m_entries[index].alive && m_release) {
+            m_release(m_entries[index].resource);
+        }
+    }
+    m_entries.clear();
+    m_freeIndices.clear();
+    m_byPath.clear();
+    m_byContent.clear();
+    m_lru.clear();
+    m_stats.residentBytes = 0;
+    m_stats.entries = 0;
+    m_stats.referenced = 0;
+}
+
+ResourceCache::Entry*
+ResourceCache::find(ResourceHandle handle) {
+    if (handle.index >= m_entries.size()) {
+        return nullptr;
+    }
+    Entry& entry = m_entries[handle.index];
+    return (entry.alive && entry.generation == handle.generation) ? &entry : nullptr;
+}
+
+const ResourceCache::Entry*
+ResourceCache::find(ResourceHandle handle) const {
+    return const_cast<ResourceCache*>(this)->find(handle);
+}
+
+ResourceHandle
+ResourceCache::reference(unsigned int index) {
+    Entry& entry = m_entries[index];
+    if (entry.refCount++ == 0) {
+        m_lru.erase(entry.lru);
+        m_stats.referenced++;
+    }
+    ResourceHandle handle;
+    handle.index = index;
+    handle.generation = entry.generation;
+    return handle;
+}
+
+ResourceHandle
+ResourceCache::acquire(const std::string& path) {
+    auto it = m_byPath.find(path);
+    if (it == m_byPath.end()) {
+        return ResourceHandle();
+    }
+    m_stats.hits++;
+    return reference(it->second);
+}
+
+ResourceHandle
+ResourceCache::acquireContent(uint64_t contentHash, const std::string& path) {
+    auto it = contentHash ? m_byContent.find(contentHash) : m_byContent.end();
+    if (it == m_byContent.end()) {
+        return ResourceHandle();
+    }
+    const unsigned int index = it->second;
+    if (m_byPath.emplace(path, index).second) {
+        m_entries[index].paths.push_back(path);
+    }
+    m_stats.contentHits++;
+    return reference(index);
+}
+
+ResourceHandle
+ResourceCache::insert(const std::string& path, uint64_t contentHash, void* resource, size_t bytes) {
+    unsigned int index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    }
+    else {
+        index = static_cast<unsigned int>(m_entries.size());
+        m_entries.emplace_back();
+    }
+
+    Entry& entry = m_entries[index];
+    entry.resource = resource;
+    entry.bytes = bytes;
+    entry.contentHash = contentHash;
+    entry.refCount = 1;
+    entry.alive = true;
+    entry.paths.assign(1, path);
+    entry.lru = m_lru.end();
+
+    // Una ruta o un contenido repetidos pasan a apuntar a la entrada nueva.
+    m_byPath[path] = index;
+    if (contentHash) {
+        m_byContent[contentHash] = index;
+    }
+
+    m_stats.misses++;
+    m_stats.entries++;
+    m_stats.referenced++;
+    m_stats.residentBytes += bytes;
+
+    ResourceHandle handle;
+    handle.index = index;
+    handle.generation = entry.generation;
+    trim();
+    return handle;
+}
+
+void
+ResourceCache::addRef(ResourceHandle handle) {
+    if (find(handle)) {
+        reference(handle.index);
+    }
+}
+
+void
+ResourceCache::release(ResourceHandle handle) {
+    Entry* entry = find(handle);
+    if (!entry || entry->refCount == 0) {
+        return;
+    }
+    if (--entry->refCount == 0) {
+        entry->lru = m_lru.insert(m_lru.end(), handle.index);
+        m_stats.referenced--;
+        trim();
+    }
+}
+
+void*
+ResourceCache::getResource(ResourceHandle handle) const {
+    const Entry* entry = find(handle);
+    return entry ? entry->resource : nullptr;
+}
+
+unsigned int
+ResourceCache::getRefCount(ResourceHandle handle) const {
+    const Entry* entry = find(handle);
+    return entry ? entry->refCount : 0;
+}
+
+void
+ResourceCache::setBudget(size_t budgetBytes) {
+    m_stats.budgetBytes = budgetBytes;
+    trim();
+}
+
+size_t
+ResourceCache::trim() {
+    size_t freed = 0;
+    while (m_stats.residentBytes > m_stats.budgetBytes && !m_lru.empty()) {
+        const unsigned int index = m_lru.front();
+        freed += m_entries[index].bytes;
+        evict(index);
+        m_stats.evictions++;
+    }
+    return freed;
+}
+
+void
+ResourceCache::evict(unsigned int index) {
+    Entry& entry = m_entries[index];
+    if (entry.refCount == 0) {
+        m_lru.erase(entry.lru);
+    }
+    else {
+        m_stats.referenced--;
+    }
+    for (const std::string& path : entry.paths) {
+        auto it = m_byPath.find(path);
+        if (it != m_byPath.end() && it->second == index) {
+            m_byPath.erase(it);
+        }
+    }
+    auto content = m_byContent.find(entry.contentHash);
+    if (content != m_byContent.end() && content->second == index) {
+        m_byContent.erase(content);
+    }
+    if (m_release) {
+        m_release(entry.resource);
+    }
+
+    m_stats.residentBytes -= entry.bytes;
+    m_stats.entries--;
+    entry.resource = nullptr;
+    entry.bytes = 0;
+    entry.refCount = 0;
+    entry.alive = false;
+    entry.paths.clear();
+    entry.generation++;
+    m_freeIndices.push_back(index);
+}
+
+void
+ResourceCache::publishCounters(const std::string& prefix) const {
+    Profiler& profiler = Profiler::instance();
+    profiler.setCounter(prefix + "::hits", static_cast<long long>(m_stats.hits));
+    profiler.setCounter(prefix + "::contentHits", static_cast<long long>(m_stats.contentHits));
+    profiler.setCounter(prefix + "::misses", static_cast<long long>(m_stats.misses));
+    profiler.setCounter(prefix + "::evictions", static_cast<long long>(m_stats.evictions));
+    profiler.setCounter(prefix + "::residentBytes", static_cast<long long>(m_stats.residentBytes));
+    profiler.setCounter(prefix + "::budgetBytes", static_cast<long long>(m_stats.budgetBytes));
+    profiler.setCounter(prefix + "::entries", m_stats.entries);
+    profiler.setCounter(prefix + "::referenced", m_stats.referenced);
+}
+
+uint64_t
+ResourceCache::hashContent(const void* data, size_t size) {
+    // Mezcla de MurmurHash3 (x64) sobre palabras de 8 bytes y avalancha final.
+    const uint64_t c1 = 0x87C37B91114253D5ull;
+    const uint64_t c2 = 0x4CF5AD432745937Full;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ size;
+
+    auto mix = [&](uint64_t word) {
+        word *= c1;
+        word = (word << 31) | (word >> 33);
+        word *= c2;
+        h ^= word;
+        h = ((h << 27) | (h >> 37)) * 5 + 0x52DCE729;
+    };
+
+    size_t offset = 0;
+    for (; offset + 8 <= size; offset += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + offset, 8);
+        mix(word);
+    }
+    if (offset < size) {
+        uint64_t word = 0;
+        memcpy(&word, bytes + offset, size - offset);
+        mix(word);
+    }
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h ? h : 1;
+}
@@ -0,0 +1,317 @@
+#include "ShaderCache.h"
+#include "Profiler.h"
+#include "ResourceCache.h"
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <set>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const uint32_t ENTRY_MAGIC = 0x4353484Du;   // "MHSC"
+    const uint32_t ENTRY_FORMAT = 1;
+
+    /// Cabecera de un archivo .cso de la cache (antes del bytecode).
+    struct EntryHeader {
+        uint32_t magic;
+        uint32_t format;
+        uint64_t key;
+        uint64_t compilerVersion;
+        uint64_t size;
+        uint64_t checksum;
+    };
+
+    bool readText(const fs::path& path, std::string& text) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    /// Nombres de los @c #include "x" / <x> de @p text, en orden de aparicion.
+    std::vector<std::string> findIncludes(const std::string& text) {
+        std::vector<std::string> includes;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            size_t i = text.find_first_not_of(" \t", pos);
+            if (i < end && text[i] == '#') {
+                i = text.find_first_not_of(" \t", i + 1);
+                if (i < end && text.compare(i, 7, "include") == 0) {
+                    i = text.find_first_not_of(" \t", i + 7);
+                    if (i < end && (text[i] == '"' || text[i] == '<')) {
+                        const char close = text[i] == '"' ? '"' : '>';
+                        const size_t last = text.find(close, i + 1);
+                        if (last < end) {
+                            includes.push_back(text.substr(i + 1, last - i - 1));
+                        }
+                    }
+                }
+            }
+            pos = end + 1;
+        }
+        return includes;
+    }
+
+    /**
+     * Agrega a @p keyData el hash del contenido de @p file y, en profundidad, el de sus
+     * includes (relativos al archivo que incluye o, si no existen ahi, a @p rootDir). Un
+     * include que no existe se registra con hash 0: la compilacion fallara de todos modos.
+     */
+    void hashSources(const fs::path& file, const fs::path& rootDir, std::set<fs::path>& visited,
+                     std::string& keyData, std::vector<std::string>* dependencies) {
+        const fs::path normal = file.lexically_normal();
+        if (!visited.insert(normal).second) {
+            return;
+        }
+        std::string text;
+        uint64_t hash = 0;
+        if (readText(normal, text)) {
+            hash = ResourceCache::hashContent(text.data(), text.size());
+        }
+        keyData.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+        if (dependencies) {
+            dependencies->push_back(normal.string());
+        }
+        for (const std::string& include : findIncludes(text)) {
+            fs::path candidate = normal.parent_path() / include;
+            if (!fs::exists(candidate)) {
+                candidate = rootDir / include;
+            }
+            hashSources(candidate, rootDir, visited, keyData, dependencies);
+        }
+    }
+}
+
+HRESULT
+ShaderCache::init(const std::string& directory, uint64_t compilerVersion) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (!fs::is_directory(directory, error)) {
+        ERROR("ShaderCache", "init", ("Failed to create shader cache directory: " + directory).c_str());
+        return E_FAIL;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory = directory;
+    m_compilerVersion = compilerVersion;
+    m_index.clear();
+    m_stats = ShaderCacheStats();
+
+    // El indice sale del nombre y tamano de cada archivo; la cabecera se valida al cargar.
+    for (const fs::directory_entry& entry : fs::directory_iterator(directory, error)) {
+        const fs::path& path = entry.path();
+        if (path.extension() == ".tmp") {
+            fs::remove(path, error);    // store() interrumpido.
+            continue;
+        }
+        const std::string stem = path.stem().string();
+        if (path.extension() != ".cso" || stem.size() != 16 ||
+            stem.find_first_not_of("0123456789abcdef") != std::string::npos) {
+            continue;
+        }
+        const uintmax_t size = entry.file_size(error);
+        if (error || size < sizeof(EntryHeader)) {
+            continue;
+        }
+        m_index[std::stoull(stem, nullptr, 16)] = size - sizeof(EntryHeader);
+    }
+    MESSAGE("ShaderCache", "init",
+        ("Entradas: " + std::to_string(m_index.size()) + " en " + directory).c_str());
+    return S_OK;
+}
+
+void
+ShaderCache::destroy() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_index.clear();
+    m_directory.clear();
+}
+
+uint64_t
+ShaderCache::computeKey(const ShaderCompileDesc& desc, std::vector<std::string>* dependencies) {
+    const double start = Profiler::now();
+    if (dependencies) {
+        dependencies->clear();
+    }
+
+    std::string keyData;
+    keyData.append(desc.entryPoint).push_back('\0');
+    keyData.append(desc.profile).push_back('\0');
+    keyData.append(reinterpret_cast<const char*>(&desc.flags), sizeof(desc.flags));
+    keyData.append(reinterpret_cast<const char*>(&m_compilerVersion), sizeof(m_compilerVersion));
+    std::vector<ShaderDefine> defines = desc.defines;
+    std::sort(defines.begin(), defines.end(),
+        [](const ShaderDefine& a, const ShaderDefine& b) { return a.name < b.name; });
+    for (const ShaderDefine& define : defines) {
+        keyData.append(define.name).push_back('=');
+        keyData.append(define.value).push_back('\0');
+    }
+
+    uint64_t key = 0;
+    const fs::path root(desc.fileName);
+    if (fs::exists(root)) {
+        std::set<fs::path> visited;
+        hashSources(root, root.parent_path(), visited, keyData, dependencies);
+        key = ResourceCache::hashContent(keyData.data(), keyData.size());
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.hashMs += Profiler::now() - start;
+    return key;
+}
+
+bool
+ShaderCache::load(uint64_t key, std::vector<unsigned char>& bytecode) {
+    const double start = Profiler::now();
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_index.find(key) == m_index.end()) {
+            m_stats.misses++;
+            return false;
+        }
+        path = entryPath(key);
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    EntryHeader header = {};
+    bool valid = file && file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+                 header.magic == ENTRY_MAGIC && header.format == ENTRY_FORMAT && header.key == key &&
+                 header.compilerVersion == m_compilerVersion && header.size > 0 && header.size < (1ull << 30);
+    if (valid) {
+        bytecode.resize(static_cast<size_t>(header.size));
+        valid = file.read(reinterpret_cast<char*>(bytecode.data()), bytecode.size()) &&
+                ResourceCache::hashContent(bytecode.data(), bytecode.size()) == header.checksum;
+    }
+    file.close();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.loadMs += Profiler::now() - start;
+    if (!valid) {
+        bytecode.clear();
+        m_index.erase(key);
+        std::error_code error;
+        fs::remove(path, error);
+        m_stats.rejected++;
+        m_stats.misses++;
+        return false;
+    }
+    m_stats.hits++;
+    m_stats.bytesLoaded += bytecode.size();
+    return true;
+}
+
+HRESULT
+ShaderCache::store(uint64_t key, const void* bytecode, size_t size) {
+    if (key == 0 || !bytecode || size == 0) {
+        ERROR("ShaderCache", "store", "Invalid key or empty bytecode.");
+        return E_INVALIDARG;
+    }
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        path = entryPath(key);
+    }
+
+    EntryHeader header = {};
+    header.magic = ENTRY_MAGIC;
+    header.format = ENTRY_FORMAT;
+    header.key = key;
+    header.compilerVersion = m_compilerVersion;
+    header.size = size;
+    header.checksum = ResourceCache::hashContent(bytecode, size);
+
+    // Temporal por hilo: dos compilaciones de la misma clave no escriben el mismo archivo.
+    const std::string temporary =
+        path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(static_cast<const char*>(bytecode), size);
+        if (!file) {
+            ERROR("ShaderCache", "store", ("Failed to write shader cache entry: " + temporary).c_str());
+            return E_FAIL;
+        }
+    }
+    std::error_code error;
+    fs::rename(temporary, path, error);
+    if (error) {
+        fs::remove(temporary, error);
+        ERROR("ShaderCache", "store", ("Failed to write shader cache entry: " + path).c_str());
+        return E_FAIL;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_index[key] = size;
+    m_stats.stores++;
+    m_stats.bytesStored += size;
+    return S_OK;
+}
+
+bool
+ShaderCache::contains(uint64_t key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.find(key) != m_index.end();
+}
+
+void
+ShaderCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code error;
+    for (const auto& entry : m_index) {
+        fs::remove(entryPath(entry.first), error);
+    }
+    m_index.clear();
+}
+
+size_t
+ShaderCache::getEntryCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.size();
+}
+
+unsigned long long
+ShaderCache::getTotalBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    unsigned long long total = 0;
+    for (const auto& entry : m_index) {
+        total += entry.second;
+    }
+    return total;
+}
+
+ShaderCacheStats
+ShaderCache::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void
+ShaderCache::publishCounters(const std::string& prefix) const {
+    const ShaderCacheStats stats = getStats();
+    Profiler& profiler = Profiler::instance();
+    profiler.setCounter(prefix + "::hits", static_cast<long long>(stats.hits));
+    profiler.setCounter(prefix + "::misses", static_cast<long long>(stats.misses));
+    profiler.setCounter(prefix + "::rejected", static_cast<long long>(stats.rejected));
+    profiler.setCounter(prefix + "::stores", static_cast<long long>(stats.stores));
+    profiler.setCounter(prefix + "::entries", static_cast<long long>(getEntryCount()));
+}
+
+std::string
+ShaderCache::entryFileName(uint64_t key) {
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx.cso", static_cast<unsigned long long>(key));
+    return name;
+}
+
+std::string
+ShaderCache::entryPath(uint64_t key) const {
+    return (fs::path(m_directory) / entryFileName(key)).string();
+}
@@ -0,0 +1,147 @@
+#include "ShaderCompileQueue.h"
+#include "Profiler.h"
+
+HRESULT
+ShaderCompileQueue::init(JobSystem* jobs, const ShaderLibrary::CompileFunc& compile, ShaderCache* cache) {
+    destroy();
+    if (!compile) {
+        ERROR("ShaderCompileQueue", "init", "Compiler function is null.");
+        return E_INVALIDARG;
+    }
+    m_jobs = jobs;
+    m_compile = compile;
+    m_cache = cache;
+    m_nextTicket = 1;
+    m_stats = ShaderCompileStats();
+    MESSAGE("ShaderCompileQueue", "init",
+        ("Hilos: " + std::to_string(jobs ? jobs->getNumThreads() : 1)).c_str());
+    return S_OK;
+}
+
+void
+ShaderCompileQueue::destroy() {
+    waitIdle();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ready.clear();
+    m_jobs = nullptr;
+}
+
+unsigned int
+ShaderCompileQueue::request(const ShaderCompileDesc& desc) {
+    const unsigned int ticket = m_nextTicket++;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.requested++;
+    }
+    m_inFlight.fetch_add(1, std::memory_order_acq_rel);
+
+    const double queued = Profiler::now();
+    auto job = [this, ticket, desc, queued]() {
+        CompiledShader result;
+        result.ticket = ticket;
+        result.desc = desc;
+        const double start = Profiler::now();
+        result.waitMs = start - queued;
+
+        uint64_t key = 0;
+        if (m_cache) {
+            key = m_cache->computeKey(desc);
+            result.fromCache = key != 0 && m_cache->load(key, result.bytecode);
+        }
+        if (!result.fromCache) {
+            result.result = m_compile(desc, result.bytecode);
+            if (SUCCEEDED(result.result) && result.bytecode.empty()) {
+                result.result = E_FAIL;
+            }
+            if (SUCCEEDED(result.result) && key != 0) {
+                m_cache->store(key, result.bytecode.data(), result.bytecode.size());
+            }
+        }
+        result.compileMs = Profiler::now() - start;
+        finish(std::move(result));
+    };
+
+    if (m_jobs) {
+        m_jobs->submit(job, &m_counter);
+    }
+    else {
+        job();
+    }
+    return ticket;
+}
+
+void
+ShaderCompileQueue::finish(CompiledShader&& result) {
+    Profiler::instance().addSample("ShaderCompile::" + sampleName(result.desc), result.compileMs);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (FAILED(result.result)) {
+            m_stats.failed++;
+        }
+        else if (result.fromCache) {
+            m_stats.cached++;
+        }
+        else {
+            m_stats.compiled++;
+        }
+        m_stats.compileMs += result.compileMs;
+        m_stats.maxCompileMs = std::max(m_stats.maxCompileMs, result.compileMs);
+        m_ready.push_back(std::move(result));
+    }
+    // Despues de publicar: quien vea getInFlight() == 0 encuentra el resultado en m_ready.
+    m_inFlight.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool
+ShaderCompileQueue::pop(CompiledShader& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_ready.empty()) {
+        return false;
+    }
+    out = std::move(m_ready.front());
+    m_ready.pop_front();
+    return true;
+}
+
+void
+ShaderCompileQueue::waitIdle() {
+    if (m_jobs) {
+        m_jobs->wait(m_counter);
+    }
+}
+
+unsigned int
+ShaderCompileQueue::getReadyCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<unsigned int>(m_ready.size());
+}
+
+ShaderCompileStats
+ShaderCompileQueue::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void
+ShaderCompileQueue::publishCounters(const std::string& prefix) const {
+    const ShaderCompileStats stats = getStats();
+    Profiler& profiler = Profiler::instance();
+    profiler.setCounter(prefix + "::queueDepth", getInFlight());
+    profiler.setCounter(prefix + "::ready", getReadyCount());
+    profiler.setCounter(prefix + "::compiled", stats.compiled);
+    profiler.setCounter(prefix + "::cached", stats.cached);
+    profiler.setCounter(prefix + "::failed", stats.failed);
+}
+
+std::string
+ShaderCompileQueue::sampleName(const ShaderCompileDesc& desc) {
+    std::string name = desc.fileName + ":" + desc.entryPoint;
+    if (!desc.defines.empty()) {
+        name += "[";
+        for (size_t i = 0; i < desc.defines.size(); ++i) {
+            name += (i ? "," : "") + desc.defines[i].name + "=" + desc.defines[i].value;
+        }
+        name += "]";
+    }
+    return name;
+}
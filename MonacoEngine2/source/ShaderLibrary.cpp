@@ -0,0 +1,285 @@
+#include "ShaderLibrary.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "ResourceCache.h"
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+    const uint32_t LIBRARY_MAGIC = 0x424C534Du;    // "MSLB"
+    const uint32_t LIBRARY_FORMAT = 1;
+    const unsigned int STAGE_COUNT = 2;
+
+    /// Cabecera del archivo; payloadHash cubre todo lo que le sigue.
+    struct LibraryHeader {
+        uint32_t magic;
+        uint32_t format;
+        uint64_t compilerVersion;
+        uint32_t featureCount;
+        uint32_t blobCount;
+        uint64_t payloadHash;
+    };
+
+    /// Posicion de un bytecode dentro del archivo.
+    struct BlobEntry {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    template<typename T>
+    void append(std::vector<unsigned char>& out, const T& value) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    /// Lector con limites sobre el archivo proyectado.
+    struct Reader {
+        const unsigned char* data;
+        size_t size;
+        size_t pos;
+
+        template<typename T>
+        bool read(T& value) {
+            if (size - pos < sizeof(T)) {
+                return false;
+            }
+            memcpy(&value, data + pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+    };
+}
+
+std::vector<ShaderDefine>
+ShaderLibrary::definesForMask(const std::vector<std::string>& features, uint32_t mask) {
+    std::vector<ShaderDefine> defines;
+    for (size_t bit = 0; bit < features.size() && bit < 32; ++bit) {
+        if (mask & (1u << bit)) {
+            defines.push_back({ features[bit], "1" });
+        }
+    }
+    return defines;
+}
+
+HRESULT
+ShaderLibrary::build(const ShaderLibraryDesc& desc, const CompileFunc& compile, const std::string& outputFile,
+                     ShaderLibraryBuildStats* stats) {
+    if (desc.fileName.empty() || !compile || desc.features.size() > MAX_FEATURES) {
+        ERROR("ShaderLibrary", "build", "Invalid shader file, compiler or too many features.");
+        return E_INVALIDARG;
+    }
+    const double start = Profiler::now();
+    const unsigned int featureCount = static_cast<unsigned int>(desc.features.size());
+    const unsigned int variantsPerStage = 1u << featureCount;
+    const unsigned int total = STAGE_COUNT * variantsPerStage;
+
+    // Cada variante es independiente: una por indice, repartidas entre los hilos.
+    std::vector<std::vector<unsigned char>> bytecodes(total);
+    std::vector<HRESULT> results(total, S_OK);
+    std::vector<double> compileTimes(total, 0.0);
+    std::vector<unsigned char> fromCache(total, 0);
+    auto compileRange = [&](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int index = begin; index < end; ++index) {
+            const bool pixel = index >= variantsPerStage;
+            ShaderCompileDesc variant;
+            variant.fileName = desc.fileName;
+            variant.entryPoint = pixel ? desc.pixelEntry : desc.vertexEntry;
+            variant.profile = pixel ? desc.pixelProfile : desc.vertexProfile;
+            variant.flags = desc.flags;
+            variant.defines = definesForMask(desc.features, index % variantsPerStage);
+
+            uint64_t key = 0;
+            if (desc.cache) {
+                key = desc.cache->computeKey(variant);
+                if (key != 0 && desc.cache->load(key, bytecodes[index])) {
+                    fromCache[index] = 1;
+                    continue;
+                }
+            }
+            const double compileStart = Profiler::now();
+            results[index] = compile(variant, bytecodes[index]);
+            compileTimes[index] = Profiler::now() - compileStart;
+            if (SUCCEEDED(results[index]) && bytecodes[index].empty()) {
+                results[index] = E_FAIL;
+            }
+            if (SUCCEEDED(results[index]) && key != 0) {
+                desc.cache->store(key, bytecodes[index].data(), bytecodes[index].size());
+            }
+        }
+    };
+    if (desc.jobs) {
+        desc.jobs->parallelFor(total, 1, compileRange);
+    }
+    else {
+        compileRange(0, total, 0);
+    }
+    for (unsigned int index = 0; index < total; ++index) {
+        if (FAILED(results[index])) {
+            ERROR("ShaderLibrary", "build",
+                ("Failed to compile " + desc.fileName + (index >= variantsPerStage ? " PS" : " VS") +
+                 " variant mask " + std::to_string(index % variantsPerStage)).c_str());
+            return results[index];
+        }
+    }
+
+    // Bytecodes iguales comparten blob.
+    std::vector<uint32_t> slotBlobs(total);
+    std::vector<uint32_t> uniqueIndices;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> byHash;
+    unsigned long long bytecodeBytes = 0;
+    for (unsigned int index = 0; index < total; ++index) {
+        const std::vector<unsigned char>& bytes = bytecodes[index];
+        bytecodeBytes += bytes.size();
+        std::vector<uint32_t>& candidates = byHash[ResourceCache::hashContent(bytes.data(), bytes.size())];
+        uint32_t blob = static_cast<uint32_t>(uniqueIndices.size());
+        for (uint32_t candidate : candidates) {
+            if (bytecodes[uniqueIndices[candidate]] == bytes) {
+                blob = candidate;
+                break;
+            }
+        }
+        if (blob == uniqueIndices.size()) {
+            candidates.push_back(blob);
+            uniqueIndices.push_back(index);
+        }
+        slotBlobs[index] = blob;
+    }
+
+    // Todo lo que va tras la cabecera, con los offsets de los blobs ya absolutos.
+    std::vector<unsigned char> payload;
+    for (const std::string& feature : desc.features) {
+        append(payload, static_cast<uint32_t>(feature.size()));
+        payload.insert(payload.end(), feature.begin(), feature.end());
+    }
+    for (uint32_t blob : slotBlobs) {
+        append(payload, blob);
+    }
+    size_t offset = sizeof(LibraryHeader) + payload.size() + uniqueIndices.size() * sizeof(BlobEntry);
+    for (uint32_t index : uniqueIndices) {
+        offset = (offset + 15) & ~static_cast<size_t>(15);
+        append(payload, BlobEntry{ offset, bytecodes[index].size() });
+        offset += bytecodes[index].size();
+    }
+    for (uint32_t index : uniqueIndices) {
+        payload.resize(((sizeof(LibraryHeader) + payload.size() + 15) & ~static_cast<size_t>(15)) -
+                       sizeof(LibraryHeader), 0);
+        payload.insert(payload.end(), bytecodes[index].begin(), bytecodes[index].end());
+    }
+
+    LibraryHeader header = {};
+    header.magic = LIBRARY_MAGIC;
+    header.format = LIBRARY_FORMAT;
+    header.compilerVersion = desc.compilerVersion;
+    header.featureCount = featureCount;
+    header.blobCount = static_cast<uint32_t>(uniqueIndices.size());
+    header.payloadHash = ResourceCache::hashContent(payload.data(), payload.size());
+
+    std::ofstream file(outputFile, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        ERROR("ShaderLibrary", "build", ("Could not open file: " + outputFile).c_str());
+        return E_FAIL;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    if (!file) {
+        ERROR("ShaderLibrary", "build", ("Failed to write shader library: " + outputFile).c_str());
+        return E_FAIL;
+    }
+
+    if (stats) {
+        *stats = ShaderLibraryBuildStats();
+        stats->variants = total;
+        for (unsigned int index = 0; index < total; ++index) {
+            (fromCache[index] ? stats->cached : stats->compiled)++;
+            stats->compileMs += compileTimes[index];
+        }
+        stats->uniqueBlobs = header.blobCount;
+        stats->bytecodeBytes = bytecodeBytes;
+        stats->fileBytes = sizeof(header) + payload.size();
+        stats->totalMs = Profiler::now() - start;
+    }
+    return S_OK;
+}
+
+HRESULT
+ShaderLibrary::loadFromFile(const std::string& fileName) {
+    destroy();
+    HRESULT hr = m_file.init(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    const unsigned char* data = m_file.getData();
+    const size_t size = m_file.getSize();
+    Reader reader = { data, size, 0 };
+    LibraryHeader header = {};
+    bool valid = reader.read(header) && header.magic == LIBRARY_MAGIC && header.format == LIBRARY_FORMAT &&
+                 header.featureCount <= MAX_FEATURES &&
+                 ResourceCache::hashContent(data + sizeof(header), size - sizeof(header)) == header.payloadHash;
+
+    std::vector<std::string> features;
+    for (uint32_t f = 0; valid && f < header.featureCount; ++f) {
+        uint32_t length = 0;
+        valid = reader.read(length) && length <= size - reader.pos;
+        if (valid) {
+            features.emplace_back(reinterpret_cast<const char*>(data + reader.pos), length);
+            reader.pos += length;
+        }
+    }
+    const uint32_t total = STAGE_COUNT << header.featureCount;
+    std::vector<uint32_t> slotBlobs(valid ? total : 0);
+    for (uint32_t& blob : slotBlobs) {
+        valid = valid && reader.read(blob) && blob < header.blobCount;
+    }
+    std::vector<Slot> blobs(valid ? header.blobCount : 0);
+    for (Slot& blob : blobs) {
+        BlobEntry entry = {};
+        valid = valid && reader.read(entry) && entry.offset <= size && entry.size <= size - entry.offset &&
+                entry.size <= UINT32_MAX;
+        if (valid) {
+            blob.data = data + entry.offset;
+            blob.size = static_cast<uint32_t>(entry.size);
+        }
+    }
+    if (!valid) {
+        ERROR("ShaderLibrary", "loadFromFile", ("Invalid or corrupted shader library: " + fileName).c_str());
+        destroy();
+        return E_FAIL;
+    }
+
+    m_slots.resize(total);
+    for (uint32_t index = 0; index < total; ++index) {
+        m_slots[index] = blobs[slotBlobs[index]];
+    }
+    m_features = std::move(features);
+    m_featureCount = header.featureCount;
+    m_maskLimit = (1u << header.featureCount) - 1;
+    m_uniqueBlobs = header.blobCount;
+    m_compilerVersion = header.compilerVersion;
+    return S_OK;
+}
+
+void
+ShaderLibrary::destroy() {
+    m_slots.clear();
+    m_features.clear();
+    m_featureCount = 0;
+    m_maskLimit = 0;
+    m_uniqueBlobs = 0;
+    m_compilerVersion = 0;
+    m_file.destroy();
+}
+
+uint32_t
+ShaderLibrary::getFeatureMask(const std::vector<std::string>& names) const {
+    uint32_t mask = 0;
+    for (const std::string& name : names) {
+        const auto found = std::find(m_features.begin(), m_features.end(), name);
+        if (found == m_features.end()) {
+            ERROR("ShaderLibrary", "getFeatureMask", ("Unknown shader feature: " + name).c_str());
+            continue;
+        }
+        mask |= 1u << (found - m_features.begin());
+    }
+    return mask;
+}
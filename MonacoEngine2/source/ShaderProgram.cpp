@@ -1,12 +1,13 @@
 #include "ShaderProgram.h"
 #include "Device.h"
 #include "DeviceContext.h"
-
+#include "ShaderCache.h"
 
 HRESULT
 ShaderProgram::init(Device& device,
 	const std::string& fileName,
-	std::vector<D3D11_INPUT_ELEMENT_DESC> Layout) {
+	std::vector<D3D11_INPUT_ELEMENT_DESC> Layout,
+	ShaderCache* cache) {
 	if (!device.m_device) {
 		ERROR("ShaderProgram", "init", "Device is null.");
 		return E_POINTER;
@@ -20,6 +21,7 @@ ShaderProgram::init(Device& device,
 		return E_INVALIDARG;
 	}
 	m_shaderFileName = fileName;
+	m_cache = cache;
 	HRESULT hr = CreateShader(device, ShaderType::VERTEX_SHADER);
 	if (FAILED(hr)) {
 		ERROR("ShaderProgram", "init", "Failed to create vertex shader.");
@@ -43,6 +45,126 @@ ShaderProgram::init(Device& device,
 	return hr;
 }
 
+HRESULT
+ShaderProgram::init(Device& device,
+	const ShaderLibrary& library,
+	uint32_t featureMask,
+	std::vector<D3D11_INPUT_ELEMENT_DESC> Layout) {
+	if (!device.m_device) {
+		ERROR("ShaderProgram", "init", "Device is null.");
+		return E_POINTER;
+	}
+	if (library.empty()) {
+		ERROR("ShaderProgram", "init", "Shader library is empty.");
+		return E_INVALIDARG;
+	}
+
+	size_t vertexSize = 0;
+	size_t pixelSize = 0;
+	const unsigned char* vertexBytecode = library.find(ShaderStage::Vertex, featureMask, vertexSize);
+	const unsigned char* pixelBytecode = library.find(ShaderStage::Pixel, featureMask, pixelSize);
+	return initFromBytecode(device, vertexBytecode, vertexSize, pixelBytecode, pixelSize, Layout);
+}
+
+HRESULT
+ShaderProgram::initFromBytecode(Device& device,
+	const void* vertexBytecode,
+	size_t vertexSize,
+	const void* pixelBytecode,
+	size_t pixelSize,
+	std::vector<D3D11_INPUT_ELEMENT_DESC> Layout) {
+	if (!device.m_device) {
+		ERROR("ShaderProgram", "initFromBytecode", "Device is null.");
+		return E_POINTER;
+	}
+	if (!vertexBytecode || !vertexSize || !pixelBytecode || !pixelSize) {
+		ERROR("ShaderProgram", "initFromBytecode", "Shader bytecode is empty.");
+		return E_INVALIDARG;
+	}
+	if (Layout.empty()) {
+		ERROR("ShaderProgram", "initFromBytecode", "Input layout is empty.");
+		return E_INVALIDARG;
+	}
+
+	// El VS se copia a un blob porque InputLayout lo necesita; el PS tambien, por simetria con
+	// CreateShader (m_pixelShaderData).
+	HRESULT hr = S_OK;
+	for (ShaderType type : { VERTEX_SHADER, PIXEL_SHADER }) {
+		const size_t size = type == PIXEL_SHADER ? pixelSize : vertexSize;
+		ID3DBlob* shaderData = nullptr;
+		hr = D3DCreateBlob(size, &shaderData);
+		if (FAILED(hr)) {
+			ERROR("ShaderProgram", "initFromBytecode", "Failed to allocate shader bytecode blob.");
+			return hr;
+		}
+		memcpy(shaderData->GetBufferPointer(), type == PIXEL_SHADER ? pixelBytecode : vertexBytecode, size);
+		hr = CreateShaderFromBlob(device, type, shaderData);
+		if (FAILED(hr)) {
+			return hr;
+		}
+		if (type == VERTEX_SHADER) {
+			hr = CreateInputLayout(device, Layout);
+			if (FAILED(hr)) {
+				ERROR("ShaderProgram", "initFromBytecode", "Failed to create input layout.");
+				return hr;
+			}
+		}
+	}
+	return hr;
+}
+
+HRESULT
+ShaderProgram::initFromSource(Device& device,
+	const std::string& source,
+	const std::string& name,
+	std::vector<D3D11_INPUT_ELEMENT_DESC> Layout) {
+	if (!device.m_device) {
+		ERROR("ShaderProgram", "initFromSource", "Device is null.");
+		return E_POINTER;
+	}
+	if (source.empty() || Layout.empty()) {
+		ERROR("ShaderProgram", "initFromSource", "Shader source or input layout is empty.");
+		return E_INVALIDARG;
+	}
+
+	HRESULT hr = S_OK;
+	for (ShaderType type : { VERTEX_SHADER, PIXEL_SHADER }) {
+		ID3DBlob* shaderData = nullptr;
+		ID3DBlob* pErrorBlob = nullptr;
+		hr = D3DCompile(source.data(),
+			source.size(),
+			name.c_str(),
+			nullptr,
+			nullptr,
+			type == PIXEL_SHADER ? "PS" : "VS",
+			type == PIXEL_SHADER ? "ps_4_0" : "vs_4_0",
+			getCompileFlags(),
+			0,
+			&shaderData,
+			&pErrorBlob);
+		if (FAILED(hr)) {
+			ERROR("ShaderProgram", "initFromSource",
+				("Failed to compile shader source: " + name + ". Error: " +
+				 (pErrorBlob ? static_cast<const char*>(pErrorBlob->GetBufferPointer()) : "No error message available.")).c_str());
+			SAFE_RELEASE(pErrorBlob);
+			return hr;
+		}
+		SAFE_RELEASE(pErrorBlob);
+		hr = CreateShaderFromBlob(device, type, shaderData);
+		if (FAILED(hr)) {
+			return hr;
+		}
+		if (type == VERTEX_SHADER) {
+			hr = CreateInputLayout(device, Layout);
+			if (FAILED(hr)) {
+				ERROR("ShaderProgram", "initFromSource", "Failed to create input layout.");
+				return hr;
+			}
+		}
+	}
+	return hr;
+}
+
 HRESULT
 ShaderProgram::CreateInputLayout(Device& device,
 	std::vector<D3D11_INPUT_ELEMENT_DESC> Layout) {
@@ -88,17 +210,45 @@ ShaderProgram::CreateShader(Device& device, ShaderType type) {
 	const char* shaderModel = (type == ShaderType::PIXEL_SHADER) ? "ps_4_0" : "vs_4_0";
 
 
-	hr = CompileShaderFromFile(m_shaderFileName.data(),
-		shaderEntryPoint,
-		shaderModel,
-		&shaderData);
+	// Con cache: una entrada valida evita la compilacion; un fallo compila y la guarda.
+	uint64_t cacheKey = 0;
+	if (m_cache) {
+		ShaderCompileDesc desc;
+		desc.fileName = m_shaderFileName;
+		desc.entryPoint = shaderEntryPoint;
+		desc.profile = shaderModel;
+		desc.flags = getCompileFlags();
+		cacheKey = m_cache->computeKey(desc);
+
+		std::vector<unsigned char> bytecode;
+		if (cacheKey != 0 && m_cache->load(cacheKey, bytecode) &&
+			SUCCEEDED(D3DCreateBlob(bytecode.size(), &shaderData))) {
+			memcpy(shaderData->GetBufferPointer(), bytecode.data(), bytecode.size());
+		}
+	}
 
-	if (FAILED(hr)) {
-		ERROR("ShaderProgram", "CreateShader",
-			"Failed to compile shader from file: %s", m_shaderFileName.c_str());
-		return hr;
+	if (!shaderData) {
+		hr = CompileShaderFromFile(m_shaderFileName.data(),
+			shaderEntryPoint,
+			shaderModel,
+			&shaderData);
+
+		if (FAILED(hr)) {
+			ERROR("ShaderProgram", "CreateShader",
+				"Failed to compile shader from file: %s", m_shaderFileName.c_str());
+			return hr;
+		}
+		if (m_cache && cacheKey != 0) {
+			m_cache->store(cacheKey, shaderData->GetBufferPointer(), shaderData->GetBufferSize());
+		}
 	}
 
+	return CreateShaderFromBlob(device, type, shaderData);
+}
+
+HRESULT
+ShaderProgram::CreateShaderFromBlob(Device& device, ShaderType type, ID3DBlob* shaderData) {
+	HRESULT hr = S_OK;
 	if (type == PIXEL_SHADER) {
 		hr = device.CreatePixelShader(shaderData->GetBufferPointer(),
 			shaderData->GetBufferSize(),
@@ -163,11 +313,7 @@ ShaderProgram::CompileShaderFromFile(char* szFileName,
 	ID3DBlob** ppBlobOut) {
 	HRESULT hr = S_OK;
 
-	DWORD dwShaderFlags = D3DCOMPILE_ENABLE_STRICTNESS;
-#if defined( DEBUG ) || defined( _DEBUG )
-
-	dwShaderFlags |= D3DCOMPILE_DEBUG;
-#endif
+	DWORD dwShaderFlags = getCompileFlags();
 	ID3DBlob* pErrorBlob;
 	hr = D3DX11CompileFromFile(szFileName,
 		nullptr,
@@ -202,6 +348,52 @@ ShaderProgram::CompileShaderFromFile(char* szFileName,
 		return S_OK;
 }
 
+HRESULT
+ShaderProgram::compileVariant(const ShaderCompileDesc& desc, std::vector<unsigned char>& bytecode) {
+	std::vector<D3D10_SHADER_MACRO> macros;
+	for (const ShaderDefine& define : desc.defines) {
+		macros.push_back({ define.name.c_str(), define.value.c_str() });
+	}
+	macros.push_back({ nullptr, nullptr });
+
+	ID3DBlob* shaderData = nullptr;
+	ID3DBlob* pErrorBlob = nullptr;
+	HRESULT hr = D3DX11CompileFromFileA(desc.fileName.c_str(),
+		macros.data(),
+		nullptr,
+		desc.entryPoint.c_str(),
+		desc.profile.c_str(),
+		desc.flags,
+		0,
+		nullptr,
+		&shaderData,
+		&pErrorBlob,
+		nullptr);
+
+	if (FAILED(hr)) {
+		ERROR("ShaderProgram", "compileVariant",
+			("Failed to compile shader from file: " + desc.fileName + " (" + desc.entryPoint + "). Error: " +
+			 (pErrorBlob ? static_cast<const char*>(pErrorBlob->GetBufferPointer()) : "No error message available.")).c_str());
+		SAFE_RELEASE(pErrorBlob);
+		return hr;
+	}
+	SAFE_RELEASE(pErrorBlob);
+
+	const unsigned char* data = static_cast<const unsigned char*>(shaderData->GetBufferPointer());
+	bytecode.assign(data, data + shaderData->GetBufferSize());
+	shaderData->Release();
+	return S_OK;
+}
+
+DWORD
+ShaderProgram::getCompileFlags() {
+	DWORD flags = D3DCOMPILE_ENABLE_STRICTNESS;
+#if defined( DEBUG ) || defined( _DEBUG )
+	flags |= D3DCOMPILE_DEBUG;
+#endif
+	return flags;
+}
+
 void
 ShaderProgram::render(DeviceContext& deviceContext) {
 	if (!m_VertexShader || !m_PixelShader || !m_inputLayout.m_inputLayout) {
@@ -232,6 +424,31 @@ ShaderProgram::render(DeviceContext& deviceContext, ShaderType type) {
 	}
 }
 
+void
+ShaderProgram::share(const ShaderProgram& other) {
+	if (&other == this) {
+		return;
+	}
+	destroy();
+	m_VertexShader = other.m_VertexShader;
+	m_PixelShader = other.m_PixelShader;
+	m_inputLayout.m_inputLayout = other.m_inputLayout.m_inputLayout;
+	if (m_VertexShader) m_VertexShader->AddRef();
+	if (m_PixelShader) m_PixelShader->AddRef();
+	if (m_inputLayout.m_inputLayout) m_inputLayout.m_inputLayout->AddRef();
+}
+
+void
+ShaderProgram::swap(ShaderProgram& other) {
+	std::swap(m_VertexShader, other.m_VertexShader);
+	std::swap(m_PixelShader, other.m_PixelShader);
+	std::swap(m_inputLayout.m_inputLayout, other.m_inputLayout.m_inputLayout);
+	std::swap(m_shaderFileName, other.m_shaderFileName);
+	std::swap(m_cache, other.m_cache);
+	std::swap(m_vertexShaderData, other.m_vertexShaderData);
+	std::swap(m_pixelShaderData, other.m_pixelShaderData);
+}
+
 void
 ShaderProgram::destroy() {
 	SAFE_RELEASE(m_VertexShader);
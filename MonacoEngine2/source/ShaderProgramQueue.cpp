@@ -0,0 +1,190 @@
+#include "ShaderProgramQueue.h"
+#include "Device.h"
+#include "Profiler.h"
+
+HRESULT
+ShaderProgramQueue::init(JobSystem& jobs, ShaderCache* cache) {
+    destroy();
+    m_stats = ShaderProgramQueueStats();
+    return m_compiler.init(&jobs, &ShaderProgram::compileVariant, cache);
+}
+
+void
+ShaderProgramQueue::destroy() {
+    m_compiler.destroy();
+    m_watcher.destroy();
+    m_hotReload = false;
+    m_pending.clear();
+    m_tickets.clear();
+    m_registered.clear();
+}
+
+HRESULT
+ShaderProgramQueue::enableHotReload(ShaderCache& keys, bool forcePolling) {
+    HRESULT hr = m_watcher.init(keys, forcePolling);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    m_hotReload = true;
+    for (const auto& entry : m_registered) {
+        m_watcher.add(entry.second.id, stageDescs(entry.second.fileName, entry.second.defines));
+    }
+    return S_OK;
+}
+
+std::vector<ShaderCompileDesc>
+ShaderProgramQueue::stageDescs(const std::string& fileName, const std::vector<ShaderDefine>& defines) {
+    std::vector<ShaderCompileDesc> stages(2);
+    for (ShaderCompileDesc& desc : stages) {
+        desc.fileName = fileName;
+        desc.defines = defines;
+        desc.flags = ShaderProgram::getCompileFlags();
+    }
+    stages[0].entryPoint = "VS";
+    stages[0].profile = "vs_4_0";
+    stages[1].entryPoint = "PS";
+    stages[1].profile = "ps_4_0";
+    return stages;
+}
+
+HRESULT
+ShaderProgramQueue::request(ShaderProgram& target, const std::string& fileName,
+                            const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout,
+                            const std::vector<ShaderDefine>& defines, const ShaderProgram* fallback) {
+    if (fileName.empty() || layout.empty()) {
+        ERROR("ShaderProgramQueue", "request", "Shader file name or input layout is empty.");
+        return E_INVALIDARG;
+    }
+    if (!target.isReady() && fallback && fallback->isReady()) {
+        target.share(*fallback);
+    }
+    if (isPending(target)) {
+        m_stats.superseded++;
+    }
+
+    // Los tickets de una solicitud reemplazada siguen en m_tickets, pero ya no coinciden con
+    // los de m_pending[target]: update() los descarta al llegar.
+    const std::vector<ShaderCompileDesc> stages = stageDescs(fileName, defines);
+    Pending pending;
+    pending.layout = layout;
+    pending.vertexTicket = m_compiler.request(stages[0]);
+    m_tickets[pending.vertexTicket] = &target;
+    pending.pixelTicket = m_compiler.request(stages[1]);
+    m_tickets[pending.pixelTicket] = &target;
+    m_pending[&target] = std::move(pending);
+
+    Registered& registered = m_registered[&target];
+    if (registered.id == 0) {
+        registered.id = m_nextId++;
+    }
+    registered.fileName = fileName;
+    registered.layout = layout;
+    registered.defines = defines;
+    if (m_hotReload) {
+        m_watcher.add(registered.id, stages);
+    }
+    return S_OK;
+}
+
+void
+ShaderProgramQueue::cancel(ShaderProgram& target) {
+    m_pending.erase(&target);
+    const auto registered = m_registered.find(&target);
+    if (registered != m_registered.end()) {
+        m_watcher.remove(registered->second.id);
+        m_registered.erase(registered);
+    }
+}
+
+bool
+ShaderProgramQueue::isPending(const ShaderProgram& target) const {
+    return m_pending.find(const_cast<ShaderProgram*>(&target)) != m_pending.end();
+}
+
+unsigned int
+ShaderProgramQueue::update(Device& device) {
+    const double start = Profiler::now();
+    unsigned int swapped = 0;
+
+    // Fuentes editadas: se piden de nuevo y el programa actual sigue dibujando mientras tanto.
+    std::vector<unsigned int> changed;
+    if (m_hotReload && m_watcher.poll(changed) > 0) {
+        for (unsigned int id : changed) {
+            const auto registered = std::find_if(m_registered.begin(), m_registered.end(),
+                [id](const std::pair<ShaderProgram* const, Registered>& entry) { return entry.second.id == id; });
+            if (registered == m_registered.end()) {
+                continue;
+            }
+            const Registered reload = registered->second;
+            MESSAGE("ShaderProgramQueue", "update", ("Recargando " + reload.fileName).c_str());
+            if (SUCCEEDED(request(*registered->first, reload.fileName, reload.layout, reload.defines))) {
+                m_stats.reloads++;
+            }
+        }
+    }
+
+    CompiledShader compiled;
+    while (m_compiler.pop(compiled)) {
+        const auto ticket = m_tickets.find(compiled.ticket);
+        if (ticket == m_tickets.end()) {
+            continue;
+        }
+        ShaderProgram* target = ticket->second;
+        m_tickets.erase(ticket);
+        const auto found = m_pending.find(target);
+        if (found == m_pending.end() ||
+            (compiled.ticket != found->second.vertexTicket && compiled.ticket != found->second.pixelTicket)) {
+            continue;   // Solicitud cancelada o reemplazada.
+        }
+
+        Pending& pending = found->second;
+        if (compiled.ticket == pending.vertexTicket) {
+            pending.vertex = std::move(compiled);
+            pending.vertexDone = true;
+        }
+        else {
+            pending.pixel = std::move(compiled);
+            pending.pixelDone = true;
+        }
+        if (!pending.vertexDone || !pending.pixelDone) {
+            continue;
+        }
+
+        // Las dos etapas listas: se crea un programa completo y solo entonces se intercambia.
+        HRESULT hr = FAILED(pending.vertex.result) ? pending.vertex.result : pending.pixel.result;
+        ShaderProgram fresh;
+        if (SUCCEEDED(hr)) {
+            hr = fresh.initFromBytecode(device,
+                pending.vertex.bytecode.data(), pending.vertex.bytecode.size(),
+                pending.pixel.bytecode.data(), pending.pixel.bytecode.size(),
+                pending.layout);
+        }
+        if (SUCCEEDED(hr)) {
+            target->swap(fresh);
+            swapped++;
+        }
+        else {
+            ERROR("ShaderProgramQueue", "update",
+                ("Keeping previous shaders for " + pending.vertex.desc.fileName).c_str());
+            m_stats.failed++;
+        }
+        fresh.destroy();
+        m_pending.erase(found);
+    }
+
+    m_stats.lastSwapped = swapped;
+    m_stats.swapped += swapped;
+    m_stats.lastUpdateMs = Profiler::now() - start;
+    return swapped;
+}
+
+void
+ShaderProgramQueue::publishCounters(const std::string& prefix) const {
+    m_compiler.publishCounters(prefix);
+    Profiler& profiler = Profiler::instance();
+    profiler.setCounter(prefix + "::pendingPrograms", static_cast<long long>(m_pending.size()));
+    profiler.setCounter(prefix + "::swapped", m_stats.swapped);
+    profiler.setCounter(prefix + "::reloads", m_stats.reloads);
+    profiler.setCounter(prefix + "::watchedFiles", static_cast<long long>(m_watcher.getFileCount()));
+    profiler.addSample(prefix + "::update", m_stats.lastUpdateMs);
+}
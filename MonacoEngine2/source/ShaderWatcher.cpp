@@ -0,0 +1,126 @@
+#include "ShaderWatcher.h"
+#include "Profiler.h"
+#include "ResourceCache.h"
+
+HRESULT
+ShaderWatcher::init(ShaderCache& keys, bool forcePolling) {
+    destroy();
+    m_keys = &keys;
+    m_stats = ShaderWatcherStats();
+    return m_watcher.init(forcePolling);
+}
+
+void
+ShaderWatcher::destroy() {
+    m_watcher.destroy();
+    m_programs.clear();
+    m_users.clear();
+    m_keys = nullptr;
+}
+
+HRESULT
+ShaderWatcher::add(unsigned int id, const std::vector<ShaderCompileDesc>& stages) {
+    if (!m_keys || stages.empty()) {
+        ERROR("ShaderWatcher", "add", "Watcher not initialized or program without stages.");
+        return E_INVALIDARG;
+    }
+    remove(id);
+    Program& program = m_programs[id];
+    program.stages = stages;
+    return refresh(id, program);
+}
+
+void
+ShaderWatcher::remove(unsigned int id) {
+    const auto found = m_programs.find(id);
+    if (found != m_programs.end()) {
+        release(id, found->second);
+        m_programs.erase(found);
+    }
+}
+
+HRESULT
+ShaderWatcher::refresh(unsigned int id, Program& program) {
+    // La clave del programa combina las de sus etapas; los archivos son la union de sus dependencias.
+    std::vector<uint64_t> keys;
+    std::vector<std::string> files;
+    for (const ShaderCompileDesc& stage : program.stages) {
+        std::vector<std::string> dependencies;
+        keys.push_back(m_keys->computeKey(stage, &dependencies));
+        if (dependencies.empty()) {
+            dependencies.push_back(stage.fileName);     // Raiz ilegible: se vigila hasta que aparezca.
+        }
+        for (const std::string& dependency : dependencies) {
+            const std::string path = FileWatcher::normalize(dependency);
+            if (std::find(files.begin(), files.end(), path) == files.end()) {
+                files.push_back(path);
+            }
+        }
+    }
+    program.key = ResourceCache::hashContent(keys.data(), keys.size() * sizeof(uint64_t));
+
+    release(id, program);
+    program.files = std::move(files);
+    HRESULT result = S_OK;
+    for (const std::string& file : program.files) {
+        std::vector<unsigned int>& users = m_users[file];
+        if (users.empty()) {
+            HRESULT hr = m_watcher.watch(file);
+            if (FAILED(hr)) {
+                result = hr;
+            }
+        }
+        users.push_back(id);
+    }
+    return result;
+}
+
+void
+ShaderWatcher::release(unsigned int id, const Program& program) {
+    for (const std::string& file : program.files) {
+        const auto users = m_users.find(file);
+        if (users == m_users.end()) {
+            continue;
+        }
+        users->second.erase(std::remove(users->second.begin(), users->second.end(), id), users->second.end());
+        if (users->second.empty()) {
+            m_watcher.unwatch(file);
+            m_users.erase(users);
+        }
+    }
+}
+
+unsigned int
+ShaderWatcher::poll(std::vector<unsigned int>& changed) {
+    const double start = Profiler::now();
+    changed.clear();
+    std::vector<std::string> files;
+    m_stats.fileEvents += m_watcher.poll(files);
+
+    std::vector<unsigned int> affected;
+    for (const std::string& file : files) {
+        const auto users = m_users.find(file);
+        if (users == m_users.end()) {
+            continue;
+        }
+        for (unsigned int id : users->second) {
+            if (std::find(affected.begin(), affected.end(), id) == affected.end()) {
+                affected.push_back(id);
+            }
+        }
+    }
+    for (unsigned int id : affected) {
+        Program& program = m_programs[id];
+        const uint64_t previous = program.key;
+        refresh(id, program);
+        if (program.key != previous) {
+            changed.push_back(id);
+            m_stats.reloads++;
+        }
+        else {
+            m_stats.unchanged++;
+        }
+    }
+    m_stats.pollMs += Profiler::now() - start;
+    return static_cast<unsigned int>(changed.size());
+}
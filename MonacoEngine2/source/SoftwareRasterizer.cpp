@@ -0,0 +1,566 @@
+#include "SoftwareRasterizer.h"
+#include "MeshComponent.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Simd.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    /// Planos de la banda de guarda en multiplos de w (evita perder precision en bordes enormes).
+    const float GUARD_BAND = 8.0f;
+
+    /// Precision de subpixel (igual que D3D11: 8 bits).
+    const float SUBPIXEL_SCALE = 256.0f;
+
+    /// Maximo de vertices tras recortar un triangulo contra 5 planos.
+    const int MAX_CLIP_VERTICES = 9;
+
+    inline float
+    snapSubpixel(float value) {
+        return std::floor(value * SUBPIXEL_SCALE + 0.5f) / SUBPIXEL_SCALE;
+    }
+
+    /// Floats por fila del depth buffer: el ancho redondeado a grupos SIMD completos.
+    inline unsigned int
+    depthPitch(unsigned int width) {
+        const unsigned int lanes = static_cast<unsigned int>(simd::SIMD_LANES);
+        return (width + lanes - 1) / lanes * lanes;
+    }
+
+    /// Muestreo bilineal con direccionamiento WRAP. Escribe RGBA en [0, 255] en @p out.
+    inline void
+    sampleBilinear(const Image& texture, float u, float v, float out[4]) {
+        const int width = static_cast<int>(texture.m_width);
+        const int height = static_cast<int>(texture.m_height);
+
+        float x = (u - std::floor(u)) * width - 0.5f;
+        float y = (v - std::floor(v)) * height - 0.5f;
+        float fx0 = std::floor(x);
+        float fy0 = std::floor(y);
+        float fx = x - fx0;
+        float fy = y - fy0;
+
+        int x0 = static_cast<int>(fx0);
+        int y0 = static_cast<int>(fy0);
+        x0 = (x0 % width + width) % width;
+        y0 = (y0 % height + height) % height;
+        int x1 = (x0 + 1) % width;
+        int y1 = (y0 + 1) % height;
+
+        const unsigned char* t00 = texture.row(y0) + x0 * 4;
+        const unsigned char* t10 = texture.row(y0) + x1 * 4;
+        const unsigned char* t01 = texture.row(y1) + x0 * 4;
+        const unsigned char* t11 = texture.row(y1) + x1 * 4;
+        for (int c = 0; c < 4; ++c) {
+            float top = t00[c] + (t10[c] - t00[c]) * fx;
+            float bottom = t01[c] + (t11[c] - t01[c]) * fx;
+            out[c] = top + (bottom - top) * fy;
+        }
+    }
+
+    /// Distancia con signo de un vertice a cada plano de recorte (>= 0 adentro).
+    inline float
+    planeDistance(int plane, const float* v) {
+        // v = { x, y, z, w, u, v }
+        switch (plane) {
+        case 0:  return v[2];                       // Plano cercano: z >= 0
+        case 1:  return GUARD_BAND * v[3] - v[0];   // x <= G*w
+        case 2:  return GUARD_BAND * v[3] + v[0];   // x >= -G*w
+        case 3:  return GUARD_BAND * v[3] - v[1];   // y <= G*w
+        default: return GUARD_BAND * v[3] + v[1];   // y >= -G*w
+        }
+    }
+}
+
+HRESULT
+SoftwareRasterizer::init(unsigned int width, unsigned int height, JobSystem& jobSystem) {
+    if (width == 0 || height == 0) {
+        ERROR("SoftwareRasterizer", "init", "Width and height must be greater than 0");
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = m_colorBuffer.init(width, height, 4);
+    if (FAILED(hr)) {
+        ERROR("SoftwareRasterizer", "init", "Failed to create color buffer.");
+        return hr;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    m_tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    m_jobSystem = &jobSystem;
+
+    // Filas de profundidad alineadas a SIMD_LANES para leer grupos completos en el borde derecho.
+    m_depthBuffer.assign(static_cast<size_t>(depthPitch(width)) * height, 1.0f);
+
+    MESSAGE("SoftwareRasterizer", "init", "OK");
+    return S_OK;
+}
+
+void
+SoftwareRasterizer::update(const Matrix4& worldViewProj, const Vector4& meshColor) {
+    m_worldViewProj = worldViewProj;
+    m_meshColor = meshColor;
+}
+
+void
+SoftwareRasterizer::clear(const float color[4], float depth) {
+    if (m_colorBuffer.empty() || !m_jobSystem) {
+        ERROR("SoftwareRasterizer", "clear", "Rasterizer not initialized.");
+        return;
+    }
+
+    unsigned int packed = 0;
+    for (int i = 0; i < 4; ++i) {
+        float c = std::min(std::max(color[i], 0.0f), 1.0f);
+        packed |= static_cast<unsigned int>(c * 255.0f + 0.5f) << (i * 8);
+    }
+
+    const unsigned int pitch = depthPitch(m_width);
+    m_jobSystem->parallelFor(m_height, 32, [&](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int y = begin; y < end; ++y) {
+            unsigned int* row = reinterpret_cast<unsigned int*>(m_colorBuffer.row(y));
+            std::fill(row, row + m_width, packed);
+            float* depthRow = m_depthBuffer.data() + static_cast<size_t>(y) * pitch;
+            std::fill(depthRow, depthRow + pitch, depth);
+        }
+    });
+}
+
+void
+SoftwareRasterizer::render(const MeshComponent& mesh) {
+    drawIndexed(mesh.m_vertex.data(),
+        static_cast<unsigned int>(mesh.m_vertex.size()),
+        mesh.m_index.data(),
+        static_cast<unsigned int>(mesh.m_numIndex));
+}
+
+void
+SoftwareRasterizer::drawIndexed(const SimpleVertex* vertices,
+                                unsigned int numVertices,
+                                const unsigned int* indices,
+                                unsigned int indexCount) {
+    if (m_colorBuffer.empty() || !m_jobSystem) {
+        ERROR("SoftwareRasterizer", "drawIndexed", "Rasterizer not initialized.");
+        return;
+    }
+    if (!vertices || !indices || numVertices == 0 || indexCount < 3) {
+        return;
+    }
+
+    m_stats = RasterStats();
+    const unsigned int numTriangles = indexCount / 3;
+    const unsigned int numTiles = m_tilesX * m_tilesY;
+    m_stats.trianglesIn = numTriangles;
+
+    // 1. Etapa de vertices: posicion * WorldViewProj (vector fila).
+    double start = Profiler::now();
+    m_clipVertices.resize(numVertices);
+    m_jobSystem->parallelFor(numVertices, 4096, [&](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int i = begin; i < end; ++i) {
+            const SimpleVertex& in = vertices[i];
+            const Vector4 clip = math::transform(Vector4(in.Pos, 1.0f), m_worldViewProj);
+            ClipVertex& out = m_clipVertices[i];
+            out.x = clip.x;
+            out.y = clip.y;
+            out.z = clip.z;
+            out.w = clip.w;
+            out.u = in.Tex.x;
+            out.v = in.Tex.y;
+        }
+    });
+    double vertexEnd = Profiler::now();
+    m_stats.vertexMs = vertexEnd - start;
+
+    // 2. Setup, recorte y clasificacion. Cada bloque escribe solo en sus propias listas.
+    m_numChunks = (numTriangles + TRIANGLES_PER_CHUNK - 1) / TRIANGLES_PER_CHUNK;
+    if (m_triangles.size() < m_numChunks) {
+        m_triangles.resize(m_numChunks);
+    }
+    if (m_bins.size() < static_cast<size_t>(m_numChunks) * numTiles) {
+        m_bins.resize(static_cast<size_t>(m_numChunks) * numTiles);
+    }
+
+    std::atomic<unsigned int> culledTotal(0);
+    std::atomic<unsigned int> clippedTotal(0);
+    m_jobSystem->parallelFor(m_numChunks, 1, [&](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int chunk = begin; chunk < end; ++chunk) {
+            m_triangles[chunk].clear();
+            for (unsigned int t = 0; t < numTiles; ++t) {
+                m_bins[static_cast<size_t>(chunk) * numTiles + t].clear();
+            }
+
+            unsigned int culled = 0;
+            unsigned int clipped = 0;
+            unsigned int first = chunk * TRIANGLES_PER_CHUNK;
+            unsigned int last = std::min(first + TRIANGLES_PER_CHUNK, numTriangles);
+            for (unsigned int tri = first; tri < last; ++tri) {
+                unsigned int i0 = indices[tri * 3 + 0];
+                unsigned int i1 = indices[tri * 3 + 1];
+                unsigned int i2 = indices[tri * 3 + 2];
+                if (i0 >= numVertices || i1 >= numVertices || i2 >= numVertices) {
+                    culled++;
+                    continue;
+                }
+                setupTriangle(m_clipVertices[i0], m_clipVertices[i1], m_clipVertices[i2],
+                    chunk, culled, clipped);
+            }
+            culledTotal += culled;
+            clippedTotal += clipped;
+        }
+    });
+    double binningEnd = Profiler::now();
+    m_stats.binningMs = binningEnd - vertexEnd;
+    m_stats.trianglesCulled = culledTotal.load();
+    m_stats.trianglesClipped = clippedTotal.load();
+
+    // 3. Rasterizacion por tile.
+    std::atomic<unsigned long long> pixels(0);
+    m_jobSystem->parallelFor(numTiles, 1, [&](unsigned int begin, unsigned int end, unsigned int) {
+        unsigned long long local = 0;
+        for (unsigned int tile = begin; tile < end; ++tile) {
+            local += rasterizeTile(tile);
+        }
+        pixels += local;
+    });
+    m_stats.rasterMs = Profiler::now() - binningEnd;
+    m_stats.pixelsShaded = pixels.load();
+
+    Profiler& profiler = Profiler::instance();
+    profiler.addSample("SoftwareRasterizer::vertex", m_stats.vertexMs);
+    profiler.addSample("SoftwareRasterizer::binning", m_stats.binningMs);
+    profiler.addSample("SoftwareRasterizer::raster", m_stats.rasterMs);
+    profiler.setCounter("SoftwareRasterizer::trianglesIn", m_stats.trianglesIn);
+    profiler.setCounter("SoftwareRasterizer::trianglesCulled", m_stats.trianglesCulled);
+    profiler.setCounter("SoftwareRasterizer::trianglesClipped", m_stats.trianglesClipped);
+    profiler.setCounter("SoftwareRasterizer::pixelsShaded", static_cast<long long>(m_stats.pixelsShaded));
+}
+
+void
+SoftwareRasterizer::setupTriangle(const ClipVertex& v0,
+                                    const ClipVertex& v1,
+                                    const ClipVertex& v2,
+                                    unsigned int chunk,
+                                    unsigned int& culled,
+                                    unsigned int& clipped) {
+    const ClipVertex* tri[3] = { &v0, &v1, &v2 };
+
+    // Rechazo trivial: los tres vertices fuera del mismo plano del frustum.
+    unsigned int outAnd = 0x3F;
+    unsigned int outOr = 0;
+    for (int i = 0; i < 3; ++i) {
+        const ClipVertex& v = *tri[i];
+        unsigned int code = 0;
+        if (v.x < -v.w) code |= 1;
+        if (v.x > v.w)  code |= 2;
+        if (v.y < -v.w) code |= 4;
+        if (v.y > v.w)  code |= 8;
+        if (v.z < 0.0f) code |= 16;
+        if (v.z > v.w)  code |= 32;
+        outAnd &= code;
+        outOr |= code;
+    }
+    if (outAnd != 0) {
+        culled++;
+        return;
+    }
+
+    bool needsClip = (outOr & 16) != 0;
+    for (int i = 0; i < 3 && !needsClip; ++i) {
+        const ClipVertex& v = *tri[i];
+        float guard = GUARD_BAND * v.w;
+        needsClip = v.x > guard || v.x < -guard || v.y > guard || v.y < -guard;
+    }
+
+    if (!needsClip) {
+        if (!binTriangle(v0, v1, v2, chunk)) {
+            culled++;
+        }
+        return;
+    }
+
+    // Sutherland-Hodgman contra el plano cercano y la banda de guarda.
+    clipped++;
+    ClipVertex buffers[2][MAX_CLIP_VERTICES];
+    int count = 3;
+    buffers[0][0] = v0;
+    buffers[0][1] = v1;
+    buffers[0][2] = v2;
+    int src = 0;
+    for (int plane = 0; plane < 5 && count >= 3; ++plane) {
+        const ClipVertex* in = buffers[src];
+        ClipVertex* out = buffers[src ^ 1];
+        int outCount = 0;
+        for (int i = 0; i < count; ++i) {
+            const ClipVertex& a = in[i];
+            const ClipVertex& b = in[(i + 1) % count];
+            float da = planeDistance(plane, &a.x);
+            float db = planeDistance(plane, &b.x);
+            if (da >= 0.0f) {
+                out[outCount++] = a;
+            }
+            if ((da >= 0.0f) != (db >= 0.0f) && outCount < MAX_CLIP_VERTICES) {
+                float t = da / (da - db);
+                ClipVertex& v = out[outCount++];
+                v.x = a.x + (b.x - a.x) * t;
+                v.y = a.y + (b.y - a.y) * t;
+                v.z = a.z + (b.z - a.z) * t;
+                v.w = a.w + (b.w - a.w) * t;
+                v.u = a.u + (b.u - a.u) * t;
+                v.v = a.v + (b.v - a.v) * t;
+            }
+        }
+        count = outCount;
+        src ^= 1;
+    }
+
+    bool anyBinned = false;
+    for (int i = 1; i + 1 < count; ++i) {
+        anyBinned |= binTriangle(buffers[src][0], buffers[src][i], buffers[src][i + 1], chunk);
+    }
+    if (!anyBinned) {
+        culled++;
+    }
+}
+
+bool
+SoftwareRasterizer::binTriangle(const ClipVertex& v0,
+                                const ClipVertex& v1,
+                                const ClipVertex& v2,
+                                unsigned int chunk) {
+    const ClipVertex* in[3] = { &v0, &v1, &v2 };
+    float sx[3], sy[3], z[3], invW[3], uw[3], vw[3];
+    for (int i = 0; i < 3; ++i) {
+        const ClipVertex& v = *in[i];
+        invW[i] = 1.0f / v.w;
+        sx[i] = snapSubpixel((v.x * invW[i] * 0.5f + 0.5f) * m_width);
+        sy[i] = snapSubpixel((0.5f - v.y * invW[i] * 0.5f) * m_height);
+        z[i] = v.z * invW[i];
+        uw[i] = v.u * invW[i];
+        vw[i] = v.v * invW[i];
+    }
+
+    // Area con signo: positiva para triangulos en sentido horario (cara frontal en D3D11).
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+    if (!(area > 0.0f)) {
+        return false;
+    }
+
+    float minXf = std::min(sx[0], std::min(sx[1], sx[2]));
+    float maxXf = std::max(sx[0], std::max(sx[1], sx[2]));
+    float minYf = std::min(sy[0], std::min(sy[1], sy[2]));
+    float maxYf = std::max(sy[0], std::max(sy[1], sy[2]));
+    int minX = std::max(0, static_cast<int>(std::floor(minXf)));
+    int minY = std::max(0, static_cast<int>(std::floor(minYf)));
+    int maxX = std::min(static_cast<int>(m_width) - 1, static_cast<int>(std::ceil(maxXf)));
+    int maxY = std::min(static_cast<int>(m_height) - 1, static_cast<int>(std::ceil(maxYf)));
+    if (minX > maxX || minY > maxY) {
+        return false;
+    }
+
+    SetupTriangle setup;
+    setup.topLeft = 0;
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3;
+        float a = sy[i] - sy[j];
+        float b = sx[j] - sx[i];
+        setup.edgeA[i] = a;
+        setup.edgeB[i] = b;
+        setup.edgeC[i] = -(a * sx[i] + b * sy[i]);
+        if (a > 0.0f || (a == 0.0f && b > 0.0f)) {
+            setup.topLeft |= 1u << i;
+        }
+    }
+
+    const float invArea = 1.0f / area;
+    const float dx1 = sx[1] - sx[0], dy1 = sy[1] - sy[0];
+    const float dx2 = sx[2] - sx[0], dy2 = sy[2] - sy[0];
+    auto makePlane = [&](const float* f, float* plane) {
+        float df1 = f[1] - f[0];
+        float df2 = f[2] - f[0];
+        plane[0] = (df1 * dy2 - df2 * dy1) * invArea;
+        plane[1] = (df2 * dx1 - df1 * dx2) * invArea;
+        plane[2] = f[0] - plane[0] * sx[0] - plane[1] * sy[0];
+    };
+    makePlane(z, setup.z);
+    makePlane(invW, setup.invW);
+    makePlane(uw, setup.uOverW);
+    makePlane(vw, setup.vOverW);
+    setup.minX = minX;
+    setup.minY = minY;
+    setup.maxX = maxX;
+    setup.maxY = maxY;
+
+    std::vector<SetupTriangle>& triangles = m_triangles[chunk];
+    const unsigned int index = static_cast<unsigned int>(triangles.size());
+    triangles.push_back(setup);
+
+    const unsigned int numTiles = m_tilesX * m_tilesY;
+    const int tileX0 = minX / static_cast<int>(TILE_SIZE);
+    const int tileX1 = maxX / static_cast<int>(TILE_SIZE);
+    const int tileY0 = minY / static_cast<int>(TILE_SIZE);
+    const int tileY1 = maxY / static_cast<int>(TILE_SIZE);
+    for (int ty = tileY0; ty <= tileY1; ++ty) {
+        for (int tx = tileX0; tx <= tileX1; ++tx) {
+            // Descarta tiles completamente fuera de algun borde (esquina mas favorable < 0).
+            float x0 = static_cast<float>(tx * TILE_SIZE);
+            float y0 = static_cast<float>(ty * TILE_SIZE);
+            float x1 = x0 + TILE_SIZE;
+            float y1 = y0 + TILE_SIZE;
+            bool outside = false;
+            for (int e = 0; e < 3 && !outside; ++e) {
+                float bestX = setup.edgeA[e] > 0.0f ? x1 : x0;
+                float bestY = setup.edgeB[e] > 0.0f ? y1 : y0;
+                outside = setup.edgeA[e] * bestX + setup.edgeB[e] * bestY + setup.edgeC[e] < 0.0f;
+            }
+            if (!outside) {
+                m_bins[static_cast<size_t>(chunk) * numTiles + ty * m_tilesX + tx].push_back(index);
+            }
+        }
+    }
+    return true;
+}
+
+unsigned long long
+SoftwareRasterizer::rasterizeTile(unsigned int tile) {
+    using namespace simd;
+    const int lanes = SIMD_LANES;
+    const unsigned int numTiles = m_tilesX * m_tilesY;
+    const int tileX0 = static_cast<int>((tile % m_tilesX) * TILE_SIZE);
+    const int tileY0 = static_cast<int>((tile / m_tilesX) * TILE_SIZE);
+    const int tileX1 = std::min(tileX0 + static_cast<int>(TILE_SIZE), static_cast<int>(m_width)) - 1;
+    const int tileY1 = std::min(tileY0 + static_cast<int>(TILE_SIZE), static_cast<int>(m_height)) - 1;
+    const unsigned int pitch = depthPitch(m_width);
+
+    const FloatV centers = laneCenters();
+    const FloatV zeroV = zero();
+    const FloatV one = set1(1.0f);
+    const FloatV tileRight = set1(static_cast<float>(tileX1 + 1));
+    const FloatV meshColor[4] = { set1(m_meshColor.x), set1(m_meshColor.y), set1(m_meshColor.z), set1(m_meshColor.w) };
+    const FloatV white = set1(255.0f);
+    const FloatV inv255 = set1(1.0f / 255.0f);
+    const FloatV half = set1(0.5f);
+    const bool textured = m_texture && !m_texture->empty();
+    unsigned long long shaded = 0;
+
+    for (unsigned int chunk = 0; chunk < m_numChunks; ++chunk) {
+        const std::vector<unsigned int>& bin = m_bins[static_cast<size_t>(chunk) * numTiles + tile];
+        const std::vector<SetupTriangle>& triangles = m_triangles[chunk];
+
+        for (unsigned int index : bin) {
+            const SetupTriangle& tri = triangles[index];
+            const int startX = std::max(tri.minX, tileX0) / lanes * lanes;
+            const int endX = std::min(tri.maxX, tileX1);
+            const int startY = std::max(tri.minY, tileY0);
+            const int endY = std::min(tri.maxY, tileY1);
+
+            FloatV edgeA[3], edgeB[3], edgeC[3], topLeft[3];
+            for (int e = 0; e < 3; ++e) {
+                edgeA[e] = set1(tri.edgeA[e]);
+                edgeB[e] = set1(tri.edgeB[e]);
+                edgeC[e] = set1(tri.edgeC[e]);
+                topLeft[e] = maskFrom(((tri.topLeft >> e) & 1) != 0);
+            }
+            const FloatV zA = set1(tri.z[0]);
+            const FloatV wA = set1(tri.invW[0]);
+            const FloatV uA = set1(tri.uOverW[0]);
+            const FloatV vA = set1(tri.vOverW[0]);
+
+            for (int y = startY; y <= endY; ++y) {
+                const FloatV py = set1(y + 0.5f);
+                FloatV rowE[3];
+                for (int e = 0; e < 3; ++e) {
+                    rowE[e] = add(mul(edgeB[e], py), edgeC[e]);
+                }
+                const float fy = y + 0.5f;
+                const FloatV zRow = set1(tri.z[1] * fy + tri.z[2]);
+                const FloatV wRow = set1(tri.invW[1] * fy + tri.invW[2]);
+                const FloatV uRow = set1(tri.uOverW[1] * fy + tri.uOverW[2]);
+                const FloatV vRow = set1(tri.vOverW[1] * fy + tri.vOverW[2]);
+
+                float* depthRow = m_depthBuffer.data() + static_cast<size_t>(y) * pitch;
+                unsigned char* colorRow = m_colorBuffer.row(y);
+
+                for (int x = startX; x <= endX; x += lanes) {
+                    const FloatV px = add(set1(static_cast<float>(x)), centers);
+
+                    // Cobertura: E > 0, o E == 0 en bordes top-left.
+                    FloatV mask = cmplt(px, tileRight);
+                    for (int e = 0; e < 3; ++e) {
+                        FloatV value = add(mul(edgeA[e], px), rowE[e]);
+                        FloatV inside = orv(cmpgt(value, zeroV), andv(cmpeq(value, zeroV), topLeft[e]));
+                        mask = andv(mask, inside);
+                    }
+                    if (movemask(mask) == 0) {
+                        continue;
+                    }
+
+                    // Prueba de profundidad LESS.
+                    FloatV depth = add(mul(zA, px), zRow);
+                    FloatV stored = load(depthRow + x);
+                    mask = andv(mask, cmplt(depth, stored));
+                    int bits = movemask(mask);
+                    if (bits == 0) {
+                        continue;
+                    }
+                    store(depthRow + x, select(mask, depth, stored));
+
+                    // Interpolacion con correccion de perspectiva.
+                    FloatV w = div(one, add(mul(wA, px), wRow));
+                    float u[SIMD_LANES];
+                    float v[SIMD_LANES];
+                    store(u, mul(add(mul(uA, px), uRow), w));
+                    store(v, mul(add(mul(vA, px), vRow), w));
+
+                    // Texturas lane por lane; carriles sin cobertura quedan en cero.
+                    float texel[4][SIMD_LANES] = {};
+                    for (int lane = 0; lane < lanes; ++lane) {
+                        if (!(bits & (1 << lane))) {
+                            continue;
+                        }
+                        float rgba[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+                        if (textured) {
+                            sampleBilinear(*m_texture, u[lane], v[lane], rgba);
+                        }
+                        for (int c = 0; c < 4; ++c) {
+                            texel[c][lane] = rgba[c];
+                        }
+                    }
+
+                    // color = saturate(textura * vMeshColor), redondeado a 8 bits.
+                    FloatV color[4];
+                    for (int c = 0; c < 4; ++c) {
+                        FloatV value = mul(mul(load(texel[c]), inv255), meshColor[c]);
+                        color[c] = add(mul(min(max(value, zeroV), one), white), half);
+                    }
+                    unsigned char pixels[4 * SIMD_LANES];
+                    storeRgba(pixels, color[0], color[1], color[2], color[3]);
+                    for (int lane = 0; lane < lanes; ++lane) {
+                        if (bits & (1 << lane)) {
+                            memcpy(colorRow + (x + lane) * 4, pixels + lane * 4, 4);
+                            shaded++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return shaded;
+}
+
+void
+SoftwareRasterizer::destroy() {
+    m_colorBuffer.destroy();
+    m_depthBuffer.clear();
+    m_depthBuffer.shrink_to_fit();
+    m_clipVertices.clear();
+    m_triangles.clear();
+    m_bins.clear();
+    m_numChunks = 0;
+    m_texture = nullptr;
+    m_jobSystem = nullptr;
+}
@@ -0,0 +1,320 @@
+#include "SpatialGrid.h"
+#include "FrustumCuller.h"
+#include "Profiler.h"
+#include <cmath>
+
+const unsigned int SpatialGrid::INVALID_HANDLE;
+const unsigned int SpatialGrid::OVERSIZED_CELL;
+
+namespace {
+    /// Desplazamiento para que las coordenadas de celda negativas quepan en 21 bits.
+    const int KEY_BIAS = 1 << 20;
+    const unsigned long long KEY_MASK = (1ull << 21) - 1;
+
+    inline bool
+    overlaps(const AABB& a, const AABB& b) {
+        return a.min.x <= b.max.x && a.max.x >= b.min.x
+            && a.min.y <= b.max.y && a.max.y >= b.min.y
+            && a.min.z <= b.max.z && a.max.z >= b.min.z;
+    }
+
+    /// Distancia al cuadrado de un punto a la caja.
+    inline float
+    distanceSq(const AABB& box, const Vector3& p) {
+        float dx = std::max(std::max(box.min.x - p.x, 0.0f), p.x - box.max.x);
+        float dy = std::max(std::max(box.min.y - p.y, 0.0f), p.y - box.max.y);
+        float dz = std::max(std::max(box.min.z - p.z, 0.0f), p.z - box.max.z);
+        return dx * dx + dy * dy + dz * dz;
+    }
+}
+
+HRESULT
+SpatialGrid::init(float cellSize) {
+    if (!(cellSize > 0.0f)) {
+        ERROR("SpatialGrid", "init", "Cell size must be greater than 0");
+        return E_INVALIDARG;
+    }
+    destroy();
+    m_cellSize = cellSize;
+    m_invCellSize = 1.0f / cellSize;
+    return S_OK;
+}
+
+unsigned int
+SpatialGrid::insert(const AABB& box, unsigned int userData) {
+    unsigned int handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+    else {
+        handle = static_cast<unsigned int>(m_objects.size());
+        m_objects.push_back(Object());
+    }
+
+    Object& object = m_objects[handle];
+    object.box = box;
+    object.userData = userData;
+    link(handle, findOrCreateCell(box));
+    ++m_objectCount;
+    return handle;
+}
+
+void
+SpatialGrid::move(unsigned int handle, const AABB& box) {
+    Object& object = m_objects[handle];
+    object.box = box;
+
+    // Sin cambio de celda: solo se actualiza la caja.
+    float halfX = (box.max.x - box.min.x) * 0.5f;
+    float halfY = (box.max.y - box.min.y) * 0.5f;
+    float halfZ = (box.max.z - box.min.z) * 0.5f;
+    bool oversized = std::max(halfX, std::max(halfY, halfZ)) > m_cellSize * 0.5f;
+    if (oversized && object.cell == OVERSIZED_CELL) {
+        return;
+    }
+    if (!oversized && object.cell != OVERSIZED_CELL) {
+        int cx, cy, cz;
+        cellCoords(box.min.x + halfX, box.min.y + halfY, box.min.z + halfZ, cx, cy, cz);
+        const Cell& cell = m_cells[object.cell];
+        if (cell.x == cx && cell.y == cy && cell.z == cz) {
+            return;
+        }
+    }
+
+    unlink(handle);
+    link(handle, findOrCreateCell(box));
+}
+
+void
+SpatialGrid::remove(unsigned int handle) {
+    unlink(handle);
+    m_objects[handle].cell = INVALID_HANDLE;
+    m_freeHandles.push_back(handle);
+    --m_objectCount;
+}
+
+void
+SpatialGrid::clear() {
+    m_objects.clear();
+    m_freeHandles.clear();
+    m_cells.clear();
+    m_cellMap.clear();
+    m_cellBounds.clear();
+    m_oversized.clear();
+    m_objectCount = 0;
+}
+
+void
+SpatialGrid::queryFrustum(FrustumCuller& culler, std::vector<unsigned int>& out) {
+    double start = Profiler::now();
+    out.clear();
+
+    // Celdas con SIMD y en paralelo; despues, los objetos de las celdas visibles.
+    culler.cull(m_cellBounds, m_visibleCells);
+    unsigned int tested = 0;
+    for (unsigned int cellIndex : m_visibleCells) {
+        for (unsigned int handle : m_cells[cellIndex].objects) {
+            const Object& object = m_objects[handle];
+            if (culler.isVisible(object.box)) {
+                out.push_back(object.userData);
+            }
+        }
+        tested += static_cast<unsigned int>(m_cells[cellIndex].objects.size());
+    }
+    for (unsigned int handle : m_oversized) {
+        const Object& object = m_objects[handle];
+        if (culler.isVisible(object.box)) {
+            out.push_back(object.userData);
+        }
+    }
+    tested += static_cast<unsigned int>(m_oversized.size());
+
+    m_stats.queryMs = Profiler::now() - start;
+    m_stats.cellsTested = getCellCount();
+    m_stats.cellsVisible = static_cast<unsigned int>(m_visibleCells.size());
+    m_stats.objectsTested = tested;
+    m_stats.objectsVisible = static_cast<unsigned int>(out.size());
+
+    Profiler& profiler = Profiler::instance();
+    profiler.addSample("SpatialGrid::queryFrustum", m_stats.queryMs);
+    profiler.setCounter("SpatialGrid::cells", m_stats.cellsTested);
+    profiler.setCounter("SpatialGrid::cellsVisible", m_stats.cellsVisible);
+    profiler.setCounter("SpatialGrid::objectsVisible", m_stats.objectsVisible);
+}
+
+void
+SpatialGrid::querySphere(const Vector3& center, float radius, std::vector<unsigned int>& out) const {
+    const float radiusSq = radius * radius;
+    auto visit = [&](unsigned int handle) {
+        const Object& object = m_objects[handle];
+        if (distanceSq(object.box, center) <= radiusSq) {
+            out.push_back(object.userData);
+        }
+    };
+    forEachCell(Vector3(center.x - radius, center.y - radius, center.z - radius),
+                Vector3(center.x + radius, center.y + radius, center.z + radius),
+                [&](const Cell& cell) {
+        for (unsigned int handle : cell.objects) {
+            visit(handle);
+        }
+    });
+    for (unsigned int handle : m_oversized) {
+        visit(handle);
+    }
+}
+
+void
+SpatialGrid::queryAABB(const AABB& box, std::vector<unsigned int>& out) const {
+    auto visit = [&](unsigned int handle) {
+        const Object& object = m_objects[handle];
+        if (overlaps(object.box, box)) {
+            out.push_back(object.userData);
+        }
+    };
+    forEachCell(box.min, box.max, [&](const Cell& cell) {
+        for (unsigned int handle : cell.objects) {
+            visit(handle);
+        }
+    });
+    for (unsigned int handle : m_oversized) {
+        visit(handle);
+    }
+}
+
+void
+SpatialGrid::destroy() {
+    clear();
+    m_objects.shrink_to_fit();
+    m_cells.shrink_to_fit();
+    m_visibleCells.clear();
+    m_visibleCells.shrink_to_fit();
+}
+
+unsigned int
+SpatialGrid::findOrCreateCell(const AABB& box) {
+    float halfX = (box.max.x - box.min.x) * 0.5f;
+    float halfY = (box.max.y - box.min.y) * 0.5f;
+    float halfZ = (box.max.z - box.min.z) * 0.5f;
+    if (std::max(halfX, std::max(halfY, halfZ)) > m_cellSize * 0.5f) {
+        return OVERSIZED_CELL;
+    }
+
+    int cx, cy, cz;
+    cellCoords(box.min.x + halfX, box.min.y + halfY, box.min.z + halfZ, cx, cy, cz);
+    unsigned long long key = cellKey(cx, cy, cz);
+    auto it = m_cellMap.find(key);
+    if (it != m_cellMap.end()) {
+        return it->second;
+    }
+
+    unsigned int index = static_cast<unsigned int>(m_cells.size());
+    m_cells.push_back(Cell());
+    Cell& cell = m_cells.back();
+    cell.x = cx;
+    cell.y = cy;
+    cell.z = cz;
+    m_cellMap.emplace(key, index);
+    m_cellBounds.add(looseBounds(cell));
+    return index;
+}
+
+void
+SpatialGrid::cellCoords(float x, float y, float z, int& cx, int& cy, int& cz) const {
+    cx = static_cast<int>(floorf(x * m_invCellSize));
+    cy = static_cast<int>(floorf(y * m_invCellSize));
+    cz = static_cast<int>(floorf(z * m_invCellSize));
+}
+
+unsigned long long
+SpatialGrid::cellKey(int x, int y, int z) {
+    return ((static_cast<unsigned long long>(x + KEY_BIAS) & KEY_MASK) << 42)
+         | ((static_cast<unsigned long long>(y + KEY_BIAS) & KEY_MASK) << 21)
+         | (static_cast<unsigned long long>(z + KEY_BIAS) & KEY_MASK);
+}
+
+void
+SpatialGrid::link(unsigned int handle, unsigned int cell) {
+    std::vector<unsigned int>& list = cell == OVERSIZED_CELL ? m_oversized : m_cells[cell].objects;
+    Object& object = m_objects[handle];
+    object.cell = cell;
+    object.slot = static_cast<unsigned int>(list.size());
+    list.push_back(handle);
+}
+
+void
+SpatialGrid::unlink(unsigned int handle) {
+    const Object& object = m_objects[handle];
+    const unsigned int cellIndex = object.cell;
+    std::vector<unsigned int>& list = cellIndex == OVERSIZED_CELL ? m_oversized : m_cells[cellIndex].objects;
+
+    unsigned int moved = list.back();
+    list[object.slot] = moved;
+    m_objects[moved].slot = object.slot;
+    list.pop_back();
+
+    if (cellIndex == OVERSIZED_CELL || !list.empty()) {
+        return;
+    }
+
+    // Celda vacia: la ultima celda ocupa su lugar (igual que en m_cellBounds).
+    m_cellMap.erase(cellKey(m_cells[cellIndex].x, m_cells[cellIndex].y, m_cells[cellIndex].z));
+    unsigned int last = static_cast<unsigned int>(m_cells.size()) - 1;
+    if (cellIndex != last) {
+        m_cells[cellIndex] = std::move(m_cells[last]);
+        const Cell& cell = m_cells[cellIndex];
+        m_cellMap[cellKey(cell.x, cell.y, cell.z)] = cellIndex;
+        for (unsigned int other : cell.objects) {
+            m_objects[other].cell = cellIndex;
+        }
+    }
+    m_cells.pop_back();
+    m_cellBounds.remove(cellIndex);
+}
+
+AABB
+SpatialGrid::looseBounds(const Cell& cell) const {
+    // Celda extendida media celda por lado.
+    AABB box;
+    box.min = Vector3((cell.x - 0.5f) * m_cellSize, (cell.y - 0.5f) * m_cellSize, (cell.z - 0.5f) * m_cellSize);
+    box.max = Vector3((cell.x + 1.5f) * m_cellSize, (cell.y + 1.5f) * m_cellSize, (cell.z + 1.5f) * m_cellSize);
+    return box;
+}
+
+template<class CellFunc>
+void
+SpatialGrid::forEachCell(const Vector3& min, const Vector3& max, CellFunc&& func) const {
+    // Un objeto de la celda c puede llegar hasta media celda fuera de ella.
+    const float margin = m_cellSize * 0.5f;
+    int x0, y0, z0, x1, y1, z1;
+    cellCoords(min.x - margin, min.y - margin, min.z - margin, x0, y0, z0);
+    cellCoords(max.x + margin, max.y + margin, max.z + margin, x1, y1, z1);
+
+    unsigned long long range = static_cast<unsigned long long>(x1 - x0 + 1)
+                             * static_cast<unsigned long long>(y1 - y0 + 1)
+                             * static_cast<unsigned long long>(z1 - z0 + 1);
+    if (range <= m_cells.size()) {
+        // Region pequena: buscar cada coordenada en la tabla hash.
+        for (int z = z0; z <= z1; ++z) {
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    auto it = m_cellMap.find(cellKey(x, y, z));
+                    if (it != m_cellMap.end()) {
+                        func(m_cells[it->second]);
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    // Region grande: recorrer las celdas ocupadas.
+    AABB query;
+    query.min = min;
+    query.max = max;
+    for (const Cell& cell : m_cells) {
+        if (overlaps(looseBounds(cell), query)) {
+            func(cell);
+        }
+    }
+}
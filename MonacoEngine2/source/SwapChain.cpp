@@ -61,8 +61,10 @@ SwapChain::init(Device& device,
         return hr;
     }
 
+    // Back buffer sRGB: el pixel shader escribe en lineal y la GPU codifica (y resuelve el MSAA)
+    // con la curva sRGB, igual que decodifica las texturas _SRGB al muestrearlas.
     m_sampleCount = 4;
-    hr = device.m_device->CheckMultisampleQualityLevels(DXGI_FORMAT_R8G8B8A8_UNORM,
+    hr = device.m_device->CheckMultisampleQualityLevels(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
         m_sampleCount,
         &m_qualityLevels);
     if (FAILED(hr) || m_qualityLevels == 0) {
@@ -77,7 +79,7 @@ SwapChain::init(Device& device,
     sd.BufferCount = 1;
     sd.BufferDesc.Width = window.m_width;
     sd.BufferDesc.Height = window.m_height;
-    sd.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    sd.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
     sd.BufferDesc.RefreshRate.Numerator = 60;
     sd.BufferDesc.RefreshRate.Denominator = 1;
     sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
@@ -1,15 +1,22 @@
-// Definimos esto ANTES de incluir el header para que la librera implemente su cdigo aqu
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-
 #include "Texture.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+
+namespace {
+    /// Formato RGBA8 de cada espacio de color.
+    DXGI_FORMAT rgba8Format(ColorSpace colorSpace) {
+        return static_cast<DXGI_FORMAT>(DdsFile::withColorSpace(DdsFormat::R8G8B8A8_UNORM, colorSpace));
+    }
+}
 
 HRESULT
 Texture::init(Device& device,
     const std::string& textureName,
-    ExtensionType extensionType) {
+    ExtensionType extensionType,
+    ColorSpace colorSpace) {
 
     if (!device.m_device) {
         ERROR("Texture", "init", "Device is null.");
@@ -26,144 +33,328 @@ Texture::init(Device& device,
     case DDS: {
         m_textureName = textureName + ".dds";
 
-        // Carga nativa de DirectX para texturas DDS
-        hr = D3DX11CreateShaderResourceViewFromFile(
-            device.m_device,
-            m_textureName.c_str(),
-            nullptr,
-            nullptr,
-            &m_textureFromImg,
-            nullptr
-        );
-
+        // El archivo se proyecta en memoria y cada nivel se sube desde la proyeccin
+        const double start = Profiler::now();
+        DdsFile dds;
+        hr = dds.loadFromFile(m_textureName);
         if (FAILED(hr)) {
             ERROR("Texture", "init",
                 ("Failed to load DDS texture. Verify filepath: " + m_textureName).c_str());
             return hr;
         }
+
+        hr = init(device, dds, 0, colorSpace);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        Profiler::instance().addSample("Texture::init(DDS)", Profiler::now() - start);
         break;
     }
 
-    case PNG: {
-        m_textureName = textureName + ".png";
-        int width, height, channels;
+    case PNG:
+    case JPG: {
+        m_textureName = textureName + (extensionType == PNG ? ".png" : ".jpg");
 
-        // Forzamos 4 canales (RGBA) para que sea compatible con DXGI_FORMAT_R8G8B8A8_UNORM
-        unsigned char* data = stbi_load(m_textureName.c_str(), &width, &height, &channels, 4);
+        MappedFile file;
+        hr = file.init(m_textureName);
+        if (FAILED(hr)) {
+            ERROR("Texture", "init", ("Failed to open texture: " + m_textureName).c_str());
+            return hr;
+        }
 
-        if (!data) {
-            ERROR("Texture", "init",
-                ("Failed to load PNG texture: " + std::string(stbi_failure_reason())).c_str());
-            return E_FAIL;
+        // RGBA8 con la cadena completa filtrada en espacio lineal, escrita directo en la arena
+        // del hilo: sin buffers por textura entre el archivo y D3D11. Los mapas de datos se
+        // promedian tal cual, sin pasar por la curva sRGB.
+        MipSettings mipSettings;
+        mipSettings.jobs = &JobSystem::instance();
+        mipSettings.srgb = colorSpace == ColorSpace::Srgb;
+        UploadImage upload;
+        hr = UploadArena::forThread().decodeImage(file.getData(), file.getSize(), mipSettings, upload);
+        if (FAILED(hr)) {
+            ERROR("Texture", "init", ("Failed to load texture: " + m_textureName).c_str());
+            return hr;
         }
 
-        // 1. Crear descripcin de la textura
-        D3D11_TEXTURE2D_DESC textureDesc = {};
-        textureDesc.Width = width;
-        textureDesc.Height = height;
-        textureDesc.MipLevels = 1;
-        textureDesc.ArraySize = 1;
-        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        textureDesc.SampleDesc.Count = 1;
-        textureDesc.Usage = D3D11_USAGE_DEFAULT;
-        textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-        textureDesc.CPUAccessFlags = 0;
-        textureDesc.MiscFlags = 0;
-
-        // 2. Preparar los datos iniciales
-        D3D11_SUBRESOURCE_DATA initData = {};
-        initData.pSysMem = data;
-        initData.SysMemPitch = width * 4; // 4 bytes por pixel (RGBA)
-
-        // 3. Crear la textura en GPU
-        hr = device.CreateTexture2D(&textureDesc, &initData, &m_texture);
-
-        // Ya no necesitamos los datos en RAM, los liberamos
-        stbi_image_free(data);
+        hr = init(device, upload, colorSpace);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        break;
+    }
+    case HDR: {
+        m_textureName = textureName + ".hdr";
 
+        // RGBA float con mipmaps promediados en lineal, subido como medios floats.
+        HdrImage image;
+        hr = image.loadFromFile(m_textureName);
         if (FAILED(hr)) {
-            ERROR("Texture", "init", "Failed to create texture from PNG data");
             return hr;
         }
+        std::vector<HdrImage> levels;
+        hr = HdrImage::generateMips(std::move(image), levels);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        hr = init(device, levels);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        break;
+    }
+    default:
+        ERROR("Texture", "init", "Unsupported extension type");
+        return E_INVALIDARG;
+    }
 
-        // 4. Crear la vista del recurso (Shader Resource View) para usarlo en el shader
-        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-        srvDesc.Format = textureDesc.Format;
-        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
-        srvDesc.Texture2D.MostDetailedMip = 0;
+    return hr;
+}
 
-        hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
+HRESULT
+Texture::init(Device& device, const Image& image, ColorSpace colorSpace) {
+    if (image.empty() || image.m_channels != 4) {
+        ERROR("Texture", "init", "Image must be a non-empty RGBA8 image.");
+        return E_INVALIDARG;
+    }
+    D3D11_SUBRESOURCE_DATA data = {};
+    data.pSysMem = image.m_pixels.data();
+    data.SysMemPitch = image.getPitch();
+    m_colorSpace = colorSpace;
+    return createFromLevels(device, image.m_width, image.m_height, rgba8Format(colorSpace),
+        std::vector<D3D11_SUBRESOURCE_DATA>(1, data));
+}
 
-        // Liberamos la referencia a la textura base ya que la vista mantiene su propia referencia interna
-        // (Asegrate de que tu clase Texture no intente liberar m_texture de nuevo si ya lo haces aqu, 
-        //  o elimina esta lnea si tu destructor maneja ambos de forma segura)
-        SAFE_RELEASE(m_texture);
+HRESULT
+Texture::init(Device& device, const MipChain& mips, ColorSpace colorSpace) {
+    if (mips.empty()) {
+        ERROR("Texture", "init", "Mip chain is empty.");
+        return E_INVALIDARG;
+    }
+
+    // Un subrecurso por nivel de mip
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(mips.getLevelCount());
+    for (unsigned int level = 0; level < mips.getLevelCount(); ++level) {
+        initData[level].pSysMem = mips.getLevel(level).m_pixels.data();
+        initData[level].SysMemPitch = mips.getLevel(level).getPitch(); // 4 bytes por pixel (RGBA)
+        initData[level].SysMemSlicePitch = 0;
+    }
+    const Image& base = mips.getLevel(0);
+    m_colorSpace = colorSpace;
+    return createFromLevels(device, base.m_width, base.m_height, rgba8Format(colorSpace), initData);
+}
+
+HRESULT
+Texture::init(Device& device, const UploadImage& image, ColorSpace colorSpace) {
+    if (image.levelCount == 0 || image.levels[0].empty()) {
+        ERROR("Texture", "init", "Upload image has no levels.");
+        return E_INVALIDARG;
+    }
+
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(image.levelCount);
+    for (unsigned int level = 0; level < image.levelCount; ++level) {
+        initData[level].pSysMem = image.levels[level].data;
+        initData[level].SysMemPitch = static_cast<UINT>(image.levels[level].rowPitch);
+        initData[level].SysMemSlicePitch = 0;
+    }
+    m_colorSpace = colorSpace;
+    return createFromLevels(device, image.levels[0].width, image.levels[0].height, rgba8Format(colorSpace),
+        initData);
+}
+
+HRESULT
+Texture::init(Device& device, const std::vector<BlockImage>& levels, ColorSpace colorSpace) {
+    if (levels.empty() || levels[0].empty()) {
+        ERROR("Texture", "init", "No compressed levels.");
+        return E_INVALIDARG;
+    }
+    if (levels[0].m_width % 4 != 0 || levels[0].m_height % 4 != 0) {
+        ERROR("Texture", "init", "Block compressed textures must be a multiple of 4 in size.");
+        return E_INVALIDARG;
+    }
+
+    const DXGI_FORMAT format = static_cast<DXGI_FORMAT>(
+        DdsFile::withColorSpace(DdsFile::toDdsFormat(levels[0].m_format), colorSpace));
 
+    // Los niveles menores de 4x4 siguen ocupando un bloque completo por fila.
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(levels.size());
+    for (size_t level = 0; level < levels.size(); ++level) {
+        initData[level].pSysMem = levels[level].m_data.data();
+        initData[level].SysMemPitch = levels[level].getRowPitch();
+        initData[level].SysMemSlicePitch = 0;
+    }
+    m_colorSpace = colorSpace;
+    return createFromLevels(device, levels[0].m_width, levels[0].m_height, format, initData);
+}
+
+HRESULT
+Texture::init(Device& device, const std::vector<HdrImage>& levels, DdsFormat format) {
+    if (levels.empty() || levels[0].empty()) {
+        ERROR("Texture", "init", "No HDR levels.");
+        return E_INVALIDARG;
+    }
+
+    unsigned int bytes = 0;
+    bool compressed = false;
+    DdsFile::getFormatInfo(format, bytes, compressed);
+    std::vector<std::vector<unsigned char>> packed(levels.size());
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(levels.size());
+    for (size_t level = 0; level < levels.size(); ++level) {
+        HRESULT hr = levels[level].pack(format, packed[level], &JobSystem::instance());
         if (FAILED(hr)) {
-            ERROR("Texture", "init", "Failed to create shader resource view for PNG texture");
             return hr;
         }
-        break;
+        initData[level].pSysMem = packed[level].data();
+        initData[level].SysMemPitch = levels[level].m_width * bytes;
+        initData[level].SysMemSlicePitch = 0;
     }
-    case JPG: {
-        m_textureName = textureName + ".jpg";
-        int width, height, channels;
+    m_colorSpace = ColorSpace::Linear;
+    return createFromLevels(device, levels[0].m_width, levels[0].m_height, static_cast<DXGI_FORMAT>(format),
+        initData);
+}
 
-        // Igual que PNG: Forzamos 4 canales
-        unsigned char* data = stbi_load(m_textureName.c_str(), &width, &height, &channels, 4);
+HRESULT
+Texture::init(Device& device, const std::vector<CubeMap>& levels, DdsFormat format) {
+    if (levels.empty() || levels[0].empty()) {
+        ERROR("Texture", "init", "No cube map levels.");
+        return E_INVALIDARG;
+    }
 
-        if (!data) {
-            ERROR("Texture", "init",
-                ("Failed to load JPG texture: " + std::string(stbi_failure_reason())).c_str());
-            return E_FAIL;
+    // Subrecursos en orden de D3D11: todos los niveles de cada cara, cara por cara.
+    const unsigned int levelCount = static_cast<unsigned int>(levels.size());
+    unsigned int bytes = 0;
+    bool compressed = false;
+    DdsFile::getFormatInfo(format, bytes, compressed);
+    std::vector<std::vector<unsigned char>> packed(CubeMap::FACE_COUNT * levelCount);
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(CubeMap::FACE_COUNT * levelCount);
+    for (unsigned int face = 0; face < CubeMap::FACE_COUNT; ++face) {
+        for (unsigned int level = 0; level < levelCount; ++level) {
+            const unsigned int index = face * levelCount + level;
+            HRESULT hr = levels[level].m_faces[face].pack(format, packed[index]);
+            if (FAILED(hr)) {
+                return hr;
+            }
+            initData[index].pSysMem = packed[index].data();
+            initData[index].SysMemPitch = levels[level].m_size * bytes;
+            initData[index].SysMemSlicePitch = 0;
         }
+    }
+    m_colorSpace = ColorSpace::Linear;
+    return createFromLevels(device, levels[0].m_size, levels[0].m_size, static_cast<DXGI_FORMAT>(format),
+        initData, CubeMap::FACE_COUNT, true);
+}
 
-        D3D11_TEXTURE2D_DESC textureDesc = {};
-        textureDesc.Width = width;
-        textureDesc.Height = height;
-        textureDesc.MipLevels = 1;
-        textureDesc.ArraySize = 1;
-        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        textureDesc.SampleDesc.Count = 1;
-        textureDesc.Usage = D3D11_USAGE_DEFAULT;
-        textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-        textureDesc.CPUAccessFlags = 0;
-        textureDesc.MiscFlags = 0;
-
-        D3D11_SUBRESOURCE_DATA initData = {};
-        initData.pSysMem = data;
-        initData.SysMemPitch = width * 4;
-
-        hr = device.CreateTexture2D(&textureDesc, &initData, &m_texture);
-        stbi_image_free(data);
+HRESULT
+Texture::init(Device& device, const DdsFile& dds, unsigned int firstMip, ColorSpace colorSpace) {
+    if (dds.empty()) {
+        ERROR("Texture", "init", "DDS file is empty.");
+        return E_INVALIDARG;
+    }
+    const DdsDesc& desc = dds.getDesc();
+    if (desc.depth > 1) {
+        ERROR("Texture", "init", ("Volume DDS textures are not supported: " + m_textureName).c_str());
+        return E_NOTIMPL;
+    }
+    if (firstMip >= desc.mipLevels) {
+        ERROR("Texture", "init", ("First mip out of range: " + m_textureName).c_str());
+        return E_INVALIDARG;
+    }
 
-        if (FAILED(hr)) {
-            ERROR("Texture", "init", "Failed to create texture from JPG data");
-            return hr;
+    // Los subrecursos ya estn en el orden de D3D11 (nivel + elemento * niveles); se toman
+    // los niveles firstMip en adelante de cada elemento.
+    const unsigned int levels = desc.mipLevels - firstMip;
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(desc.getItemCount() * levels);
+    for (unsigned int item = 0; item < desc.getItemCount(); ++item) {
+        for (unsigned int level = 0; level < levels; ++level) {
+            const unsigned int source = item * desc.mipLevels + firstMip + level;
+            D3D11_SUBRESOURCE_DATA& data = initData[item * levels + level];
+            data.pSysMem = dds.getData(source);
+            data.SysMemPitch = dds.getSurface(source).rowPitch;
+            data.SysMemSlicePitch = dds.getSurface(source).getSlicePitch();
         }
+    }
+    const DdsSurface& top = dds.getSurface(firstMip);
+    const DdsFormat format = DdsFile::withColorSpace(desc.format, colorSpace);
+    m_colorSpace = colorSpace;
+    return createFromLevels(device, top.width, top.height, static_cast<DXGI_FORMAT>(format), initData,
+        desc.getItemCount(), desc.cubemap);
+}
+
+HRESULT
+Texture::createFromLevels(Device& device,
+    unsigned int width,
+    unsigned int height,
+    DXGI_FORMAT format,
+    const std::vector<D3D11_SUBRESOURCE_DATA>& initData,
+    unsigned int arraySize,
+    bool cubemap) {
+    if (!device.m_device) {
+        ERROR("Texture", "init", "Device is null.");
+        return E_POINTER;
+    }
 
-        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-        srvDesc.Format = textureDesc.Format;
+    HRESULT hr = S_OK;
+
+    // 1. Crear descripcin de la textura
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = width;
+    textureDesc.Height = height;
+    textureDesc.MipLevels = static_cast<UINT>(initData.size() / arraySize);
+    textureDesc.ArraySize = arraySize;
+    textureDesc.Format = format;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    textureDesc.CPUAccessFlags = 0;
+    textureDesc.MiscFlags = cubemap ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0;
+
+    // 2. Crear la textura en GPU
+    hr = device.CreateTexture2D(&textureDesc, initData.data(), &m_texture);
+
+    if (FAILED(hr)) {
+        ERROR("Texture", "init", "Failed to create texture from image data");
+        return hr;
+    }
+
+    // 3. Crear la vista del recurso (Shader Resource View) para usarlo en el shader
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = textureDesc.Format;
+    if (cubemap && arraySize == 6) {
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+        srvDesc.TextureCube.MipLevels = textureDesc.MipLevels;
+        srvDesc.TextureCube.MostDetailedMip = 0;
+    }
+    else if (cubemap) {
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBEARRAY;
+        srvDesc.TextureCubeArray.MipLevels = textureDesc.MipLevels;
+        srvDesc.TextureCubeArray.MostDetailedMip = 0;
+        srvDesc.TextureCubeArray.First2DArrayFace = 0;
+        srvDesc.TextureCubeArray.NumCubes = arraySize / 6;
+    }
+    else if (arraySize > 1) {
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        srvDesc.Texture2DArray.MipLevels = textureDesc.MipLevels;
+        srvDesc.Texture2DArray.MostDetailedMip = 0;
+        srvDesc.Texture2DArray.FirstArraySlice = 0;
+        srvDesc.Texture2DArray.ArraySize = arraySize;
+    }
+    else {
         srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
+        srvDesc.Texture2D.MipLevels = textureDesc.MipLevels;
         srvDesc.Texture2D.MostDetailedMip = 0;
+    }
 
-        hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
-        SAFE_RELEASE(m_texture);
+    hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
 
-        if (FAILED(hr)) {
-            ERROR("Texture", "init", "Failed to create shader resource view for JPG texture");
-            return hr;
-        }
-        break;
-    }
-    default:
-        ERROR("Texture", "init", "Unsupported extension type");
-        return E_INVALIDARG;
+    // Liberamos la referencia a la textura base ya que la vista mantiene su propia referencia interna
+    // (Asegrate de que tu clase Texture no intente liberar m_texture de nuevo si ya lo haces aqu, 
+    //  o elimina esta lnea si tu destructor maneja ambos de forma segura)
+    SAFE_RELEASE(m_texture);
+
+    if (FAILED(hr)) {
+        ERROR("Texture", "init", "Failed to create shader resource view for image texture");
+        return hr;
     }
 
-    return hr;
+    return S_OK;
 }
 
 HRESULT
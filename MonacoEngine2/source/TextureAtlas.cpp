@@ -0,0 +1,316 @@
+#include "TextureAtlas.h"
+#include "MeshComponent.h"
+#include "Profiler.h"
+#include <cstring>
+
+namespace {
+    unsigned int roundUp(unsigned int value, unsigned int alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    unsigned int nextPowerOfTwo(unsigned int value) {
+        unsigned int result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+HRESULT
+TextureAtlas::build(const std::vector<AtlasSource>& sources, const AtlasSettings& settings) {
+    destroy();
+    const double start = Profiler::now();
+    if (settings.mipLevels == 0 || settings.mipLevels > 12 ||
+        (settings.maxPageSize & (settings.maxPageSize - 1)) != 0) {
+        ERROR("TextureAtlas", "build", "mipLevels must be 1-12 and maxPageSize a power of two.");
+        return E_INVALIDARG;
+    }
+    for (const AtlasSource& source : sources) {
+        if (!source.image || source.image->empty() || source.image->m_channels != 4) {
+            ERROR("TextureAtlas", "build", "Sources must be non-empty RGBA8 images.");
+            return E_INVALIDARG;
+        }
+    }
+
+    // Margen y tamanos multiplos de la alineacion: cada region empieza en un texel entero de
+    // los primeros mipLevels niveles.
+    const unsigned int alignment = 1u << (settings.mipLevels - 1);
+    const unsigned int gutter = roundUp(std::max(settings.padding, 1u), alignment);
+    m_regions.assign(sources.size(), AtlasRegion());
+    m_stats.sources = static_cast<unsigned int>(sources.size());
+
+    std::vector<Rect> cells(sources.size(), Rect{ 0, 0, 0, 0 });
+    std::vector<unsigned int> pending;
+    std::map<std::pair<unsigned int, unsigned int>, std::vector<unsigned int>> tiled;
+    for (unsigned int i = 0; i < sources.size(); ++i) {
+        const Image& image = *sources[i].image;
+        const bool small = image.m_width <= settings.maxRegionSize && image.m_height <= settings.maxRegionSize;
+        const unsigned int cellWidth = roundUp(image.m_width, alignment) + 2 * gutter;
+        const unsigned int cellHeight = roundUp(image.m_height, alignment) + 2 * gutter;
+        if (!small || cellWidth > settings.maxPageSize || cellHeight > settings.maxPageSize) {
+            continue;
+        }
+        if (sources[i].tiling) {
+            if (settings.useArrays) {
+                tiled[std::make_pair(image.m_width, image.m_height)].push_back(i);
+            }
+            continue;
+        }
+        cells[i].width = cellWidth;
+        cells[i].height = cellHeight;
+        pending.push_back(i);
+    }
+
+    // Del mas grande al mas pequeno por lado mayor y despues por area: MaxRects rinde mejor.
+    std::sort(pending.begin(), pending.end(), [&cells](unsigned int a, unsigned int b) {
+        const unsigned int sideA = std::max(cells[a].width, cells[a].height);
+        const unsigned int sideB = std::max(cells[b].width, cells[b].height);
+        if (sideA != sideB) {
+            return sideA > sideB;
+        }
+        return cells[a].width * cells[a].height > cells[b].width * cells[b].height;
+    });
+
+    unsigned long long regionPixels = 0;
+    unsigned long long cellPixels = 0;
+    unsigned long long pagePixels = 0;
+    while (!pending.empty()) {
+        // La pagina mas chica (cuadrada o 2:1) donde cabe todo lo que queda; si no hay, una de
+        // maxPageSize con lo que quepa.
+        unsigned long long area = 0;
+        unsigned int largest = 0;
+        for (unsigned int i : pending) {
+            area += static_cast<unsigned long long>(cells[i].width) * cells[i].height;
+            largest = std::max(largest, std::max(cells[i].width, cells[i].height));
+        }
+        const unsigned int side = std::min(nextPowerOfTwo(largest), settings.maxPageSize);
+
+        std::vector<Rect> placed(sources.size(), Rect{ 0, 0, 0, 0 });
+        std::vector<unsigned int> left;
+        unsigned int pageWidth = side;
+        unsigned int pageHeight = side;
+        for (;;) {
+            const bool last = pageWidth == settings.maxPageSize && pageHeight == settings.maxPageSize;
+            // Las paginas con menos area que las celdas no se intentan.
+            if (last || static_cast<unsigned long long>(pageWidth) * pageHeight >= area) {
+                left = packPage(pageWidth, pageHeight, cells, pending, placed);
+                if (left.empty() || last) {
+                    break;
+                }
+            }
+            if (pageWidth == pageHeight) {
+                pageWidth *= 2;
+            }
+            else {
+                pageHeight *= 2;
+            }
+        }
+        if (left.size() == pending.size()) {
+            break;  // No deberia pasar: cada celda cabe en una pagina maxima.
+        }
+
+        Image page;
+        HRESULT hr = page.init(pageWidth, pageHeight, 4);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        const unsigned int pageIndex = static_cast<unsigned int>(m_pages.size());
+        std::vector<bool> isLeft(sources.size(), false);
+        for (unsigned int i : left) {
+            isLeft[i] = true;
+        }
+        for (unsigned int i : pending) {
+            if (isLeft[i]) {
+                continue;
+            }
+            const Image& image = *sources[i].image;
+            AtlasRegion& region = m_regions[i];
+            region.placement = AtlasPlacement::Page;
+            region.target = pageIndex;
+            region.x = placed[i].x + gutter;
+            region.y = placed[i].y + gutter;
+            region.width = image.m_width;
+            region.height = image.m_height;
+            region.uvOffset = Vector2(static_cast<float>(region.x) / pageWidth, static_cast<float>(region.y) / pageHeight);
+            region.uvScale = Vector2(static_cast<float>(region.width) / pageWidth,
+                                     static_cast<float>(region.height) / pageHeight);
+            blit(page, image, region.x, region.y, placed[i]);
+            regionPixels += static_cast<unsigned long long>(image.m_width) * image.m_height;
+            cellPixels += static_cast<unsigned long long>(cells[i].width) * cells[i].height;
+            m_stats.packed++;
+        }
+        pagePixels += static_cast<unsigned long long>(pageWidth) * pageHeight;
+        m_pages.push_back(std::move(page));
+        pending.swap(left);
+    }
+
+    // Texturas que se repiten: un arreglo por tamano; un arreglo de una capa no ahorra nada.
+    for (auto& group : tiled) {
+        if (group.second.size() < 2) {
+            continue;
+        }
+        AtlasArray array;
+        array.width = group.first.first;
+        array.height = group.first.second;
+        for (unsigned int i : group.second) {
+            AtlasRegion& region = m_regions[i];
+            region.placement = AtlasPlacement::ArraySlice;
+            region.target = static_cast<unsigned int>(m_arrays.size());
+            region.slice = static_cast<unsigned int>(array.slices.size());
+            region.width = array.width;
+            region.height = array.height;
+            array.slices.push_back(*sources[i].image);
+            m_stats.sliced++;
+        }
+        m_arrays.push_back(std::move(array));
+    }
+
+    m_stats.skipped = m_stats.sources - m_stats.packed - m_stats.sliced;
+    m_stats.pages = static_cast<unsigned int>(m_pages.size());
+    m_stats.arrays = static_cast<unsigned int>(m_arrays.size());
+    m_stats.efficiency = pagePixels ? static_cast<double>(regionPixels) / pagePixels : 0.0;
+    m_stats.paddedEfficiency = pagePixels ? static_cast<double>(cellPixels) / pagePixels : 0.0;
+    m_stats.buildMs = Profiler::now() - start;
+    return S_OK;
+}
+
+void
+TextureAtlas::destroy() {
+    m_pages.clear();
+    m_arrays.clear();
+    m_regions.clear();
+    m_stats = AtlasStats();
+}
+
+std::vector<unsigned int>
+TextureAtlas::packPage(unsigned int width, unsigned int height, const std::vector<Rect>& sizes,
+                       const std::vector<unsigned int>& order, std::vector<Rect>& placed) {
+    std::vector<Rect> freeRects(1, Rect{ 0, 0, width, height });
+    std::vector<unsigned int> left;
+
+    for (unsigned int index : order) {
+        const unsigned int w = sizes[index].width;
+        const unsigned int h = sizes[index].height;
+
+        // Mejor ajuste por lado corto (y despues por lado largo).
+        size_t best = freeRects.size();
+        unsigned int bestShort = ~0u;
+        unsigned int bestLong = ~0u;
+        for (size_t f = 0; f < freeRects.size(); ++f) {
+            const Rect& free = freeRects[f];
+            if (free.width < w || free.height < h) {
+                continue;
+            }
+            const unsigned int shortSide = std::min(free.width - w, free.height - h);
+            const unsigned int longSide = std::max(free.width - w, free.height - h);
+            if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+                best = f;
+                bestShort = shortSide;
+                bestLong = longSide;
+            }
+        }
+        if (best == freeRects.size()) {
+            left.push_back(index);
+            continue;
+        }
+
+        const Rect used = { freeRects[best].x, freeRects[best].y, w, h };
+        placed[index] = used;
+
+        // Parte cada rectangulo libre que toca el colocado en hasta cuatro rectangulos maximos.
+        std::vector<Rect> next;
+        next.reserve(freeRects.size() + 4);
+        for (const Rect& free : freeRects) {
+            if (used.x >= free.x + free.width || used.x + used.width <= free.x ||
+                used.y >= free.y + free.height || used.y + used.height <= free.y) {
+                next.push_back(free);
+                continue;
+            }
+            if (used.x > free.x) {
+                next.push_back(Rect{ free.x, free.y, used.x - free.x, free.height });
+            }
+            if (used.x + used.width < free.x + free.width) {
+                next.push_back(Rect{ used.x + used.width, free.y, free.x + free.width - (used.x + used.width),
+                                     free.height });
+            }
+            if (used.y > free.y) {
+                next.push_back(Rect{ free.x, free.y, free.width, used.y - free.y });
+            }
+            if (used.y + used.height < free.y + free.height) {
+                next.push_back(Rect{ free.x, used.y + used.height, free.width,
+                                     free.y + free.height - (used.y + used.height) });
+            }
+        }
+
+        // Quita los rectangulos contenidos en otro.
+        freeRects.clear();
+        for (size_t a = 0; a < next.size(); ++a) {
+            bool contained = false;
+            for (size_t b = 0; b < next.size() && !contained; ++b) {
+                if (a == b) {
+                    continue;
+                }
+                const Rect& ra = next[a];
+                const Rect& rb = next[b];
+                const bool inside = ra.x >= rb.x && ra.y >= rb.y && ra.x + ra.width <= rb.x + rb.width &&
+                                    ra.y + ra.height <= rb.y + rb.height;
+                // Dos iguales: se queda el primero.
+                const bool same = ra.x == rb.x && ra.y == rb.y && ra.width == rb.width && ra.height == rb.height;
+                contained = inside && (!same || b < a);
+            }
+            if (!contained) {
+                freeRects.push_back(next[a]);
+            }
+        }
+    }
+    return left;
+}
+
+void
+TextureAtlas::blit(Image& page, const Image& source, unsigned int x, unsigned int y, const Rect& cell) {
+    for (unsigned int py = cell.y; py < cell.y + cell.height; ++py) {
+        const int sy = std::min(std::max(static_cast<int>(py) - static_cast<int>(y), 0),
+                                static_cast<int>(source.m_height) - 1);
+        const unsigned char* src = source.row(static_cast<unsigned int>(sy));
+        unsigned char* dst = page.row(py);
+        // Margen izquierdo, fila original y margen derecho (y el relleno de la alineacion).
+        for (unsigned int px = cell.x; px < x; ++px) {
+            memcpy(dst + px * 4, src, 4);
+        }
+        memcpy(dst + x * 4, src, source.m_width * 4);
+        for (unsigned int px = x + source.m_width; px < cell.x + cell.width; ++px) {
+            memcpy(dst + px * 4, src + (source.m_width - 1) * 4, 4);
+        }
+    }
+}
+
+HRESULT
+TextureAtlas::remapUVs(MeshComponent& mesh, const SubMesh& subMesh, const AtlasRegion& region) {
+    if (region.placement != AtlasPlacement::Page) {
+        ERROR("TextureAtlas", "remapUVs", "Region is not on an atlas page.");
+        return E_INVALIDARG;
+    }
+    const float epsilon = 1.0e-4f;
+    const unsigned int end = subMesh.startIndex + subMesh.indexCount;
+    for (unsigned int i = subMesh.startIndex; i < end; ++i) {
+        const Vector2& uv = mesh.m_vertex[mesh.m_index[i]].Tex;
+        if (uv.x < -epsilon || uv.x > 1.0f + epsilon || uv.y < -epsilon || uv.y > 1.0f + epsilon) {
+            ERROR("TextureAtlas", "remapUVs", ("UVs outside 0..1 in " + subMesh.name).c_str());
+            return E_INVALIDARG;
+        }
+    }
+
+    std::vector<bool> remapped(mesh.m_vertex.size(), false);
+    for (unsigned int i = subMesh.startIndex; i < end; ++i) {
+        const unsigned int vertex = mesh.m_index[i];
+        if (remapped[vertex]) {
+            continue;
+        }
+        remapped[vertex] = true;
+        Vector2& uv = mesh.m_vertex[vertex].Tex;
+        uv.x = uv.x * region.uvScale.x + region.uvOffset.x;
+        uv.y = uv.y * region.uvScale.y + region.uvOffset.y;
+    }
+    return S_OK;
+}
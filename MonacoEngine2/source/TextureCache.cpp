@@ -0,0 +1,241 @@
+#include "TextureCache.h"
+#include "Device.h"
+#include "DdsFile.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+
+HRESULT
+TextureCache::init(size_t budgetBytes) {
+    m_handles.clear();
+    m_cache.init(budgetBytes, [this](void* resource) {
+        ID3D11ShaderResourceView* view = static_cast<ID3D11ShaderResourceView*>(resource);
+        m_handles.erase(view);
+        view->Release();
+    });
+    MESSAGE("TextureCache", "init", ("Budget: " + std::to_string(budgetBytes >> 20) + " MB").c_str());
+    return S_OK;
+}
+
+void
+TextureCache::destroy() {
+    m_cache.destroy();
+    m_handles.clear();
+}
+
+void
+TextureCache::bind(Texture& texture, ResourceHandle handle, const std::string& fileName, ColorSpace colorSpace) {
+    texture.m_textureFromImg = static_cast<ID3D11ShaderResourceView*>(m_cache.getResource(handle));
+    texture.m_textureFromImg->AddRef();
+    texture.m_textureName = fileName;
+    texture.m_colorSpace = colorSpace;
+}
+
+std::string
+TextureCache::cacheKey(const std::string& fileName, ColorSpace colorSpace) {
+    return colorSpace == ColorSpace::Srgb ? fileName : fileName + "|linear";
+}
+
+uint64_t
+TextureCache::contentKey(uint64_t contentHash, ColorSpace colorSpace) {
+    // Cualquier permutacion fija sirve; el 0 ("sin hash") se conserva.
+    if (colorSpace == ColorSpace::Srgb || contentHash == 0) {
+        return contentHash;
+    }
+    return (contentHash ^ 0x9E3779B97F4A7C15ull) * 0xBF58476D1CE4E5B9ull;
+}
+
+bool
+TextureCache::acquireCached(Texture& texture, const std::string& fileName, ColorSpace colorSpace) {
+    const ResourceHandle handle = m_cache.acquire(cacheKey(fileName, colorSpace));
+    if (!handle.isValid()) {
+        return false;
+    }
+    bind(texture, handle, fileName, colorSpace);
+    return true;
+}
+
+bool
+TextureCache::acquireContent(Texture& texture, uint64_t contentHash, const std::string& fileName,
+                             ColorSpace colorSpace) {
+    const ResourceHandle handle = m_cache.acquireContent(contentKey(contentHash, colorSpace),
+                                                         cacheKey(fileName, colorSpace));
+    if (!handle.isValid()) {
+        return false;
+    }
+    bind(texture, handle, fileName, colorSpace);
+    return true;
+}
+
+void
+TextureCache::insert(Texture& texture, const std::string& fileName, uint64_t contentHash) {
+    ID3D11ShaderResourceView* view = texture.m_textureFromImg;
+    if (!view || m_handles.count(view)) {
+        return;
+    }
+    // La cache guarda su propia referencia; la de @p texture cuenta como la primera del handle.
+    view->AddRef();
+    m_handles[view] = m_cache.insert(cacheKey(fileName, texture.m_colorSpace),
+                                     contentKey(contentHash, texture.m_colorSpace), view, estimateBytes(view));
+}
+
+void
+TextureCache::share(const Texture& source, Texture& texture) {
+    texture.m_textureFromImg = source.m_textureFromImg;
+    texture.m_textureName = source.m_textureName;
+    texture.m_colorSpace = source.m_colorSpace;
+    if (!texture.m_textureFromImg) {
+        return;
+    }
+    texture.m_textureFromImg->AddRef();
+    auto it = m_handles.find(texture.m_textureFromImg);
+    if (it != m_handles.end()) {
+        m_cache.addRef(it->second);
+    }
+}
+
+void
+TextureCache::release(Texture& texture) {
+    auto it = texture.m_textureFromImg ? m_handles.find(texture.m_textureFromImg) : m_handles.end();
+    if (it == m_handles.end()) {
+        texture.destroy();
+        return;
+    }
+    const ResourceHandle handle = it->second;
+    SAFE_RELEASE(texture.m_textureFromImg);
+    // Despues de soltar la referencia de la textura: si la entrada se expulsa, la vista se libera aqui.
+    m_cache.release(handle);
+}
+
+HRESULT
+TextureCache::acquire(Device& device, Texture& texture, const std::string& textureName,
+                      ExtensionType extensionType, ColorSpace colorSpace) {
+    if (textureName.empty()) {
+        ERROR("TextureCache", "acquire", "Texture name cannot be empty.");
+        return E_INVALIDARG;
+    }
+
+    std::string fileName;
+    switch (extensionType) {
+    case DDS:
+        fileName = textureName + ".dds";
+        break;
+    case PNG:
+        fileName = textureName + ".png";
+        break;
+    case JPG:
+        fileName = textureName + ".jpg";
+        break;
+    case HDR:
+        fileName = textureName + ".hdr";
+        break;
+    default:
+        ERROR("TextureCache", "acquire", "Unsupported extension type");
+        return E_INVALIDARG;
+    }
+
+    if (acquireCached(texture, fileName, colorSpace)) {
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+    texture.m_textureName = fileName;
+
+    if (extensionType == DDS) {
+        // La proyeccion sirve tanto para el hash como para subir los niveles.
+        DdsFile dds;
+        hr = dds.loadFromFile(fileName);
+        if (FAILED(hr)) {
+            ERROR("TextureCache", "acquire", ("Failed to load DDS texture: " + fileName).c_str());
+            return hr;
+        }
+        const uint64_t contentHash = ResourceCache::hashContent(dds.getFileData(), dds.getFileSize());
+        if (acquireContent(texture, contentHash, fileName, colorSpace)) {
+            return S_OK;
+        }
+        hr = texture.init(device, dds, 0, colorSpace);
+        if (SUCCEEDED(hr)) {
+            insert(texture, fileName, contentHash);
+        }
+        return hr;
+    }
+
+    // Proyectado: el hash y la decodificacion leen el archivo sin copiarlo a un buffer.
+    MappedFile file;
+    hr = file.init(fileName);
+    if (FAILED(hr)) {
+        ERROR("TextureCache", "acquire", ("Failed to open texture: " + fileName).c_str());
+        return hr;
+    }
+
+    const uint64_t contentHash = ResourceCache::hashContent(file.getData(), file.getSize());
+    if (acquireContent(texture, contentHash, fileName, colorSpace)) {
+        return S_OK;
+    }
+
+    if (extensionType == HDR) {
+        HdrImage image;
+        std::vector<HdrImage> levels;
+        hr = image.loadFromMemory(file.getData(), file.getSize());
+        if (SUCCEEDED(hr)) {
+            hr = HdrImage::generateMips(std::move(image), levels);
+        }
+        if (FAILED(hr)) {
+            ERROR("TextureCache", "acquire", ("Failed to decode HDR texture: " + fileName).c_str());
+            return hr;
+        }
+        hr = texture.init(device, levels);
+        if (SUCCEEDED(hr)) {
+            insert(texture, fileName, contentHash);
+        }
+        return hr;
+    }
+
+    MipSettings mipSettings;
+    mipSettings.jobs = &JobSystem::instance();
+    mipSettings.srgb = colorSpace == ColorSpace::Srgb;
+    UploadImage upload;
+    hr = UploadArena::forThread().decodeImage(file.getData(), file.getSize(), mipSettings, upload);
+    if (FAILED(hr)) {
+        ERROR("TextureCache", "acquire", ("Failed to decode texture: " + fileName).c_str());
+        return hr;
+    }
+    hr = texture.init(device, upload, colorSpace);
+    if (SUCCEEDED(hr)) {
+        insert(texture, fileName, contentHash);
+    }
+    return hr;
+}
+
+size_t
+TextureCache::estimateBytes(ID3D11ShaderResourceView* view) {
+    ID3D11Resource* resource = nullptr;
+    ID3D11Texture2D* texture = nullptr;
+    view->GetResource(&resource);
+    HRESULT hr = resource ? resource->QueryInterface(__uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&texture))
+                          : E_FAIL;
+    SAFE_RELEASE(resource);
+    if (FAILED(hr)) {
+        return 0;
+    }
+    D3D11_TEXTURE2D_DESC textureDesc;
+    texture->GetDesc(&textureDesc);
+    SAFE_RELEASE(texture);
+
+    // DdsFile ya sabe el tamano de cada subrecurso (incluidos los formatos BC).
+    DdsDesc desc;
+    desc.width = textureDesc.Width;
+    desc.height = textureDesc.Height;
+    desc.mipLevels = textureDesc.MipLevels;
+    desc.cubemap = (textureDesc.MiscFlags & D3D11_RESOURCE_MISC_TEXTURECUBE) != 0;
+    desc.arraySize = desc.cubemap ? textureDesc.ArraySize / 6 : textureDesc.ArraySize;
+    desc.format = static_cast<DdsFormat>(textureDesc.Format);
+
+    std::vector<DdsSurface> surfaces;
+    size_t totalSize = 0;
+    if (FAILED(DdsFile::computeLayout(desc, 0, surfaces, totalSize))) {
+        // Formato desconocido: 4 bytes por pixel y un tercio mas por los mips.
+        totalSize = static_cast<size_t>(desc.width) * desc.height * textureDesc.ArraySize * 4;
+        totalSize += textureDesc.MipLevels > 1 ? totalSize / 3 : 0;
+    }
+    return totalSize;
+}
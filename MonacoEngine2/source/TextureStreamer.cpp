@@ -0,0 +1,305 @@
+#include "TextureStreamer.h"
+#include "MeshComponent.h"
+#include "Profiler.h"
+#include <cmath>
+#include <functional>
+#include <queue>
+
+HRESULT
+TextureStreamer::init(const TextureStreamerSettings& settings, LoadFunction load, ResidencyFunction residency) {
+    destroy();
+    if (!load) {
+        ERROR("TextureStreamer", "init", "Load function cannot be empty.");
+        return E_INVALIDARG;
+    }
+    m_settings = settings;
+    m_settings.maxInFlight = std::max(1u, settings.maxInFlight);
+    m_load = load;
+    m_residency = residency;
+    m_frame = 0;
+    m_stats = TextureStreamerStats();
+    m_stats.budgetBytes = settings.budgetBytes;
+    MESSAGE("TextureStreamer", "init", ("Budget: " + std::to_string(settings.budgetBytes >> 20) + " MB").c_str());
+    return S_OK;
+}
+
+void
+TextureStreamer::destroy() {
+    waitIdle();
+    m_textures.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_completions.clear();
+    }
+    m_stats.residentBytes = 0;
+    m_stats.baseBytes = 0;
+    m_stats.pendingBytes = 0;
+    m_stats.pendingRequests = 0;
+    m_stats.textures = 0;
+}
+
+void
+TextureStreamer::waitIdle() {
+    if (m_settings.jobs) {
+        m_settings.jobs->wait(m_counter);
+    }
+}
+
+unsigned int
+TextureStreamer::addTexture(const std::string& name, const DdsDesc& desc) {
+    StreamedTexture texture;
+    texture.name = name;
+    texture.width = desc.width;
+    texture.height = desc.height;
+    texture.levelBytes.assign(std::max(1u, desc.mipLevels), 0);
+
+    std::vector<DdsSurface> surfaces;
+    size_t totalSize = 0;
+    unsigned int elementBytes = 4;
+    bool compressed = false;
+    if (SUCCEEDED(DdsFile::computeLayout(desc, 0, surfaces, totalSize))) {
+        DdsFile::getFormatInfo(desc.format, elementBytes, compressed);
+        for (size_t i = 0; i < surfaces.size(); ++i) {
+            texture.levelBytes[i % desc.mipLevels] += surfaces[i].size;
+        }
+    }
+    else {
+        // Formato desconocido: se cuenta como RGBA8.
+        for (unsigned int mip = 0; mip < texture.levelBytes.size(); ++mip) {
+            texture.levelBytes[mip] = static_cast<size_t>(std::max(1u, desc.width >> mip)) *
+                                      std::max(1u, desc.height >> mip) * 4 * desc.getItemCount();
+        }
+    }
+
+    // Primer nivel pequeno; en BC, el anterior cuyo lado sea multiplo de 4.
+    const unsigned int last = static_cast<unsigned int>(texture.levelBytes.size()) - 1;
+    unsigned int base = 0;
+    while (base < last && std::max(desc.width >> base, desc.height >> base) > m_settings.residentSize) {
+        base++;
+    }
+    while (compressed && base > 0 &&
+           (std::max(1u, desc.width >> base) % 4 != 0 || std::max(1u, desc.height >> base) % 4 != 0)) {
+        base--;
+    }
+    texture.baseMip = base;
+    texture.residentMip = base;
+    texture.wantedMip = base;
+
+    for (unsigned int mip = base; mip <= last; ++mip) {
+        m_stats.baseBytes += texture.levelBytes[mip];
+        m_stats.residentBytes += texture.levelBytes[mip];
+    }
+    m_textures.push_back(std::move(texture));
+    m_stats.textures = static_cast<unsigned int>(m_textures.size());
+    return m_stats.textures - 1;
+}
+
+void
+TextureStreamer::beginFrame(const StreamingView& view) {
+    m_frame++;
+    m_view = view;
+    m_pixelsPerUnit = view.screenHeight / (2.0f * tanf(view.fovY * 0.5f));
+}
+
+void
+TextureStreamer::addDemand(unsigned int index, const Vector3& center, float radius, float uvDensity) {
+    StreamedTexture& texture = m_textures[index];
+    if (uvDensity <= 0.0f) {
+        return;
+    }
+
+    // Pixeles por unidad de mundo en el punto mas cercano de la esfera contra texeles por unidad.
+    const float distance = std::max(math::length(center - m_view.position) - radius, 0.01f);
+    const float pixelsPerUnit = m_pixelsPerUnit / distance;
+    const float texelsPerUnit = uvDensity * static_cast<float>(std::max(texture.width, texture.height));
+    const float level = log2f(texelsPerUnit / pixelsPerUnit) + m_settings.mipBias;
+    const unsigned int mip = level <= 0.0f ? 0u : std::min(static_cast<unsigned int>(level), texture.baseMip);
+
+    const float pixels = radius * pixelsPerUnit;
+    const float coverage = std::min(3.14159265f * pixels * pixels, 2.0f * m_view.screenHeight * m_view.screenHeight);
+
+    if (texture.demandFrame != m_frame) {
+        texture.demandFrame = m_frame;
+        texture.wantedMip = mip;
+        texture.coverage = coverage;
+    }
+    else {
+        texture.wantedMip = std::min(texture.wantedMip, mip);
+        texture.coverage = std::max(texture.coverage, coverage);
+    }
+}
+
+float
+TextureStreamer::levelPriority(const StreamedTexture& texture, unsigned int mip) const {
+    if (mip < texture.wantedMip) {
+        return 0.0f;
+    }
+    return texture.coverage * static_cast<float>(1 + mip - texture.wantedMip);
+}
+
+void
+TextureStreamer::evictLevel(unsigned int index) {
+    StreamedTexture& texture = m_textures[index];
+    m_stats.residentBytes -= texture.levelBytes[texture.residentMip];
+    texture.residentMip++;
+    m_stats.evictedLevels++;
+    if (m_residency) {
+        m_residency(index, texture.residentMip);
+    }
+}
+
+void
+TextureStreamer::applyCompletions() {
+    std::vector<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        completions.swap(m_completions);
+    }
+    for (const Completion& completion : completions) {
+        StreamedTexture& texture = m_textures[completion.texture];
+        const size_t bytes = texture.levelBytes[completion.mip];
+        texture.loading = false;
+        m_stats.pendingBytes -= bytes;
+        m_stats.pendingRequests--;
+        if (FAILED(completion.result)) {
+            // Se queda en su nivel actual: no se vuelve a pedir.
+            ERROR("TextureStreamer", "update", ("Failed to stream " + texture.name + " mip " +
+                std::to_string(completion.mip)).c_str());
+            texture.baseMip = texture.residentMip;
+            m_stats.failed++;
+            continue;
+        }
+        texture.residentMip = completion.mip;
+        m_stats.residentBytes += bytes;
+        m_stats.streamedBytes += bytes;
+        m_stats.completed++;
+        if (m_residency) {
+            m_residency(completion.texture, completion.mip);
+        }
+    }
+}
+
+void
+TextureStreamer::update() {
+    const double start = Profiler::now();
+    applyCompletions();
+
+    // Las texturas sin demanda reciente vuelven a su nivel base y sus niveles pasan a sobrar.
+    std::vector<unsigned int> candidates;
+    m_stats.wantedBytes = 0;
+    m_stats.missingLevels = 0;
+    m_stats.deniedRequests = 0;
+    for (unsigned int i = 0; i < m_textures.size(); ++i) {
+        StreamedTexture& texture = m_textures[i];
+        if (texture.demandFrame + m_settings.keepFrames < m_frame) {
+            texture.wantedMip = texture.baseMip;
+            texture.coverage = 0.0f;
+        }
+        for (unsigned int mip = texture.wantedMip; mip < texture.levelBytes.size(); ++mip) {
+            m_stats.wantedBytes += texture.levelBytes[mip];
+        }
+        if (texture.wantedMip < texture.residentMip) {
+            m_stats.missingLevels += texture.residentMip - texture.wantedMip;
+            if (!texture.loading) {
+                candidates.push_back(i);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](unsigned int a, unsigned int b) {
+        return levelPriority(m_textures[a], m_textures[a].residentMip - 1) >
+               levelPriority(m_textures[b], m_textures[b].residentMip - 1);
+    });
+
+    // Niveles que se pueden soltar, del menos al mas prioritario; se arma solo si falta espacio.
+    typedef std::pair<float, unsigned int> Victim;
+    std::priority_queue<Victim, std::vector<Victim>, std::greater<Victim>> victims;
+    bool victimsBuilt = false;
+
+    size_t ioBytes = 0;
+    for (unsigned int index : candidates) {
+        if (m_stats.pendingRequests >= m_settings.maxInFlight) {
+            break;
+        }
+        StreamedTexture& texture = m_textures[index];
+        const unsigned int mip = texture.residentMip - 1;
+        const size_t bytes = texture.levelBytes[mip];
+        if (m_settings.ioBytesPerFrame && ioBytes > 0 && ioBytes + bytes > m_settings.ioBytesPerFrame) {
+            break;
+        }
+
+        const float priority = levelPriority(texture, mip);
+        if (m_stats.residentBytes + m_stats.pendingBytes + bytes > m_settings.budgetBytes && !victimsBuilt) {
+            for (unsigned int i = 0; i < m_textures.size(); ++i) {
+                if (!m_textures[i].loading && m_textures[i].residentMip < m_textures[i].baseMip) {
+                    victims.push(Victim(levelPriority(m_textures[i], m_textures[i].residentMip), i));
+                }
+            }
+            victimsBuilt = true;
+        }
+        while (m_stats.residentBytes + m_stats.pendingBytes + bytes > m_settings.budgetBytes &&
+               !victims.empty() && victims.top().first < priority) {
+            const unsigned int victim = victims.top().second;
+            victims.pop();
+            if (m_textures[victim].loading || m_textures[victim].residentMip >= m_textures[victim].baseMip) {
+                continue;  // Empezo a leer un nivel en este update(), o ya no tiene que soltar.
+            }
+            evictLevel(victim);
+            if (m_textures[victim].residentMip < m_textures[victim].baseMip) {
+                victims.push(Victim(levelPriority(m_textures[victim], m_textures[victim].residentMip), victim));
+            }
+        }
+        if (m_stats.residentBytes + m_stats.pendingBytes + bytes > m_settings.budgetBytes) {
+            m_stats.deniedRequests++;
+            continue;
+        }
+
+        texture.loading = true;
+        m_stats.pendingBytes += bytes;
+        m_stats.pendingRequests++;
+        ioBytes += bytes;
+
+        auto job = [this, index, mip]() {
+            const HRESULT hr = m_load(index, mip);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_completions.push_back(Completion{ index, mip, hr });
+        };
+        if (m_settings.jobs) {
+            m_settings.jobs->submit(job, &m_counter);
+        }
+        else {
+            job();
+        }
+    }
+
+    m_stats.lastUpdateMs = Profiler::now() - start;
+    Profiler& profiler = Profiler::instance();
+    profiler.addSample("TextureStreamer::update", m_stats.lastUpdateMs);
+    profiler.setCounter("TextureStreamer::residentBytes", static_cast<long long>(m_stats.residentBytes));
+    profiler.setCounter("TextureStreamer::budgetBytes", static_cast<long long>(m_stats.budgetBytes));
+    profiler.setCounter("TextureStreamer::wantedBytes", static_cast<long long>(m_stats.wantedBytes));
+    profiler.setCounter("TextureStreamer::pendingBytes", static_cast<long long>(m_stats.pendingBytes));
+    profiler.setCounter("TextureStreamer::pendingRequests", m_stats.pendingRequests);
+    profiler.setCounter("TextureStreamer::missingLevels", m_stats.missingLevels);
+    profiler.setCounter("TextureStreamer::deniedRequests", m_stats.deniedRequests);
+    profiler.setCounter("TextureStreamer::evictedLevels", static_cast<long long>(m_stats.evictedLevels));
+}
+
+float
+TextureStreamer::computeUvDensity(const MeshComponent& mesh) {
+    double worldArea = 0.0;
+    double uvArea = 0.0;
+    const bool indexed = !mesh.m_index.empty();
+    const size_t count = indexed ? mesh.m_index.size() : mesh.m_vertex.size();
+    for (size_t i = 0; i + 2 < count; i += 3) {
+        const SimpleVertex& a = mesh.m_vertex[indexed ? mesh.m_index[i] : i];
+        const SimpleVertex& b = mesh.m_vertex[indexed ? mesh.m_index[i + 1] : i + 1];
+        const SimpleVertex& c = mesh.m_vertex[indexed ? mesh.m_index[i + 2] : i + 2];
+        worldArea += 0.5 * math::length(math::cross(b.Pos - a.Pos, c.Pos - a.Pos));
+        const float du1 = b.Tex.x - a.Tex.x;
+        const float dv1 = b.Tex.y - a.Tex.y;
+        const float du2 = c.Tex.x - a.Tex.x;
+        const float dv2 = c.Tex.y - a.Tex.y;
+        uvArea += 0.5 * fabs(du1 * dv2 - dv1 * du2);
+    }
+    return worldArea > 0.0 ? static_cast<float>(sqrt(uvArea / worldArea)) : 0.0f;
+}
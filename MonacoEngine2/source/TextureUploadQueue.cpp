@@ -0,0 +1,172 @@
+#include "TextureUploadQueue.h"
+#include "TextureCache.h"
+#include "Device.h"
+#include "Profiler.h"
+
+HRESULT
+TextureUploadQueue::init(Device& device, JobSystem& jobs, TextureCache* cache) {
+    // Damero magenta/gris de 8x8: se nota en pantalla si una textura tarda en llegar.
+    Image checker;
+    HRESULT hr = checker.init(8, 8, 4);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    for (unsigned int y = 0; y < checker.m_height; ++y) {
+        unsigned char* row = checker.row(y);
+        for (unsigned int x = 0; x < checker.m_width; ++x) {
+            const bool odd = ((x ^ y) & 1) != 0;
+            row[x * 4 + 0] = odd ? 255 : 96;
+            row[x * 4 + 1] = odd ? 0 : 96;
+            row[x * 4 + 2] = odd ? 255 : 96;
+            row[x * 4 + 3] = 255;
+        }
+    }
+
+    hr = m_placeholder.init(device, checker);
+    if (FAILED(hr)) {
+        ERROR("TextureUploadQueue", "init", "Failed to create placeholder texture.");
+        return hr;
+    }
+
+    m_cache = cache;
+    m_stats = TextureUploadStats();
+    return m_decoder.init(&jobs, true);
+}
+
+void
+TextureUploadQueue::destroy() {
+    m_decoder.destroy();
+    m_pending.clear();
+    m_tickets.clear();
+    m_placeholder.destroy();
+    m_cache = nullptr;
+}
+
+void
+TextureUploadQueue::bindPlaceholder(Texture& texture) {
+    texture.m_textureFromImg = m_placeholder.m_textureFromImg;
+    if (texture.m_textureFromImg) {
+        texture.m_textureFromImg->AddRef();
+    }
+}
+
+HRESULT
+TextureUploadQueue::request(Device& device, Texture& texture, const std::string& textureName,
+                            ExtensionType extensionType, ColorSpace colorSpace) {
+    if (textureName.empty()) {
+        ERROR("TextureUploadQueue", "request", "Texture name cannot be empty.");
+        return E_INVALIDARG;
+    }
+
+    switch (extensionType) {
+    case DDS:
+    case HDR:
+        return m_cache ? m_cache->acquire(device, texture, textureName, extensionType, colorSpace)
+                       : texture.init(device, textureName, extensionType, colorSpace);
+    case PNG:
+        texture.m_textureName = textureName + ".png";
+        break;
+    case JPG:
+        texture.m_textureName = textureName + ".jpg";
+        break;
+    default:
+        ERROR("TextureUploadQueue", "request", "Unsupported extension type");
+        return E_INVALIDARG;
+    }
+
+    if (m_cache && m_cache->acquireCached(texture, texture.m_textureName, colorSpace)) {
+        return S_OK;
+    }
+
+    bindPlaceholder(texture);
+    texture.m_colorSpace = colorSpace;
+    const std::string key = TextureCache::cacheKey(texture.m_textureName, colorSpace);
+    auto inFlight = m_tickets.find(key);
+    if (inFlight != m_tickets.end()) {
+        m_pending[inFlight->second].push_back(&texture);
+        m_stats.shared++;
+        return S_OK;
+    }
+    const unsigned int ticket = m_decoder.request(texture.m_textureName, colorSpace);
+    m_tickets[key] = ticket;
+    m_pending[ticket].push_back(&texture);
+    return S_OK;
+}
+
+void
+TextureUploadQueue::cancel(Texture& texture) {
+    // El ticket sigue en m_tickets: otra solicitud del mismo archivo puede unirse a el.
+    for (auto it = m_pending.begin(); it != m_pending.end(); ++it) {
+        std::vector<Texture*>& targets = it->second;
+        targets.erase(std::remove(targets.begin(), targets.end(), &texture), targets.end());
+    }
+}
+
+unsigned int
+TextureUploadQueue::update(Device& device, double budgetMs) {
+    const double start = Profiler::now();
+    unsigned int uploaded = 0;
+
+    DecodedImage decoded;
+    while ((uploaded == 0 || Profiler::now() - start < budgetMs) && m_decoder.pop(decoded)) {
+        m_tickets.erase(TextureCache::cacheKey(decoded.name, decoded.colorSpace));
+        auto it = m_pending.find(decoded.ticket);
+        if (it == m_pending.end()) {
+            continue;
+        }
+        std::vector<Texture*> targets = std::move(it->second);
+        m_pending.erase(it);
+        if (targets.empty()) {
+            continue;  // Canceladas.
+        }
+
+        if (FAILED(decoded.result)) {
+            m_stats.failed++;
+            continue;  // Se quedan con el reemplazo; Image ya reporto el error.
+        }
+
+        // Otro archivo con los mismos bytes ya tiene textura: se comparte en lugar de crearla.
+        Texture loaded;
+        if (!m_cache || !m_cache->acquireContent(loaded, decoded.contentHash, decoded.name, decoded.colorSpace)) {
+            HRESULT hr = decoded.mips.empty() ? loaded.init(device, decoded.image, decoded.colorSpace)
+                                              : loaded.init(device, decoded.mips, decoded.colorSpace);
+            if (FAILED(hr)) {
+                ERROR("TextureUploadQueue", "update", ("Failed to create texture " + decoded.name).c_str());
+                m_stats.failed++;
+                continue;
+            }
+            loaded.m_textureName = decoded.name;
+            if (m_cache) {
+                m_cache->insert(loaded, decoded.name, decoded.contentHash);
+            }
+        }
+
+        // Cambia el reemplazo por la vista definitiva; el siguiente render() ya la usa.
+        // La primera textura se queda con la referencia de @c loaded y las demas suman la suya.
+        for (size_t i = 0; i < targets.size(); ++i) {
+            SAFE_RELEASE(targets[i]->m_textureFromImg);
+            if (i == 0) {
+                targets[i]->m_textureFromImg = loaded.m_textureFromImg;
+            }
+            else if (m_cache) {
+                m_cache->share(loaded, *targets[i]);
+            }
+            else {
+                targets[i]->m_textureFromImg = loaded.m_textureFromImg;
+                targets[i]->m_textureFromImg->AddRef();
+            }
+        }
+        uploaded++;
+    }
+
+    m_stats.lastUpdateMs = Profiler::now() - start;
+    m_stats.lastUploaded = uploaded;
+    m_stats.uploaded += uploaded;
+
+    Profiler& profiler = Profiler::instance();
+    if (uploaded > 0) {
+        profiler.addSample("TextureUploadQueue::update", m_stats.lastUpdateMs);
+    }
+    profiler.setCounter("TextureUploadQueue::pending", static_cast<long long>(m_pending.size()));
+    return uploaded;
+}
@@ -0,0 +1,427 @@
+#include "TransformHierarchy.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Math/VectorBatch.h"
+#include <atomic>
+
+const unsigned int TransformHierarchy::INVALID_HANDLE;
+const unsigned int TransformHierarchy::BLOCK_SIZE;
+const unsigned int TransformHierarchy::WORLD_ELEMENTS;
+
+namespace {
+    /// Reordena @p values segun @p order (values[i] = anterior values[order[i]]).
+    template<class T>
+    void
+    permute(std::vector<T>& values, const std::vector<unsigned int>& order) {
+        std::vector<T> sorted(order.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            sorted[i] = values[order[i]];
+        }
+        values.swap(sorted);
+    }
+}
+
+HRESULT
+TransformHierarchy::init(JobSystem* jobs) {
+    destroy();
+    m_jobs = jobs;
+    return S_OK;
+}
+
+void
+TransformHierarchy::destroy() {
+    std::vector<float>* floats[] = { &m_posX, &m_posY, &m_posZ, &m_rotX, &m_rotY, &m_rotZ, &m_rotW,
+                                     &m_scaleX, &m_scaleY, &m_scaleZ };
+    for (std::vector<float>* values : floats) {
+        values->clear();
+        values->shrink_to_fit();
+    }
+    for (std::vector<float>& values : m_world) {
+        values.clear();
+        values.shrink_to_fit();
+    }
+    m_parentSlot.clear();
+    m_handleOfSlot.clear();
+    m_localDirty.clear();
+    m_changed.clear();
+    m_levelStart.clear();
+    m_slotOfHandle.clear();
+    m_parentHandle.clear();
+    m_firstChild.clear();
+    m_nextSibling.clear();
+    m_prevSibling.clear();
+    m_freeHandles.clear();
+    m_count = 0;
+    m_orderDirty = false;
+    m_stats = TransformHierarchyStats();
+}
+
+unsigned int
+TransformHierarchy::create(unsigned int parent) {
+    if (parent != INVALID_HANDLE && !isValid(parent)) {
+        ERROR("TransformHierarchy", "create", "Invalid parent handle");
+        return INVALID_HANDLE;
+    }
+
+    unsigned int handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+    else {
+        handle = static_cast<unsigned int>(m_slotOfHandle.size());
+        m_slotOfHandle.push_back(INVALID_HANDLE);
+        m_parentHandle.push_back(INVALID_HANDLE);
+        m_firstChild.push_back(INVALID_HANDLE);
+        m_nextSibling.push_back(INVALID_HANDLE);
+        m_prevSibling.push_back(INVALID_HANDLE);
+    }
+
+    // El nodo se agrega al final; el siguiente update() lo mueve a su nivel.
+    unsigned int slot = static_cast<unsigned int>(m_handleOfSlot.size());
+    m_slotOfHandle[handle] = slot;
+    m_parentHandle[handle] = INVALID_HANDLE;
+    m_firstChild[handle] = INVALID_HANDLE;
+    m_nextSibling[handle] = INVALID_HANDLE;
+    m_prevSibling[handle] = INVALID_HANDLE;
+    m_handleOfSlot.push_back(handle);
+    m_posX.push_back(0.0f);   m_posY.push_back(0.0f);   m_posZ.push_back(0.0f);
+    m_rotX.push_back(0.0f);   m_rotY.push_back(0.0f);   m_rotZ.push_back(0.0f);   m_rotW.push_back(1.0f);
+    m_scaleX.push_back(1.0f); m_scaleY.push_back(1.0f); m_scaleZ.push_back(1.0f);
+    for (unsigned int e = 0; e < WORLD_ELEMENTS; ++e) {
+        m_world[e].push_back(e % 4 == 0 ? 1.0f : 0.0f);
+    }
+    m_parentSlot.push_back(INVALID_HANDLE);
+    m_localDirty.push_back(1);
+    m_changed.push_back(0);
+
+    if (parent != INVALID_HANDLE) {
+        linkChild(handle, parent);
+    }
+    ++m_count;
+    m_orderDirty = true;
+    return handle;
+}
+
+void
+TransformHierarchy::destroyNode(unsigned int handle) {
+    if (!isValid(handle)) {
+        return;
+    }
+    unlinkChild(handle);
+
+    std::vector<unsigned int> stack(1, handle);
+    while (!stack.empty()) {
+        unsigned int node = stack.back();
+        stack.pop_back();
+        for (unsigned int child = m_firstChild[node]; child != INVALID_HANDLE; child = m_nextSibling[child]) {
+            stack.push_back(child);
+        }
+        m_handleOfSlot[m_slotOfHandle[node]] = INVALID_HANDLE;
+        m_slotOfHandle[node] = INVALID_HANDLE;
+        m_parentHandle[node] = INVALID_HANDLE;
+        m_firstChild[node] = INVALID_HANDLE;
+        m_freeHandles.push_back(node);
+        --m_count;
+    }
+    m_orderDirty = true;
+}
+
+HRESULT
+TransformHierarchy::setParent(unsigned int handle, unsigned int parent) {
+    if (!isValid(handle) || (parent != INVALID_HANDLE && !isValid(parent))) {
+        ERROR("TransformHierarchy", "setParent", "Invalid handle");
+        return E_INVALIDARG;
+    }
+    for (unsigned int ancestor = parent; ancestor != INVALID_HANDLE; ancestor = m_parentHandle[ancestor]) {
+        if (ancestor == handle) {
+            ERROR("TransformHierarchy", "setParent", "Parent is a descendant of the node");
+            return E_INVALIDARG;
+        }
+    }
+    if (m_parentHandle[handle] == parent) {
+        return S_OK;
+    }
+
+    unlinkChild(handle);
+    if (parent != INVALID_HANDLE) {
+        linkChild(handle, parent);
+    }
+    m_localDirty[m_slotOfHandle[handle]] = 1;
+    m_orderDirty = true;
+    return S_OK;
+}
+
+void
+TransformHierarchy::setLocal(unsigned int handle, const Vector3& position, const Quaternion& rotation,
+                             const Vector3& scale) {
+    unsigned int slot = m_slotOfHandle[handle];
+    m_posX[slot] = position.x;   m_posY[slot] = position.y;   m_posZ[slot] = position.z;
+    m_rotX[slot] = rotation.x;   m_rotY[slot] = rotation.y;   m_rotZ[slot] = rotation.z;   m_rotW[slot] = rotation.w;
+    m_scaleX[slot] = scale.x;    m_scaleY[slot] = scale.y;    m_scaleZ[slot] = scale.z;
+    m_localDirty[slot] = 1;
+}
+
+void
+TransformHierarchy::setPosition(unsigned int handle, const Vector3& position) {
+    unsigned int slot = m_slotOfHandle[handle];
+    m_posX[slot] = position.x;
+    m_posY[slot] = position.y;
+    m_posZ[slot] = position.z;
+    m_localDirty[slot] = 1;
+}
+
+void
+TransformHierarchy::setRotation(unsigned int handle, const Quaternion& rotation) {
+    unsigned int slot = m_slotOfHandle[handle];
+    m_rotX[slot] = rotation.x;
+    m_rotY[slot] = rotation.y;
+    m_rotZ[slot] = rotation.z;
+    m_rotW[slot] = rotation.w;
+    m_localDirty[slot] = 1;
+}
+
+void
+TransformHierarchy::setScale(unsigned int handle, const Vector3& scale) {
+    unsigned int slot = m_slotOfHandle[handle];
+    m_scaleX[slot] = scale.x;
+    m_scaleY[slot] = scale.y;
+    m_scaleZ[slot] = scale.z;
+    m_localDirty[slot] = 1;
+}
+
+void
+TransformHierarchy::update() {
+    double start = Profiler::now();
+    if (m_orderDirty) {
+        rebuildOrder();
+        m_stats.rebuildMs = Profiler::now() - start;
+    }
+    else {
+        m_stats.rebuildMs = 0.0;
+    }
+
+    // Los niveles van en orden (el hijo necesita al padre); dentro de un nivel, por bloques.
+    std::atomic<unsigned int> updated(0);
+    const unsigned int levels = m_levelStart.empty() ? 0 : static_cast<unsigned int>(m_levelStart.size()) - 1;
+    for (unsigned int level = 0; level < levels; ++level) {
+        const unsigned int begin = m_levelStart[level];
+        const unsigned int end = m_levelStart[level + 1];
+        const unsigned int blocks = (end - begin + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const bool roots = level == 0;
+        auto runBlocks = [&](unsigned int first, unsigned int last, unsigned int) {
+            unsigned int count = 0;
+            for (unsigned int block = first; block < last; ++block) {
+                unsigned int blockBegin = begin + block * BLOCK_SIZE;
+                count += updateBlock(blockBegin, std::min(blockBegin + BLOCK_SIZE, end), roots);
+            }
+            updated.fetch_add(count, std::memory_order_relaxed);
+        };
+        if (m_jobs && blocks > 1) {
+            m_jobs->parallelFor(blocks, 1, runBlocks);
+        }
+        else {
+            runBlocks(0, blocks, 0);
+        }
+    }
+
+    m_stats.updateMs = Profiler::now() - start;
+    m_stats.nodesUpdated = updated.load();
+    m_stats.levels = levels;
+
+    Profiler& profiler = Profiler::instance();
+    profiler.addSample("TransformHierarchy::update", m_stats.updateMs);
+    profiler.setCounter("TransformHierarchy::nodesUpdated", m_stats.nodesUpdated);
+}
+
+Matrix4
+TransformHierarchy::getWorld(unsigned int handle) const {
+    unsigned int slot = m_slotOfHandle[handle];
+    Matrix4 world;
+    for (unsigned int r = 0; r < 4; ++r) {
+        for (unsigned int c = 0; c < 3; ++c) {
+            world.m[r][c] = m_world[r * 3 + c][slot];
+        }
+        world.m[r][3] = r == 3 ? 1.0f : 0.0f;
+    }
+    return world;
+}
+
+void
+TransformHierarchy::rebuildOrder() {
+    // Raices en el orden actual y despues cada nivel con los hijos del anterior.
+    std::vector<unsigned int> order;
+    order.reserve(m_count);
+    for (unsigned int handle : m_handleOfSlot) {
+        if (handle != INVALID_HANDLE && m_parentHandle[handle] == INVALID_HANDLE) {
+            order.push_back(handle);
+        }
+    }
+    m_levelStart.assign(1, 0);
+    size_t begin = 0;
+    while (begin < order.size()) {
+        size_t end = order.size();
+        m_levelStart.push_back(static_cast<unsigned int>(end));
+        for (size_t i = begin; i < end; ++i) {
+            for (unsigned int child = m_firstChild[order[i]]; child != INVALID_HANDLE; child = m_nextSibling[child]) {
+                order.push_back(child);
+            }
+        }
+        begin = end;
+    }
+
+    std::vector<unsigned int> oldSlots(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        oldSlots[i] = m_slotOfHandle[order[i]];
+    }
+    std::vector<float>* floats[] = { &m_posX, &m_posY, &m_posZ, &m_rotX, &m_rotY, &m_rotZ, &m_rotW,
+                                     &m_scaleX, &m_scaleY, &m_scaleZ };
+    for (std::vector<float>* values : floats) {
+        permute(*values, oldSlots);
+    }
+    for (std::vector<float>& values : m_world) {
+        permute(values, oldSlots);
+    }
+    permute(m_localDirty, oldSlots);
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        m_slotOfHandle[order[i]] = static_cast<unsigned int>(i);
+    }
+    m_handleOfSlot = order;
+    m_parentSlot.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        unsigned int parent = m_parentHandle[order[i]];
+        m_parentSlot[i] = parent != INVALID_HANDLE ? m_slotOfHandle[parent] : INVALID_HANDLE;
+    }
+    m_changed.assign(order.size(), 0);
+    m_orderDirty = false;
+}
+
+unsigned int
+TransformHierarchy::updateBlock(unsigned int begin, unsigned int end, bool roots) {
+    // Un nodo se recalcula si cambio su valor local o si su padre (nivel anterior) se recalculo.
+    unsigned int slots[BLOCK_SIZE];
+    unsigned int count = 0;
+    for (unsigned int slot = begin; slot < end; ++slot) {
+        unsigned char dirty = m_localDirty[slot];
+        if (!roots) {
+            dirty |= m_changed[m_parentSlot[slot]];
+        }
+        m_changed[slot] = dirty;
+        m_localDirty[slot] = 0;
+        slots[count] = slot;
+        count += dirty;
+    }
+    computeWorld(slots, count, roots);
+    return count;
+}
+
+void
+TransformHierarchy::computeWorld(const unsigned int* slots, unsigned int count, bool roots) {
+    using namespace simd;
+    const unsigned int lanes = static_cast<unsigned int>(SIMD_LANES);
+    alignas(32) float scratch[SIMD_LANES];
+
+    auto fetch = [&](const std::vector<float>& values, const unsigned int* index, bool contiguous) {
+        if (contiguous) {
+            return load(&values[index[0]]);
+        }
+        for (unsigned int lane = 0; lane < lanes; ++lane) {
+            scratch[lane] = values[index[lane]];
+        }
+        return load(scratch);
+    };
+    auto put = [&](std::vector<float>& values, const unsigned int* index, bool contiguous, FloatV v) {
+        if (contiguous) {
+            store(&values[index[0]], v);
+            return;
+        }
+        store(scratch, v);
+        for (unsigned int lane = 0; lane < lanes; ++lane) {
+            values[index[lane]] = scratch[lane];
+        }
+    };
+
+    unsigned int index[SIMD_LANES];
+    unsigned int parent[SIMD_LANES];
+    for (unsigned int first = 0; first < count; first += lanes) {
+        // El ultimo lote se completa repitiendo el ultimo nodo (mismo resultado, misma posicion).
+        for (unsigned int lane = 0; lane < lanes; ++lane) {
+            index[lane] = slots[std::min(first + lane, count - 1)];
+        }
+        const bool contiguous = first + lanes <= count && index[lanes - 1] == index[0] + lanes - 1;
+
+        const QuaternionV rotation = { fetch(m_rotX, index, contiguous), fetch(m_rotY, index, contiguous),
+                                       fetch(m_rotZ, index, contiguous), fetch(m_rotW, index, contiguous) };
+        const Vector3V scale = { fetch(m_scaleX, index, contiguous), fetch(m_scaleY, index, contiguous),
+                                 fetch(m_scaleZ, index, contiguous) };
+        const Vector3V position = { fetch(m_posX, index, contiguous), fetch(m_posY, index, contiguous),
+                                    fetch(m_posZ, index, contiguous) };
+        const Affine3V local = math::affineTransformation(scale, rotation, position);
+
+        if (roots) {
+            for (unsigned int e = 0; e < WORLD_ELEMENTS; ++e) {
+                put(m_world[e], index, contiguous, local.m[e]);
+            }
+            continue;
+        }
+
+        // Matriz del padre: difusion si todo el lote comparte padre (hermanos), si no, recoleccion.
+        bool sameParent = true;
+        for (unsigned int lane = 0; lane < lanes; ++lane) {
+            parent[lane] = m_parentSlot[index[lane]];
+            sameParent = sameParent && parent[lane] == parent[0];
+        }
+        Affine3V parentWorld;
+        for (unsigned int e = 0; e < WORLD_ELEMENTS; ++e) {
+            if (sameParent) {
+                parentWorld.m[e] = set1(m_world[e][parent[0]]);
+            }
+            else {
+                for (unsigned int lane = 0; lane < lanes; ++lane) {
+                    scratch[lane] = m_world[e][parent[lane]];
+                }
+                parentWorld.m[e] = load(scratch);
+            }
+        }
+
+        // mundo = local * mundo del padre (vector fila).
+        const Affine3V world = math::multiply(local, parentWorld);
+        for (unsigned int e = 0; e < WORLD_ELEMENTS; ++e) {
+            put(m_world[e], index, contiguous, world.m[e]);
+        }
+    }
+}
+
+void
+TransformHierarchy::linkChild(unsigned int handle, unsigned int parent) {
+    m_parentHandle[handle] = parent;
+    m_prevSibling[handle] = INVALID_HANDLE;
+    m_nextSibling[handle] = m_firstChild[parent];
+    if (m_firstChild[parent] != INVALID_HANDLE) {
+        m_prevSibling[m_firstChild[parent]] = handle;
+    }
+    m_firstChild[parent] = handle;
+}
+
+void
+TransformHierarchy::unlinkChild(unsigned int handle) {
+    unsigned int parent = m_parentHandle[handle];
+    if (parent == INVALID_HANDLE) {
+        return;
+    }
+    unsigned int prev = m_prevSibling[handle];
+    unsigned int next = m_nextSibling[handle];
+    if (prev != INVALID_HANDLE) {
+        m_nextSibling[prev] = next;
+    }
+    else {
+        m_firstChild[parent] = next;
+    }
+    if (next != INVALID_HANDLE) {
+        m_prevSibling[next] = prev;
+    }
+    m_parentHandle[handle] = INVALID_HANDLE;
+    m_prevSibling[handle] = INVALID_HANDLE;
+    m_nextSibling[handle] = INVALID_HANDLE;
+}
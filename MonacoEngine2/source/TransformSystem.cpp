@@ -0,0 +1,19 @@
+#include "TransformSystem.h"
+#include "TransformComponent.h"
+#include "ECS/World.h"
+
+void
+TransformSystem::update(World& world, float deltaTime) {
+    world.parallelForEachChunk<TransformComponent>(
+        [](unsigned int count, const Entity*, TransformComponent* transforms) {
+        computeWorld(transforms, count);
+    });
+}
+
+void
+TransformSystem::computeWorld(TransformComponent* transforms, unsigned int count) {
+    for (unsigned int i = 0; i < count; ++i) {
+        TransformComponent& transform = transforms[i];
+        transform.world = math::affineTransformation(transform.scale, transform.rotation, transform.position);
+    }
+}
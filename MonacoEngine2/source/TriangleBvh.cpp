@@ -0,0 +1,182 @@
+#include "TriangleBvh.h"
+#include "MeshComponent.h"
+#include <cmath>
+
+namespace {
+    /// Determinantes menores que esto se consideran rayos paralelos al triangulo.
+    const float DET_EPSILON = 1e-12f;
+}
+
+HRESULT
+TriangleBvh::build(const MeshComponent& mesh, unsigned int maxLeafSize) {
+    return build(mesh.m_vertex.data(),
+        static_cast<unsigned int>(mesh.m_vertex.size()),
+        mesh.m_index.data(),
+        static_cast<unsigned int>(std::min(mesh.m_index.size(), static_cast<size_t>(mesh.m_numIndex))),
+        maxLeafSize);
+}
+
+HRESULT
+TriangleBvh::build(const SimpleVertex* vertices,
+                   unsigned int numVertices,
+                   const unsigned int* indices,
+                   unsigned int indexCount,
+                   unsigned int maxLeafSize) {
+    destroy();
+    const unsigned int triangleCount = indexCount / 3;
+    for (unsigned int i = 0; i < triangleCount * 3; ++i) {
+        if (indices[i] >= numVertices) {
+            ERROR("TriangleBvh", "build", "Index out of range");
+            return E_INVALIDARG;
+        }
+    }
+
+    std::vector<AABB> boxes(triangleCount);
+    for (unsigned int t = 0; t < triangleCount; ++t) {
+        const Vector3& a = vertices[indices[t * 3 + 0]].Pos;
+        const Vector3& b = vertices[indices[t * 3 + 1]].Pos;
+        const Vector3& c = vertices[indices[t * 3 + 2]].Pos;
+        boxes[t].min = Vector3(std::min(a.x, std::min(b.x, c.x)),
+                                std::min(a.y, std::min(b.y, c.y)),
+                                std::min(a.z, std::min(b.z, c.z)));
+        boxes[t].max = Vector3(std::max(a.x, std::max(b.x, c.x)),
+                                std::max(a.y, std::max(b.y, c.y)),
+                                std::max(a.z, std::max(b.z, c.z)));
+    }
+
+    HRESULT hr = m_bvh.build(boxes.data(), triangleCount, maxLeafSize);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    // Triangulos en el orden de las hojas.
+    const std::vector<unsigned int>& order = m_bvh.getIndices();
+    m_triangles.resize(triangleCount);
+    for (unsigned int i = 0; i < triangleCount; ++i) {
+        unsigned int id = order[i];
+        const Vector3& a = vertices[indices[id * 3 + 0]].Pos;
+        const Vector3& b = vertices[indices[id * 3 + 1]].Pos;
+        const Vector3& c = vertices[indices[id * 3 + 2]].Pos;
+        Triangle& triangle = m_triangles[i];
+        triangle.v0[0] = a.x;       triangle.v0[1] = a.y;       triangle.v0[2] = a.z;
+        triangle.e1[0] = b.x - a.x; triangle.e1[1] = b.y - a.y; triangle.e1[2] = b.z - a.z;
+        triangle.e2[0] = c.x - a.x; triangle.e2[1] = c.y - a.y; triangle.e2[2] = c.z - a.z;
+        triangle.id = id;
+    }
+    return S_OK;
+}
+
+bool
+TriangleBvh::raycast(const Ray& ray, RayHit& hit) const {
+    const float o[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+    const float d[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+
+    hit.t = ray.tMax;
+    hit.primitive = Bvh::INVALID_INDEX;
+    hit.u = hit.v = 0.0f;
+    float tMax = ray.tMax;
+    m_bvh.traverseRay(ray, tMax, [&](unsigned int first, unsigned int count, float& tLimit) {
+        for (unsigned int i = first; i < first + count; ++i) {
+            const Triangle& tri = m_triangles[i];
+            // Moller-Trumbore, sumando en el mismo orden que intersectPacket() para que ambos
+            // caminos redondeen igual en las aristas.
+            float p[3] = { d[1] * tri.e2[2] - d[2] * tri.e2[1],
+                           d[2] * tri.e2[0] - d[0] * tri.e2[2],
+                           d[0] * tri.e2[1] - d[1] * tri.e2[0] };
+            float det = tri.e1[0] * p[0] + (tri.e1[1] * p[1] + tri.e1[2] * p[2]);
+            if (fabsf(det) <= DET_EPSILON) {
+                continue;
+            }
+            float invDet = 1.0f / det;
+            float s[3] = { o[0] - tri.v0[0], o[1] - tri.v0[1], o[2] - tri.v0[2] };
+            float u = (s[0] * p[0] + (s[1] * p[1] + s[2] * p[2])) * invDet;
+            if (u < 0.0f || u > 1.0f) {
+                continue;
+            }
+            float q[3] = { s[1] * tri.e1[2] - s[2] * tri.e1[1],
+                           s[2] * tri.e1[0] - s[0] * tri.e1[2],
+                           s[0] * tri.e1[1] - s[1] * tri.e1[0] };
+            float v = (d[0] * q[0] + (d[1] * q[1] + d[2] * q[2])) * invDet;
+            if (v < 0.0f || u + v > 1.0f) {
+                continue;
+            }
+            float t = (tri.e2[0] * q[0] + (tri.e2[1] * q[1] + tri.e2[2] * q[2])) * invDet;
+            if (t >= 0.0f && t < tLimit) {
+                tLimit = t;
+                hit.t = t;
+                hit.primitive = tri.id;
+                hit.u = u;
+                hit.v = v;
+            }
+        }
+    });
+    return hit.primitive != Bvh::INVALID_INDEX;
+}
+
+void
+TriangleBvh::intersectPacket(RayPacket& packet) const {
+    using namespace simd;
+    const FloatV ox = load(packet.originX), oy = load(packet.originY), oz = load(packet.originZ);
+    const FloatV dx = load(packet.dirX), dy = load(packet.dirY), dz = load(packet.dirZ);
+    const FloatV zeroV = zero();
+    const FloatV one = set1(1.0f);
+    const FloatV epsilon = set1(DET_EPSILON);
+    const FloatV minusEpsilon = set1(-DET_EPSILON);
+
+    m_bvh.traversePacket(packet, [&](unsigned int first, unsigned int count) {
+        FloatV tMax = load(packet.tMax);
+        FloatV bestU = load(packet.u);
+        FloatV bestV = load(packet.v);
+        for (unsigned int i = first; i < first + count; ++i) {
+            const Triangle& tri = m_triangles[i];
+            const FloatV e1x = set1(tri.e1[0]), e1y = set1(tri.e1[1]), e1z = set1(tri.e1[2]);
+            const FloatV e2x = set1(tri.e2[0]), e2y = set1(tri.e2[1]), e2z = set1(tri.e2[2]);
+
+            // Moller-Trumbore con un triangulo contra todos los carriles. Sin madd(): con FMA
+            // redondearia distinto que raycast() y los rayos que rozan aristas diferirian.
+            FloatV px = sub(mul(dy, e2z), mul(dz, e2y));
+            FloatV py = sub(mul(dz, e2x), mul(dx, e2z));
+            FloatV pz = sub(mul(dx, e2y), mul(dy, e2x));
+            FloatV det = add(mul(e1x, px), add(mul(e1y, py), mul(e1z, pz)));
+            FloatV invDet = div(one, det);
+
+            FloatV sx = sub(ox, set1(tri.v0[0]));
+            FloatV sy = sub(oy, set1(tri.v0[1]));
+            FloatV sz = sub(oz, set1(tri.v0[2]));
+            FloatV u = mul(add(mul(sx, px), add(mul(sy, py), mul(sz, pz))), invDet);
+
+            FloatV qx = sub(mul(sy, e1z), mul(sz, e1y));
+            FloatV qy = sub(mul(sz, e1x), mul(sx, e1z));
+            FloatV qz = sub(mul(sx, e1y), mul(sy, e1x));
+            FloatV v = mul(add(mul(dx, qx), add(mul(dy, qy), mul(dz, qz))), invDet);
+            FloatV t = mul(add(mul(e2x, qx), add(mul(e2y, qy), mul(e2z, qz))), invDet);
+
+            FloatV hit = orv(cmpgt(det, epsilon), cmplt(det, minusEpsilon));
+            hit = andv(hit, andv(cmpge(u, zeroV), cmpge(v, zeroV)));
+            hit = andv(hit, cmple(add(u, v), one));
+            hit = andv(hit, andv(cmpge(t, zeroV), cmplt(t, tMax)));
+
+            int bits = movemask(hit);
+            if (bits == 0) {
+                continue;
+            }
+            tMax = select(hit, t, tMax);
+            bestU = select(hit, u, bestU);
+            bestV = select(hit, v, bestV);
+            for (int lane = 0; bits != 0; ++lane, bits >>= 1) {
+                if (bits & 1) {
+                    packet.primitive[lane] = tri.id;
+                }
+            }
+        }
+        store(packet.tMax, tMax);
+        store(packet.u, bestU);
+        store(packet.v, bestV);
+    });
+}
+
+void
+TriangleBvh::destroy() {
+    m_bvh.destroy();
+    m_triangles.clear();
+}
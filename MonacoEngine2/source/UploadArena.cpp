@@ -0,0 +1,119 @@
+#include "UploadArena.h"
+#include "ImageDecoder.h"
+#include <new>
+
+const unsigned int UploadImage::MAX_LEVELS;
+
+namespace {
+    inline size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+HRESULT
+UploadArena::reset(size_t capacity) {
+    m_used = 0;
+    if (capacity <= m_capacity) {
+        return S_OK;
+    }
+
+    // Sin copiar lo anterior: reset() ya lo descarto.
+    destroy();
+    m_block = new (std::nothrow) unsigned char[capacity + ALIGNMENT];
+    if (!m_block) {
+        ERROR("UploadArena", "reset", "Out of memory.");
+        return E_OUTOFMEMORY;
+    }
+    m_data = m_block + (ALIGNMENT - reinterpret_cast<uintptr_t>(m_block) % ALIGNMENT) % ALIGNMENT;
+    m_capacity = capacity;
+    m_growCount++;
+    return S_OK;
+}
+
+void*
+UploadArena::allocate(size_t bytes) {
+    const size_t size = alignUp(bytes, ALIGNMENT);
+    if (size > m_capacity - m_used) {
+        return nullptr;
+    }
+    void* result = m_data + m_used;
+    m_used += size;
+    return result;
+}
+
+size_t
+UploadArena::imageBytes(unsigned int width, unsigned int height, unsigned int rowAlignment) {
+    return alignUp(alignUp(static_cast<size_t>(width) * 4, rowAlignment) * height, ALIGNMENT);
+}
+
+ImageView
+UploadArena::allocateImage(unsigned int width, unsigned int height, unsigned int rowAlignment) {
+    ImageView view;
+    const size_t rowPitch = alignUp(static_cast<size_t>(width) * 4, rowAlignment);
+    view.data = static_cast<unsigned char*>(allocate(rowPitch * height));
+    if (view.data) {
+        view.width = width;
+        view.height = height;
+        view.rowPitch = rowPitch;
+    }
+    return view;
+}
+
+HRESULT
+UploadArena::decodeImage(const unsigned char* data, size_t size, const MipSettings& settings, UploadImage& out) {
+    out.levelCount = 0;
+    const ImageDecoderRegistry& decoders = ImageDecoderRegistry::instance();
+    unsigned int width = 0;
+    unsigned int height = 0;
+    HRESULT hr = decoders.getInfo(data, size, width, height);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    unsigned int levels = MipChain::fullLevelCount(width, height);
+    if (settings.maxLevels > 0) {
+        levels = std::min(levels, settings.maxLevels);
+    }
+    levels = std::min(levels, UploadImage::MAX_LEVELS);
+
+    // Tamano exacto de la cadena + memoria de trabajo, para crecer a lo sumo una vez.
+    size_t total = alignUp(MipChain::scratchBytes(width, height, levels), ALIGNMENT);
+    for (unsigned int level = 0; level < levels; ++level) {
+        total += imageBytes(std::max(1u, width >> level), std::max(1u, height >> level));
+    }
+    hr = reset(total);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    for (unsigned int level = 0; level < levels; ++level) {
+        out.levels[level] = allocateImage(std::max(1u, width >> level), std::max(1u, height >> level));
+    }
+    void* scratch = allocate(MipChain::scratchBytes(width, height, levels));
+
+    hr = decoders.decodeInto(data, size, out.levels[0], settings.jobs);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    hr = MipChain::generateInto(out.levels, levels, scratch, settings);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    out.levelCount = levels;
+    return S_OK;
+}
+
+void
+UploadArena::destroy() {
+    delete[] m_block;
+    m_block = nullptr;
+    m_data = nullptr;
+    m_capacity = 0;
+    m_used = 0;
+}
+
+UploadArena&
+UploadArena::forThread() {
+    thread_local UploadArena arena;
+    return arena;
+}